@@ -249,11 +249,15 @@ CTX.INPUT['structures'] = """
 
 CTX.INPUT['common'] = """
  FatalException.cpp
+ FixedWidthFilter.cpp
+ HugePages.cpp
+ MemoryReclaimer.cpp
  ThreadLocalPool.cpp
  SegvException.cpp
  SerializableEEException.cpp
  SQLException.cpp
  InterruptException.cpp
+ StringDictionary.cpp
  StringRef.cpp
  tabletuple.cpp
  TupleSchema.cpp
@@ -280,6 +284,7 @@ CTX.INPUT['execution'] = """
 """
 
 CTX.INPUT['executors'] = """
+ ExecutorStats.cpp
  OptimizedProjector.cpp
  abstractexecutor.cpp
  abstractjoinexecutor.cpp
@@ -287,6 +292,7 @@ CTX.INPUT['executors'] = """
  deleteexecutor.cpp
  executorfactory.cpp
  executorutil.cpp
+ hashjoinexecutor.cpp
  indexcountexecutor.cpp
  indexscanexecutor.cpp
  insertexecutor.cpp
@@ -302,14 +308,17 @@ CTX.INPUT['executors'] = """
  receiveexecutor.cpp
  sendexecutor.cpp
  seqscanexecutor.cpp
+ spilledsortruns.cpp
  tablecountexecutor.cpp
  tuplescanexecutor.cpp
+ tuplespillfile.cpp
  unionexecutor.cpp
  updateexecutor.cpp
 """
 
 CTX.INPUT['expressions'] = """
  abstractexpression.cpp
+ expressioncompiler.cpp
  expressionutil.cpp
  functionexpression.cpp
  geofunctions.cpp
@@ -329,6 +338,7 @@ CTX.INPUT['plannodes'] = """
  abstractscannode.cpp
  aggregatenode.cpp
  deletenode.cpp
+ hashjoinnode.cpp
  indexscannode.cpp
  indexcountnode.cpp
  tablecountnode.cpp
@@ -362,6 +372,7 @@ CTX.INPUT['indexes'] = """
 
 CTX.INPUT['storage'] = """
  AbstractDRTupleStream.cpp
+ AntiCache.cpp
  BinaryLogSink.cpp
  BinaryLogSinkWrapper.cpp
  CompatibleBinaryLogSink.cpp
@@ -396,6 +407,7 @@ CTX.INPUT['storage'] = """
  TempTableLimits.cpp
  TupleBlock.cpp
  TupleStreamBase.cpp
+ ZoneMapFilter.cpp
 """
 
 CTX.INPUT['stats'] = """
@@ -475,6 +487,7 @@ if whichtests in ("${eetestsuite}", "common"):
     CTX.TESTS['common'] = """
      debuglog_test
      elastic_hashinator_test
+     fixed_width_filter_test
      nvalue_test
      pool_test
      serializeio_test
@@ -496,6 +509,10 @@ if whichtests in ("${eetestsuite}", "executors"):
     CTX.TESTS['executors'] = """
     OptimizedProjectorTest
     MergeReceiveExecutorTest
+    HashJoinExecutorTest
+    PipelinedExecutionTest
+    SpilledSortRunsTest
+    HashAggregateSpillTest
     TestGeneratedPlans
     TestWindowedRank
     TestWindowedCount
@@ -506,6 +523,8 @@ if whichtests in ("${eetestsuite}", "executors"):
 
 if whichtests in ("${eetestsuite}", "expressions"):
     CTX.TESTS['expressions'] = """
+     batch_evaluation_test
+     compiled_expression_test
      expression_test
      function_test
     """
@@ -545,9 +564,14 @@ if whichtests in ("${eetestsuite}", "structures"):
     CTX.TESTS['structures'] = """
      CompactingMapTest
      CompactingMapIndexCountTest
+     CompactingBTreeTest
+     CompressedBitmapTest
      CompactingHashTest
+     CompactingHashBenchmark
      CompactingPoolTest
      CompactingMapBenchmark
+     FlatHashMapTest
+     FlatHashMapBenchmark
     """
 
 if whichtests in ("${eetestsuite}", "plannodes"):
@@ -0,0 +1,251 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/FixedWidthFilter.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define VOLT_FIXED_WIDTH_FILTER_SIMD
+#include <immintrin.h>
+#endif
+
+namespace voltdb
+{
+
+namespace {
+
+template <FixedWidthFilter::Op OP>
+inline bool compareScalar(int64_t lhs, int64_t rhs)
+{
+    switch (OP) {
+    case FixedWidthFilter::EQ:  return lhs == rhs;
+    case FixedWidthFilter::NE:  return lhs != rhs;
+    case FixedWidthFilter::LT:  return lhs < rhs;
+    case FixedWidthFilter::GT:  return lhs > rhs;
+    case FixedWidthFilter::LTE: return lhs <= rhs;
+    default:                    return lhs >= rhs;
+    }
+}
+
+template <FixedWidthFilter::Op OP>
+size_t filterScalar(const int64_t* values, int* positions, size_t count,
+                    int64_t rhs, int64_t nullValue)
+{
+    size_t kept = 0;
+    for (size_t ii = 0; ii < count; ++ii) {
+        // Always copy the position, but only keep it if the value passes,
+        // so that there is no branch to mispredict.
+        positions[kept] = positions[ii];
+        kept += (values[ii] != nullValue) & compareScalar<OP>(values[ii], rhs);
+    }
+    return kept;
+}
+
+#ifdef VOLT_FIXED_WIDTH_FILTER_SIMD
+
+// The vector kernels only have "equal" and "greater than" instructions,
+// so the other comparisons swap the operands or negate the result.
+template <FixedWidthFilter::Op OP>
+struct VectorCompare {
+    static const bool SWAP = (OP == FixedWidthFilter::LT || OP == FixedWidthFilter::GTE);
+    static const bool NEGATE = (OP == FixedWidthFilter::NE ||
+                                OP == FixedWidthFilter::LTE ||
+                                OP == FixedWidthFilter::GTE);
+    static const bool EQUAL = (OP == FixedWidthFilter::EQ || OP == FixedWidthFilter::NE);
+};
+
+// Move the positions of the lanes set in mask to the front.
+inline size_t keepLanes(int* positions, size_t kept, size_t first, int lanes, int mask)
+{
+    int lanePositions[4];
+    for (int lane = 0; lane < lanes; ++lane) {
+        lanePositions[lane] = positions[first + lane];
+    }
+    for (int lane = 0; lane < lanes; ++lane) {
+        if (mask & (1 << lane)) {
+            positions[kept++] = lanePositions[lane];
+        }
+    }
+    return kept;
+}
+
+template <FixedWidthFilter::Op OP>
+__attribute__((target("sse4.2")))
+size_t filterSse42(const int64_t* values, int* positions, size_t count,
+                   int64_t rhs, int64_t nullValue)
+{
+    typedef VectorCompare<OP> VC;
+    const __m128i rhsVector = _mm_set1_epi64x(rhs);
+    const __m128i nullVector = _mm_set1_epi64x(nullValue);
+    size_t kept = 0;
+    size_t ii = 0;
+    for (; ii + 2 <= count; ii += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + ii));
+        __m128i result;
+        if (VC::EQUAL) {
+            result = _mm_cmpeq_epi64(v, rhsVector);
+        }
+        else if (VC::SWAP) {
+            result = _mm_cmpgt_epi64(rhsVector, v);
+        }
+        else {
+            result = _mm_cmpgt_epi64(v, rhsVector);
+        }
+        const __m128i isNull = _mm_cmpeq_epi64(v, nullVector);
+        // keep = !null && (NEGATE ? !result : result)
+        __m128i keep = VC::NEGATE ?
+            _mm_andnot_si128(_mm_or_si128(result, isNull), _mm_set1_epi64x(-1)) :
+            _mm_andnot_si128(isNull, result);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(keep));
+        if (mask == 0) {
+            continue;
+        }
+        kept = keepLanes(positions, kept, ii, 2, mask);
+    }
+    for (; ii < count; ++ii) {
+        positions[kept] = positions[ii];
+        kept += (values[ii] != nullValue) & compareScalar<OP>(values[ii], rhs);
+    }
+    return kept;
+}
+
+template <FixedWidthFilter::Op OP>
+__attribute__((target("avx2")))
+size_t filterAvx2(const int64_t* values, int* positions, size_t count,
+                  int64_t rhs, int64_t nullValue)
+{
+    typedef VectorCompare<OP> VC;
+    const __m256i rhsVector = _mm256_set1_epi64x(rhs);
+    const __m256i nullVector = _mm256_set1_epi64x(nullValue);
+    size_t kept = 0;
+    size_t ii = 0;
+    for (; ii + 4 <= count; ii += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + ii));
+        __m256i result;
+        if (VC::EQUAL) {
+            result = _mm256_cmpeq_epi64(v, rhsVector);
+        }
+        else if (VC::SWAP) {
+            result = _mm256_cmpgt_epi64(rhsVector, v);
+        }
+        else {
+            result = _mm256_cmpgt_epi64(v, rhsVector);
+        }
+        const __m256i isNull = _mm256_cmpeq_epi64(v, nullVector);
+        // keep = !null && (NEGATE ? !result : result)
+        __m256i keep = VC::NEGATE ?
+            _mm256_andnot_si256(_mm256_or_si256(result, isNull), _mm256_set1_epi64x(-1)) :
+            _mm256_andnot_si256(isNull, result);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(keep));
+        if (mask == 0) {
+            continue;
+        }
+        kept = keepLanes(positions, kept, ii, 4, mask);
+    }
+    for (; ii < count; ++ii) {
+        positions[kept] = positions[ii];
+        kept += (values[ii] != nullValue) & compareScalar<OP>(values[ii], rhs);
+    }
+    return kept;
+}
+
+#endif // VOLT_FIXED_WIDTH_FILTER_SIMD
+
+// Indexed by FixedWidthFilter::Op
+const FixedWidthFilter::Kernel SCALAR_KERNELS[] = {
+    filterScalar<FixedWidthFilter::EQ>,
+    filterScalar<FixedWidthFilter::NE>,
+    filterScalar<FixedWidthFilter::LT>,
+    filterScalar<FixedWidthFilter::GT>,
+    filterScalar<FixedWidthFilter::LTE>,
+    filterScalar<FixedWidthFilter::GTE>
+};
+
+#ifdef VOLT_FIXED_WIDTH_FILTER_SIMD
+const FixedWidthFilter::Kernel SSE42_KERNELS[] = {
+    filterSse42<FixedWidthFilter::EQ>,
+    filterSse42<FixedWidthFilter::NE>,
+    filterSse42<FixedWidthFilter::LT>,
+    filterSse42<FixedWidthFilter::GT>,
+    filterSse42<FixedWidthFilter::LTE>,
+    filterSse42<FixedWidthFilter::GTE>
+};
+
+const FixedWidthFilter::Kernel AVX2_KERNELS[] = {
+    filterAvx2<FixedWidthFilter::EQ>,
+    filterAvx2<FixedWidthFilter::NE>,
+    filterAvx2<FixedWidthFilter::LT>,
+    filterAvx2<FixedWidthFilter::GT>,
+    filterAvx2<FixedWidthFilter::LTE>,
+    filterAvx2<FixedWidthFilter::GTE>
+};
+#endif
+
+} // namespace
+
+bool FixedWidthFilter::isSupported(InstructionSet instructionSet)
+{
+    switch (instructionSet) {
+    case SCALAR:
+        return true;
+#ifdef VOLT_FIXED_WIDTH_FILTER_SIMD
+    case SSE42:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2");
+    case AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+FixedWidthFilter::InstructionSet FixedWidthFilter::bestInstructionSet()
+{
+    if (isSupported(AVX2)) {
+        return AVX2;
+    }
+    if (isSupported(SSE42)) {
+        return SSE42;
+    }
+    return SCALAR;
+}
+
+FixedWidthFilter::Kernel FixedWidthFilter::get(Op op)
+{
+    static const InstructionSet best = bestInstructionSet();
+    return get(op, best);
+}
+
+FixedWidthFilter::Kernel FixedWidthFilter::get(Op op, InstructionSet instructionSet)
+{
+    if ( ! isSupported(instructionSet)) {
+        return NULL;
+    }
+    switch (instructionSet) {
+#ifdef VOLT_FIXED_WIDTH_FILTER_SIMD
+    case AVX2:
+        return AVX2_KERNELS[op];
+    case SSE42:
+        return SSE42_KERNELS[op];
+#endif
+    default:
+        return SCALAR_KERNELS[op];
+    }
+}
+
+} // namespace voltdb
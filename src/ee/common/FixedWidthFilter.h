@@ -0,0 +1,77 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FIXED_WIDTH_FILTER_H_
+#define FIXED_WIDTH_FILTER_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace voltdb
+{
+
+/**
+ * Kernels that compare a column of 64-bit integers with a constant, for
+ * scan predicates like "int_col = ?" or "ts_col < ?".  Narrower integer
+ * columns are widened to 64 bits first, along with their NULL value.
+ *
+ * There are scalar, SSE4.2 and AVX2 versions of each kernel.  The vector
+ * versions are compiled for their instruction sets whatever the build's
+ * target is, and get() picks the best one that the CPU supports when it
+ * is first called.
+ */
+class FixedWidthFilter
+{
+  public:
+    enum Op {
+        EQ,
+        NE,
+        LT,
+        GT,
+        LTE,
+        GTE
+    };
+
+    enum InstructionSet {
+        SCALAR,
+        SSE42,
+        AVX2
+    };
+
+    /**
+     * Keep the positions[i] for which values[i] is not nullValue and
+     * "values[i] op rhs" is true, moving them to the front of positions
+     * in their original order.  Returns how many were kept.
+     */
+    typedef size_t (*Kernel)(const int64_t* values, int* positions, size_t count,
+                             int64_t rhs, int64_t nullValue);
+
+    /** The best kernel for op on this CPU */
+    static Kernel get(Op op);
+
+    /** The kernel for op using the given instruction set, or NULL if the CPU lacks it */
+    static Kernel get(Op op, InstructionSet instructionSet);
+
+    static bool isSupported(InstructionSet instructionSet);
+
+  private:
+    static InstructionSet bestInstructionSet();
+};
+
+} // namespace voltdb
+
+#endif // FIXED_WIDTH_FILTER_H_
@@ -0,0 +1,76 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/HugePages.h"
+#include "common/FatalException.hpp"
+
+#include <sys/mman.h>
+#include <errno.h>
+#include <cstdlib>
+#include <cstring>
+
+namespace voltdb {
+
+static bool hugePagesRequested() {
+    const char* setting = ::getenv("VOLTDB_HUGE_PAGES");
+    return setting != NULL && ::strcmp(setting, "0") != 0 && ::strcmp(setting, "false") != 0;
+}
+
+bool HugePages::s_enabled = hugePagesRequested();
+volatile int64_t HugePages::s_hugePageBytes = 0;
+volatile int64_t HugePages::s_normalPageBytes = 0;
+
+char* HugePages::allocate(std::size_t size, bool* fromHugePagePool) {
+    size = roundUp(size);
+    void* storage = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    storage = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+#endif
+    if (storage != MAP_FAILED) {
+        *fromHugePagePool = true;
+        __sync_fetch_and_add(&s_hugePageBytes, static_cast<int64_t>(size));
+        return static_cast<char*>(storage);
+    }
+
+    // The huge page pool is empty or not configured
+    storage = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (storage == MAP_FAILED) {
+        throwFatalException("Failed mmap: %s", strerror(errno));
+    }
+#ifdef MADV_HUGEPAGE
+    // Only advice; the kernel may not have transparent huge pages
+    ::madvise(storage, size, MADV_HUGEPAGE);
+#endif
+    *fromHugePagePool = false;
+    __sync_fetch_and_add(&s_normalPageBytes, static_cast<int64_t>(size));
+    return static_cast<char*>(storage);
+}
+
+void HugePages::free(char* storage, std::size_t size, bool fromHugePagePool) {
+    size = roundUp(size);
+    if (::munmap(storage, size) != 0) {
+        throwFatalException("Failed munmap: %s", strerror(errno));
+    }
+    if (fromHugePagePool) {
+        __sync_fetch_and_sub(&s_hugePageBytes, static_cast<int64_t>(size));
+    }
+    else {
+        __sync_fetch_and_sub(&s_normalPageBytes, static_cast<int64_t>(size));
+    }
+}
+
+}
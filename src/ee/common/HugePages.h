@@ -0,0 +1,81 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HUGEPAGES_H_
+#define HUGEPAGES_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Opt-in backing of the EE's big, long-lived buffers -- tuple blocks, Pool
+ * chunks and ContiguousAllocator buffers (which include CompactingPool and
+ * index node storage) -- with 2MB pages, to cut TLB misses on large hosts.
+ *
+ * Start the process with VOLTDB_HUGE_PAGES=1 in its environment to turn it
+ * on.  Each buffer is mapped from the kernel's explicit huge page pool
+ * (MAP_HUGETLB) when it has pages to spare, and otherwise with normal pages
+ * advised to become transparent huge pages (MADV_HUGEPAGE).  Buffers smaller
+ * than a huge page keep their usual allocation.
+ *
+ * The byte counts of both kinds of mapping are process-wide; the frontend
+ * reports them with the memory stats.
+ */
+class HugePages {
+public:
+    static const std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    /** True if huge pages were requested for this process */
+    static bool enabled() { return s_enabled; }
+
+    /** Tests turn huge pages on and off directly */
+    static void setEnabled(bool enabled) { s_enabled = enabled; }
+
+    /** True for buffers big enough to be worth whole huge pages */
+    static bool worthwhile(std::size_t size) { return s_enabled && size >= HUGE_PAGE_SIZE; }
+
+    /** The size rounded up to whole huge pages */
+    static std::size_t roundUp(std::size_t size) {
+        return (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+    /**
+     * Map roundUp(size) bytes.  Sets *fromHugePagePool to tell free()
+     * which kind of mapping it got.
+     */
+    static char* allocate(std::size_t size, bool* fromHugePagePool);
+
+    /** Unmap a buffer returned by allocate() */
+    static void free(char* storage, std::size_t size, bool fromHugePagePool);
+
+    /** Bytes currently mapped from the explicit huge page pool */
+    static int64_t hugePageBytes() { return s_hugePageBytes; }
+
+    /** Bytes currently mapped with normal pages advised to become huge */
+    static int64_t normalPageBytes() { return s_normalPageBytes; }
+
+private:
+    static bool s_enabled;
+    static volatile int64_t s_hugePageBytes;
+    static volatile int64_t s_normalPageBytes;
+};
+
+}
+
+#endif /* HUGEPAGES_H_ */
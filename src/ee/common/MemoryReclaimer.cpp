@@ -0,0 +1,62 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/MemoryReclaimer.h"
+#include "common/Pool.hpp"
+#include "common/ThreadLocalPool.h"
+
+#include <cstdlib>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace voltdb {
+
+static int64_t highWaterMarkFromEnvironment() {
+    const char* setting = ::getenv("VOLTDB_EE_HIGH_WATER_MARK");
+    if (setting == NULL || ::atol(setting) <= 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(::atol(setting)) * 1024 * 1024;
+}
+
+int64_t MemoryReclaimer::s_highWaterMark = highWaterMarkFromEnvironment();
+volatile int64_t MemoryReclaimer::s_bytesReturned = 0;
+volatile int64_t MemoryReclaimer::s_lastTrimMillis = 0;
+
+bool MemoryReclaimer::reclaim(Pool &pool, int64_t timeInMillis) {
+    int64_t released = pool.releaseSurplusChunks();
+    released += ThreadLocalPool::releaseCachedBuffers();
+    if (released > 0) {
+        __sync_fetch_and_add(&s_bytesReturned, released);
+    }
+
+    // Only the site that moves the trim time forward trims
+    int64_t lastTrimMillis = s_lastTrimMillis;
+    if (timeInMillis - lastTrimMillis < RECLAIM_INTERVAL_MILLIS ||
+        ! __sync_bool_compare_and_swap(&s_lastTrimMillis, lastTrimMillis, timeInMillis)) {
+        return false;
+    }
+#ifdef __GLIBC__
+    // Also releases free pages in the middle of the heap, such as those
+    // of freed tuple blocks, not just the top of it
+    ::malloc_trim(0);
+#endif
+    return true;
+}
+
+}
@@ -0,0 +1,82 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORYRECLAIMER_H_
+#define MEMORYRECLAIMER_H_
+
+#include <stdint.h>
+
+namespace voltdb {
+
+class Pool;
+
+/**
+ * Gives memory the EE has freed, but its allocators still hold, back to
+ * the operating system once a site's engine grows past a high-water mark.
+ *
+ * Freed tuple blocks and other large heap buffers mostly stay resident in
+ * the malloc heap, Pool chunks are kept for reuse, and each relocatable
+ * string pool keeps one empty buffer, so RSS never drops after a big delete
+ * or truncate. Reclaiming frees the surplus Pool chunks and cached string
+ * pool buffers and then trims the heap, which unmaps or MADV_DONTNEEDs its
+ * free pages.
+ *
+ * Start the process with VOLTDB_EE_HIGH_WATER_MARK set to a size in MB to
+ * turn it on. The mark is compared with the bytes a site's engine has
+ * allocated itself (see VoltDBEngine::tick), not the process's RSS, which
+ * the JVM's heap dominates. Trimming the heap is process wide, so it runs
+ * at most once every RECLAIM_INTERVAL_MILLIS whichever site asks.
+ */
+class MemoryReclaimer {
+public:
+    /** The fewest milliseconds between heap trims */
+    static const int64_t RECLAIM_INTERVAL_MILLIS = 10000;
+
+    /** The engine allocation in bytes above which memory is reclaimed, or 0 to never reclaim */
+    static int64_t highWaterMark() { return s_highWaterMark; }
+
+    /** Tests set the high-water mark directly */
+    static void setHighWaterMark(int64_t bytes) { s_highWaterMark = bytes; }
+
+    /** True when reclaiming is on and allocatedBytes is above the high-water mark */
+    static bool aboveHighWaterMark(int64_t allocatedBytes) {
+        return s_highWaterMark > 0 && allocatedBytes > s_highWaterMark;
+    }
+
+    /**
+     * Release the pool's surplus chunks and the calling thread's cached
+     * string pool buffers, then trim the heap unless another reclaim did
+     * within RECLAIM_INTERVAL_MILLIS of timeInMillis. Returns false if the
+     * heap was not trimmed, so the caller can try again later.
+     */
+    static bool reclaim(Pool &pool, int64_t timeInMillis);
+
+    /**
+     * Bytes the EE's allocators have released by reclaim() so far. What
+     * trimming the heap gives back can't be counted.
+     */
+    static int64_t bytesReturned() { return s_bytesReturned; }
+
+private:
+    static int64_t s_highWaterMark;
+    static volatile int64_t s_bytesReturned;
+    static volatile int64_t s_lastTrimMillis;
+};
+
+}
+
+#endif /* MEMORYRECLAIMER_H_ */
@@ -1968,6 +1968,11 @@ private:
 
         assert(m_valueType == VALUE_TYPE_VARCHAR);
 
+        // Values from a StringDictionary are equal when they are shared
+        if ( ! m_sourceInlined && ! rhs.m_sourceInlined && getObjectPointer() == rhs.getObjectPointer()) {
+            return VALUE_COMPARE_EQUAL;
+        }
+
         int32_t leftLength;
         const char* left = getObject_withoutNull(&leftLength);
         int32_t rightLength;
@@ -1999,6 +2004,9 @@ private:
                                data_exception_most_specific_type_mismatch,
                                message);
         }
+        if ( ! m_sourceInlined && ! rhs.m_sourceInlined && getObjectPointer() == rhs.getObjectPointer()) {
+            return VALUE_COMPARE_EQUAL;
+        }
         int32_t leftLength;
         const char* left = getObject_withoutNull(&leftLength);
         int32_t rightLength;
@@ -25,6 +25,7 @@
 #include <climits>
 #include <string.h>
 #include "common/FatalException.hpp"
+#include "common/HugePages.h"
 
 namespace voltdb {
 static const size_t TEMP_POOL_CHUNK_SIZE = 262144;
@@ -36,12 +37,13 @@ static const size_t TEMP_POOL_CHUNK_SIZE = 262144;
 class Chunk {
 public:
     Chunk()
-        : m_offset(0), m_size(0), m_chunkData(NULL)
+        : m_offset(0), m_size(0), m_chunkData(NULL), m_hugePageSize(0), m_fromHugePagePool(false)
     {
     }
 
     inline Chunk(uint64_t size, void *chunkData)
-        : m_offset(0), m_size(size), m_chunkData(static_cast<char*>(chunkData))
+        : m_offset(0), m_size(size), m_chunkData(static_cast<char*>(chunkData)),
+          m_hugePageSize(0), m_fromHugePagePool(false)
     {
     }
 
@@ -53,6 +55,9 @@ public:
     uint64_t m_offset;
     uint64_t m_size;
     char *m_chunkData;
+    // Bytes mapped for m_chunkData by HugePages, or 0 when it came from new[]
+    uint64_t m_hugePageSize;
+    bool m_fromHugePagePool;
 };
 
 /*
@@ -87,7 +92,8 @@ public:
 #ifdef USE_MMAP
         m_allocationSize(nexthigher(allocationSize)),
 #else
-        m_allocationSize(allocationSize),
+        m_allocationSize(HugePages::worthwhile(allocationSize) ?
+                         HugePages::roundUp(allocationSize) : allocationSize),
 #endif
         m_maxChunkCount(static_cast<std::size_t>(maxChunkCount)),
         m_currentChunkIndex(0)
@@ -103,10 +109,10 @@ public:
             std::cout << strerror( errno ) << std::endl;
             throwFatalException("Failed mmap");
         }
+        m_chunks.push_back(Chunk(m_allocationSize, storage));
 #else
-        char *storage = new char[m_allocationSize];
+        m_chunks.push_back(newChunk(m_allocationSize, m_allocationSize));
 #endif
-        m_chunks.push_back(Chunk(m_allocationSize, storage));
     }
 
     ~Pool() {
@@ -117,7 +123,7 @@ public:
                 throwFatalException("Failed munmap");
             }
 #else
-            delete [] m_chunks[ii].m_chunkData;
+            freeChunk(m_chunks[ii]);
 #endif
         }
         for (std::size_t ii = 0; ii < m_oversizeChunks.size(); ii++) {
@@ -127,7 +133,7 @@ public:
                 throwFatalException("Failed munmap");
             }
 #else
-            delete [] m_oversizeChunks[ii].m_chunkData;
+            freeChunk(m_oversizeChunks[ii]);
 #endif
         }
     }
@@ -155,10 +161,10 @@ public:
                     std::cout << strerror( errno ) << std::endl;
                     throwFatalException("Failed mmap");
                 }
+                m_oversizeChunks.push_back(Chunk(nexthigher(size), storage));
 #else
-                char *storage = new char[size];
+                m_oversizeChunks.push_back(newChunk(nexthigher(size), size));
 #endif
-                m_oversizeChunks.push_back(Chunk(nexthigher(size), storage));
                 Chunk &newChunk = m_oversizeChunks.back();
                 newChunk.m_offset = size;
                 return newChunk.m_chunkData;
@@ -187,10 +193,10 @@ public:
                     std::cout << strerror( errno ) << std::endl;
                     throwFatalException("Failed mmap");
                 }
+                m_chunks.push_back(Chunk(m_allocationSize, storage));
 #else
-                char *storage = new char[m_allocationSize];
+                m_chunks.push_back(newChunk(m_allocationSize, m_allocationSize));
 #endif
-                m_chunks.push_back(Chunk(m_allocationSize, storage));
                 Chunk &newChunk = m_chunks.back();
                 newChunk.m_offset = size;
                 return newChunk.m_chunkData;
@@ -230,7 +236,7 @@ public:
                 throwFatalException("Failed munmap");
             }
 #else
-            delete [] m_oversizeChunks[ii].m_chunkData;
+            freeChunk(m_oversizeChunks[ii]);
 #endif
         }
         m_oversizeChunks.clear();
@@ -252,7 +258,7 @@ public:
                     throwFatalException("Failed munmap");
                 }
 #else
-                delete []m_chunks[ii].m_chunkData;
+                freeChunk(m_chunks[ii]);
 #endif
             }
             m_chunks.resize(m_maxChunkCount);
@@ -264,6 +270,30 @@ public:
         }
     }
 
+    /*
+     * Free the chunks past the one in use, which are otherwise kept for
+     * reuse until the pool is destroyed. Returns the number of bytes freed.
+     */
+    int64_t releaseSurplusChunks() {
+        const std::size_t numChunks = m_chunks.size();
+        int64_t bytesFreed = 0;
+        for (std::size_t ii = m_currentChunkIndex + 1; ii < numChunks; ii++) {
+#ifdef USE_MMAP
+            if (::munmap( m_chunks[ii].m_chunkData, m_chunks[ii].m_size) != 0) {
+                std::cout << strerror( errno ) << std::endl;
+                throwFatalException("Failed munmap");
+            }
+#else
+            freeChunk(m_chunks[ii]);
+#endif
+            bytesFreed += m_chunks[ii].getSize();
+        }
+        if (numChunks > m_currentChunkIndex + 1) {
+            m_chunks.resize(m_currentChunkIndex + 1);
+        }
+        return bytesFreed;
+    }
+
     int64_t getAllocatedMemory()
     {
         int64_t total = 0;
@@ -276,6 +306,30 @@ public:
     }
 
 private:
+    /*
+     * A chunk of chunkSize bytes backed by storageSize bytes of heap, or by
+     * huge pages when the storage is big enough to fill them.
+     */
+    static Chunk newChunk(uint64_t chunkSize, std::size_t storageSize) {
+        if (HugePages::worthwhile(storageSize)) {
+            bool fromHugePagePool;
+            Chunk chunk(chunkSize, HugePages::allocate(storageSize, &fromHugePagePool));
+            chunk.m_hugePageSize = storageSize;
+            chunk.m_fromHugePagePool = fromHugePagePool;
+            return chunk;
+        }
+        return Chunk(chunkSize, new char[storageSize]);
+    }
+
+    static void freeChunk(Chunk &chunk) {
+        if (chunk.m_hugePageSize != 0) {
+            HugePages::free(chunk.m_chunkData, chunk.m_hugePageSize, chunk.m_fromHugePagePool);
+        }
+        else {
+            delete [] chunk.m_chunkData;
+        }
+    }
+
     const uint64_t m_allocationSize;
     std::size_t m_maxChunkCount;
     std::size_t m_currentChunkIndex;
@@ -330,6 +384,10 @@ public:
         m_memTotal = 0;
     }
 
+    int64_t releaseSurplusChunks() {
+        return 0;
+    }
+
     int64_t getAllocatedMemory()
     {
         return m_memTotal;
@@ -0,0 +1,107 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/StringDictionary.h"
+#include "common/StringRef.h"
+#include "common/ThreadLocalPool.h"
+
+#include "boost/functional/hash.hpp"
+#include <cassert>
+#include <cstring>
+#include <new>
+
+namespace voltdb {
+
+/**
+ * A shared StringRef is allocated in one piece with this header and its
+ * string, in that order.
+ */
+struct SharedStringHeader {
+    // NULL once the dictionary is gone
+    StringDictionary* m_dictionary;
+    int32_t m_references;
+};
+
+static inline SharedStringHeader* headerOf(const StringRef* sref) {
+    return reinterpret_cast<SharedStringHeader*>(const_cast<StringRef*>(sref + 1));
+}
+
+static inline ThreadLocalPool::Sized* sizedOf(const StringRef* sref) {
+    return reinterpret_cast<ThreadLocalPool::Sized*>(headerOf(sref) + 1);
+}
+
+bool StringDictionary::Key::operator==(const Key &other) const {
+    return m_length == other.m_length && ::memcmp(m_bytes, other.m_bytes, m_length) == 0;
+}
+
+std::size_t StringDictionary::KeyHasher::operator()(const Key &key) const {
+    return boost::hash_range(key.m_bytes, key.m_bytes + key.m_length);
+}
+
+StringDictionary::~StringDictionary() {
+    // Strings still referenced by tuples outlive the dictionary, uncharged
+    for (StringMap::iterator iter = m_strings.begin(); iter != m_strings.end(); ++iter) {
+        headerOf(iter->second)->m_dictionary = NULL;
+    }
+    m_memoryCount -= m_bytesAllocated;
+}
+
+int64_t StringDictionary::allocationSize(int32_t length) {
+    return sizeof(StringRef) + sizeof(SharedStringHeader) + sizeof(ThreadLocalPool::Sized) + length;
+}
+
+StringRef* StringDictionary::intern(const char* bytes, int32_t length) {
+    StringMap::iterator iter = m_strings.find(Key(bytes, length));
+    if (iter != m_strings.end()) {
+        headerOf(iter->second)->m_references++;
+        return iter->second;
+    }
+
+    char* block = new char[allocationSize(length)];
+    StringRef* sref = new (block) StringRef(block + sizeof(StringRef) + sizeof(SharedStringHeader));
+    SharedStringHeader* header = headerOf(sref);
+    header->m_dictionary = this;
+    header->m_references = 1;
+    ThreadLocalPool::Sized* sized = new (sizedOf(sref)) ThreadLocalPool::Sized(length);
+    ::memcpy(sized->m_data, bytes, length);
+    m_strings.insert(std::make_pair(Key(sized->m_data, length), sref));
+    m_bytesAllocated += allocationSize(length);
+    m_memoryCount += allocationSize(length);
+    return sref;
+}
+
+bool StringDictionary::isShared(const StringRef* sref) {
+    return (reinterpret_cast<uintptr_t>(sref->m_stringPtr) & StringRef::SHARED_TAG) != 0;
+}
+
+void StringDictionary::release(StringRef* sref) {
+    SharedStringHeader* header = headerOf(sref);
+    assert(header->m_references > 0);
+    if (--header->m_references > 0) {
+        return;
+    }
+    if (header->m_dictionary != NULL) {
+        StringDictionary* dictionary = header->m_dictionary;
+        ThreadLocalPool::Sized* sized = sizedOf(sref);
+        dictionary->m_strings.erase(Key(sized->m_data, sized->m_size));
+        dictionary->m_bytesAllocated -= allocationSize(sized->m_size);
+        dictionary->m_memoryCount -= allocationSize(sized->m_size);
+    }
+    delete [] reinterpret_cast<char*>(sref);
+}
+
+}
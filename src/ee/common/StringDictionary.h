@@ -0,0 +1,101 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRINGDICTIONARY_H_
+#define STRINGDICTIONARY_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include "boost/unordered_map.hpp"
+
+namespace voltdb {
+
+class StringRef;
+
+/**
+ * The distinct values of a table's dictionary encoded VARCHAR or VARBINARY
+ * columns. Each value is stored once, in a StringRef that every tuple
+ * holding the value points at, and that counts those references. The
+ * tuples' StringRef pointers serve as the value codes: two tuples have the
+ * same value in an encoded column exactly when they point at the same
+ * StringRef, so comparing them takes no string compare.
+ *
+ * Shared StringRefs are freed by StringRef::destroy with their last
+ * reference, so tuples release them on every delete, update and undo path
+ * like any other persistent string. They are not relocatable, and they are
+ * allocated with their StringRef, so they cost one allocation per distinct
+ * value rather than two per row.
+ *
+ * Since no one tuple is charged for a shared value (see
+ * StringRef::getAllocatedSize), the dictionary charges each value's
+ * allocation to its table's string memory count once, when the value is
+ * added, and takes it back when the value is freed.
+ */
+class StringDictionary {
+public:
+    /** Values are charged to memoryCount, which must outlive the dictionary */
+    explicit StringDictionary(int64_t &memoryCount) : m_memoryCount(memoryCount), m_bytesAllocated(0) {}
+    ~StringDictionary();
+
+    /** A StringRef with the given value, holding one more reference to it */
+    StringRef* intern(const char* bytes, int32_t length);
+
+    /** The number of distinct values */
+    std::size_t size() const { return m_strings.size(); }
+
+    /** The bytes allocated for the distinct values, as charged to the table */
+    int64_t bytesAllocated() const { return m_bytesAllocated; }
+
+    /** True if sref was returned by intern */
+    static bool isShared(const StringRef* sref);
+
+    /** Drop a reference to a shared StringRef, freeing it with the last */
+    static void release(StringRef* sref);
+
+private:
+    struct Key {
+        Key(const char* bytes, int32_t length) : m_bytes(bytes), m_length(length) {}
+
+        bool operator==(const Key &other) const;
+
+        const char* m_bytes;
+        int32_t m_length;
+    };
+
+    struct KeyHasher {
+        std::size_t operator()(const Key &key) const;
+    };
+
+    typedef boost::unordered_map<Key, StringRef*, KeyHasher> StringMap;
+
+    static int64_t allocationSize(int32_t length);
+
+    // Values keyed by the bytes in their own StringRef
+    StringMap m_strings;
+
+    // The table's count of string memory, and this dictionary's part of it
+    int64_t &m_memoryCount;
+    int64_t m_bytesAllocated;
+
+    // No implicit copies
+    StringDictionary(const StringDictionary&);
+    StringDictionary& operator=(const StringDictionary&);
+};
+
+}
+
+#endif /* STRINGDICTIONARY_H_ */
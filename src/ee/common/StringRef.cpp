@@ -18,12 +18,17 @@
 #include "StringRef.h"
 
 #include "Pool.hpp"
+#include "StringDictionary.h"
 #include "ThreadLocalPool.h"
 
 using namespace voltdb;
 
 inline ThreadLocalPool::Sized* asSizedObject(char* stringPtr)
-{ return reinterpret_cast<ThreadLocalPool::Sized*>(stringPtr); }
+{
+    // Clear the tag of a shared string
+    return reinterpret_cast<ThreadLocalPool::Sized*>(
+        reinterpret_cast<uintptr_t>(stringPtr) & ~static_cast<uintptr_t>(1));
+}
 
 char* StringRef::getObjectValue()
 { return asSizedObject(m_stringPtr)->m_data; }
@@ -48,6 +53,10 @@ const char* StringRef::getObject(int32_t* lengthOut) const
 
 int32_t StringRef::getAllocatedSize() const
 {
+    // A shared string is not charged to any one of the tuples using it.
+    if (StringDictionary::isShared(this)) {
+        return 0;
+    }
     // The CompactingPool allocated a chunk of this size for storage.
     int32_t alloc_size = ThreadLocalPool::getAllocationSizeForRelocatable(asSizedObject(m_stringPtr));
     //cout << "Pool allocation size: " << alloc_size << endl;
@@ -145,5 +154,9 @@ StringRef::destroy(StringRef* sref)
     if (sref->m_stringPtr == reinterpret_cast<char*>(sref+1)) {
         return;
     }
+    if (StringDictionary::isShared(sref)) {
+        StringDictionary::release(sref);
+        return;
+    }
     delete sref;
 }
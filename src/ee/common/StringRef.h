@@ -23,6 +23,7 @@
 namespace voltdb
 {
 class Pool;
+class StringDictionary;
 
 /// An object to use in lieu of raw char* pointers for strings
 /// which are not inlined into tuple storage.  This provides a
@@ -50,6 +51,8 @@ public:
 
     /// Destroy the given StringRef object and free any memory
     /// allocated from persistent pools to store the object.
+    /// For a StringRef shared through a StringDictionary, this
+    /// drops one reference and frees it with the last.
     /// sref must have been allocated and returned by a call to
     /// StringRef::create().
     /// This is a no-op for strings created in a temporary Pool
@@ -68,16 +71,27 @@ public:
     const char* getObject(int32_t* lengthOut) const;
 
 private:
+    friend class StringDictionary;
+
     // Signature used internally for persistent strings
     StringRef(int32_t size);
     // Signature used internally for temporary strings
     StringRef(Pool* tempPool, int32_t size);
+    // Signature used by StringDictionary for shared strings, which are
+    // told apart by SHARED_TAG in m_stringPtr
+    explicit StringRef(char* stringPtr)
+      : m_stringPtr(reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(stringPtr) | SHARED_TAG))
+    { }
     // Only called from destroy and only for persistent strings.
     ~StringRef();
 
     // Only called from destroy and only for persistent strings.
     void operator delete(void* object);
 
+    // Set in m_stringPtr of shared strings. Strings start with their
+    // int32_t size, so the bit is otherwise always clear.
+    static const uintptr_t SHARED_TAG = 1;
+
     char* m_stringPtr;
 };
 
@@ -167,6 +167,9 @@ int32_t ThreadLocalPool::getAllocationSizeForRelocatable(Sized* data)
 void ThreadLocalPool::freeRelocatable(Sized* data)
 { delete [] reinterpret_cast<char*>(data); }
 
+std::size_t ThreadLocalPool::releaseCachedBuffers()
+{ return 0; }
+
 #else // not MEMCHECK
 
 static CompactingStringStorage& getStringPoolMap()
@@ -236,6 +239,18 @@ void ThreadLocalPool::freeRelocatable(Sized* sized)
     iter->second->free(sized);
 }
 
+std::size_t ThreadLocalPool::releaseCachedBuffers()
+{
+    std::size_t bytesFreed = 0;
+    CompactingStringStorage& poolMap = getStringPoolMap();
+    for (CompactingStringStorage::iterator iter = poolMap.begin();
+         iter != poolMap.end();
+         ++iter) {
+        bytesFreed += iter->second->releaseCachedBuffer();
+    }
+    return bytesFreed;
+}
+
 #endif
 
 void* ThreadLocalPool::allocateExactSizedObject(std::size_t sz)
@@ -114,6 +114,12 @@ public:
      * relocating some other allocation.
      */
     static void freeRelocatable(Sized* string);
+
+    /**
+     * Free the empty buffers that this thread's relocatable pools keep for
+     * reuse. Return the number of bytes freed.
+     */
+    static std::size_t releaseCachedBuffers();
 };
 }
 
@@ -145,6 +145,14 @@ namespace voltdb
             }
         }
 
+        /**
+         * True if no quantum is waiting to be undone or released, as
+         * between transactions.
+         */
+        inline bool isEmpty() const {
+            return m_undoQuantums.empty();
+        }
+
         int64_t getSize() const
         {
             int64_t total = 0;
@@ -191,6 +191,7 @@ enum PlanNodeType {
     //
     PLAN_NODE_TYPE_NESTLOOP         = 20,
     PLAN_NODE_TYPE_NESTLOOPINDEX    = 21,
+    PLAN_NODE_TYPE_HASHJOIN         = 22,
 
     //
     // Operator Nodes
@@ -361,8 +362,9 @@ enum QuantifierType {
 enum TableIndexType {
     BALANCED_TREE_INDEX     = 1,
     HASH_TABLE_INDEX        = 2,
-    BTREE_INDEX             = 3, // unused
-    COVERING_CELL_INDEX     = 4
+    BTREE_INDEX             = 3, // B+-tree; a balanced tree for keys it can't hold
+    COVERING_CELL_INDEX     = 4,
+    BITMAP_INDEX            = 5  // bitmaps of tuple slots; a tree for keys it can't hold
 };
 
 // ------------------------------------------------------------------
@@ -454,7 +456,9 @@ inline bool tableStreamTypeAppliesToPreTruncateTable(TableStreamType streamType)
 // ------------------------------------------------------------------
 enum StatisticsSelectorType {
     STATISTICS_SELECTOR_TYPE_TABLE,
-    STATISTICS_SELECTOR_TYPE_INDEX
+    STATISTICS_SELECTOR_TYPE_INDEX,
+    // The frontend passes StatsSelector ordinals, and EXECUTOR comes last there
+    STATISTICS_SELECTOR_TYPE_EXECUTOR = 31
 };
 
 // ------------------------------------------------------------------
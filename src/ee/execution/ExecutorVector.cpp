@@ -54,6 +54,8 @@
 
 #include "boost/foreach.hpp"
 
+#include <set>
+
 namespace voltdb {
 
 boost::shared_ptr<ExecutorVector> ExecutorVector::fromCatalogStatement(VoltDBEngine* engine,
@@ -107,10 +109,25 @@ boost::shared_ptr<ExecutorVector> ExecutorVector::fromJsonPlan(VoltDBEngine* eng
                                                             tempTableLogLimit,
                                                             tempTableMemoryLimit,
                                                             pnf));
+    ev->compileExpressions();
     ev->init(engine);
     return ev;
 }
 
+/**
+ * Specialize the plan's expressions before any executor caches pointers to
+ * them.  The specialized forms live in the plan nodes, so they are built once
+ * and reused for as long as the engine keeps this fragment in its plan cache.
+ */
+void ExecutorVector::compileExpressions() {
+    for (PlanNodeFragment::PlanNodeMapIterator it = m_fragment->executeListBegin();
+         it != m_fragment->executeListEnd(); ++it) {
+        BOOST_FOREACH (AbstractPlanNode* planNode, *it->second) {
+            planNode->compileExpressions();
+        }
+    }
+}
+
 void ExecutorVector::init(VoltDBEngine* engine) {
     // Initialize each node!
     for (PlanNodeFragment::PlanNodeMapIterator it = m_fragment->executeListBegin();
@@ -122,9 +139,15 @@ void ExecutorVector::init(VoltDBEngine* engine) {
             initPlanNode(engine, planNode);
             executorList->push_back(planNode->getExecutor());
         }
+        if (isPipelined()) {
+            linkPullChains(*executorList);
+        }
         m_subplanExecListMap.insert(make_pair(it->first, executorList.get()));
         executorList.release();
     }
+    if (engine->isExecutorProfilingEnabled()) {
+        setProfiling(true);
+    }
 }
 
 std::string ExecutorVector::debug() const {
@@ -181,11 +204,71 @@ void ExecutorVector::initPlanNode(VoltDBEngine* engine, AbstractPlanNode* node)
     throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION, msg);
 }
 
+/**
+ * Let each executor that can consume its only child by pulling do so when the
+ * child can be pulled from.  A pulled executor runs from inside its parent,
+ * so it is dropped from the list; only the top of each such chain is executed
+ * and materializes an output table.  Blocking executors (order by, hash
+ * aggregate, ...) support neither side and keep materializing as before.
+ */
+void ExecutorVector::linkPullChains(std::vector<AbstractExecutor*>& executorList) {
+    std::set<AbstractExecutor*> pulled;
+    BOOST_FOREACH (AbstractExecutor* executor, executorList) {
+        AbstractPlanNode* node = executor->getPlanNode();
+        if ( ! executor->canPullInput() || node->getChildren().size() != 1) {
+            continue;
+        }
+        AbstractExecutor* child = node->getChildren()[0]->getExecutor();
+        if (child == NULL || ! child->supportsPull()) {
+            continue;
+        }
+        VOLT_DEBUG("Plan node %d pulls from plan node %d",
+                   node->getPlanNodeId(), child->getPlanNode()->getPlanNodeId());
+        executor->setPullSource(child);
+        pulled.insert(child);
+    }
+    if (pulled.empty()) {
+        return;
+    }
+    std::vector<AbstractExecutor*> remaining;
+    BOOST_FOREACH (AbstractExecutor* executor, executorList) {
+        if (pulled.find(executor) == pulled.end()) {
+            remaining.push_back(executor);
+        }
+    }
+    executorList.swap(remaining);
+}
+
 void ExecutorVector::setupContext(ExecutorContext* executorContext)
     { executorContext->setupForExecutors(&m_subplanExecListMap); }
 
 void ExecutorVector::resetLimitStats() { m_limits.resetPeakMemory(); }
 
+/**
+ * Only the executors in the lists are profiled.  Inline and pulled executors
+ * run inside another executor, whose profile includes their work.
+ */
+void ExecutorVector::setProfiling(bool enable) {
+    typedef std::map<int, std::vector<AbstractExecutor*>*>::value_type MapEntry;
+    BOOST_FOREACH (MapEntry &entry, m_subplanExecListMap) {
+        BOOST_FOREACH (AbstractExecutor* executor, *entry.second) {
+            executor->setProfiling(m_fragId, enable);
+        }
+    }
+}
+
+void ExecutorVector::registerExecutorStats(StatsAgent& statsAgent) const {
+    typedef std::map<int, std::vector<AbstractExecutor*>*>::value_type MapEntry;
+    BOOST_FOREACH (const MapEntry &entry, m_subplanExecListMap) {
+        BOOST_FOREACH (AbstractExecutor* executor, *entry.second) {
+            ExecutorStats* stats = executor->getExecutorStats();
+            if (stats != NULL) {
+                statsAgent.registerStatsSource(STATISTICS_SELECTOR_TYPE_EXECUTOR, 0, stats);
+            }
+        }
+    }
+}
+
 const std::vector<AbstractExecutor*>& ExecutorVector::getExecutorList(int planId) {
     assert(m_subplanExecListMap.find(planId) != m_subplanExecListMap.end());
     return *(m_subplanExecListMap.find(planId)->second);
@@ -63,6 +63,7 @@ class VoltDBEngine;
 class AbstractPlanNode;
 class AbstractExecutor;
 class ExecutorContext;
+class StatsAgent;
 
 /**
  * A list of executors for runtime.
@@ -87,6 +88,9 @@ public:
 
     const TempTableLimits& limits() const { return m_limits; }
 
+    /** True if this plan runs pull-based chains of executors (see linkPullChains) */
+    bool isPipelined() const { return m_fragment->isPipelined(); }
+
     /** Return a std::string with helpful info about this object. */
     std::string debug() const;
 
@@ -94,6 +98,12 @@ public:
 
     void resetLimitStats();
 
+    /** Turn ExecutorStats collection on or off for each executor that runs */
+    void setProfiling(bool enable);
+
+    /** Hand the ExecutorStats of each profiled executor to the stats agent */
+    void registerExecutorStats(StatsAgent& statsAgent) const;
+
     // Get the executors list for a given subplan. The default plan id = 0
     // represents the top level parent plan
     const std::vector<AbstractExecutor*>& getExecutorList(int planId = 0);
@@ -127,8 +137,12 @@ private:
         , m_fragment(fragment)
     { }
 
+    void compileExpressions();
+
     void initPlanNode(VoltDBEngine* engine, AbstractPlanNode* node);
 
+    void linkPullChains(std::vector<AbstractExecutor*>& executorList);
+
     const int64_t m_fragId;
     std::map<int, std::vector<AbstractExecutor*>* > m_subplanExecListMap;
     TempTableLimits m_limits;
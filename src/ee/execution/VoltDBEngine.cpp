@@ -65,10 +65,13 @@
 #include "common/FatalException.hpp"
 #include "common/LegacyHashinator.h"
 #include "common/InterruptException.h"
+#include "common/MemoryReclaimer.h"
+#include "storage/AntiCache.h"
 #include "common/RecoveryProtoMessage.h"
 #include "common/SerializableEEException.h"
 #include "common/TupleOutputStream.h"
 #include "common/TupleOutputStreamProcessor.h"
+#include "common/UniqueId.hpp"
 #include "executors/abstractexecutor.h"
 #include "indexes/tableindex.h"
 #include "indexes/tableindexfactory.h"
@@ -97,6 +100,8 @@
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
 
+#include <algorithm>
+#include <functional>
 #include <sstream>
 #include <locale>
 #include <typeinfo>
@@ -137,12 +142,37 @@ typedef boost::multi_index::multi_index_container<
 /// This class wrapper around a typedef allows forward declaration as in scoped_ptr<EnginePlanSet>.
 class EnginePlanSet : public PlanSet { };
 
+/**
+ * The most tuples a table's time to live expires per transaction, which can
+ * be set with the VOLTDB_TTL_BATCH_SIZE environment variable.
+ */
+static int getExpirationBatchSizeFromEnvironment() {
+    const char* setting = ::getenv("VOLTDB_TTL_BATCH_SIZE");
+    if (setting != NULL && ::atoi(setting) > 0) {
+        return ::atoi(setting);
+    }
+    return 100;
+}
+
+/**
+ * The microseconds each tick may spend compacting fragmented tables, which
+ * can be set with the VOLTDB_COMPACTION_BUDGET environment variable.
+ */
+static int64_t getCompactionBudgetFromEnvironment() {
+    const char* setting = ::getenv("VOLTDB_COMPACTION_BUDGET");
+    if (setting != NULL && ::atoi(setting) > 0) {
+        return ::atoi(setting);
+    }
+    return 10000;
+}
+
 VoltDBEngine::VoltDBEngine(Topend *topend, LogProxy *logProxy)
     : m_currentIndexInBatch(-1),
       m_currentUndoQuantum(NULL),
       m_partitionId(-1),
       m_hashinator(NULL),
       m_isActiveActiveDREnabled(false),
+      m_isDRReplica(false),
       m_currentInputDepId(-1),
       m_stringPool(16777216, 2),
       m_numResultDependencies(0),
@@ -156,7 +186,13 @@ VoltDBEngine::VoltDBEngine(Topend *topend, LogProxy *logProxy)
       m_drReplicatedStream(NULL),
       m_compatibleDRStream(NULL),
       m_compatibleDRReplicatedStream(NULL),
-      m_currExecutorVec(NULL)
+      m_currExecutorVec(NULL),
+      m_executorProfiling(false),
+      m_expirationBatchSize(getExpirationBatchSizeFromEnvironment()),
+      m_expireTuplesInBatch(false),
+      m_lastExpirationTxnId(-1),
+      m_compactionBudget(getCompactionBudgetFromEnvironment()),
+      m_memoryToReclaim(false)
 {
 }
 
@@ -376,6 +412,10 @@ int VoltDBEngine::executePlanFragments(int32_t numFragments,
 
     m_executorContext->checkTransactionForDR();
 
+    // Expire tuples in the first read-write batch of each transaction, so
+    // the deletes can be undone and replay the same on every replica
+    m_expireTuplesInBatch = undoToken != INT64_MAX && txnId != m_lastExpirationTxnId;
+
     // reset these at the start of each batch
     m_executorContext->m_progressStats.resetForNewBatch();
     NValueArray &params = m_executorContext->getParameterContainer();
@@ -450,6 +490,13 @@ int VoltDBEngine::executePlanFragment(int64_t planfragmentId,
 
     int64_t tuplesModified = 0;
     try {
+        if (first && m_expireTuplesInBatch) {
+            m_lastExpirationTxnId = m_executorContext->currentTxnId();
+            if (expireTuples() > 0) {
+                m_dirtyFragmentBatch = true;
+            }
+        }
+
         // execution lists for planfragments are cached by planfragment id
         setExecutorVectorForFragmentId(planfragmentId);
         assert(m_currExecutorVec);
@@ -591,6 +638,7 @@ bool VoltDBEngine::updateCatalogDatabaseReference() {
         return false;
     }
     m_isActiveActiveDREnabled = m_database->isActiveActiveDRed();
+    m_isDRReplica = cluster->drConsumerEnabled() && !m_isActiveActiveDREnabled;
 
     return true;
 }
@@ -1172,7 +1220,10 @@ VoltDBEngine::loadTable(int32_t tableId,
     }
 
     try {
+        // Without a way to return duplicates, a duplicate is fatal anyway
+        table->beginBulkIndexing( ! returnUniqueViolations);
         table->loadTuplesFrom(serializeIn, NULL, returnUniqueViolations ? &m_resultOutput : NULL, shouldDRStream);
+        table->endBulkIndexing();
     }
     catch (const SerializableEEException &e) {
         throwFatalException("%s", e.message().c_str());
@@ -1484,6 +1535,117 @@ void VoltDBEngine::tick(int64_t timeInMillis, int64_t lastCommittedSpHandle) {
     if (m_executorContext->drReplicatedStream()) {
         m_executorContext->drReplicatedStream()->periodicFlush(timeInMillis, lastCommittedSpHandle);
     }
+    // A tick can come between the fragments of a multi-partition
+    // transaction, whose undo actions may point at the moved tuples.
+    if (m_undoLog.isEmpty()) {
+        compactTables();
+    }
+    if (AntiCache::enabled()) {
+        evictColdBlocks();
+        AntiCache::advanceClock(timeInMillis);
+    }
+    if (MemoryReclaimer::highWaterMark() > 0) {
+        // Reclaim once more after dropping below the mark, which is when
+        // a big delete or truncate has left the most to give back
+        if (MemoryReclaimer::aboveHighWaterMark(allocatedMemory())) {
+            m_memoryToReclaim = true;
+        }
+        if (m_memoryToReclaim && MemoryReclaimer::reclaim(m_stringPool, timeInMillis)) {
+            m_memoryToReclaim = false;
+        }
+    }
+}
+
+int64_t VoltDBEngine::allocatedMemory() {
+    int64_t bytes = m_stringPool.getAllocatedMemory() + ThreadLocalPool::getPoolAllocationSize();
+    typedef std::pair<int64_t, PersistentTable*> HashedTable;
+    BOOST_FOREACH (HashedTable table, m_tablesBySignatureHash) {
+        bytes += table.second->allocatedTupleMemory();
+        BOOST_FOREACH (TableIndex *index, table.second->allIndexes()) {
+            bytes += index->getMemoryEstimate();
+        }
+    }
+    return bytes;
+}
+
+int VoltDBEngine::expireTuples() {
+    // The transaction's timestamp, unlike the wall clock, is the same
+    // wherever and whenever the transaction runs
+    const int64_t nowMicros = UniqueId::timestampSinceUnixEpoch(m_executorContext->currentUniqueId());
+    int expired = 0;
+    typedef std::pair<int64_t, PersistentTable*> HashedTable;
+    BOOST_FOREACH (HashedTable table, m_tablesBySignatureHash) {
+        // A replica gets the master's expiry through DR, so deleting here too
+        // would diverge from it
+        if (table.second->timeToLiveColumn() >= 0 &&
+            !(m_isDRReplica && table.second->isDREnabled())) {
+            expired += table.second->expireTuples(nowMicros, m_expirationBatchSize);
+        }
+    }
+    return expired;
+}
+
+void VoltDBEngine::compactTables() {
+    typedef std::pair<int64_t, PersistentTable*> FragmentedTable;
+    std::vector<FragmentedTable> fragmentedTables;
+    typedef std::pair<int64_t, PersistentTable*> HashedTable;
+    BOOST_FOREACH (HashedTable table, m_tablesBySignatureHash) {
+        if (table.second->needsCompaction()) {
+            fragmentedTables.push_back(FragmentedTable(table.second->reclaimableTupleMemory(), table.second));
+        }
+    }
+    // The tables with the most memory to reclaim go first
+    std::sort(fragmentedTables.begin(), fragmentedTables.end(), std::greater<FragmentedTable>());
+    int64_t budget = m_compactionBudget;
+    BOOST_FOREACH (FragmentedTable table, fragmentedTables) {
+        if (budget <= 0) {
+            break;
+        }
+        budget -= table.second->doIncrementalCompaction(budget);
+    }
+}
+
+namespace {
+struct ColdBlock {
+    ColdBlock(TBPtr block, PersistentTable* table) : m_block(block), m_table(table) {}
+
+    bool operator<(const ColdBlock &other) const {
+        return m_block->lastAccess() < other.m_block->lastAccess();
+    }
+
+    TBPtr m_block;
+    PersistentTable* m_table;
+};
+}
+
+void VoltDBEngine::evictColdBlocks() {
+    int64_t residentMemory = 0;
+    typedef std::pair<int64_t, PersistentTable*> HashedTable;
+    BOOST_FOREACH (HashedTable table, m_tablesBySignatureHash) {
+        residentMemory += table.second->allocatedTupleMemory() - table.second->evictedTupleMemory();
+    }
+    if (residentMemory <= AntiCache::memoryLimit()) {
+        return;
+    }
+
+    std::vector<ColdBlock> coldBlocks;
+    std::vector<TBPtr> blocks;
+    BOOST_FOREACH (HashedTable table, m_tablesBySignatureHash) {
+        table.second->collectEvictableBlocks(blocks);
+        BOOST_FOREACH (TBPtr block, blocks) {
+            coldBlocks.push_back(ColdBlock(block, table.second));
+        }
+        blocks.clear();
+    }
+    // The blocks that have gone longest without access go first
+    std::stable_sort(coldBlocks.begin(), coldBlocks.end());
+    BOOST_FOREACH (ColdBlock &cold, coldBlocks) {
+        if (residentMemory <= AntiCache::memoryLimit()) {
+            break;
+        }
+        cold.m_table->evictBlock(cold.m_block);
+        residentMemory -= cold.m_table->getTableAllocationSize();
+    }
 }
 
 /** Bring the Export and DR system to a steady state with no pending committed data */
@@ -1577,6 +1739,22 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
                 (StatisticsSelectorType) selector,
                 locatorIds, interval, now);
             break;
+        case STATISTICS_SELECTOR_TYPE_EXECUTOR:
+            // Executors come and go with the plan cache, so register the
+            // ones cached right now.  They all share locator 0; each row
+            // carries its own fragment and plan node ids.
+            m_statsManager.unregisterStatsSource(STATISTICS_SELECTOR_TYPE_EXECUTOR);
+            if (m_plans) {
+                BOOST_FOREACH (boost::shared_ptr<ExecutorVector> ev_guard, *m_plans) {
+                    ev_guard->registerExecutorStats(m_statsManager);
+                }
+            }
+            locatorIds.assign(1, 0);
+            resultTable = m_statsManager.getStats(
+                (StatisticsSelectorType) selector,
+                locatorIds, interval, now);
+            m_statsManager.unregisterStatsSource(STATISTICS_SELECTOR_TYPE_EXECUTOR);
+            break;
         default:
             char message[256];
             snprintf(message, 256, "getStats() called with an unrecognized selector"
@@ -1601,6 +1779,16 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
 }
 
 
+void VoltDBEngine::setExecutorProfiling(bool enable)
+{
+    m_executorProfiling = enable;
+    if (m_plans) {
+        BOOST_FOREACH (boost::shared_ptr<ExecutorVector> ev_guard, *m_plans) {
+            ev_guard->setProfiling(enable);
+        }
+    }
+}
+
 void VoltDBEngine::setCurrentUndoQuantum(voltdb::UndoQuantum* undoQuantum)
 {
     m_currentUndoQuantum = undoQuantum;
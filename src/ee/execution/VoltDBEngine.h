@@ -307,6 +307,15 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                 bool interval,
                 int64_t now);
 
+        /**
+         * Turn per-executor profiling on or off.  While it is on, every
+         * executor of a cached plan fragment keeps an ExecutorStats, which
+         * getStats() reports under STATISTICS_SELECTOR_TYPE_EXECUTOR.
+         */
+        void setExecutorProfiling(bool enable);
+
+        bool isExecutorProfilingEnabled() const { return m_executorProfiling; }
+
         Pool* getStringPool() { return &m_stringPool; }
 
         LogManager* getLogManager() { return &m_logManager; }
@@ -439,6 +448,24 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         bool updateCatalogDatabaseReference();
         void resetDRConflictStreamedTables();
 
+        /**
+         * Delete a batch of the tuples that outlived their table's time to
+         * live as of the current transaction, and return how many
+         */
+        int expireTuples();
+
+        /** Spend up to the tick's compaction budget on the most fragmented tables */
+        void compactTables();
+
+        /** Evict the coldest tuple blocks while over the anti-cache memory limit */
+        void evictColdBlocks();
+
+        /**
+         * The bytes held by the engine's temp pool, the thread's string and
+         * object pools, and the tables' tuple blocks and indexes
+         */
+        int64_t allocatedMemory();
+
         /**
          * Execute a single plan fragment.
          */
@@ -515,6 +542,8 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         boost::scoped_ptr<catalog::Catalog> m_catalog;
         catalog::Database *m_database;
         bool m_isActiveActiveDREnabled;
+        // Consuming DR from a master, which expires the DR tables' tuples
+        bool m_isDRReplica;
 
         /** buffer object for result tables. set when the result table is sent out to localsite. */
         FallbackSerializeOutput m_resultOutput;
@@ -605,6 +634,24 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         /** current ExecutorVector **/
         ExecutorVector *m_currExecutorVec;
 
+        /** see setExecutorProfiling() */
+        bool m_executorProfiling;
+
+        /** The most tuples each table's time to live expires per transaction */
+        int m_expirationBatchSize;
+
+        /** Whether to expire tuples before the current batch's first fragment */
+        bool m_expireTuplesInBatch;
+
+        /** The last transaction that expired tuples, which does so only once */
+        int64_t m_lastExpirationTxnId;
+
+        /** The microseconds of table compaction each tick may take */
+        int64_t m_compactionBudget;
+
+        /** Set once above the memory high-water mark until a reclaim trims the heap */
+        bool m_memoryToReclaim;
+
         // This stateless member acts as a counted reference to keep the ThreadLocalPool alive
         // just while this VoltDBEngine is alive. That simplifies valgrind-compliant process shutdown.
         ThreadLocalPool m_tlPool;
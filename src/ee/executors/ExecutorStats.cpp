@@ -0,0 +1,171 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include <string>
+#include "executors/ExecutorStats.h"
+#include "stats/StatsSource.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "plannodes/abstractplannode.h"
+#include "storage/tablefactory.h"
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> ExecutorStats::generateExecutorStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("FRAGMENT_ID");
+    columnNames.push_back("PLAN_NODE_ID");
+    columnNames.push_back("PLAN_NODE_TYPE");
+    columnNames.push_back("INVOCATIONS");
+    columnNames.push_back("EXECUTION_TIME");
+    columnNames.push_back("TUPLES_IN");
+    columnNames.push_back("TUPLES_OUT");
+    columnNames.push_back("INDEX_PROBES");
+    columnNames.push_back("MAX_TEMP_TABLE_MEMORY");
+
+    return columnNames;
+}
+
+// make sure to update schema in frontend sources (ExecutorStats.java) when updating
+// the executor-stats schema in here.
+void ExecutorStats::populateExecutorStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+
+    // fragment id
+    types.push_back(VALUE_TYPE_BIGINT);
+    columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // plan node id
+    types.push_back(VALUE_TYPE_INTEGER);
+    columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // plan node type
+    types.push_back(VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(4096);
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // invocations, execution time (microseconds), tuples in, tuples out,
+    // index probes and the largest output table (bytes)
+    for (int ii = 0; ii < 6; ++ii) {
+        types.push_back(VALUE_TYPE_BIGINT);
+        columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        allowNull.push_back(false);
+        inBytes.push_back(false);
+    }
+}
+
+TempTable* ExecutorStats::generateEmptyExecutorStatsTable() {
+    string name = "Executor stats temp table";
+    vector<string> columnNames = ExecutorStats::generateExecutorStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    ExecutorStats::populateExecutorStatsSchema(columnTypes, columnLengths,
+                                               columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name,
+                                        schema,
+                                        columnNames,
+                                        NULL);
+}
+
+ExecutorStats::ExecutorStats(int64_t fragmentId, AbstractPlanNode* node)
+    : StatsSource(), m_fragmentId(fragmentId), m_planNodeId(node->getPlanNodeId()),
+      m_invocations(0), m_executionMicros(0), m_tuplesIn(0), m_tuplesOut(0),
+      m_indexProbes(0), m_maxTempTableBytes(0),
+      m_lastInvocations(0), m_lastExecutionMicros(0), m_lastTuplesIn(0),
+      m_lastTuplesOut(0), m_lastIndexProbes(0)
+{
+    string typeName = planNodeToString(node->getPlanNodeType());
+    m_planNodeType = ValueFactory::getStringValue(typeName);
+    configure(typeName + " executor stats");
+}
+
+vector<string> ExecutorStats::generateStatsColumnNames()
+{
+    return ExecutorStats::generateExecutorStatsColumnNames();
+}
+
+void ExecutorStats::updateStatsTuple(TableTuple *tuple) {
+    int64_t invocations = m_invocations;
+    int64_t executionMicros = m_executionMicros;
+    int64_t tuplesIn = m_tuplesIn;
+    int64_t tuplesOut = m_tuplesOut;
+    int64_t indexProbes = m_indexProbes;
+    int64_t maxTempTableBytes = m_maxTempTableBytes;
+
+    if (interval()) {
+        invocations -= m_lastInvocations;
+        executionMicros -= m_lastExecutionMicros;
+        tuplesIn -= m_lastTuplesIn;
+        tuplesOut -= m_lastTuplesOut;
+        indexProbes -= m_lastIndexProbes;
+        m_lastInvocations = m_invocations;
+        m_lastExecutionMicros = m_executionMicros;
+        m_lastTuplesIn = m_tuplesIn;
+        m_lastTuplesOut = m_tuplesOut;
+        m_lastIndexProbes = m_indexProbes;
+        // the peak is per interval
+        m_maxTempTableBytes = 0;
+    }
+
+    tuple->setNValue(StatsSource::m_columnName2Index["FRAGMENT_ID"],
+                     ValueFactory::getBigIntValue(m_fragmentId));
+    tuple->setNValue(StatsSource::m_columnName2Index["PLAN_NODE_ID"],
+                     ValueFactory::getIntegerValue(m_planNodeId));
+    tuple->setNValue(StatsSource::m_columnName2Index["PLAN_NODE_TYPE"], m_planNodeType);
+    tuple->setNValue(StatsSource::m_columnName2Index["INVOCATIONS"],
+                     ValueFactory::getBigIntValue(invocations));
+    tuple->setNValue(StatsSource::m_columnName2Index["EXECUTION_TIME"],
+                     ValueFactory::getBigIntValue(executionMicros));
+    tuple->setNValue(StatsSource::m_columnName2Index["TUPLES_IN"],
+                     ValueFactory::getBigIntValue(tuplesIn));
+    tuple->setNValue(StatsSource::m_columnName2Index["TUPLES_OUT"],
+                     ValueFactory::getBigIntValue(tuplesOut));
+    tuple->setNValue(StatsSource::m_columnName2Index["INDEX_PROBES"],
+                     ValueFactory::getBigIntValue(indexProbes));
+    tuple->setNValue(StatsSource::m_columnName2Index["MAX_TEMP_TABLE_MEMORY"],
+                     ValueFactory::getBigIntValue(maxTempTableBytes));
+}
+
+void ExecutorStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    ExecutorStats::populateExecutorStatsSchema(types, columnLengths, allowNull, inBytes);
+}
+
+ExecutorStats::~ExecutorStats() {
+    m_planNodeType.free();
+}
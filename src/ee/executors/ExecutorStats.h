@@ -0,0 +1,110 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXECUTORSTATS_H_
+#define EXECUTORSTATS_H_
+
+#include "stats/StatsSource.h"
+
+namespace voltdb {
+class AbstractPlanNode;
+class TempTable;
+
+/**
+ * StatsSource extension for the executor of one plan node of a cached plan
+ * fragment.  The engine only creates these while executor profiling is on
+ * (see VoltDBEngine::setExecutorProfiling); AbstractExecutor::execute feeds
+ * them one row of counters per run.
+ */
+class ExecutorStats : public StatsSource {
+public:
+    /**
+     * Static method to generate the column names for the tables which
+     * contain executor stats.
+     */
+    static std::vector<std::string> generateExecutorStatsColumnNames();
+
+    /**
+     * Static method to generate the remaining schema information for
+     * the tables which contain executor stats.
+     */
+    static void populateExecutorStatsSchema(std::vector<voltdb::ValueType>& types,
+                                            std::vector<int32_t>& columnLengths,
+                                            std::vector<bool>& allowNull,
+                                            std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptyExecutorStatsTable();
+
+    ExecutorStats(int64_t fragmentId, AbstractPlanNode* node);
+
+    ~ExecutorStats();
+
+    /**
+     * Account for one run of the executor.
+     * @param micros Wall clock time spent in the executor
+     * @param tuplesIn Tuples in the executor's input tables
+     * @param tuplesOut Tuples in the executor's output table
+     * @param tempTableBytes Memory held by the executor's output table
+     */
+    void recordExecution(int64_t micros, int64_t tuplesIn, int64_t tuplesOut, int64_t tempTableBytes)
+    {
+        ++m_invocations;
+        m_executionMicros += micros;
+        m_tuplesIn += tuplesIn;
+        m_tuplesOut += tuplesOut;
+        if (tempTableBytes > m_maxTempTableBytes) {
+            m_maxTempTableBytes = tempTableBytes;
+        }
+    }
+
+    /** Account for one lookup of a search key in an index */
+    void countIndexProbe() { ++m_indexProbes; }
+
+protected:
+
+    /**
+     * Update the stats tuple with the latest statistics available to this StatsSource.
+     */
+    virtual void updateStatsTuple(TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    const int64_t m_fragmentId;
+    const int32_t m_planNodeId;
+    voltdb::NValue m_planNodeType;
+
+    int64_t m_invocations;
+    int64_t m_executionMicros;
+    int64_t m_tuplesIn;
+    int64_t m_tuplesOut;
+    int64_t m_indexProbes;
+    int64_t m_maxTempTableBytes;
+
+    int64_t m_lastInvocations;
+    int64_t m_lastExecutionMicros;
+    int64_t m_lastTuplesIn;
+    int64_t m_lastTuplesOut;
+    int64_t m_lastIndexProbes;
+};
+
+}
+
+#endif /* EXECUTORSTATS_H_ */
@@ -45,6 +45,8 @@
 
 #include "abstractexecutor.h"
 
+#include "common/FatalException.hpp"
+#include "execution/ProgressMonitorProxy.h"
 #include "execution/VoltDBEngine.h"
 #include "expressions/abstractexpression.h"
 #include "plannodes/abstractoperationnode.h"
@@ -52,6 +54,8 @@
 #include "storage/tablefactory.h"
 #include "storage/TableCatalogDelegate.hpp"
 
+#include "boost/date_time/posix_time/posix_time.hpp"
+
 #include <vector>
 
 using namespace std;
@@ -178,6 +182,103 @@ void AbstractExecutor::setDMLCountOutputTable(TempTableLimits* limits) {
     m_abstractNode->setOutputTable(m_tmpOutputTable);
 }
 
+void AbstractExecutor::p_pre_pull(const NValueArray& params, ProgressMonitorProxy* pmp) {
+    throwFatalException("Executor for plan node type %s can not be pulled from",
+                        planNodeToString(m_abstractNode->getPlanNodeType()).c_str());
+}
+
+bool AbstractExecutor::p_next_pull(TableTuple& tuple) {
+    throwFatalException("Executor for plan node type %s can not be pulled from",
+                        planNodeToString(m_abstractNode->getPlanNodeType()).c_str());
+}
+
+void AbstractExecutor::p_post_pull() {
+    throwFatalException("Executor for plan node type %s can not be pulled from",
+                        planNodeToString(m_abstractNode->getPlanNodeType()).c_str());
+}
+
+void AbstractExecutor::openPullInput(Table* inputTable, const NValueArray& params, ProgressMonitorProxy* pmp,
+                                     ZoneMapFilter* zoneMapFilter) {
+    m_pullProgress = pmp;
+    if (m_pullSource != NULL) {
+        m_pullSource->p_pre_pull(params, pmp);
+        return;
+    }
+    assert(inputTable);
+    m_pullInputIterator.reset(new TableIterator(inputTable->iteratorDeletingAsWeGo()));
+    if (zoneMapFilter != NULL) {
+        m_pullInputIterator->setZoneMapFilter(zoneMapFilter);
+    }
+}
+
+bool AbstractExecutor::nextPullInput(TableTuple& tuple) {
+    if (m_pullSource != NULL) {
+        return m_pullSource->p_next_pull(tuple);
+    }
+    // Only the bottom of a chain reads a table, so each input tuple
+    // is counted toward progress exactly once.
+    assert(m_pullInputIterator);
+    if ( ! m_pullInputIterator->next(tuple)) {
+        return false;
+    }
+    m_pullProgress->countdownProgress();
+    return true;
+}
+
+void AbstractExecutor::closePullInput(Table* inputTable) {
+    m_pullProgress = NULL;
+    if (m_pullSource != NULL) {
+        m_pullSource->p_post_pull();
+        return;
+    }
+    m_pullInputIterator.reset();
+    // A limit may have stopped the chain early; drop whatever was not read.
+    cleanupInputTempTable(inputTable);
+}
+
+bool AbstractExecutor::executePulled(const NValueArray& params) {
+    VOLT_TRACE("Pulling from the pipeline topped by plannode(id=%d)...", m_abstractNode->getPlanNodeId());
+    assert(m_tmpOutputTable);
+    ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
+    p_pre_pull(params, &pmp);
+    TableTuple tuple;
+    while (p_next_pull(tuple)) {
+        m_tmpOutputTable->insertTempTuple(tuple);
+    }
+    p_post_pull();
+    return true;
+}
+
+void AbstractExecutor::setProfiling(int64_t fragmentId, bool enable) {
+    if ( ! enable) {
+        m_stats.reset();
+    }
+    else if ( ! m_stats) {
+        m_stats.reset(new ExecutorStats(fragmentId, m_abstractNode));
+    }
+}
+
+bool AbstractExecutor::executeProfiled(const NValueArray& params) {
+    int64_t tuplesIn = 0;
+    for (int ii = 0; ii < m_abstractNode->getInputTableCount(); ++ii) {
+        tuplesIn += m_abstractNode->getInputTable(ii)->activeTupleCount();
+    }
+
+    boost::posix_time::ptime startTime(boost::posix_time::microsec_clock::universal_time());
+    bool result = executeWithoutProfiling(params);
+    boost::posix_time::ptime endTime(boost::posix_time::microsec_clock::universal_time());
+
+    int64_t tuplesOut = 0;
+    int64_t tempTableBytes = 0;
+    if (m_tmpOutputTable != NULL) {
+        tuplesOut = m_tmpOutputTable->activeTupleCount();
+        tempTableBytes = m_tmpOutputTable->allocatedTupleMemory() + m_tmpOutputTable->nonInlinedMemorySize();
+    }
+    m_stats->recordExecution((endTime - startTime).total_microseconds(),
+                             tuplesIn, tuplesOut, tempTableBytes);
+    return result;
+}
+
 AbstractExecutor::~AbstractExecutor() {}
 
 AbstractExecutor::TupleComparer::TupleComparer(const std::vector<AbstractExpression*>& keys,
@@ -50,8 +50,12 @@
 #include "common/tabletuple.h"
 #include "common/types.h"
 #include "execution/VoltDBEngine.h"
+#include "executors/ExecutorStats.h"
 #include "plannodes/abstractplannode.h"
 #include "storage/temptable.h"
+#include "storage/tableiterator.h"
+
+#include "boost/scoped_ptr.hpp"
 
 #include <cassert>
 #include <vector>
@@ -59,6 +63,7 @@
 namespace voltdb {
 
 class AbstractExpression;
+class ProgressMonitorProxy;
 class TempTableLimits;
 class VoltDBEngine;
 
@@ -106,6 +111,50 @@ class AbstractExecutor {
         // LEAVE as blank on purpose
     }
 
+    /**
+     * Start or stop collecting ExecutorStats for each run of this executor.
+     * While off, execute() costs one extra NULL check.
+     */
+    void setProfiling(int64_t fragmentId, bool enable);
+
+    /** This executor's profile, or NULL when profiling is off */
+    ExecutorStats* getExecutorStats() const { return m_stats.get(); }
+
+    /*
+     * Pull-based execution, used by pipelined executor vectors (see
+     * ExecutorVector::init).  A chain such as scan -> projection -> limit
+     * is run by its top executor alone: each executor in the chain asks its
+     * child for one tuple at a time instead of reading the child's
+     * materialized output table, so only the top of the chain fills a
+     * temp table.
+     */
+
+    /** True if this executor can produce its output one tuple at a time */
+    virtual bool supportsPull() const { return false; }
+
+    /** True if this executor can consume its only input one tuple at a time */
+    virtual bool canPullInput() const { return false; }
+
+    /** Make this executor pull its input from its child's executor */
+    void setPullSource(AbstractExecutor* source) { m_pullSource = source; }
+
+    AbstractExecutor* getPullSource() const { return m_pullSource; }
+
+    /**
+     * Prepare to produce output tuples through p_next_pull.  The progress
+     * monitor belongs to the executor at the top of the chain.
+     */
+    virtual void p_pre_pull(const NValueArray& params, ProgressMonitorProxy* pmp);
+
+    /**
+     * Point tuple at the next output tuple, which stays valid until the next
+     * call.  Returns false when there are no more tuples.
+     */
+    virtual bool p_next_pull(TableTuple& tuple);
+
+    /** Release whatever p_pre_pull acquired */
+    virtual void p_post_pull();
+
     inline bool outputTempTableIsEmpty() const {
         if (m_tmpOutputTable != NULL) {
             return m_tmpOutputTable->activeTupleCount() == 0;
@@ -133,6 +182,8 @@ class AbstractExecutor {
         m_abstractNode = abstractNode;
         m_tmpOutputTable = NULL;
         m_engine = engine;
+        m_pullSource = NULL;
+        m_pullProgress = NULL;
     }
 
     /** Concrete executor classes implement initialization in p_init() */
@@ -154,6 +205,23 @@ class AbstractExecutor {
      */
     void setDMLCountOutputTable(TempTableLimits* limits);
 
+    /**
+     * Helpers for executors that support pulling: read the input either from
+     * the pull source or by iterating inputTable, which is cleaned up on close.
+     * A zone map filter, if given, lets the iteration of inputTable skip blocks.
+     */
+    void openPullInput(Table* inputTable, const NValueArray& params, ProgressMonitorProxy* pmp,
+                       ZoneMapFilter* zoneMapFilter = NULL);
+    bool nextPullInput(TableTuple& tuple);
+    void closePullInput(Table* inputTable);
+
+    /** Executors that look up search keys in an index count each lookup here */
+    void countIndexProbe() {
+        if (m_stats) {
+            m_stats->countIndexProbe();
+        }
+    }
+
     // execution engine owns the plannode allocation.
     AbstractPlanNode* m_abstractNode;
     TempTable* m_tmpOutputTable;
@@ -161,6 +229,24 @@ class AbstractExecutor {
     /** reference to the engine to call up to the top end */
     VoltDBEngine* m_engine;
 
+  private:
+    /** Run the pipelined chain topped by this executor into its temp output table */
+    bool executePulled(const NValueArray& params);
+
+    bool executeWithoutProfiling(const NValueArray& params) {
+        if (m_pullSource != NULL) {
+            return executePulled(params);
+        }
+        return p_execute(params);
+    }
+
+    /** Run the executor, adding its time and tuple counts to m_stats */
+    bool executeProfiled(const NValueArray& params);
+
+    AbstractExecutor* m_pullSource;
+    boost::scoped_ptr<TableIterator> m_pullInputIterator;
+    ProgressMonitorProxy* m_pullProgress;
+    boost::scoped_ptr<ExecutorStats> m_stats;
 };
 
 
@@ -170,7 +256,10 @@ inline bool AbstractExecutor::execute(const NValueArray& params)
     VOLT_TRACE("Starting execution of plannode(id=%d)...",  m_abstractNode->getPlanNodeId());
 
     // run the executor
-    return p_execute(params);
+    if (m_stats) {
+        return executeProfiled(params);
+    }
+    return executeWithoutProfiling(params);
 }
 
 }
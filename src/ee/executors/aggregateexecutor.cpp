@@ -48,15 +48,17 @@
 #include "common/ValueFactory.hpp"
 #include "common/common.h"
 #include "common/debuglog.h"
+#include "common/executorcontext.hpp"
 #include "common/SerializableEEException.h"
 #include "expressions/abstractexpression.h"
 #include "plannodes/aggregatenode.h"
 #include "plannodes/limitnode.h"
 #include "storage/temptable.h"
 #include "storage/tableiterator.h"
+#include "storage/TempTableLimits.h"
 
 #include "boost/foreach.hpp"
-#include "boost/unordered_map.hpp"
+#include "boost/functional/hash.hpp"
 #include "hyperloglog/hyperloglog.hpp" // for APPROX_COUNT_DISTINCT
 
 #include <algorithm>
@@ -71,9 +73,9 @@ namespace voltdb {
 /*
  * Type of the hash set used to check for column aggregate distinctness
  */
-typedef boost::unordered_set<NValue,
-                             NValue::hash,
-                             NValue::equal_to> AggregateNValueSetType;
+typedef FlatHashSet<NValue,
+                    NValue::hash,
+                    NValue::equal_to> AggregateNValueSetType;
 
 /**
  * Mix-in class to tweak some Aggs' behavior when the DISTINCT flag was specified,
@@ -83,7 +85,8 @@ typedef boost::unordered_set<NValue,
 struct Distinct : public AggregateNValueSetType {
 
     explicit Distinct(Pool* memoryPool)
-        : m_memoryPool(memoryPool)
+        : AggregateNValueSetType(memoryPool)
+        , m_memoryPool(memoryPool)
     {
     }
 
@@ -92,8 +95,7 @@ struct Distinct : public AggregateNValueSetType {
         // find this value in the set.  If it doesn't exist, add
         // it, otherwise indicate it shouldn't be included in the
         // aggregate
-        iterator setval = find(val);
-        if (setval == end())
+        if ( ! contains(val))
         {
             if (val.getSourceInlined()) {
                 // We only come here in the case of inlined VARCHAR or
@@ -139,11 +141,8 @@ template<class D>
 class SumAgg : public Agg
 {
 public:
-    // We're providing a NULL pool argument here to ifDistinct because
-    // SUM only operates on numeric values which don't have the same
-    // issues as inlined strings.
-    SumAgg()
-        : ifDistinct(NULL)
+    SumAgg(Pool* memoryPool)
+        : ifDistinct(memoryPool)
     {
     }
 
@@ -177,11 +176,8 @@ template<class D>
 class AvgAgg : public Agg
 {
 public:
-    // We're providing a NULL pool argument here to ifDistinct because
-    // AVG only operates on numeric values which don't have the same
-    // issues as inlined strings.
-    AvgAgg()
-        : ifDistinct(NULL)
+    AvgAgg(Pool* memoryPool)
+        : ifDistinct(memoryPool)
         , m_count(0)
     {
     }
@@ -525,14 +521,14 @@ inline Agg* getAggInstance(Pool& memoryPool, ExpressionType agg_type, bool isDis
         return new (memoryPool) CountAgg<NotDistinct>(&memoryPool);
     case EXPRESSION_TYPE_AGGREGATE_SUM:
         if (isDistinct) {
-            return new (memoryPool) SumAgg<Distinct>();
+            return new (memoryPool) SumAgg<Distinct>(&memoryPool);
         }
-        return new (memoryPool) SumAgg<NotDistinct>();
+        return new (memoryPool) SumAgg<NotDistinct>(&memoryPool);
     case EXPRESSION_TYPE_AGGREGATE_AVG:
         if (isDistinct) {
-            return new (memoryPool) AvgAgg<Distinct>();
+            return new (memoryPool) AvgAgg<Distinct>(&memoryPool);
         }
-        return new (memoryPool) AvgAgg<NotDistinct>();
+        return new (memoryPool) AvgAgg<NotDistinct>(&memoryPool);
     case EXPRESSION_TYPE_AGGREGATE_APPROX_COUNT_DISTINCT:
         return new (memoryPool) ApproxCountDistinctAgg();
     case EXPRESSION_TYPE_AGGREGATE_VALS_TO_HYPERLOGLOG:
@@ -683,7 +679,12 @@ inline bool AggregateExecutorBase::insertOutputTuple(AggregateRow* aggregateRow)
 
     bool needInsert = m_postfilter.eval(&tempTuple, NULL);
     if (needInsert) {
-        m_tmpOutputTable->insertTempTuple(tempTuple);
+        if (m_deepCopyOutput) {
+            m_tmpOutputTable->insertTempTupleDeepCopy(tempTuple, ExecutorContext::getTempStringPool());
+        }
+        else {
+            m_tmpOutputTable->insertTempTuple(tempTuple);
+        }
     }
 
     VOLT_TRACE("output_table:\n%s", m_tmpOutputTable->debug().c_str());
@@ -745,6 +746,7 @@ TableTuple AggregateExecutorBase::p_execute_init(const NValueArray& params,
         m_tmpOutputTable = newTempTable;
     }
     m_memoryPool.purge();
+    m_deepCopyOutput = false;
     initCountingPredicate(params, parentPostfilter);
     m_pmp = pmp;
 
@@ -772,8 +774,28 @@ void AggregateExecutorBase::p_execute_finish()
     m_memoryPool.purge();
 }
 
+// Number of partitions that spilled hash aggregation input is split into at each level
+static const int SPILL_PARTITION_COUNT = 16;
+// Past this many levels of spilling, a partition is aggregated in memory regardless of the limit
+static const int MAX_SPILL_LEVEL = 4;
+// Serialized tuples are buffered up to about this size per partition before being written
+static const size_t SPILL_PARTITION_WRITE_SIZE = 64 * 1024;
+// Measuring memory use walks the pool's chunks, so it is only done every so many new groups
+static const size_t SPILL_CHECK_INTERVAL = 256;
+
+AggregateHashExecutor::SpillPartition::SpillPartition(const TupleSchema* schema, int level)
+    : m_file(schema, SPILL_PARTITION_WRITE_SIZE)
+    , m_level(level)
+{ }
+
 AggregateHashExecutor::~AggregateHashExecutor() {}
 
+bool AggregateHashExecutor::p_init(AbstractPlanNode* abstract_node, TempTableLimits* limits)
+{
+    m_limits = limits;
+    return AggregateExecutorBase::p_init(abstract_node, limits);
+}
+
 TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
                                                  ProgressMonitorProxy* pmp,
                                                  const TupleSchema * schema,
@@ -781,7 +803,11 @@ TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
                                                  CountingPostfilter* parentPostfilter)
 {
     VOLT_TRACE("hash aggregate executor init..");
-    m_hash.clear();
+    m_hash.reset();
+    m_spillLevel = 0;
+    m_spilling = false;
+    m_spillPartitions.clear();
+    m_pendingPartitions.clear();
 
     return AggregateExecutorBase::p_execute_init(params, pmp, schema, newTempTable, parentPostfilter);
 }
@@ -819,8 +845,13 @@ void AggregateHashExecutor::p_execute_tuple(const TableTuple& nextTuple) {
     // Search for the matching group.
     HashAggregateMapType::const_iterator keyIter = m_hash.find(nextGroupByKeyTuple);
 
-    // Group not found. Make a new entry in the hash for this new group.
+    // Group not found. Make a new entry in the hash for this new group,
+    // unless it no longer fits in memory.
     if (keyIter == m_hash.end()) {
+        if (m_spilling || shouldSpill()) {
+            spillTuple(nextTuple, nextGroupByKeyTuple);
+            return;
+        }
         VOLT_TRACE("hash aggregate: new group..");
         aggregateRow = new (m_memoryPool, m_aggTypes.size()) AggregateRow();
         m_hash.insert(HashAggregateMapType::value_type(nextGroupByKeyTuple, aggregateRow));
@@ -849,7 +880,30 @@ void AggregateHashExecutor::p_execute_tuple(const TableTuple& nextTuple) {
 
 void AggregateHashExecutor::p_execute_finish() {
     VOLT_TRACE("finalizing..");
+    outputGroups();
+
+    // Aggregate whatever was spilled, one partition at a time.  A partition
+    // that spills again pushes its own partitions, which are done next.
+    queueSpillPartitions();
+    while ( ! m_pendingPartitions.empty() && m_postfilter.isUnderLimit()) {
+        boost::ptr_vector<SpillPartition>::auto_type partition = m_pendingPartitions.pop_back();
+        if (partition->m_file.tupleCount() == 0) {
+            continue;
+        }
+        m_spillLevel = partition->m_level;
+        aggregatePartition(partition->m_file);
+        queueSpillPartitions();
+    }
 
+    // Clean up
+    m_pendingPartitions.clear();
+    m_spillStringPool.reset();
+    m_spillLevel = 0;
+    m_spilling = false;
+    AggregateExecutorBase::p_execute_finish();
+}
+
+void AggregateHashExecutor::outputGroups() {
     // If there is no aggregation, results are already inserted already
     if (m_aggTypes.size() != 0) {
         for (HashAggregateMapType::const_iterator iter = m_hash.begin(); iter != m_hash.end(); iter++) {
@@ -860,10 +914,67 @@ void AggregateHashExecutor::p_execute_finish() {
             delete aggregateRow;
         }
     }
+    // The pool is purged before any more groups are started.
+    m_hash.reset();
+}
 
-    // Clean up
-    m_hash.clear();
-    AggregateExecutorBase::p_execute_finish();
+bool AggregateHashExecutor::shouldSpill() {
+    if (m_limits == NULL || m_limits->getMemoryLimit() <= 0 || m_spillLevel >= MAX_SPILL_LEVEL) {
+        return false;
+    }
+    // Spilling only helps by keeping groups out of memory, so some have to be there first.
+    if (m_hash.size() == 0 || m_hash.size() % SPILL_CHECK_INTERVAL != 0) {
+        return false;
+    }
+    int64_t used = m_limits->getAllocated() + m_memoryPool.getAllocatedMemory();
+    if (m_spillStringPool) {
+        used += m_spillStringPool->getAllocatedMemory();
+    }
+    if (used <= m_limits->getMemoryLimit()) {
+        return false;
+    }
+    VOLT_DEBUG("Hash aggregation spilling at level %d after %d groups", m_spillLevel, (int)m_hash.size());
+    m_spilling = true;
+    // The spilled partitions are aggregated after purging the groups
+    // output so far, and read their strings into pools that are purged
+    // in turn, so every row output from here on takes its own copy.
+    m_deepCopyOutput = true;
+    for (int ii = 0; ii < SPILL_PARTITION_COUNT; ii++) {
+        m_spillPartitions.push_back(new SpillPartition(m_inputSchema, m_spillLevel + 1));
+    }
+    return true;
+}
+
+void AggregateHashExecutor::spillTuple(const TableTuple& nextTuple, const TableTuple& groupByKeyTuple) {
+    // Mix in the level so that a partition that spills again is split differently.
+    std::size_t hash = TableTupleHasher()(groupByKeyTuple);
+    boost::hash_combine(hash, m_spillLevel);
+    m_spillPartitions[hash % SPILL_PARTITION_COUNT].m_file.append(nextTuple);
+}
+
+void AggregateHashExecutor::queueSpillPartitions() {
+    for (int ii = 0; ii < m_spillPartitions.size(); ii++) {
+        m_spillPartitions[ii].m_file.flush();
+    }
+    m_pendingPartitions.transfer(m_pendingPartitions.end(), m_spillPartitions);
+}
+
+void AggregateHashExecutor::aggregatePartition(const TupleSpillFile& partition) {
+    // The groups of the previous input or partition have all been output.
+    m_memoryPool.purge();
+    TableTuple& nextGroupByKeyTuple = m_nextGroupByKeyStorage;
+    nextGroupByKeyTuple.move(NULL);
+    m_spilling = false;
+    if ( ! m_spillStringPool) {
+        m_spillStringPool.reset(new Pool());
+    }
+    m_spillStringPool->purge();
+
+    TupleSpillFile::Reader reader(partition, 0, partition.size());
+    while (reader.next(m_spillStringPool.get())) {
+        AggregateHashExecutor::p_execute_tuple(reader.tuple());
+    }
+    outputGroups();
 }
 
 AggregateSerialExecutor::~AggregateSerialExecutor() {}
@@ -997,7 +1108,7 @@ TableTuple AggregatePartialExecutor::p_execute_init(const NValueArray& params,
     TableTuple& nextPartialGroupByKeyTuple = m_nextGroupByKeyStorage;
     nextPartialGroupByKeyTuple.move(NULL);
 
-    m_hash.clear();
+    m_hash.reset();
 
     // for next input tuple
     return nextInputTuple;
@@ -1109,7 +1220,7 @@ void AggregatePartialExecutor::p_execute_finish()
     }
 
     // Clean up
-    m_hash.clear();
+    m_hash.reset();
     TableTuple& nextGroupByKeyTuple = m_nextPartialGroupByKeyStorage;
     nextGroupByKeyTuple.move(NULL);
 
@@ -55,6 +55,11 @@
 #include "expressions/abstractexpression.h"
 #include "execution/ProgressMonitorProxy.h"
 #include "executors/executorutil.h"
+#include "executors/tuplespillfile.h"
+#include "structures/FlatHashMap.h"
+
+#include "boost/ptr_container/ptr_vector.hpp"
+#include "boost/scoped_ptr.hpp"
 
 namespace voltdb {
 
@@ -120,12 +125,9 @@ struct AggregateRow
         for (int ii = 0; m_aggregates[ii] != NULL; ++ii) {
             // All the aggs inherit no-op delete operators, so, "delete" is really just destructor invocation.
             // The destructor being invoked is the implicit specialization of Agg's destructor.
-            // The compiler generates it to invoke the destructor (if any) of the distinct value set (if any).
-            // It must be called because the pooled Agg object only embeds the (boost) set's "head".
-            // The "body" is allocated by boost via its defaulted stl allocator as the set grows
-            // -- AND it is not completely deallocated when "clear" is called.
-            // This AggregateRow destructor would not be required at all if distinct was based on a home-grown
-            // pool-aware hash, incapable of leaking outside the pool.
+            // The distinct value sets live entirely in the pool, but the approximate count distinct
+            // aggs embed a hyperloglog whose registers are allocated outside of it,
+            // so the destructors must still be called.
             delete m_aggregates[ii];
         }
     }
@@ -164,7 +166,8 @@ public:
         m_postPredicate(NULL),
         m_pmp(NULL),
         m_inputSchema(NULL),
-        m_groupByKeyPartialHashSchema(NULL)
+        m_groupByKeyPartialHashSchema(NULL),
+        m_deepCopyOutput(false)
     { }
     ~AggregateExecutorBase()
     {
@@ -254,25 +257,42 @@ protected:
     // used for inline limit for serial/partial aggregate
     CountingPostfilter m_postfilter;
 
+    // Set when the pools that hold the groups' strings are purged before
+    // the output table is read, so output rows need copies of their own
+    bool m_deepCopyOutput;
+
 private:
     TupleSchema* constructGroupBySchema(bool partial);
 };
 
-typedef boost::unordered_map<TableTuple,
-                             AggregateRow*,
-                             TableTupleHasher,
-                             TableTupleEqualityChecker> HashAggregateMapType;
+/*
+ * Groups in progress by group by key.  The map lives in the executor's memory pool,
+ * so it must be reset whenever the pool is purged.
+ */
+typedef FlatHashMap<TableTuple,
+                    AggregateRow*,
+                    TableTupleHasher,
+                    TableTupleEqualityChecker> HashAggregateMapType;
 
 
 /**
  * The concrete executor class for PLAN_NODE_TYPE_HASHAGGREGATE
  * in which the input does not need to be sorted and execution will hash the group by key to aggregate the tuples.
+ *
+ * When the groups in the hash would push the fragment past its TempTableLimits, no more groups are started in
+ * memory.  Input tuples for groups already in the hash keep being aggregated, and the rest are written to disk,
+ * split into partitions by the hash of their group by key.  Once the input is done and the groups in memory have
+ * been output, each partition is aggregated the same way, spilling again at the next level if it is still too big.
  */
 class AggregateHashExecutor : public AggregateExecutorBase
 {
 public:
     AggregateHashExecutor(VoltDBEngine* engine, AbstractPlanNode* abstract_node) :
-        AggregateExecutorBase(engine, abstract_node) { }
+        AggregateExecutorBase(engine, abstract_node),
+        m_hash(&m_memoryPool),
+        m_limits(NULL),
+        m_spillLevel(0),
+        m_spilling(false) { }
 
     // empty destructor defined in .cpp file because of it is called virtually (not inline)
     // same reason for serial and partial
@@ -284,9 +304,46 @@ public:
     void p_execute_tuple(const TableTuple& nextTuple);
     void p_execute_finish();
 
+protected:
+    virtual bool p_init(AbstractPlanNode*, TempTableLimits*);
+
 private:
     virtual bool p_execute(const NValueArray& params);
+
+    /** Insert the result of every group in the hash into the output table and empty the hash. */
+    void outputGroups();
+
+    /** Decide whether a new group would use too much memory and so its tuples should be spilled instead. */
+    bool shouldSpill();
+
+    /** Write the input tuple of a group that was not started in memory to its partition. */
+    void spillTuple(const TableTuple& nextTuple, const TableTuple& groupByKeyTuple);
+
+    /** Finish writing the partitions of the current level and queue them to be aggregated. */
+    void queueSpillPartitions();
+
+    /** Aggregate the tuples of one spilled partition. */
+    void aggregatePartition(const TupleSpillFile& partition);
+
+    // Input tuples of groups that did not fit in memory, with the spill level they were written at.
+    struct SpillPartition {
+        SpillPartition(const TupleSchema* schema, int level);
+        TupleSpillFile m_file;
+        const int m_level;
+    };
+
     HashAggregateMapType m_hash;
+    TempTableLimits* m_limits;
+    // 0 while aggregating the input, n while aggregating a partition spilled at level n
+    int m_spillLevel;
+    // Set once new groups stop being started in memory
+    bool m_spilling;
+    // Partitions being written at the current level
+    boost::ptr_vector<SpillPartition> m_spillPartitions;
+    // Partitions that are written and are waiting to be aggregated
+    boost::ptr_vector<SpillPartition> m_pendingPartitions;
+    // Non-inlined values of the tuples read back from a partition; only created if something is spilled
+    boost::scoped_ptr<Pool> m_spillStringPool;
 };
 
 /**
@@ -326,7 +383,7 @@ class AggregatePartialExecutor : public AggregateExecutorBase
 {
 public:
     AggregatePartialExecutor(VoltDBEngine* engine, AbstractPlanNode* abstract_node) :
-        AggregateExecutorBase(engine, abstract_node), m_atTheFirstRow(true) { }
+        AggregateExecutorBase(engine, abstract_node), m_atTheFirstRow(true), m_hash(&m_memoryPool) { }
     ~AggregatePartialExecutor();
 
     TableTuple p_execute_init(const NValueArray& params, ProgressMonitorProxy* pmp,
@@ -51,6 +51,7 @@
 #include "executors/abstractexecutor.h"
 #include "executors/aggregateexecutor.h"
 #include "executors/deleteexecutor.h"
+#include "executors/hashjoinexecutor.h"
 #include "executors/indexscanexecutor.h"
 #include "executors/indexcountexecutor.h"
 #include "executors/tablecountexecutor.h"
@@ -85,6 +86,7 @@ AbstractExecutor* getNewExecutor(VoltDBEngine *engine,
     case PLAN_NODE_TYPE_AGGREGATE: return new AggregateSerialExecutor(engine, abstract_node);
     case PLAN_NODE_TYPE_DELETE: return new DeleteExecutor(engine, abstract_node);
     case PLAN_NODE_TYPE_HASHAGGREGATE: return new AggregateHashExecutor(engine, abstract_node);
+    case PLAN_NODE_TYPE_HASHJOIN: return new HashJoinExecutor(engine, abstract_node);
     case PLAN_NODE_TYPE_PARTIALAGGREGATE: return new AggregatePartialExecutor(engine, abstract_node);
     case PLAN_NODE_TYPE_INDEXSCAN: return new IndexScanExecutor(engine, abstract_node);
     case PLAN_NODE_TYPE_INDEXCOUNT: return new IndexCountExecutor(engine, abstract_node);
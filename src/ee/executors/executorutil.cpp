@@ -69,4 +69,22 @@ CountingPostfilter::CountingPostfilter() :
     m_under_limit(false)
 {}
 
+TupleBatch::TupleBatch(const TupleSchema* schema) :
+    m_tuples(MAX_SIZE, TableTuple(schema)),
+    m_selection(),
+    m_size(0)
+{
+    m_selection.reserve(MAX_SIZE);
+}
+
+void TupleBatch::filter(const AbstractExpression* predicate) {
+    m_selection.resize(m_size);
+    for (int ii = 0; ii < m_size; ++ii) {
+        m_selection[ii] = ii;
+    }
+    if (predicate != NULL && m_size > 0) {
+        predicate->filterBatch(tuples(), m_selection);
+    }
+}
+
 }
@@ -52,6 +52,7 @@
 
 #include <cstddef> // for NULL !
 #include <cassert>
+#include <vector>
 
 namespace voltdb {
 
@@ -123,6 +124,61 @@ bool CountingPostfilter::eval(const TableTuple* outer_tuple, const TableTuple* i
     return false;
 }
 
+// Helper class to collect the tuples of a scan, so that a predicate or a projection
+// can be applied to all of them at once (see AbstractExpression::filterBatch).
+// The collected tuples must stay where they are until the batch is cleared.
+class TupleBatch {
+public:
+    static const int MAX_SIZE = 1024;
+
+    TupleBatch(const TupleSchema* schema);
+
+    bool isEmpty() const {
+        return m_size == 0;
+    }
+
+    bool isFull() const {
+        return m_size == MAX_SIZE;
+    }
+
+    // The place for the next tuple of the batch. Call append() once it is filled in.
+    TableTuple& nextTuple() {
+        assert( ! isFull());
+        return m_tuples[m_size];
+    }
+
+    void append() {
+        assert( ! isFull());
+        ++m_size;
+    }
+
+    void clear() {
+        m_size = 0;
+        m_selection.clear();
+    }
+
+    // Select the tuples of the batch for which predicate is true, or all of them if it is NULL.
+    void filter(const AbstractExpression* predicate);
+
+    const TableTuple* tuples() const {
+        return &m_tuples[0];
+    }
+
+    // Positions of the tuples selected by the last call to filter()
+    const std::vector<int>& selection() const {
+        return m_selection;
+    }
+
+    TableTuple& selectedTuple(size_t ii) {
+        return m_tuples[m_selection[ii]];
+    }
+
+private:
+    std::vector<TableTuple> m_tuples;
+    std::vector<int> m_selection;
+    int m_size;
+};
+
 }
 
 #endif
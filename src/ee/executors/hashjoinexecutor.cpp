@@ -0,0 +1,415 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "hashjoinexecutor.h"
+
+#include "common/debuglog.h"
+#include "common/common.h"
+#include "common/tabletuple.h"
+#include "common/FatalException.hpp"
+#include "executors/aggregateexecutor.h"
+#include "executors/executorutil.h"
+#include "execution/ProgressMonitorProxy.h"
+#include "expressions/abstractexpression.h"
+#include "storage/table.h"
+#include "storage/temptable.h"
+#include "storage/tableiterator.h"
+#include "storage/TempTableLimits.h"
+#include "plannodes/hashjoinnode.h"
+#include "plannodes/limitnode.h"
+
+#include <vector>
+
+using namespace std;
+using namespace voltdb;
+
+namespace voltdb {
+/*
+ * Releases the hash table (and its temp table memory reservation)
+ * however p_execute is exited, including on a thrown SQLException.
+ */
+struct HashTableCleanupGuard {
+    HashTableCleanupGuard(HashJoinExecutor *executor)
+        : m_executor(executor) {
+    }
+    ~HashTableCleanupGuard() {
+        m_executor->clearHashTable();
+    }
+
+    HashJoinExecutor *m_executor;
+};
+}
+
+/*
+ * boost::hash_combine of small integer values is close to the identity,
+ * so scramble the bits before masking off a bucket index.
+ */
+static inline size_t mixHash(size_t hash) {
+    uint64_t h = static_cast<uint64_t>(hash);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+static inline bool isIntegralKeyType(ValueType type) {
+    switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+ * Equal values of different integral types already hash alike,
+ * but mixing an integer key with a DECIMAL or FLOAT key needs both
+ * sides cast to the wider type before hashing.
+ */
+static ValueType commonKeyType(ValueType outerType, ValueType innerType) {
+    if (outerType == innerType) {
+        return VALUE_TYPE_INVALID;
+    }
+    bool outerNumeric = isIntegralKeyType(outerType) ||
+        outerType == VALUE_TYPE_DECIMAL || outerType == VALUE_TYPE_DOUBLE;
+    bool innerNumeric = isIntegralKeyType(innerType) ||
+        innerType == VALUE_TYPE_DECIMAL || innerType == VALUE_TYPE_DOUBLE;
+    if ( ! outerNumeric || ! innerNumeric) {
+        return VALUE_TYPE_INVALID;
+    }
+    if (outerType == VALUE_TYPE_DOUBLE || innerType == VALUE_TYPE_DOUBLE) {
+        return VALUE_TYPE_DOUBLE;
+    }
+    if (outerType == VALUE_TYPE_DECIMAL || innerType == VALUE_TYPE_DECIMAL) {
+        return VALUE_TYPE_DECIMAL;
+    }
+    return VALUE_TYPE_INVALID;
+}
+
+bool HashJoinExecutor::p_init(AbstractPlanNode* abstractNode,
+                              TempTableLimits* limits)
+{
+    VOLT_TRACE("init HashJoin Executor");
+    assert(limits);
+
+    HashJoinPlanNode* node = dynamic_cast<HashJoinPlanNode*>(m_abstractNode);
+    assert(node);
+
+    // Init parent first
+    if (!AbstractJoinExecutor::p_init(abstractNode, limits)) {
+        return false;
+    }
+
+    // NULL tuples for left and full joins
+    p_init_null_tuples(node->getInputTable(), node->getInputTable(1));
+
+    m_limits = limits;
+
+    const std::vector<AbstractExpression*>& outerKeys = node->getOuterHashExpressions();
+    const std::vector<AbstractExpression*>& innerKeys = node->getInnerHashExpressions();
+    assert(outerKeys.size() == innerKeys.size());
+    m_keyCastTypes.clear();
+    for (size_t ii = 0; ii < outerKeys.size(); ii++) {
+        m_keyCastTypes.push_back(commonKeyType(outerKeys[ii]->getValueType(),
+                                               innerKeys[ii]->getValueType()));
+    }
+    m_probeKeyValues.resize(outerKeys.size());
+
+    return true;
+}
+
+bool HashJoinExecutor::hashKeys(const std::vector<AbstractExpression*>& keys,
+                                const TableTuple& tuple,
+                                std::vector<NValue>* keyValues,
+                                size_t& hash) const
+{
+    size_t seed = 0;
+    for (size_t ii = 0; ii < keys.size(); ii++) {
+        // Each key list refers to the columns of its own input only,
+        // so the tuple is offered in both positions.
+        NValue value = keys[ii]->eval(&tuple, &tuple);
+        if (value.isNull()) {
+            return false;
+        }
+        if (m_keyCastTypes[ii] != VALUE_TYPE_INVALID) {
+            value = value.castAs(m_keyCastTypes[ii]);
+        }
+        value.hashCombine(seed);
+        if (keyValues) {
+            (*keyValues)[ii] = value;
+        }
+    }
+    hash = mixHash(seed);
+    return true;
+}
+
+bool HashJoinExecutor::keysMatch(const TableTuple& buildTuple,
+                                 const std::vector<AbstractExpression*>& buildKeys) const
+{
+    for (size_t ii = 0; ii < buildKeys.size(); ii++) {
+        NValue value = buildKeys[ii]->eval(&buildTuple, &buildTuple);
+        if (m_keyCastTypes[ii] != VALUE_TYPE_INVALID) {
+            value = value.castAs(m_keyCastTypes[ii]);
+        }
+        if (value.compare(m_probeKeyValues[ii]) != VALUE_COMPARE_EQUAL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HashJoinExecutor::buildHashTable(Table* buildTable,
+                                      const std::vector<AbstractExpression*>& buildKeys,
+                                      AbstractExpression* buildFilter,
+                                      ProgressMonitorProxy& pmp)
+{
+    int64_t tupleCount = buildTable->activeTupleCount();
+    if (tupleCount == 0) {
+        return;
+    }
+
+    size_t bucketCount = nexthigher(static_cast<size_t>(tupleCount));
+    int64_t bytes = bucketCount * sizeof(HashJoinEntry*) + tupleCount * sizeof(HashJoinEntry);
+    // Account for the table before allocating it, so that an oversized
+    // build input fails the same way an oversized temp table does.
+    m_reservedBytes = bytes;
+    if (m_limits) {
+        m_limits->increaseAllocated(bytes);
+    }
+
+    m_buckets = reinterpret_cast<HashJoinEntry**>(
+            m_memoryPool.allocateZeroes(bucketCount * sizeof(HashJoinEntry*)));
+    m_bucketMask = bucketCount - 1;
+    m_entries = reinterpret_cast<HashJoinEntry*>(
+            m_memoryPool.allocate(tupleCount * sizeof(HashJoinEntry)));
+
+    TableTuple buildTuple(buildTable->schema());
+    TableIterator iterator = buildTable->iterator();
+    while (iterator.next(buildTuple)) {
+        pmp.countdownProgress();
+        assert(m_entryCount < tupleCount);
+        HashJoinEntry* entry = &m_entries[m_entryCount++];
+        entry->m_next = NULL;
+        entry->m_hash = 0;
+        entry->m_tupleAddress = buildTuple.address();
+        entry->m_matched = false;
+        // Tuples that fail the filter or have a NULL key can never match,
+        // but keep their entries so that outer joins can still null-pad them.
+        if (buildFilter != NULL && ! buildFilter->eval(&buildTuple, NULL).isTrue()) {
+            continue;
+        }
+        size_t hash;
+        if ( ! hashKeys(buildKeys, buildTuple, NULL, hash)) {
+            continue;
+        }
+        entry->m_hash = hash;
+        HashJoinEntry** bucket = &m_buckets[hash & m_bucketMask];
+        entry->m_next = *bucket;
+        *bucket = entry;
+    }
+}
+
+void HashJoinExecutor::clearHashTable()
+{
+    if (m_limits && m_reservedBytes > 0) {
+        m_limits->reduceAllocated(m_reservedBytes);
+    }
+    m_reservedBytes = 0;
+    m_buckets = NULL;
+    m_bucketMask = 0;
+    m_entries = NULL;
+    m_entryCount = 0;
+    m_memoryPool.purge();
+}
+
+bool HashJoinExecutor::p_execute(const NValueArray &params) {
+    VOLT_DEBUG("executing HashJoin...");
+
+    HashJoinPlanNode* node = dynamic_cast<HashJoinPlanNode*>(m_abstractNode);
+    assert(node);
+    assert(node->getInputTableCount() == 2);
+
+    // output table must be a temp table
+    assert(m_tmpOutputTable);
+
+    Table* outer_table = node->getInputTable();
+    assert(outer_table);
+
+    Table* inner_table = node->getInputTable(1);
+    assert(inner_table);
+
+    VOLT_TRACE ("input table left:\n %s", outer_table->debug().c_str());
+    VOLT_TRACE ("input table right:\n %s", inner_table->debug().c_str());
+
+    AbstractExpression *preJoinPredicate = node->getPreJoinPredicate();
+    AbstractExpression *joinPredicate = node->getJoinPredicate();
+    AbstractExpression *wherePredicate = node->getWherePredicate();
+
+    LimitPlanNode* limit_node = dynamic_cast<LimitPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_LIMIT));
+    int limit = CountingPostfilter::NO_LIMIT;
+    int offset = CountingPostfilter::NO_OFFSET;
+    if (limit_node) {
+        limit_node->getLimitAndOffsetByReference(params, limit, offset);
+    }
+
+    // Build on the smaller input.  Ties go to the inner table,
+    // which keeps the common (inner/left, similar size) case streaming
+    // the outer table exactly like a nest loop join would.
+    const bool buildOuter = outer_table->activeTupleCount() < inner_table->activeTupleCount();
+    Table* build_table = buildOuter ? outer_table : inner_table;
+    Table* probe_table = buildOuter ? inner_table : outer_table;
+    const std::vector<AbstractExpression*>& outerKeys = node->getOuterHashExpressions();
+    const std::vector<AbstractExpression*>& innerKeys = node->getInnerHashExpressions();
+    const std::vector<AbstractExpression*>& buildKeys = buildOuter ? outerKeys : innerKeys;
+    const std::vector<AbstractExpression*>& probeKeys = buildOuter ? innerKeys : outerKeys;
+    VOLT_TRACE("Building hash table on the %s input", buildOuter ? "outer" : "inner");
+
+    int outer_cols = outer_table->columnCount();
+    int inner_cols = inner_table->columnCount();
+    TableTuple outer_tuple(outer_table->schema());
+    TableTuple inner_tuple(inner_table->schema());
+    TableTuple& build_tuple = buildOuter ? outer_tuple : inner_tuple;
+    TableTuple& probe_tuple = buildOuter ? inner_tuple : outer_tuple;
+
+    ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
+    // Init the postfilter
+    CountingPostfilter postfilter(m_tmpOutputTable, wherePredicate, limit, offset);
+
+    TableTuple join_tuple;
+    if (m_aggExec != NULL) {
+        VOLT_TRACE("Init inline aggregate...");
+        const TupleSchema * aggInputSchema = node->getTupleSchemaPreAgg();
+        join_tuple = m_aggExec->p_execute_init(params, &pmp, aggInputSchema, m_tmpOutputTable, &postfilter);
+    } else {
+        join_tuple = m_tmpOutputTable->tempTuple();
+    }
+
+    HashTableCleanupGuard cleanupGuard(this);
+    // The pre-join predicate only references outer columns, so when the
+    // outer table is the build side it is applied once per tuple up front.
+    buildHashTable(build_table, buildKeys, buildOuter ? preJoinPredicate : NULL, pmp);
+
+    //
+    // Probe phase: stream the other input through the hash table.
+    //
+    TableIterator probeIterator = probe_table->iteratorDeletingAsWeGo();
+    while (postfilter.isUnderLimit() && probeIterator.next(probe_tuple)) {
+        pmp.countdownProgress();
+
+        if ( ! buildOuter) {
+            join_tuple.setNValues(0, outer_tuple, 0, outer_cols);
+        }
+
+        bool probeMatch = false;
+        size_t hash;
+        if (m_entryCount > 0 &&
+            (buildOuter || preJoinPredicate == NULL || preJoinPredicate->eval(&outer_tuple, NULL).isTrue()) &&
+            hashKeys(probeKeys, probe_tuple, &m_probeKeyValues, hash)) {
+            for (HashJoinEntry* entry = m_buckets[hash & m_bucketMask];
+                 entry != NULL && postfilter.isUnderLimit();
+                 entry = entry->m_next) {
+                if (entry->m_hash != hash) {
+                    continue;
+                }
+                build_tuple.move(entry->m_tupleAddress);
+                if ( ! keysMatch(build_tuple, buildKeys)) {
+                    continue;
+                }
+                if (joinPredicate != NULL && ! joinPredicate->eval(&outer_tuple, &inner_tuple).isTrue()) {
+                    continue;
+                }
+                probeMatch = true;
+                entry->m_matched = true;
+                // Filter the joined tuple
+                if (postfilter.eval(&outer_tuple, &inner_tuple)) {
+                    if (buildOuter) {
+                        join_tuple.setNValues(0, outer_tuple, 0, outer_cols);
+                    }
+                    join_tuple.setNValues(outer_cols, inner_tuple, 0, inner_cols);
+                    outputTuple(postfilter, join_tuple, pmp);
+                }
+            }
+        }
+
+        //
+        // Null-pad an unmatched probe tuple: an outer tuple for LEFT and FULL joins,
+        // an inner tuple only for FULL joins.
+        //
+        if (probeMatch || ! postfilter.isUnderLimit()) {
+            continue;
+        }
+        if ( ! buildOuter && m_joinType != JOIN_TYPE_INNER) {
+            const TableTuple& null_inner_tuple = m_null_inner_tuple.tuple();
+            if (postfilter.eval(&outer_tuple, &null_inner_tuple)) {
+                join_tuple.setNValues(outer_cols, null_inner_tuple, 0, inner_cols);
+                outputTuple(postfilter, join_tuple, pmp);
+            }
+        } else if (buildOuter && m_joinType == JOIN_TYPE_FULL) {
+            const TableTuple& null_outer_tuple = m_null_outer_tuple.tuple();
+            if (postfilter.eval(&null_outer_tuple, &inner_tuple)) {
+                join_tuple.setNValues(0, null_outer_tuple, 0, outer_cols);
+                join_tuple.setNValues(outer_cols, inner_tuple, 0, inner_cols);
+                outputTuple(postfilter, join_tuple, pmp);
+            }
+        }
+    }
+
+    //
+    // Null-pad the build tuples that never matched: outer tuples for LEFT
+    // and FULL joins, inner tuples only for FULL joins.
+    //
+    bool padBuildSide = buildOuter ? (m_joinType != JOIN_TYPE_INNER) : (m_joinType == JOIN_TYPE_FULL);
+    if (padBuildSide) {
+        const TableTuple& null_tuple = buildOuter ? m_null_inner_tuple.tuple() : m_null_outer_tuple.tuple();
+        if ( ! buildOuter) {
+            join_tuple.setNValues(0, null_tuple, 0, outer_cols);
+        }
+        for (size_t ii = 0; ii < m_entryCount && postfilter.isUnderLimit(); ii++) {
+            HashJoinEntry& entry = m_entries[ii];
+            if (entry.m_matched) {
+                continue;
+            }
+            pmp.countdownProgress();
+            build_tuple.move(entry.m_tupleAddress);
+            assert(build_tuple.isActive());
+            if (buildOuter) {
+                if (postfilter.eval(&outer_tuple, &null_tuple)) {
+                    join_tuple.setNValues(0, outer_tuple, 0, outer_cols);
+                    join_tuple.setNValues(outer_cols, null_tuple, 0, inner_cols);
+                    outputTuple(postfilter, join_tuple, pmp);
+                }
+            } else if (postfilter.eval(&null_tuple, &inner_tuple)) {
+                join_tuple.setNValues(outer_cols, inner_tuple, 0, inner_cols);
+                outputTuple(postfilter, join_tuple, pmp);
+            }
+        }
+    }
+
+    if (m_aggExec != NULL) {
+        m_aggExec->p_execute_finish();
+    }
+
+    cleanupInputTempTable(inner_table);
+    cleanupInputTempTable(outer_table);
+
+    return (true);
+}
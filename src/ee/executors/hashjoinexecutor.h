@@ -0,0 +1,114 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSTOREHASHJOINEXECUTOR_H
+#define HSTOREHASHJOINEXECUTOR_H
+
+#include "common/common.h"
+#include "common/Pool.hpp"
+#include "common/valuevector.h"
+#include "executors/abstractjoinexecutor.h"
+
+#include <vector>
+
+namespace voltdb {
+
+class AbstractExpression;
+
+/**
+ * An entry in the hash join table: one tuple of the build input.
+ * Entries live in one contiguous pool allocation so that the
+ * unmatched-tuple pass for outer joins is a linear walk.
+ */
+struct HashJoinEntry {
+    HashJoinEntry* m_next;
+    std::size_t m_hash;
+    char* m_tupleAddress;
+    bool m_matched;
+};
+
+/**
+ * Executor for PLAN_NODE_TYPE_HASHJOIN.
+ *
+ * The smaller of the two inputs is loaded into a chained hash table that
+ * is allocated wholesale from a Pool; the other input is then streamed
+ * through it.  Supports inner, left outer and full outer joins regardless
+ * of which side ends up being the build side.
+ */
+class HashJoinExecutor : public AbstractJoinExecutor {
+    public:
+        HashJoinExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node) :
+            AbstractJoinExecutor(engine, abstract_node),
+            m_limits(NULL),
+            m_reservedBytes(0),
+            m_buckets(NULL),
+            m_bucketMask(0),
+            m_entries(NULL),
+            m_entryCount(0)
+        { }
+
+    private:
+        friend struct HashTableCleanupGuard;
+
+        bool p_init(AbstractPlanNode*, TempTableLimits* limits);
+        bool p_execute(const NValueArray &params);
+
+        /**
+         * Compute the combined hash of one side's join keys for the given tuple,
+         * optionally saving the (cast) key values.
+         * Returns false if any key is NULL, since a NULL key can never satisfy
+         * an equi-join condition.
+         */
+        bool hashKeys(const std::vector<AbstractExpression*>& keys,
+                      const TableTuple& tuple,
+                      std::vector<NValue>* keyValues,
+                      std::size_t& hash) const;
+
+        void buildHashTable(Table* buildTable,
+                            const std::vector<AbstractExpression*>& buildKeys,
+                            AbstractExpression* buildFilter,
+                            ProgressMonitorProxy& pmp);
+
+        /** Evaluate the build side keys of an entry and compare them with the probe values */
+        bool keysMatch(const TableTuple& buildTuple,
+                       const std::vector<AbstractExpression*>& buildKeys) const;
+
+        /** Release the hash table.  Safe to call when nothing was built. */
+        void clearHashTable();
+
+        TempTableLimits* m_limits;
+        // Bytes of the current hash table charged against m_limits
+        int64_t m_reservedBytes;
+
+        // Per-key-column common type to cast both sides' key values to
+        // when the outer and inner key expressions differ in type.
+        std::vector<ValueType> m_keyCastTypes;
+
+        // Probe side key values of the current probe tuple
+        std::vector<NValue> m_probeKeyValues;
+
+        // Backing store for the bucket array and the entries
+        Pool m_memoryPool;
+        HashJoinEntry** m_buckets;
+        std::size_t m_bucketMask;
+        HashJoinEntry* m_entries;
+        std::size_t m_entryCount;
+};
+
+}
+
+#endif
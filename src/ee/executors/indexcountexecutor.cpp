@@ -321,6 +321,7 @@ bool IndexCountExecutor::p_execute(const NValueArray &params)
     int64_t rkStart = 0, rkEnd = 0, rkRes = 0;
     int leftIncluded = 0, rightIncluded = 0;
 
+    countIndexProbe();
     if (m_numOfSearchkeys != 0) {
         // Deal with multi-map
         VOLT_DEBUG("INDEX_LOOKUP_TYPE(%d) m_numSearchkeys(%d) key:%s",
@@ -68,6 +68,8 @@
 #include "storage/temptable.h"
 #include "storage/persistenttable.h"
 
+#include "boost/scoped_ptr.hpp"
+
 using namespace voltdb;
 using std::cout;
 using std::endl;
@@ -141,6 +143,28 @@ bool IndexScanExecutor::p_init(AbstractPlanNode *abstractNode,
     m_lookupType = m_node->getLookupType();
     m_sortDirection = m_node->getSortDirection();
 
+    const int prefixLength = m_node->getSkipScanPrefixLength();
+    if (prefixLength > 0) {
+        // A skip scan runs forward through a tree index, seeking to the
+        // search key within each distinct prefix of the leading key columns.
+        // Without a search key it must be after just one entry per prefix,
+        // or it would be an ordinary scan.
+        if (prefixLength + m_numOfSearchkeys > tableIndex->getKeySchema()->columnCount() ||
+            (m_numOfSearchkeys == 0 && ! m_node->isSkipScanDistinct()) ||
+            (m_lookupType != INDEX_LOOKUP_TYPE_EQ &&
+             m_lookupType != INDEX_LOOKUP_TYPE_GT &&
+             m_lookupType != INDEX_LOOKUP_TYPE_GTE) ||
+            m_sortDirection == SORT_DIRECTION_TYPE_DESC ||
+            tableIndex->getIndexType() == HASH_TABLE_INDEX ||
+            tableIndex->getIndexType() == BITMAP_INDEX ||
+            tableIndex->getIndexType() == COVERING_CELL_INDEX) {
+            VOLT_ERROR("Unsupported skip scan of %d key columns for PlanNode '%s'",
+                       prefixLength, m_node->debug().c_str());
+            return false;
+        }
+        m_prefixKeyBackingStore = new char[tableIndex->getKeySchema()->tupleLength()];
+    }
+
     VOLT_DEBUG("IndexScan: %s.%s\n", targetTable->name().c_str(), tableIndex->getName().c_str());
 
     return true;
@@ -163,7 +187,7 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
     searchKey.moveNoHeader(m_searchKeyBackingStore);
 
     assert(m_lookupType != INDEX_LOOKUP_TYPE_EQ ||
-            searchKey.getSchema()->columnCount() == m_numOfSearchkeys);
+            searchKey.getSchema()->columnCount() == m_node->getSkipScanPrefixLength() + m_numOfSearchkeys);
 
     int activeNumOfSearchKeys = m_numOfSearchkeys;
     IndexLookupType localLookupType = m_lookupType;
@@ -187,8 +211,27 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
         VOLT_DEBUG("Post Expression:\n%s", post_expression->debug(true).c_str());
     }
 
+    const bool skipScanning = (m_node->getSkipScanPrefixLength() > 0);
+
+    // Without a LIMIT, the post expression can be applied to batches of the
+    // tuples found in the index instead of to each one as it is found.
+    bool batched = (post_expression != NULL && limit_node == NULL && ! skipScanning);
+
+    // A countable index can find the entry after the OFFSET by rank instead
+    // of visiting every entry before it, as long as the postfilter would
+    // have counted each of those entries towards the offset.
+    bool offsetByRank = (offset > 0 &&
+                         post_expression == NULL &&
+                         m_aggExec == NULL &&
+                         m_node->getSkipNullPredicate() == NULL &&
+                         m_lookupType != INDEX_LOOKUP_TYPE_GEO_CONTAINS &&
+                         ! skipScanning &&
+                         tableIndex->isCountableIndex() &&
+                         ! targetTable->hasViews());
+
     // Initialize the postfilter
-    CountingPostfilter postfilter(m_outputTable, post_expression, limit, offset);
+    CountingPostfilter postfilter(m_outputTable, batched ? NULL : post_expression, limit,
+                                  offsetByRank ? CountingPostfilter::NO_OFFSET : offset);
 
     TableTuple temp_tuple;
     ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
@@ -211,6 +254,15 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
         return true;
     }
 
+    if (skipScanning) {
+        skipScan(tableIndex, searchKey, indexCursor, postfilter, temp_tuple, pmp);
+        if (m_aggExec != NULL) {
+            m_aggExec->p_execute_finish();
+        }
+        VOLT_DEBUG ("Index Skip Scanned :\n %s", m_outputTable->debug().c_str());
+        return true;
+    }
+
     //
     // SEARCH KEY
     //
@@ -372,6 +424,7 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
     //
 
     TableTuple tuple;
+    countIndexProbe();
     if (activeNumOfSearchKeys > 0) {
         VOLT_TRACE("INDEX_LOOKUP_TYPE(%d) m_numSearchkeys(%d) key:%s",
                 localLookupType, activeNumOfSearchKeys, searchKey.debugNoHeader().c_str());
@@ -422,6 +475,15 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
         tableIndex->moveToEnd(toStartActually, indexCursor);
     }
 
+    if (offsetByRank) {
+        // Entries that fail the end expression come after every entry that
+        // passes it, so skipping past the end of the range finds nothing.
+        bool atKey = (localLookupType == INDEX_LOOKUP_TYPE_EQ && activeNumOfSearchKeys > 0);
+        tableIndex->skipEntries(offset, atKey, indexCursor);
+    }
+
+    boost::scoped_ptr<TupleBatch> batch(batched ? new TupleBatch(tableIndex->getTupleSchema()) : NULL);
+
     //
     // We have to different nextValue() methods for different lookup types
     //
@@ -455,6 +517,14 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
             VOLT_TRACE("End Expression evaluated to false, stopping scan");
             break;
         }
+        if (batched) {
+            batch->nextTuple() = tuple;
+            batch->append();
+            if (batch->isFull()) {
+                outputBatch(*batch, post_expression, postfilter, temp_tuple, pmp);
+            }
+            continue;
+        }
         //
         // Then apply our post-predicate and LIMIT/OFFSET to do further filtering
         //
@@ -470,6 +540,9 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
             pmp.countdownProgress();
         }
     }
+    if (batched) {
+        outputBatch(*batch, post_expression, postfilter, temp_tuple, pmp);
+    }
 
     if (m_aggExec != NULL) {
         m_aggExec->p_execute_finish();
@@ -480,6 +553,192 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
     return true;
 }
 
+/*
+ * A skip scan (loose index scan) visits each distinct value of the leading
+ * prefix key columns in turn. Within a prefix it seeks to the search key,
+ * which covers the key columns after the prefix, and scans forward until
+ * the end expression fails or the prefix changes, then seeks past the rest
+ * of the prefix. A distinct skip scan returns just the first entry of each
+ * prefix that passes the post expression, as DISTINCT or GROUP BY on the
+ * prefix needs.
+ */
+void IndexScanExecutor::skipScan(TableIndex* tableIndex,
+                                 TableTuple& searchKey,
+                                 IndexCursor& indexCursor,
+                                 CountingPostfilter& postfilter,
+                                 TableTuple& temp_tuple,
+                                 ProgressMonitorProxy& pmp)
+{
+    const int prefixLength = m_node->getSkipScanPrefixLength();
+    IndexLookupType lookupType = m_lookupType;
+    assert(lookupType != INDEX_LOOKUP_TYPE_EQ || m_numOfSearchkeys == 0 ||
+           prefixLength + m_numOfSearchkeys == searchKey.getSchema()->columnCount());
+    const bool distinct = m_node->isSkipScanDistinct();
+
+    // The search values are the same for every prefix. Check once that
+    // they fit the key columns, adjusting the lookup as p_execute does.
+    std::vector<NValue> searchValues;
+    int activeNumOfSearchKeys = m_numOfSearchkeys;
+    bool shrinkLastSearchKey = false;
+    searchKey.setAllNulls();
+    for (int ctr = 0; ctr < m_numOfSearchkeys; ctr++) {
+        NValue candidateValue = m_searchKeyArray[ctr]->eval(NULL, NULL);
+        if (candidateValue.isNull()) {
+            return;
+        }
+        try {
+            searchKey.setNValue(prefixLength + ctr, candidateValue);
+            searchValues.push_back(candidateValue);
+        }
+        catch (const SQLException &e) {
+            const int flags = e.getInternalFlags();
+            if ((flags & (SQLException::TYPE_OVERFLOW | SQLException::TYPE_UNDERFLOW | SQLException::TYPE_VAR_LENGTH_MISMATCH)) == 0) {
+                throw e;
+            }
+            // Only the last key of a range lookup can be out of range and
+            // still match anything.
+            if (lookupType == INDEX_LOOKUP_TYPE_EQ ||
+                ctr != m_numOfSearchkeys - 1 ||
+                (flags & SQLException::TYPE_OVERFLOW)) {
+                return;
+            }
+            if (flags & SQLException::TYPE_UNDERFLOW) {
+                activeNumOfSearchKeys--;
+            }
+            else {
+                searchValues.push_back(candidateValue);
+                shrinkLastSearchKey = true;
+            }
+            // don't allow GTE because it breaks null handling
+            lookupType = INDEX_LOOKUP_TYPE_GT;
+        }
+    }
+
+    AbstractExpression* end_expression = m_node->getEndExpression();
+    const bool canSeekPastPrefix = tableIndex->canMoveToNextPrefix(prefixLength);
+    const bool atKey = (lookupType == INDEX_LOOKUP_TYPE_EQ && m_numOfSearchkeys > 0);
+
+    countIndexProbe();
+    tableIndex->moveToEnd(true, indexCursor);
+    TableTuple tuple = tableIndex->nextValue(indexCursor);
+    while ( ! tuple.isNullTuple() && postfilter.isUnderLimit()) {
+        // tuple is the first entry with a new prefix.
+        searchKey.setAllNulls();
+        tableIndex->copyKeyPrefix(tuple, prefixLength, searchKey);
+        if (m_numOfSearchkeys > 0) {
+            for (int ctr = 0; ctr < activeNumOfSearchKeys; ctr++) {
+                if (shrinkLastSearchKey && ctr == activeNumOfSearchKeys - 1) {
+                    searchKey.shrinkAndSetNValue(prefixLength + ctr, searchValues[ctr]);
+                }
+                else {
+                    searchKey.setNValue(prefixLength + ctr, searchValues[ctr]);
+                }
+            }
+            countIndexProbe();
+            if (lookupType == INDEX_LOOKUP_TYPE_EQ) {
+                tableIndex->moveToKey(&searchKey, indexCursor);
+                tuple = tableIndex->nextValueAtKey(indexCursor);
+            }
+            else {
+                if (lookupType == INDEX_LOOKUP_TYPE_GT) {
+                    tableIndex->moveToGreaterThanKey(&searchKey, indexCursor);
+                }
+                else {
+                    tableIndex->moveToKeyOrGreater(&searchKey, indexCursor);
+                }
+                tuple = tableIndex->nextValue(indexCursor);
+            }
+        }
+
+        // Scan the entries with this prefix. Stopping on a tuple with a
+        // different prefix leaves it as the start of the next prefix.
+        bool skipRestOfPrefix = atKey;
+        while ( ! tuple.isNullTuple() && postfilter.isUnderLimit()) {
+            pmp.countdownProgress();
+            if ( ! atKey && ! hasPrefix(tableIndex, tuple, searchKey)) {
+                skipRestOfPrefix = false;
+                break;
+            }
+            if ( ! tuple.isPendingDelete()) {
+                if (end_expression != NULL && !end_expression->eval(&tuple, NULL).isTrue()) {
+                    skipRestOfPrefix = true;
+                    break;
+                }
+                if (postfilter.eval(&tuple, NULL)) {
+                    if (m_projector.numSteps() > 0) {
+                        m_projector.exec(temp_tuple, tuple);
+                        outputTuple(postfilter, temp_tuple);
+                    }
+                    else {
+                        outputTuple(postfilter, tuple);
+                    }
+                    if (distinct) {
+                        skipRestOfPrefix = true;
+                        break;
+                    }
+                }
+            }
+            tuple = atKey ? tableIndex->nextValueAtKey(indexCursor) : tableIndex->nextValue(indexCursor);
+        }
+
+        if ( ! skipRestOfPrefix || ! postfilter.isUnderLimit()) {
+            continue;
+        }
+        if (canSeekPastPrefix) {
+            countIndexProbe();
+            if (tableIndex->moveToNextPrefix(searchKey, prefixLength, indexCursor)) {
+                break;
+            }
+            tuple = tableIndex->nextValue(indexCursor);
+        }
+        else {
+            // Without a largest key value to seek past, step over the rest
+            // of the prefix instead.
+            if (atKey) {
+                tableIndex->moveToGreaterThanKey(&searchKey, indexCursor);
+            }
+            do {
+                tuple = tableIndex->nextValue(indexCursor);
+                pmp.countdownProgress();
+            } while ( ! tuple.isNullTuple() && hasPrefix(tableIndex, tuple, searchKey));
+        }
+    }
+}
+
+bool IndexScanExecutor::hasPrefix(TableIndex* tableIndex, const TableTuple& tuple, const TableTuple& searchKey)
+{
+    const int prefixLength = m_node->getSkipScanPrefixLength();
+    TableTuple prefixKey(tableIndex->getKeySchema());
+    prefixKey.moveNoHeader(m_prefixKeyBackingStore);
+    tableIndex->copyKeyPrefix(tuple, prefixLength, prefixKey);
+    for (int ii = 0; ii < prefixLength; ii++) {
+        if (prefixKey.getNValue(ii).compare(searchKey.getNValue(ii)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void IndexScanExecutor::outputBatch(TupleBatch& batch,
+                                    const AbstractExpression* post_expression,
+                                    CountingPostfilter& postfilter,
+                                    TableTuple& temp_tuple,
+                                    ProgressMonitorProxy& pmp) {
+    batch.filter(post_expression);
+    for (size_t ii = 0; ii < batch.selection().size() && postfilter.isUnderLimit(); ii++) {
+        TableTuple& tuple = batch.selectedTuple(ii);
+        if (m_projector.numSteps() > 0) {
+            m_projector.exec(temp_tuple, tuple);
+            outputTuple(postfilter, temp_tuple);
+        }
+        else {
+            outputTuple(postfilter, tuple);
+        }
+        pmp.countdownProgress();
+    }
+    batch.clear();
+}
+
 void IndexScanExecutor::outputTuple(CountingPostfilter& postfilter, TableTuple& tuple) {
     if (m_aggExec != NULL) {
         m_aggExec->p_execute_tuple(tuple);
@@ -494,4 +753,5 @@ void IndexScanExecutor::outputTuple(CountingPostfilter& postfilter, TableTuple&
 
 IndexScanExecutor::~IndexScanExecutor() {
     delete [] m_searchKeyBackingStore;
+    delete [] m_prefixKeyBackingStore;
 }
@@ -70,6 +70,7 @@ class LimitPlanNode;
 class AggregateExecutorBase;
 
 struct CountingPostfilter;
+class TupleBatch;
 
 class IndexScanExecutor : public AbstractExecutor
 {
@@ -78,6 +79,7 @@ public:
         : AbstractExecutor(engine, abstractNode)
         , m_projector()
         , m_searchKeyBackingStore(NULL)
+        , m_prefixKeyBackingStore(NULL)
         , m_aggExec(NULL)
     {}
     ~IndexScanExecutor();
@@ -111,7 +113,19 @@ private:
     bool p_init(AbstractPlanNode*,
                 TempTableLimits* limits);
     bool p_execute(const NValueArray &params);
+    void skipScan(TableIndex* tableIndex,
+                  TableTuple& searchKey,
+                  IndexCursor& indexCursor,
+                  CountingPostfilter& postfilter,
+                  TableTuple& temp_tuple,
+                  ProgressMonitorProxy& pmp);
+    bool hasPrefix(TableIndex* tableIndex, const TableTuple& tuple, const TableTuple& searchKey);
     void outputTuple(CountingPostfilter& postfilter, TableTuple& tuple);
+    void outputBatch(TupleBatch& batch,
+                     const AbstractExpression* post_expression,
+                     CountingPostfilter& postfilter,
+                     TableTuple& temp_tuple,
+                     ProgressMonitorProxy& pmp);
 
 
     // Data in this class is arranged roughly in the order it is read for
@@ -139,6 +153,8 @@ private:
     boost::shared_array<AbstractExpression*> m_searchKeyArrayPtr;
     // So Valgrind doesn't complain:
     char* m_searchKeyBackingStore;
+    // The prefix of the entry being visited by a skip scan
+    char* m_prefixKeyBackingStore;
 
     AggregateExecutorBase* m_aggExec;
 };
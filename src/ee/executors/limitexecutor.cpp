@@ -129,3 +129,44 @@ LimitExecutor::p_execute(const NValueArray &params)
 
     return true;
 }
+
+void
+LimitExecutor::p_pre_pull(const NValueArray &params, ProgressMonitorProxy* pmp)
+{
+    LimitPlanNode* node = dynamic_cast<LimitPlanNode*>(m_abstractNode);
+    assert(node);
+    assert( ! node->isInline());
+    m_pullLimit = -1;
+    m_pullOffset = -1;
+    node->getLimitAndOffsetByReference(params, m_pullLimit, m_pullOffset);
+    m_pullCount = 0;
+    m_pullSkipped = 0;
+    m_pullTuple = TableTuple(node->getInputTable()->schema());
+    openPullInput(node->getInputTable(), params, pmp);
+}
+
+bool
+LimitExecutor::p_next_pull(TableTuple& tuple)
+{
+    // Once the limit is reached, stop pulling so that the rest of the
+    // chain below is never evaluated.
+    if (m_pullLimit != -1 && m_pullCount >= m_pullLimit) {
+        return false;
+    }
+    while (nextPullInput(m_pullTuple)) {
+        if (m_pullSkipped < m_pullOffset) {
+            m_pullSkipped++;
+            continue;
+        }
+        m_pullCount++;
+        tuple = m_pullTuple;
+        return true;
+    }
+    return false;
+}
+
+void
+LimitExecutor::p_post_pull()
+{
+    closePullInput(m_abstractNode->getInputTable());
+}
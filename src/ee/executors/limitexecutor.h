@@ -58,16 +58,32 @@ namespace voltdb
     public:
         LimitExecutor(VoltDBEngine* engine, AbstractPlanNode* abstract_node)
             : AbstractExecutor(engine, abstract_node)
+            , m_pullLimit(-1)
+            , m_pullOffset(-1)
+            , m_pullCount(0)
+            , m_pullSkipped(0)
         {
         }
 
         ~LimitExecutor() {
         }
 
+        bool supportsPull() const { return true; }
+        bool canPullInput() const { return true; }
+        void p_pre_pull(const NValueArray& params, ProgressMonitorProxy* pmp);
+        bool p_next_pull(TableTuple& tuple);
+        void p_post_pull();
+
     private:
         bool p_init(AbstractPlanNode*,
                     TempTableLimits* limits);
         bool p_execute(const NValueArray &params);
+
+        int m_pullLimit;
+        int m_pullOffset;
+        int m_pullCount;
+        int m_pullSkipped;
+        TableTuple m_pullTuple;
     };
 
 }
@@ -422,6 +422,7 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
                 //
                 // Essentially cut and pasted this if ladder from
                 // index scan executor
+                countIndexProbe();
                 if (num_of_searchkeys > 0) {
                     if (localLookupType == INDEX_LOOKUP_TYPE_EQ) {
                         index->moveToKey(&index_values, indexCursor);
@@ -48,13 +48,18 @@
 #include "common/common.h"
 #include "common/tabletuple.h"
 #include "common/FatalException.hpp"
+#include "common/executorcontext.hpp"
 #include "execution/ProgressMonitorProxy.h"
+#include "executors/spilledsortruns.h"
 #include "plannodes/orderbynode.h"
 #include "plannodes/limitnode.h"
 #include "storage/table.h"
 #include "storage/temptable.h"
 #include "storage/tableiterator.h"
 #include "storage/tablefactory.h"
+#include "storage/TempTableLimits.h"
+
+#include "boost/scoped_ptr.hpp"
 
 #include <algorithm>
 #include <vector>
@@ -62,11 +67,15 @@
 using namespace voltdb;
 using namespace std;
 
+// Each sorted run written to disk may use about this fraction of the temp table memory limit.
+static const int64_t SPILL_RUN_DIVISOR = 4;
+
 bool
 OrderByExecutor::p_init(AbstractPlanNode* abstract_node,
                         TempTableLimits* limits)
 {
     VOLT_TRACE("init OrderBy Executor");
+    m_limits = limits;
 
     OrderByPlanNode* node = dynamic_cast<OrderByPlanNode*>(abstract_node);
     assert(node);
@@ -133,7 +142,11 @@ OrderByExecutor::p_execute(const NValueArray &params)
     // or to fetch the vector of tuples from the input.  If limit < 0 we
     // need to do the loop below, though.  The only case where we can skip
     // is if limit == 0.
-    if (limit != 0) {
+    if (limit != 0 && shouldSpill(input_table, limit, offset)) {
+        ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
+        spillingSort(dynamic_cast<TempTable*>(input_table), output_table, limit, offset, pmp);
+    }
+    else if (limit != 0) {
         vector<TableTuple> xs;
         ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
         while (iterator.next(tuple))
@@ -187,5 +200,85 @@ OrderByExecutor::p_execute(const NValueArray &params)
     return true;
 }
 
+bool
+OrderByExecutor::shouldSpill(Table* input_table, int limit, int offset) const
+{
+    // Only a temp table input can be released while it is being sorted,
+    // and only its memory is counted against the limit.
+    if (m_limits == NULL || m_limits->getMemoryLimit() <= 0 ||
+        dynamic_cast<TempTable*>(input_table) == NULL) {
+        return false;
+    }
+    int64_t outputCount = input_table->activeTupleCount();
+    if (limit >= 0) {
+        outputCount = std::min(outputCount, static_cast<int64_t>(limit));
+    }
+    int64_t tupleSize = input_table->schema()->tupleLength() + TUPLE_HEADER_SIZE;
+    return m_limits->getAllocated() + outputCount * tupleSize > m_limits->getMemoryLimit();
+}
+
+void
+OrderByExecutor::spillingSort(TempTable* input_table, TempTable* output_table,
+                              int limit, int offset, ProgressMonitorProxy& pmp)
+{
+    OrderByPlanNode* node = dynamic_cast<OrderByPlanNode*>(m_abstractNode);
+    assert(node);
+    assert(input_table);
+    AbstractExecutor::TupleComparer comp(node->getSortExpressions(), node->getSortDirections());
+
+    int64_t tupleSize = input_table->schema()->tupleLength() + TUPLE_HEADER_SIZE;
+    int64_t runCapacity = std::max(static_cast<int64_t>(1),
+                                   m_limits->getMemoryLimit() / SPILL_RUN_DIVISOR / tupleSize);
+    // Only the first limit + offset tuples of any run can make it to the output.
+    int64_t runOutputCount = -1;
+    if (limit >= 0) {
+        runOutputCount = limit + std::max(offset, 0);
+    }
+    VOLT_DEBUG("Spilling sort of %jd tuples in runs of %jd",
+               (intmax_t)input_table->activeTupleCount(), (intmax_t)runCapacity);
+
+    SpilledSortRuns runs(input_table->schema());
+    // Each run is copied out of the input as the input is released,
+    // so memory use stays near the size of the input instead of doubling.
+    boost::scoped_ptr<TempTable> runTable(TableFactory::buildCopiedTempTable(input_table->name(),
+                                                                              input_table,
+                                                                              m_limits));
+    vector<TableTuple> xs;
+    xs.reserve(runCapacity);
+    TableTuple tuple(input_table->schema());
+    TableIterator iterator = input_table->iteratorDeletingAsWeGo();
+    bool more = true;
+    while (more) {
+        more = iterator.next(tuple);
+        if (more) {
+            pmp.countdownProgress();
+            runTable->insertTempTuple(tuple);
+            if (runTable->activeTupleCount() < runCapacity) {
+                continue;
+            }
+        }
+        if (runTable->activeTupleCount() == 0) {
+            break;
+        }
+        xs.clear();
+        TableTuple runTuple(runTable->schema());
+        TableIterator runIterator = runTable->iterator();
+        while (runIterator.next(runTuple)) {
+            xs.push_back(runTuple);
+        }
+        vector<TableTuple>::iterator runEnd = xs.end();
+        if (runOutputCount >= 0 && runOutputCount < static_cast<int64_t>(xs.size())) {
+            runEnd = xs.begin() + runOutputCount;
+            partial_sort(xs.begin(), runEnd, xs.end(), comp);
+        } else {
+            sort(xs.begin(), xs.end(), comp);
+        }
+        runs.writeRun(xs.begin(), runEnd);
+        runTable->deleteAllTempTuples();
+    }
+
+    runs.mergeRuns(comp, limit, offset, output_table, ExecutorContext::getTempStringPool(), &pmp);
+}
+
 OrderByExecutor::~OrderByExecutor() {
 }
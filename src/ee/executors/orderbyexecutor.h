@@ -55,6 +55,7 @@ namespace voltdb {
     class UndoLog;
     class ReadWriteSet;
     class LimitPlanNode;
+    class ProgressMonitorProxy;
 
     /**
      *
@@ -62,7 +63,7 @@ namespace voltdb {
     class OrderByExecutor : public AbstractExecutor {
     public:
         OrderByExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
-            : AbstractExecutor(engine, abstract_node), limit_node(NULL)
+            : AbstractExecutor(engine, abstract_node), limit_node(NULL), m_limits(NULL)
             { }
         ~OrderByExecutor();
 
@@ -72,7 +73,21 @@ namespace voltdb {
         bool p_execute(const NValueArray &params);
 
     private:
+        /**
+         * True if copying the sorted input into the output table would
+         * probably exceed the temp table memory limit.
+         */
+        bool shouldSpill(Table* input_table, int limit, int offset) const;
+
+        /**
+         * Sort by spilling sorted runs of the input to disk, freeing the input
+         * as it goes, and then merging the runs into the output table.
+         */
+        void spillingSort(TempTable* input_table, TempTable* output_table,
+                          int limit, int offset, ProgressMonitorProxy& pmp);
+
         LimitPlanNode *limit_node;
+        TempTableLimits* m_limits;
     };
 
 }
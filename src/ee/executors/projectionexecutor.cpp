@@ -133,26 +133,7 @@ bool ProjectionExecutor::p_execute(const NValueArray &params) {
     TableIterator iterator = input_table->iteratorDeletingAsWeGo();
     assert (tuple.sizeInValues() == input_table->columnCount());
     while (iterator.next(tuple)) {
-        //
-        // Project (or replace) values from input tuple
-        //
-        TableTuple &temp_tuple = output_table->tempTuple();
-        if (all_tuple_array != NULL) {
-            VOLT_TRACE("sweet, all tuples");
-            for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
-                temp_tuple.setNValue(ctr, tuple.getNValue(all_tuple_array[ctr]));
-            }
-        } else if (all_param_array != NULL) {
-            VOLT_TRACE("sweet, all params");
-            for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
-                temp_tuple.setNValue(ctr, params[all_param_array[ctr]]);
-            }
-        } else {
-            for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
-                temp_tuple.setNValue(ctr, expression_array[ctr]->eval(&tuple, NULL));
-            }
-        }
-        output_table->insertTempTuple(temp_tuple);
+        output_table->insertTempTuple(projectTuple(params));
 
         VOLT_TRACE("OUTPUT TABLE: %s\n", output_table->debug().c_str());
     }
@@ -162,6 +143,48 @@ bool ProjectionExecutor::p_execute(const NValueArray &params) {
     return (true);
 }
 
+TableTuple& ProjectionExecutor::projectTuple(const NValueArray &params) {
+    //
+    // Project (or replace) values from input tuple
+    //
+    TableTuple &temp_tuple = output_table->tempTuple();
+    if (all_tuple_array != NULL) {
+        VOLT_TRACE("sweet, all tuples");
+        for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
+            temp_tuple.setNValue(ctr, tuple.getNValue(all_tuple_array[ctr]));
+        }
+    } else if (all_param_array != NULL) {
+        VOLT_TRACE("sweet, all params");
+        for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
+            temp_tuple.setNValue(ctr, params[all_param_array[ctr]]);
+        }
+    } else {
+        for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
+            temp_tuple.setNValue(ctr, expression_array[ctr]->eval(&tuple, NULL));
+        }
+    }
+    return temp_tuple;
+}
+
+void ProjectionExecutor::p_pre_pull(const NValueArray &params, ProgressMonitorProxy* pmp) {
+    assert ( ! m_abstractNode->isInline());
+    m_pullParams = &params;
+    openPullInput(m_abstractNode->getInputTable(), params, pmp);
+}
+
+bool ProjectionExecutor::p_next_pull(TableTuple& outputTuple) {
+    if ( ! nextPullInput(tuple)) {
+        return false;
+    }
+    outputTuple = projectTuple(*m_pullParams);
+    return true;
+}
+
+void ProjectionExecutor::p_post_pull() {
+    closePullInput(m_abstractNode->getInputTable());
+    m_pullParams = NULL;
+}
+
 ProjectionExecutor::~ProjectionExecutor() {
 }
 
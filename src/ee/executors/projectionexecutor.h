@@ -66,14 +66,25 @@ class ProjectionExecutor : public AbstractExecutor {
     public:
         ProjectionExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node) : AbstractExecutor(engine, abstract_node) {
             output_table = NULL;
+            m_pullParams = NULL;
         }
         ~ProjectionExecutor();
+
+        bool supportsPull() const { return true; }
+        bool canPullInput() const { return true; }
+        void p_pre_pull(const NValueArray& params, ProgressMonitorProxy* pmp);
+        bool p_next_pull(TableTuple& tuple);
+        void p_post_pull();
+
     protected:
         bool p_init(AbstractPlanNode*,
                     TempTableLimits* limits);
         bool p_execute(const NValueArray &params);
 
     private:
+        /** Project the current input tuple into the output table's temp tuple */
+        TableTuple& projectTuple(const NValueArray &params);
+
         TempTable* output_table;
         int m_columnCount;
         boost::shared_array<int> all_tuple_array_ptr;
@@ -86,6 +97,8 @@ class ProjectionExecutor : public AbstractExecutor {
 
         boost::shared_array<AbstractExpression*> expression_array_ptr;
         AbstractExpression** expression_array;
+
+        const NValueArray* m_pullParams;
 };
 
 }
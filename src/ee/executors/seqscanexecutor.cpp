@@ -56,6 +56,7 @@
 #include "plannodes/seqscannode.h"
 #include "plannodes/projectionnode.h"
 #include "plannodes/limitnode.h"
+#include "storage/persistenttable.h"
 #include "storage/table.h"
 #include "storage/temptable.h"
 #include "storage/tablefactory.h"
@@ -176,13 +177,35 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
             VOLT_TRACE("SCAN PREDICATE :\n%s\n", predicate->debug(true).c_str());
         }
 
+        //
+        // OPTIMIZATION: ZONE MAPS
+        //
+        // Skip the blocks of a persistent table whose column summaries
+        // show that none of their tuples can pass the predicate.
+        //
+        ZoneMapFilter zoneMapFilter(dynamic_cast<PersistentTable*>(input_table),
+                                    node->getOriginalPredicate());
+        if ( ! zoneMapFilter.isEmpty()) {
+            iterator.setZoneMapFilter(&zoneMapFilter);
+        }
+
         int limit = CountingPostfilter::NO_LIMIT;
         int offset = CountingPostfilter::NO_OFFSET;
         if (limit_node) {
             limit_node->getLimitAndOffsetByReference(params, limit, offset);
         }
+        //
+        // OPTIMIZATION: BATCHED EVALUATION
+        //
+        // Without a LIMIT every tuple has to be filtered anyway, so the predicate
+        // and projection can be applied to a batch of tuples at a time. A temp
+        // table frees its blocks as the scan passes them, so a subquery's output
+        // is still scanned a tuple at a time.
+        //
+        bool batched = (limit_node == NULL && ! node->isSubQuery() &&
+                        (predicate != NULL || projection_node != NULL));
         // Initialize the postfilter
-        CountingPostfilter postfilter(m_tmpOutputTable, predicate, limit, offset);
+        CountingPostfilter postfilter(m_tmpOutputTable, batched ? NULL : predicate, limit, offset);
 
         ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
         TableTuple temp_tuple;
@@ -198,40 +221,46 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
             temp_tuple = m_tmpOutputTable->tempTuple();
         }
 
-        while (postfilter.isUnderLimit() && iterator.next(tuple))
-        {
+        if (batched) {
+            scanInBatches(iterator, input_table->schema(), predicate, projection_node,
+                          postfilter, temp_tuple, pmp);
+        }
+        else {
+            while (postfilter.isUnderLimit() && iterator.next(tuple))
+            {
 #if   defined(VOLT_TRACE_ENABLED)
-            int tuple_ctr = 0;
+                int tuple_ctr = 0;
 #endif
-            VOLT_TRACE("INPUT TUPLE: %s, %d/%d\n",
-                       tuple.debug(input_table->name()).c_str(),
-                       ++tuple_ctr,
-                       (int)input_table->activeTupleCount());
-            pmp.countdownProgress();
+                VOLT_TRACE("INPUT TUPLE: %s, %d/%d\n",
+                           tuple.debug(input_table->name()).c_str(),
+                           ++tuple_ctr,
+                           (int)input_table->activeTupleCount());
+                pmp.countdownProgress();
 
-            //
-            // For each tuple we need to evaluate it against our predicate and limit/offset
-            //
-            if (postfilter.eval(&tuple, NULL))
-            {
                 //
-                // Nested Projection
-                // Project (or replace) values from input tuple
+                // For each tuple we need to evaluate it against our predicate and limit/offset
                 //
-                if (projection_node != NULL)
+                if (postfilter.eval(&tuple, NULL))
                 {
-                    VOLT_TRACE("inline projection...");
-                    for (int ctr = 0; ctr < num_of_columns; ctr++) {
-                        NValue value = projection_node->getOutputColumnExpressions()[ctr]->eval(&tuple, NULL);
-                        temp_tuple.setNValue(ctr, value);
+                    //
+                    // Nested Projection
+                    // Project (or replace) values from input tuple
+                    //
+                    if (projection_node != NULL)
+                    {
+                        VOLT_TRACE("inline projection...");
+                        for (int ctr = 0; ctr < num_of_columns; ctr++) {
+                            NValue value = projection_node->getOutputColumnExpressions()[ctr]->eval(&tuple, NULL);
+                            temp_tuple.setNValue(ctr, value);
+                        }
+                        outputTuple(postfilter, temp_tuple);
                     }
-                    outputTuple(postfilter, temp_tuple);
-                }
-                else
-                {
-                    outputTuple(postfilter, tuple);
+                    else
+                    {
+                        outputTuple(postfilter, tuple);
+                    }
+                    pmp.countdownProgress();
                 }
-                pmp.countdownProgress();
             }
         }
 
@@ -248,6 +277,122 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
     return true;
 }
 
+Table* SeqScanExecutor::getScanInputTable() const {
+    SeqScanPlanNode* node = static_cast<SeqScanPlanNode*>(m_abstractNode);
+    return node->isSubQuery() ? node->getChildren()[0]->getOutputTable() : node->getTargetTable();
+}
+
+void SeqScanExecutor::p_pre_pull(const NValueArray &params, ProgressMonitorProxy* pmp) {
+    SeqScanPlanNode* node = dynamic_cast<SeqScanPlanNode*>(m_abstractNode);
+    assert(node);
+    assert(m_aggExec == NULL);
+
+    Table* input_table = getScanInputTable();
+    assert(input_table);
+    VOLT_DEBUG("Pulling from sequential scan of table : %s", input_table->name().c_str());
+    m_pullInputTuple = TableTuple(input_table->schema());
+    m_pullZoneMapFilter.reset(new ZoneMapFilter(dynamic_cast<PersistentTable*>(input_table),
+                                                node->getOriginalPredicate()));
+    openPullInput(input_table, params, pmp,
+                  m_pullZoneMapFilter->isEmpty() ? NULL : m_pullZoneMapFilter.get());
+
+    m_pullProjection = dynamic_cast<ProjectionPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_PROJECTION));
+    LimitPlanNode* limit_node = dynamic_cast<LimitPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_LIMIT));
+    int limit = CountingPostfilter::NO_LIMIT;
+    int offset = CountingPostfilter::NO_OFFSET;
+    if (limit_node) {
+        limit_node->getLimitAndOffsetByReference(params, limit, offset);
+    }
+    // An empty scan produces nothing, like a limit of zero.
+    m_pullLimit = node->isEmptyScan() ? 0 : limit;
+    m_pullCount = 0;
+    m_pullPostfilter = CountingPostfilter(m_tmpOutputTable, node->getPredicate(),
+                                          CountingPostfilter::NO_LIMIT, offset);
+}
+
+bool SeqScanExecutor::p_next_pull(TableTuple& tuple) {
+    while ((m_pullLimit == CountingPostfilter::NO_LIMIT || m_pullCount < m_pullLimit) &&
+           nextPullInput(m_pullInputTuple)) {
+        if ( ! m_pullPostfilter.eval(&m_pullInputTuple, NULL)) {
+            continue;
+        }
+        ++m_pullCount;
+        if (m_pullProjection == NULL) {
+            tuple = m_pullInputTuple;
+            return true;
+        }
+        const std::vector<AbstractExpression*>& columnExpressions =
+            m_pullProjection->getOutputColumnExpressions();
+        TableTuple &temp_tuple = m_tmpOutputTable->tempTuple();
+        for (int ctr = 0; ctr < columnExpressions.size(); ctr++) {
+            temp_tuple.setNValue(ctr, columnExpressions[ctr]->eval(&m_pullInputTuple, NULL));
+        }
+        tuple = temp_tuple;
+        return true;
+    }
+    return false;
+}
+
+void SeqScanExecutor::p_post_pull() {
+    closePullInput(getScanInputTable());
+}
+
+void SeqScanExecutor::scanInBatches(TableIterator& iterator,
+                                    const TupleSchema* inputSchema,
+                                    const AbstractExpression* predicate,
+                                    const ProjectionPlanNode* projection_node,
+                                    CountingPostfilter& postfilter,
+                                    TableTuple& temp_tuple,
+                                    ProgressMonitorProxy& pmp) {
+    TupleBatch batch(inputSchema);
+    // The projected values of a batch, one column after another
+    std::vector<NValue> projected;
+    int num_of_columns = 0;
+    if (projection_node != NULL) {
+        num_of_columns = static_cast<int>(projection_node->getOutputColumnExpressions().size());
+        projected.resize(num_of_columns * TupleBatch::MAX_SIZE);
+    }
+
+    while (postfilter.isUnderLimit()) {
+        batch.clear();
+        while ( ! batch.isFull() && iterator.next(batch.nextTuple())) {
+            batch.append();
+            pmp.countdownProgress();
+        }
+        if (batch.isEmpty()) {
+            break;
+        }
+
+        batch.filter(predicate);
+        const std::vector<int>& selection = batch.selection();
+        if (selection.empty()) {
+            continue;
+        }
+        for (int ctr = 0; ctr < num_of_columns; ctr++) {
+            projection_node->getOutputColumnExpressions()[ctr]->evalBatch(
+                    batch.tuples(), selection, &projected[ctr * TupleBatch::MAX_SIZE]);
+        }
+
+        // The postfilter has no predicate or limit of its own here,
+        // but an inline aggregate may still tell it to stop.
+        for (size_t ii = 0; ii < selection.size() && postfilter.isUnderLimit(); ii++) {
+            if ( ! postfilter.eval(&batch.selectedTuple(ii), NULL)) {
+                continue;
+            }
+            if (projection_node != NULL) {
+                for (int ctr = 0; ctr < num_of_columns; ctr++) {
+                    temp_tuple.setNValue(ctr, projected[ctr * TupleBatch::MAX_SIZE + ii]);
+                }
+                outputTuple(postfilter, temp_tuple);
+            }
+            else {
+                outputTuple(postfilter, batch.selectedTuple(ii));
+            }
+            pmp.countdownProgress();
+        }
+    }
+}
+
 void SeqScanExecutor::outputTuple(CountingPostfilter& postfilter, TableTuple& tuple) {
     if (m_aggExec != NULL) {
         m_aggExec->p_execute_tuple(tuple);
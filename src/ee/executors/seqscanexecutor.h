@@ -49,19 +49,31 @@
 #include "common/common.h"
 #include "common/valuevector.h"
 #include "executors/abstractexecutor.h"
+#include "executors/executorutil.h"
 #include "execution/VoltDBEngine.h"
 
 namespace voltdb
 {
     class AggregateExecutorBase;
-    struct CountingPostfilter;
+    class ProjectionPlanNode;
+    class TableIterator;
 
     class SeqScanExecutor : public AbstractExecutor {
     public:
         SeqScanExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
             : AbstractExecutor(engine, abstract_node)
             , m_aggExec(NULL)
+            , m_pullProjection(NULL)
+            , m_pullLimit(CountingPostfilter::NO_LIMIT)
+            , m_pullCount(0)
         {}
+
+        // An inline aggregate has to see every tuple before it can produce any.
+        bool supportsPull() const { return m_aggExec == NULL; }
+        void p_pre_pull(const NValueArray& params, ProgressMonitorProxy* pmp);
+        bool p_next_pull(TableTuple& tuple);
+        void p_post_pull();
+
     protected:
         bool p_init(AbstractPlanNode* abstract_node,
                     TempTableLimits* limits);
@@ -71,7 +83,27 @@ namespace voltdb
 
         void outputTuple(CountingPostfilter& postfilter, TableTuple& tuple);
 
+        void scanInBatches(TableIterator& iterator,
+                           const TupleSchema* inputSchema,
+                           const AbstractExpression* predicate,
+                           const ProjectionPlanNode* projection_node,
+                           CountingPostfilter& postfilter,
+                           TableTuple& temp_tuple,
+                           ProgressMonitorProxy& pmp);
+
+        Table* getScanInputTable() const;
+
         AggregateExecutorBase* m_aggExec;
+
+        // State of a pulled scan, set up by p_pre_pull.
+        // The postfilter applies the predicate and offset only,
+        // since its limit check counts the rows of an output table.
+        CountingPostfilter m_pullPostfilter;
+        ProjectionPlanNode* m_pullProjection;
+        TableTuple m_pullInputTuple;
+        int m_pullLimit;
+        int m_pullCount;
+        boost::scoped_ptr<ZoneMapFilter> m_pullZoneMapFilter;
     };
 }
 
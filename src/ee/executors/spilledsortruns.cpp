@@ -0,0 +1,144 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "spilledsortruns.h"
+
+#include "common/debuglog.h"
+#include "common/Pool.hpp"
+#include "execution/ProgressMonitorProxy.h"
+#include "storage/temptable.h"
+
+#include "boost/ptr_container/ptr_vector.hpp"
+
+#include <algorithm>
+
+namespace voltdb {
+
+// Serialized tuples are buffered up to about this size before being written.
+static const size_t SPILL_WRITE_SIZE = 1024 * 1024;
+
+// Each run's reader keeps the non-inlined values of its current tuple in a
+// pool of about this size.
+static const size_t RUN_POOL_CHUNK_SIZE = 16 * 1024;
+
+namespace {
+
+// A run's reader, with a pool for the non-inlined values of its current
+// tuple that is purged as the tuple leaves the merge.
+struct RunCursor {
+    RunCursor(const TupleSpillFile& file, int64_t start, int64_t end)
+        : m_reader(file, start, end)
+        , m_stringPool(RUN_POOL_CHUNK_SIZE, 1)
+    { }
+
+    bool next()
+    {
+        m_stringPool.purge();
+        return m_reader.next(&m_stringPool);
+    }
+
+    TableTuple& tuple() { return m_reader.tuple(); }
+
+    TupleSpillFile::Reader m_reader;
+    Pool m_stringPool;
+};
+
+// Orders run cursors so that std::*_heap keeps the one with the
+// smallest current tuple on top.
+struct RunCursorComparer {
+    RunCursorComparer(AbstractExecutor::TupleComparer comp) : m_comp(comp) { }
+
+    bool operator()(RunCursor* ra, RunCursor* rb) const
+    {
+        return m_comp(rb->tuple(), ra->tuple());
+    }
+
+    AbstractExecutor::TupleComparer m_comp;
+};
+
+}
+
+SpilledSortRuns::SpilledSortRuns(const TupleSchema* schema)
+    : m_file(schema, SPILL_WRITE_SIZE)
+    , m_runs()
+{ }
+
+SpilledSortRuns::~SpilledSortRuns()
+{ }
+
+void SpilledSortRuns::writeRun(std::vector<TableTuple>::const_iterator begin,
+                               std::vector<TableTuple>::const_iterator end)
+{
+    if (begin == end) {
+        return;
+    }
+    Run run;
+    run.m_start = m_file.size();
+    for (std::vector<TableTuple>::const_iterator it = begin; it != end; ++it) {
+        m_file.append(*it);
+    }
+    m_file.flush();
+    run.m_end = m_file.size();
+    m_runs.push_back(run);
+    VOLT_DEBUG("Spilled sort run %d of %jd bytes", (int)m_runs.size(), (intmax_t)(run.m_end - run.m_start));
+}
+
+void SpilledSortRuns::mergeRuns(AbstractExecutor::TupleComparer comp,
+                                int limit,
+                                int offset,
+                                TempTable* outputTable,
+                                Pool* stringPool,
+                                ProgressMonitorProxy* pmp)
+{
+    boost::ptr_vector<RunCursor> cursors;
+    std::vector<RunCursor*> heap;
+    heap.reserve(m_runs.size());
+    for (std::vector<Run>::const_iterator it = m_runs.begin(); it != m_runs.end(); ++it) {
+        cursors.push_back(new RunCursor(m_file, it->m_start, it->m_end));
+        if (cursors.back().next()) {
+            heap.push_back(&cursors.back());
+        }
+    }
+
+    RunCursorComparer cursorComp(comp);
+    std::make_heap(heap.begin(), heap.end(), cursorComp);
+
+    int tuple_ctr = 0;
+    int tuple_skipped = 0;
+    while ( ! heap.empty() && (limit < 0 || tuple_ctr < limit)) {
+        std::pop_heap(heap.begin(), heap.end(), cursorComp);
+        RunCursor* cursor = heap.back();
+        if (tuple_skipped < offset) {
+            tuple_skipped++;
+        } else {
+            // The cursor's pool is reused for its next tuple.
+            outputTable->insertTempTupleDeepCopy(cursor->tuple(), stringPool);
+            tuple_ctr++;
+            if (pmp != NULL) {
+                // Should only be NULL when unit testing
+                pmp->countdownProgress();
+            }
+        }
+        if (cursor->next()) {
+            std::push_heap(heap.begin(), heap.end(), cursorComp);
+        } else {
+            heap.pop_back();
+        }
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSTORESPILLEDSORTRUNS_H
+#define HSTORESPILLEDSORTRUNS_H
+
+#include "common/tabletuple.h"
+#include "executors/abstractexecutor.h"
+#include "executors/tuplespillfile.h"
+
+#include <vector>
+
+namespace voltdb {
+
+class Pool;
+class ProgressMonitorProxy;
+class TempTable;
+
+/**
+ * Sorted runs of tuples written to an unnamed scratch file, for sorts that
+ * would not fit under the fragment's TempTableLimits if done in memory.
+ *
+ * Runs are appended one at a time with writeRun and then merged in one
+ * k-way pass by mergeRuns, which applies LIMIT/OFFSET the same way
+ * MergeReceiveExecutor::merge_sort does.  All the runs share one
+ * TupleSpillFile.
+ */
+class SpilledSortRuns {
+public:
+    SpilledSortRuns(const TupleSchema* schema);
+    ~SpilledSortRuns();
+
+    /** Append a run.  The tuples must already be sorted. */
+    void writeRun(std::vector<TableTuple>::const_iterator begin,
+                  std::vector<TableTuple>::const_iterator end);
+
+    size_t runCount() const { return m_runs.size(); }
+
+    /**
+     * Merge all the runs into the output table, skipping the first offset
+     * tuples and stopping after limit tuples (-1 means no limit or offset).
+     * Only the non-inlined values of the tuples put into the output table
+     * are allocated from stringPool, which must outlive its contents; each
+     * run holds those of just its current tuple.
+     */
+    void mergeRuns(AbstractExecutor::TupleComparer comp,
+                   int limit,
+                   int offset,
+                   TempTable* outputTable,
+                   Pool* stringPool,
+                   ProgressMonitorProxy* pmp);
+
+private:
+    struct Run {
+        int64_t m_start;
+        int64_t m_end;
+    };
+
+    TupleSpillFile m_file;
+    std::vector<Run> m_runs;
+};
+
+}
+
+#endif
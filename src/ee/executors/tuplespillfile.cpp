@@ -0,0 +1,196 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tuplespillfile.h"
+
+#include "common/debuglog.h"
+#include "common/Pool.hpp"
+#include "common/SerializableEEException.h"
+#include "common/SQLException.h"
+#include "common/TupleSchema.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace voltdb {
+
+// Each reader reads its part of the file in chunks of this size.
+static const size_t SPILL_READ_SIZE = 64 * 1024;
+
+TupleSpillFile::TupleSpillFile(const TupleSchema* schema, size_t writeBufferSize)
+    : m_schema(schema)
+    , m_writeBufferSize(writeBufferSize)
+    , m_fd(-1)
+    , m_fileSize(0)
+    , m_tupleCount(0)
+    , m_writeBuffer()
+{ }
+
+TupleSpillFile::~TupleSpillFile()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+static std::string scratchDirectoryFromEnvironment()
+{
+    const char* setting = ::getenv("VOLTDB_SPILL_DIR");
+    if (setting == NULL || *setting == '\0') {
+        setting = ::getenv("TMPDIR");
+    }
+    if (setting == NULL || *setting == '\0') {
+        return "/tmp";
+    }
+    return setting;
+}
+
+std::string TupleSpillFile::s_scratchDirectory = scratchDirectoryFromEnvironment();
+
+/**
+ * Fail the query that is spilling the same way as if it had not been
+ * able to spill, but saying why.
+ */
+static void throwSpillFailure(const char* action, int error)
+{
+    char msg[1024];
+    snprintf(msg, sizeof(msg),
+             "Temp table memory was exceeded and %s spill file in %s failed: %s."
+             " Set VOLTDB_SPILL_DIR to a writable local directory.",
+             action, TupleSpillFile::scratchDirectory().c_str(), ::strerror(error));
+    throw SQLException(SQLException::volt_temp_table_memory_overflow, msg);
+}
+
+void TupleSpillFile::openFile()
+{
+    std::string path = s_scratchDirectory + "/voltdb_spill_XXXXXX";
+    std::vector<char> pathTemplate(path.begin(), path.end());
+    pathTemplate.push_back('\0');
+    m_fd = ::mkstemp(&pathTemplate[0]);
+    if (m_fd < 0) {
+        throwSpillFailure("creating a", errno);
+    }
+    // Nobody else needs to find the file; let it disappear when closed.
+    ::unlink(&pathTemplate[0]);
+    VOLT_DEBUG("Spilling tuples to %s", &pathTemplate[0]);
+}
+
+void TupleSpillFile::append(const TableTuple& tuple)
+{
+    tuple.serializeTo(m_writeBuffer);
+    ++m_tupleCount;
+    if (m_writeBuffer.position() >= m_writeBufferSize) {
+        flush();
+    }
+}
+
+void TupleSpillFile::flush()
+{
+    const char* data = m_writeBuffer.data();
+    size_t remaining = m_writeBuffer.position();
+    if (remaining > 0 && m_fd < 0) {
+        openFile();
+    }
+    while (remaining > 0) {
+        ssize_t written = ::write(m_fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwSpillFailure("writing the", errno);
+        }
+        data += written;
+        remaining -= written;
+        m_fileSize += written;
+    }
+    m_writeBuffer.reset();
+}
+
+TupleSpillFile::Reader::Reader(const TupleSpillFile& file, int64_t start, int64_t end)
+    : m_fd(file.m_fd)
+    , m_position(start)
+    , m_end(end)
+    , m_buffer(SPILL_READ_SIZE)
+    , m_bufferStart(0)
+    , m_bufferEnd(0)
+    , m_tupleStorage(new char[file.m_schema->tupleLength() + TUPLE_HEADER_SIZE])
+    , m_tuple(m_tupleStorage.get(), file.m_schema)
+{
+    assert(end <= file.m_fileSize);
+    ::memset(m_tupleStorage.get(), 0, file.m_schema->tupleLength() + TUPLE_HEADER_SIZE);
+}
+
+bool TupleSpillFile::Reader::next(Pool* stringPool)
+{
+    if ( ! fill(sizeof(int32_t))) {
+        return false;
+    }
+    ReferenceSerializeInputBE lengthIn(&m_buffer[m_bufferStart], sizeof(int32_t));
+    size_t recordLength = sizeof(int32_t) + lengthIn.readInt();
+    if ( ! fill(recordLength)) {
+        throwSerializableEEException("Spill file is truncated");
+    }
+    ReferenceSerializeInputBE tupleIn(&m_buffer[m_bufferStart], recordLength);
+    m_tuple.deserializeFrom(tupleIn, stringPool);
+    m_bufferStart += recordLength;
+    return true;
+}
+
+/**
+ * Make sure that at least bytes unread bytes are buffered.  Returns false
+ * if the range ends first; that is only legal at a tuple boundary.
+ */
+bool TupleSpillFile::Reader::fill(size_t bytes)
+{
+    size_t buffered = m_bufferEnd - m_bufferStart;
+    if (buffered >= bytes) {
+        return true;
+    }
+    if (buffered == 0 && m_position == m_end) {
+        return false;
+    }
+    ::memmove(&m_buffer[0], &m_buffer[m_bufferStart], buffered);
+    m_bufferStart = 0;
+    m_bufferEnd = buffered;
+    if (m_buffer.size() < bytes) {
+        m_buffer.resize(bytes);
+    }
+    while (m_bufferEnd < bytes && m_position < m_end) {
+        size_t wanted = std::min(m_buffer.size() - m_bufferEnd,
+                                 static_cast<size_t>(m_end - m_position));
+        ssize_t got = ::pread(m_fd, &m_buffer[m_bufferEnd], wanted, m_position);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            throwSerializableEEException("Unable to read spill file: %s",
+                                         got < 0 ? ::strerror(errno) : "unexpected end of file");
+        }
+        m_bufferEnd += got;
+        m_position += got;
+    }
+    if (m_bufferEnd < bytes) {
+        throwSerializableEEException("Spill file is truncated");
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,116 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSTORETUPLESPILLFILE_H
+#define HSTORETUPLESPILLFILE_H
+
+#include "common/serializeio.h"
+#include "common/tabletuple.h"
+
+#include "boost/scoped_array.hpp"
+
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+class Pool;
+class TupleSchema;
+
+/**
+ * An unnamed scratch file of serialized tuples, used by executors that
+ * would otherwise exceed their TempTableLimits.
+ *
+ * Tuples are appended through a write buffer and read back in order,
+ * either all of them or a byte range recorded with size() between
+ * flushes.  The file lives in the scratch directory and is unlinked as
+ * soon as it is created, so it goes away with this object even if the
+ * query fails.  Nothing is created on disk until the first tuple is
+ * appended.
+ *
+ * Start the process with VOLTDB_SPILL_DIR naming a local directory to
+ * choose the scratch directory; otherwise it is $TMPDIR, or /tmp. If the
+ * file can't be created or written there, the query fails with the
+ * SQLException it would have hit without spilling, naming the directory.
+ */
+class TupleSpillFile {
+public:
+    TupleSpillFile(const TupleSchema* schema, size_t writeBufferSize);
+    ~TupleSpillFile();
+
+    void append(const TableTuple& tuple);
+
+    /** Write out anything still buffered */
+    void flush();
+
+    /** Bytes appended so far, including any still in the write buffer */
+    int64_t size() const { return m_fileSize + m_writeBuffer.position(); }
+
+    int64_t tupleCount() const { return m_tupleCount; }
+
+    const TupleSchema* schema() const { return m_schema; }
+
+    /** The directory that scratch files are created in */
+    static const std::string& scratchDirectory() { return s_scratchDirectory; }
+
+    static void setScratchDirectory(const std::string& directory) { s_scratchDirectory = directory; }
+
+    /**
+     * Reads back the tuples in a flushed byte range of the file, one at a
+     * time, into a private tuple.
+     */
+    class Reader {
+    public:
+        Reader(const TupleSpillFile& file, int64_t start, int64_t end);
+
+        /**
+         * Read the next tuple.  Non-inlined values are allocated from
+         * stringPool.  Returns false at the end of the range.
+         */
+        bool next(Pool* stringPool);
+
+        TableTuple& tuple() { return m_tuple; }
+
+    private:
+        bool fill(size_t bytes);
+
+        const int m_fd;
+        int64_t m_position;
+        const int64_t m_end;
+        std::vector<char> m_buffer;
+        size_t m_bufferStart;
+        size_t m_bufferEnd;
+        boost::scoped_array<char> m_tupleStorage;
+        TableTuple m_tuple;
+    };
+
+private:
+    void openFile();
+
+    const TupleSchema* m_schema;
+    const size_t m_writeBufferSize;
+    int m_fd;
+    int64_t m_fileSize;
+    int64_t m_tupleCount;
+    CopySerializeOutput m_writeBuffer;
+
+    static std::string s_scratchDirectory;
+};
+
+}
+
+#endif
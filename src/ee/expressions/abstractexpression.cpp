@@ -46,6 +46,8 @@
 #include "abstractexpression.h"
 
 #include "common/debuglog.h"
+#include "common/NValue.hpp"
+#include "common/tabletuple.h"
 #include "common/serializeio.h"
 #include "common/types.h"
 #include "expressions/expressionutil.h"
@@ -96,6 +98,27 @@ AbstractExpression::hasParameter() const
     return (m_right && m_right->hasParameter());
 }
 
+void
+AbstractExpression::filterBatch(const TableTuple *tuples, std::vector<int> &selection) const
+{
+    std::vector<int>::iterator kept = selection.begin();
+    for (std::vector<int>::const_iterator it = selection.begin(); it != selection.end(); ++it) {
+        if (eval(&tuples[*it], NULL).isTrue()) {
+            *kept++ = *it;
+        }
+    }
+    selection.erase(kept, selection.end());
+}
+
+void
+AbstractExpression::evalBatch(const TableTuple *tuples, const std::vector<int> &selection,
+                              NValue *results) const
+{
+    for (size_t ii = 0; ii < selection.size(); ++ii) {
+        results[ii] = eval(&tuples[selection[ii]], NULL);
+    }
+}
+
 bool
 AbstractExpression::initParamShortCircuits()
 {
@@ -73,6 +73,23 @@ class AbstractExpression {
 
     virtual NValue eval(const TableTuple *tuple1 = NULL, const TableTuple *tuple2 = NULL) const = 0;
 
+    /*
+     * Batch evaluation, for executors that apply the same expression to
+     * many tuples of one table.  Every tuple of the batch is a "tuple1";
+     * there is no "tuple2".  A selection holds the positions in the batch,
+     * in increasing order, of the tuples that are still of interest.
+     * The default implementations call eval() for each tuple; expression
+     * types that are common in scan predicates and projections override
+     * them to avoid a virtual call per node per tuple.
+     */
+
+    /** remove from selection the tuples for which this expression is not true */
+    virtual void filterBatch(const TableTuple *tuples, std::vector<int> &selection) const;
+
+    /** store the value for tuples[selection[i]] in results[i] */
+    virtual void evalBatch(const TableTuple *tuples, const std::vector<int> &selection,
+                           NValue *results) const;
+
     /** return true if self or descendent should be substitute()'d */
     virtual bool hasParameter() const;
 
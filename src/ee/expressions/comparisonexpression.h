@@ -47,16 +47,21 @@
 #define HSTORECOMPARISONEXPRESSION_H
 
 #include "common/common.h"
+#include "common/FixedWidthFilter.h"
 #include "common/serializeio.h"
 #include "common/valuevector.h"
+#include "common/ValuePeeker.hpp"
 
 #include "expressions/abstractexpression.h"
 #include "expressions/parametervalueexpression.h"
 #include "expressions/constantvalueexpression.h"
 #include "expressions/tuplevalueexpression.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <cassert>
+#include <cstring>
 
 namespace voltdb {
 
@@ -211,6 +216,52 @@ public:
     inline static bool isNullRejecting() { return true; }
 };
 
+// FixedWidthComparison<OP>::FILTER_OP is the FixedWidthFilter kernel that
+// does what OP::compare does for two non-null integer or timestamp NValues.
+// Batch filtering uses it to compare a column's storage directly.
+// Operators without a specialization here never take that path.
+template <typename OP>
+struct FixedWidthComparison {
+    static const bool supported = false;
+    static const FixedWidthFilter::Op FILTER_OP = FixedWidthFilter::EQ;
+};
+
+template <>
+struct FixedWidthComparison<CmpEq> {
+    static const bool supported = true;
+    static const FixedWidthFilter::Op FILTER_OP = FixedWidthFilter::EQ;
+};
+
+template <>
+struct FixedWidthComparison<CmpNe> {
+    static const bool supported = true;
+    static const FixedWidthFilter::Op FILTER_OP = FixedWidthFilter::NE;
+};
+
+template <>
+struct FixedWidthComparison<CmpLt> {
+    static const bool supported = true;
+    static const FixedWidthFilter::Op FILTER_OP = FixedWidthFilter::LT;
+};
+
+template <>
+struct FixedWidthComparison<CmpGt> {
+    static const bool supported = true;
+    static const FixedWidthFilter::Op FILTER_OP = FixedWidthFilter::GT;
+};
+
+template <>
+struct FixedWidthComparison<CmpLte> {
+    static const bool supported = true;
+    static const FixedWidthFilter::Op FILTER_OP = FixedWidthFilter::LTE;
+};
+
+template <>
+struct FixedWidthComparison<CmpGte> {
+    static const bool supported = true;
+    static const FixedWidthFilter::Op FILTER_OP = FixedWidthFilter::GTE;
+};
+
 template <typename OP>
 class ComparisonExpression : public AbstractExpression {
 public:
@@ -221,6 +272,18 @@ public:
     {
         m_left = left;
         m_right = right;
+        // Recognize "column <op> constant-or-parameter" for batch filtering.
+        m_batchColumn = NULL;
+        m_batchKernel = NULL;
+        if (FixedWidthComparison<OP>::supported &&
+            (dynamic_cast<ConstantValueExpression*>(right) != NULL ||
+             dynamic_cast<ParameterValueExpression*>(right) != NULL)) {
+            TupleValueExpression *column = dynamic_cast<TupleValueExpression*>(left);
+            if (column != NULL && column->getTupleId() == 0) {
+                m_batchColumn = column;
+                m_batchKernel = FixedWidthFilter::get(FixedWidthComparison<OP>::FILTER_OP);
+            }
+        }
     };
 
     inline NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const
@@ -255,6 +318,40 @@ public:
         return OP::compare(lnv, rnv);
     }
 
+    void filterBatch(const TableTuple *tuples, std::vector<int> &selection) const
+    {
+        if (selection.empty() || filterFixedWidthBatch(tuples, selection)) {
+            return;
+        }
+
+        // Evaluate the right side only for tuples whose left side is not NULL, like eval.
+        std::vector<NValue> lnvs(selection.size());
+        m_left->evalBatch(tuples, selection, &lnvs[0]);
+        size_t kept = 0;
+        for (size_t ii = 0; ii < selection.size(); ++ii) {
+            if ( ! (lnvs[ii].isNull() && OP::isNullRejecting())) {
+                selection[kept] = selection[ii];
+                lnvs[kept] = lnvs[ii];
+                ++kept;
+            }
+        }
+        selection.resize(kept);
+        if (selection.empty()) {
+            return;
+        }
+
+        std::vector<NValue> rnvs(selection.size());
+        m_right->evalBatch(tuples, selection, &rnvs[0]);
+        kept = 0;
+        for (size_t ii = 0; ii < selection.size(); ++ii) {
+            if ( ! (rnvs[ii].isNull() && OP::isNullRejecting()) &&
+                 OP::compare(lnvs[ii], rnvs[ii]).isTrue()) {
+                selection[kept++] = selection[ii];
+            }
+        }
+        selection.resize(kept);
+    }
+
     inline const char* traceEval(const TableTuple *tuple1, const TableTuple *tuple2) const
     {
         NValue lnv;
@@ -272,8 +369,95 @@ public:
     }
 
 private:
+    /**
+     * Filter a batch on an integer or timestamp column compared to an integer or
+     * timestamp constant, reading the column's storage without building NValues.
+     * Returns false, leaving the selection alone, if the comparison is not like that.
+     */
+    bool filterFixedWidthBatch(const TableTuple *tuples, std::vector<int> &selection) const
+    {
+        if (m_batchColumn == NULL) {
+            return false;
+        }
+        const TupleSchema::ColumnInfo *columnInfo =
+            tuples[selection[0]].getSchema()->getColumnInfo(m_batchColumn->getColumnId());
+        const NValue constant = m_right->eval(NULL, NULL);
+        if ( ! isFixedWidthIntegerType(columnInfo->getVoltType()) ||
+             ! isFixedWidthIntegerType(ValuePeeker::peekValueType(constant))) {
+            return false;
+        }
+        if (constant.isNull()) {
+            // every comparison with NULL is NULL
+            selection.clear();
+            return true;
+        }
+        const int64_t rhs = ValuePeeker::peekAsRawInt64(constant);
+        const uint32_t offset = TUPLE_HEADER_SIZE + columnInfo->offset;
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_TINYINT:
+            filterColumn<int8_t>(tuples, selection, offset, INT8_NULL, rhs);
+            break;
+        case VALUE_TYPE_SMALLINT:
+            filterColumn<int16_t>(tuples, selection, offset, INT16_NULL, rhs);
+            break;
+        case VALUE_TYPE_INTEGER:
+            filterColumn<int32_t>(tuples, selection, offset, INT32_NULL, rhs);
+            break;
+        default:
+            filterColumn<int64_t>(tuples, selection, offset, INT64_NULL, rhs);
+            break;
+        }
+        return true;
+    }
+
+    // Rows are stored whole, so copy a chunk of the column into an array at a
+    // time, widened to 64 bits, for the (possibly SIMD) kernel to compare.
+    template <typename T>
+    void filterColumn(const TableTuple *tuples, std::vector<int> &selection,
+                      uint32_t offset, T nullValue, int64_t rhs) const
+    {
+        int64_t values[FIXED_WIDTH_CHUNK_SIZE];
+        size_t kept = 0;
+        for (size_t start = 0; start < selection.size(); start += FIXED_WIDTH_CHUNK_SIZE) {
+            const size_t remaining = selection.size() - start;
+            const size_t count = remaining < FIXED_WIDTH_CHUNK_SIZE ? remaining : FIXED_WIDTH_CHUNK_SIZE;
+            for (size_t ii = 0; ii < count; ++ii) {
+                T value;
+                ::memcpy(&value, tuples[selection[start + ii]].address() + offset, sizeof(T));
+                values[ii] = value;
+            }
+            // The kernel moves the chunk's passing positions to the front of the chunk.
+            const size_t passed = m_batchKernel(values, &selection[start], count, rhs, nullValue);
+            std::copy(selection.begin() + start, selection.begin() + start + passed,
+                      selection.begin() + kept);
+            kept += passed;
+        }
+        selection.resize(kept);
+    }
+
+    static bool isFixedWidthIntegerType(ValueType type)
+    {
+        switch (type) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static const size_t FIXED_WIDTH_CHUNK_SIZE = 256;
+
     AbstractExpression *m_left;
     AbstractExpression *m_right;
+    // the column of a "column <op> constant" comparison that filterBatch can
+    // read directly, or NULL
+    const TupleValueExpression *m_batchColumn;
+    // the kernel for OP, when there is a m_batchColumn
+    FixedWidthFilter::Kernel m_batchKernel;
 };
 
 template <typename C, typename L, typename R>
@@ -52,7 +52,10 @@
 
 #include "expressions/abstractexpression.h"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
+#include <vector>
 
 namespace voltdb {
 
@@ -74,6 +77,8 @@ class ConjunctionExpression : public AbstractExpression
 
     NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const;
 
+    void filterBatch(const TableTuple *tuples, std::vector<int> &selection) const;
+
     std::string debugInfo(const std::string &spacer) const {
         return (spacer + "ConjunctionExpression\n");
     }
@@ -130,5 +135,40 @@ ConjunctionExpression<ConjunctionOr>::eval(const TableTuple *tuple1,
     return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
 }
 
+// A tuple passes AND only if it passes both sides,
+// so the right side only needs to see what passed the left.
+template<> inline void
+ConjunctionExpression<ConjunctionAnd>::filterBatch(const TableTuple *tuples,
+                                                   std::vector<int> &selection) const
+{
+    m_left->filterBatch(tuples, selection);
+    if ( ! selection.empty()) {
+        m_right->filterBatch(tuples, selection);
+    }
+}
+
+// A tuple passes OR if it passes either side,
+// so the right side only needs to see what failed the left.
+template<> inline void
+ConjunctionExpression<ConjunctionOr>::filterBatch(const TableTuple *tuples,
+                                                  std::vector<int> &selection) const
+{
+    std::vector<int> passedLeft(selection);
+    m_left->filterBatch(tuples, passedLeft);
+    if (passedLeft.size() == selection.size()) {
+        return;
+    }
+    std::vector<int> failedLeft;
+    failedLeft.reserve(selection.size() - passedLeft.size());
+    std::set_difference(selection.begin(), selection.end(),
+                        passedLeft.begin(), passedLeft.end(),
+                        std::back_inserter(failedLeft));
+    m_right->filterBatch(tuples, failedLeft);
+    selection.clear();
+    std::merge(passedLeft.begin(), passedLeft.end(),
+               failedLeft.begin(), failedLeft.end(),
+               std::back_inserter(selection));
+}
+
 }
 #endif
@@ -50,6 +50,7 @@
 
 #include "common/valuevector.h"
 
+#include <algorithm>
 #include <string>
 
 namespace voltdb {
@@ -73,6 +74,11 @@ class ConstantValueExpression : public AbstractExpression {
         return this->value;
     }
 
+    void evalBatch(const TableTuple *tuples, const std::vector<int> &selection, NValue *results) const
+    {
+        std::fill(results, results + selection.size(), this->value);
+    }
+
     std::string debugInfo(const std::string &spacer) const {
         return spacer + "OptimizedConstantValueExpression:" +
           value.debug() + "\n";
@@ -0,0 +1,461 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/expressioncompiler.h"
+
+#include "common/FixedWidthFilter.h"
+#include "common/ValuePeeker.hpp"
+#include "common/tabletuple.h"
+#include "expressions/comparisonexpression.h"
+#include "expressions/conjunctionexpression.h"
+#include "expressions/constantvalueexpression.h"
+#include "expressions/operatorexpression.h"
+#include "expressions/parametervalueexpression.h"
+#include "expressions/tuplevalueexpression.h"
+
+#include "boost/ptr_container/ptr_vector.hpp"
+#include "boost/scoped_ptr.hpp"
+
+#include <vector>
+
+namespace voltdb {
+
+namespace {
+
+enum CompiledTruth {
+    COMPILED_FALSE,
+    COMPILED_TRUE,
+    COMPILED_NULL,
+    // The tuple or a parameter does not have the types the test was compiled for
+    COMPILED_FALLBACK
+};
+
+bool isFixedWidthIntegerType(ValueType type)
+{
+    switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/** A boolean expression, reduced to a non-virtual test where possible */
+class CompiledTest {
+public:
+    virtual ~CompiledTest() { }
+    virtual CompiledTruth test(const TableTuple *tuple1, const TableTuple *tuple2) const = 0;
+};
+
+/** A term of a conjunction that has no specialization */
+class ExpressionTest : public CompiledTest {
+public:
+    ExpressionTest(const AbstractExpression *expression) : m_expression(expression) { }
+
+    CompiledTruth test(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        NValue result = m_expression->eval(tuple1, tuple2);
+        if (result.isNull()) {
+            return COMPILED_NULL;
+        }
+        return result.isTrue() ? COMPILED_TRUE : COMPILED_FALSE;
+    }
+
+private:
+    const AbstractExpression *m_expression;
+};
+
+template <FixedWidthFilter::Op OP>
+inline bool compareFixedWidth(int64_t lhs, int64_t rhs)
+{
+    switch (OP) {
+    case FixedWidthFilter::EQ:  return lhs == rhs;
+    case FixedWidthFilter::NE:  return lhs != rhs;
+    case FixedWidthFilter::LT:  return lhs < rhs;
+    case FixedWidthFilter::GT:  return lhs > rhs;
+    case FixedWidthFilter::LTE: return lhs <= rhs;
+    default:                    return lhs >= rhs;
+    }
+}
+
+/** The NULL value of a column stored as a T */
+template <typename T> struct FixedWidthNull;
+template <> struct FixedWidthNull<int8_t> { static int8_t value() { return INT8_NULL; } };
+template <> struct FixedWidthNull<int16_t> { static int16_t value() { return INT16_NULL; } };
+template <> struct FixedWidthNull<int32_t> { static int32_t value() { return INT32_NULL; } };
+template <> struct FixedWidthNull<int64_t> { static int64_t value() { return INT64_NULL; } };
+
+/**
+ * "column OP constant" or "column OP parameter", for a column stored as a T.
+ * A constant is converted once, here; a parameter is read for each tuple,
+ * since it changes from one execution of the plan to the next.
+ */
+template <FixedWidthFilter::Op OP, typename T>
+class ColumnTest : public CompiledTest {
+public:
+    ColumnTest(const TupleValueExpression *column, const NValue *parameter, const NValue &constant)
+        : m_tupleId(column->getTupleId())
+        , m_columnId(column->getColumnId())
+        , m_columnType(column->getValueType())
+        , m_parameter(parameter)
+        , m_constantIsNull(constant.isNull())
+        , m_constant(m_parameter != NULL || m_constantIsNull ? 0 : ValuePeeker::peekAsRawInt64(constant))
+    { }
+
+    CompiledTruth test(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        const TableTuple *tuple = m_tupleId == 0 ? tuple1 : tuple2;
+        if (tuple == NULL) {
+            return COMPILED_FALLBACK;
+        }
+        const TupleSchema::ColumnInfo *columnInfo = tuple->getSchema()->getColumnInfo(m_columnId);
+        if (columnInfo->getVoltType() != m_columnType) {
+            return COMPILED_FALLBACK;
+        }
+        const T value = *reinterpret_cast<const T*>(tuple->address() + TUPLE_HEADER_SIZE +
+                                                    columnInfo->offset);
+        if (value == FixedWidthNull<T>::value()) {
+            return COMPILED_NULL;
+        }
+
+        int64_t rhs = m_constant;
+        if (m_parameter != NULL) {
+            if (m_parameter->isNull()) {
+                return COMPILED_NULL;
+            }
+            if ( ! isFixedWidthIntegerType(ValuePeeker::peekValueType(*m_parameter))) {
+                return COMPILED_FALLBACK;
+            }
+            rhs = ValuePeeker::peekAsRawInt64(*m_parameter);
+        }
+        else if (m_constantIsNull) {
+            return COMPILED_NULL;
+        }
+        return compareFixedWidth<OP>(value, rhs) ? COMPILED_TRUE : COMPILED_FALSE;
+    }
+
+private:
+    const int m_tupleId;
+    const int m_columnId;
+    const ValueType m_columnType;
+    const NValue *m_parameter;
+    const bool m_constantIsNull;
+    const int64_t m_constant;
+};
+
+/** The terms of a chain of ANDs (IS_AND) or ORs, in the order the expression evaluates them */
+template <bool IS_AND>
+class ConjunctionTest : public CompiledTest {
+public:
+    void addTerm(CompiledTest *term) { m_terms.push_back(term); }
+
+    CompiledTruth test(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        // A FALSE term decides an AND and a TRUE term decides an OR;
+        // otherwise the result is NULL if any term is NULL.
+        const CompiledTruth deciding = IS_AND ? COMPILED_FALSE : COMPILED_TRUE;
+        CompiledTruth result = IS_AND ? COMPILED_TRUE : COMPILED_FALSE;
+        for (boost::ptr_vector<CompiledTest>::const_iterator it = m_terms.begin();
+             it != m_terms.end(); ++it) {
+            const CompiledTruth truth = it->test(tuple1, tuple2);
+            if (truth == deciding || truth == COMPILED_FALLBACK) {
+                return truth;
+            }
+            if (truth == COMPILED_NULL) {
+                result = COMPILED_NULL;
+            }
+        }
+        return result;
+    }
+
+private:
+    boost::ptr_vector<CompiledTest> m_terms;
+};
+
+NValue truthValue(CompiledTruth truth)
+{
+    switch (truth) {
+    case COMPILED_TRUE:
+        return NValue::getTrue();
+    case COMPILED_FALSE:
+        return NValue::getFalse();
+    default:
+        return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+    }
+}
+
+/** Base for the specialized expressions, which stand in for an original they do not own */
+class CompiledExpression : public AbstractExpression {
+public:
+    CompiledExpression(const AbstractExpression *original)
+        : AbstractExpression(original->getExpressionType())
+        , m_original(original)
+    {
+        setValueType(original->getValueType());
+        setValueSize(original->getValueSize());
+        setInBytes(original->getInBytes());
+    }
+
+    void filterBatch(const TableTuple *tuples, std::vector<int> &selection) const
+    {
+        m_original->filterBatch(tuples, selection);
+    }
+
+    void evalBatch(const TableTuple *tuples, const std::vector<int> &selection, NValue *results) const
+    {
+        m_original->evalBatch(tuples, selection, results);
+    }
+
+    bool hasParameter() const { return m_original->hasParameter(); }
+
+    std::string debugInfo(const std::string &spacer) const
+    {
+        return spacer + "CompiledExpression of\n" + m_original->debug(spacer);
+    }
+
+protected:
+    const AbstractExpression *m_original;
+};
+
+class CompiledPredicateExpression : public CompiledExpression {
+public:
+    CompiledPredicateExpression(const AbstractExpression *original, CompiledTest *test)
+        : CompiledExpression(original)
+        , m_test(test)
+    { }
+
+    NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        const CompiledTruth truth = m_test->test(tuple1, tuple2);
+        if (truth == COMPILED_FALLBACK) {
+            return m_original->eval(tuple1, tuple2);
+        }
+        return truthValue(truth);
+    }
+
+private:
+    boost::scoped_ptr<CompiledTest> m_test;
+};
+
+/** CASE WHEN <compiled test> THEN ... ELSE ..., either branch of which may itself be compiled */
+class CompiledCaseWhenExpression : public CompiledExpression {
+public:
+    CompiledCaseWhenExpression(const AbstractExpression *original, CompiledTest *when)
+        : CompiledExpression(original)
+        , m_when(when)
+        , m_compiledThen(ExpressionCompiler::compile(original->getRight()->getLeft()))
+        , m_compiledElse(ExpressionCompiler::compile(original->getRight()->getRight()))
+        , m_then(m_compiledThen ? m_compiledThen.get() : original->getRight()->getLeft())
+        , m_else(m_compiledElse ? m_compiledElse.get() : original->getRight()->getRight())
+    { }
+
+    NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        const CompiledTruth truth = m_when->test(tuple1, tuple2);
+        if (truth == COMPILED_FALLBACK) {
+            return m_original->eval(tuple1, tuple2);
+        }
+        const AbstractExpression *branch = truth == COMPILED_TRUE ? m_then : m_else;
+        return branch->eval(tuple1, tuple2).castAs(m_valueType);
+    }
+
+private:
+    boost::scoped_ptr<CompiledTest> m_when;
+    boost::scoped_ptr<AbstractExpression> m_compiledThen;
+    boost::scoped_ptr<AbstractExpression> m_compiledElse;
+    const AbstractExpression *m_then;
+    const AbstractExpression *m_else;
+};
+
+/** The FixedWidthFilter::Op of a comparison that can be specialized */
+bool fixedWidthOp(const AbstractExpression *expression, FixedWidthFilter::Op &op)
+{
+    if (dynamic_cast<const ComparisonExpression<CmpEq>*>(expression) != NULL) {
+        op = FixedWidthFilter::EQ;
+    }
+    else if (dynamic_cast<const ComparisonExpression<CmpNe>*>(expression) != NULL) {
+        op = FixedWidthFilter::NE;
+    }
+    else if (dynamic_cast<const ComparisonExpression<CmpLt>*>(expression) != NULL) {
+        op = FixedWidthFilter::LT;
+    }
+    else if (dynamic_cast<const ComparisonExpression<CmpGt>*>(expression) != NULL) {
+        op = FixedWidthFilter::GT;
+    }
+    else if (dynamic_cast<const ComparisonExpression<CmpLte>*>(expression) != NULL) {
+        op = FixedWidthFilter::LTE;
+    }
+    else if (dynamic_cast<const ComparisonExpression<CmpGte>*>(expression) != NULL) {
+        op = FixedWidthFilter::GTE;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/** The op that gives the same result with its operands swapped: "c < x" for "x > c" */
+FixedWidthFilter::Op reverseOp(FixedWidthFilter::Op op)
+{
+    switch (op) {
+    case FixedWidthFilter::LT:  return FixedWidthFilter::GT;
+    case FixedWidthFilter::GT:  return FixedWidthFilter::LT;
+    case FixedWidthFilter::LTE: return FixedWidthFilter::GTE;
+    case FixedWidthFilter::GTE: return FixedWidthFilter::LTE;
+    default:                    return op;
+    }
+}
+
+template <typename T>
+CompiledTest* newColumnTest(FixedWidthFilter::Op op, const TupleValueExpression *column,
+                            const NValue *parameter, const NValue &constant)
+{
+    switch (op) {
+    case FixedWidthFilter::EQ:
+        return new ColumnTest<FixedWidthFilter::EQ, T>(column, parameter, constant);
+    case FixedWidthFilter::NE:
+        return new ColumnTest<FixedWidthFilter::NE, T>(column, parameter, constant);
+    case FixedWidthFilter::LT:
+        return new ColumnTest<FixedWidthFilter::LT, T>(column, parameter, constant);
+    case FixedWidthFilter::GT:
+        return new ColumnTest<FixedWidthFilter::GT, T>(column, parameter, constant);
+    case FixedWidthFilter::LTE:
+        return new ColumnTest<FixedWidthFilter::LTE, T>(column, parameter, constant);
+    default:
+        return new ColumnTest<FixedWidthFilter::GTE, T>(column, parameter, constant);
+    }
+}
+
+CompiledTest* compileComparison(const AbstractExpression *expression)
+{
+    FixedWidthFilter::Op op;
+    if ( ! fixedWidthOp(expression, op)) {
+        return NULL;
+    }
+    const AbstractExpression *columnSide = expression->getLeft();
+    const AbstractExpression *valueSide = expression->getRight();
+    if (dynamic_cast<const TupleValueExpression*>(columnSide) == NULL) {
+        std::swap(columnSide, valueSide);
+        op = reverseOp(op);
+    }
+    const TupleValueExpression *column = dynamic_cast<const TupleValueExpression*>(columnSide);
+    if (column == NULL || ! isFixedWidthIntegerType(column->getValueType())) {
+        return NULL;
+    }
+
+    const NValue *parameter = NULL;
+    NValue constant = NValue::getNullValue(VALUE_TYPE_BIGINT);
+    if (dynamic_cast<const ParameterValueExpression*>(valueSide) != NULL) {
+        parameter = static_cast<const ParameterValueExpression*>(valueSide)->getParamValue();
+    }
+    else if (dynamic_cast<const ConstantValueExpression*>(valueSide) != NULL) {
+        constant = valueSide->eval(NULL, NULL);
+        if ( ! constant.isNull() && ! isFixedWidthIntegerType(ValuePeeker::peekValueType(constant))) {
+            return NULL;
+        }
+    }
+    else {
+        return NULL;
+    }
+
+    switch (column->getValueType()) {
+    case VALUE_TYPE_TINYINT:
+        return newColumnTest<int8_t>(op, column, parameter, constant);
+    case VALUE_TYPE_SMALLINT:
+        return newColumnTest<int16_t>(op, column, parameter, constant);
+    case VALUE_TYPE_INTEGER:
+        return newColumnTest<int32_t>(op, column, parameter, constant);
+    default:
+        return newColumnTest<int64_t>(op, column, parameter, constant);
+    }
+}
+
+CompiledTest* compileTest(const AbstractExpression *expression);
+
+/** Add the terms of a chain of the same conjunction to terms, in evaluation order */
+void collectTerms(const AbstractExpression *expression, ExpressionType type,
+                  std::vector<const AbstractExpression*> &terms)
+{
+    if (expression->getExpressionType() == type) {
+        collectTerms(expression->getLeft(), type, terms);
+        collectTerms(expression->getRight(), type, terms);
+    }
+    else {
+        terms.push_back(expression);
+    }
+}
+
+template <bool IS_AND>
+CompiledTest* compileConjunction(const AbstractExpression *expression)
+{
+    std::vector<const AbstractExpression*> terms;
+    collectTerms(expression, expression->getExpressionType(), terms);
+    std::vector<CompiledTest*> compiledTerms;
+    bool anyCompiled = false;
+    for (size_t ii = 0; ii < terms.size(); ++ii) {
+        CompiledTest *compiled = compileTest(terms[ii]);
+        anyCompiled = anyCompiled || compiled != NULL;
+        compiledTerms.push_back(compiled);
+    }
+    if ( ! anyCompiled) {
+        return NULL;
+    }
+    ConjunctionTest<IS_AND> *conjunction = new ConjunctionTest<IS_AND>();
+    for (size_t ii = 0; ii < terms.size(); ++ii) {
+        conjunction->addTerm(compiledTerms[ii] != NULL ? compiledTerms[ii] : new ExpressionTest(terms[ii]));
+    }
+    return conjunction;
+}
+
+CompiledTest* compileTest(const AbstractExpression *expression)
+{
+    switch (expression->getExpressionType()) {
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+        return compileConjunction<true>(expression);
+    case EXPRESSION_TYPE_CONJUNCTION_OR:
+        return compileConjunction<false>(expression);
+    default:
+        return compileComparison(expression);
+    }
+}
+
+} // namespace
+
+AbstractExpression* ExpressionCompiler::compile(const AbstractExpression* expression)
+{
+    if (expression == NULL || dynamic_cast<const CompiledExpression*>(expression) != NULL) {
+        return NULL;
+    }
+    if (expression->getExpressionType() == EXPRESSION_TYPE_OPERATOR_CASE_WHEN) {
+        CompiledTest *when = compileTest(expression->getLeft());
+        if (when == NULL) {
+            return NULL;
+        }
+        return new CompiledCaseWhenExpression(expression, when);
+    }
+    CompiledTest *test = compileTest(expression);
+    if (test == NULL) {
+        return NULL;
+    }
+    return new CompiledPredicateExpression(expression, test);
+}
+
+} // namespace voltdb
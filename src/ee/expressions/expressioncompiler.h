@@ -0,0 +1,53 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSTOREEXPRESSIONCOMPILER_H
+#define HSTOREEXPRESSIONCOMPILER_H
+
+namespace voltdb {
+
+class AbstractExpression;
+
+/**
+ * Specializes expressions of a few common shapes when a plan is loaded:
+ *
+ *   - an integer or timestamp column compared with a constant or parameter,
+ *   - ANDs and ORs that have such comparisons among their terms,
+ *   - CASE expressions whose WHEN conditions are any of these.
+ *
+ * A specialized comparison is a template instance for its operator and
+ * column width that reads the column's storage directly, instead of going
+ * through a virtual call per node and building an NValue for each side.
+ * If a tuple or parameter turns out not to have the types that the plan
+ * promised, it evaluates the original expression instead.
+ *
+ * Batch evaluation (filterBatch, evalBatch) is passed on to the original
+ * expression, which has its own vectorized implementations.
+ */
+class ExpressionCompiler {
+public:
+    /**
+     * Return a specialized version of expression, or NULL if it has none.
+     * The result refers to, but does not own, expression, which must
+     * outlive it.
+     */
+    static AbstractExpression* compile(const AbstractExpression* expression);
+};
+
+} // namespace voltdb
+
+#endif // HSTOREEXPRESSIONCOMPILER_H
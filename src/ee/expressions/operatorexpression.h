@@ -53,6 +53,7 @@
 #include "expressions/abstractexpression.h"
 
 #include <string>
+#include <vector>
 #include <cassert>
 
 namespace voltdb {
@@ -229,6 +230,23 @@ class OperatorExpression : public AbstractExpression {
                        m_right->eval(tuple1, tuple2));
     }
 
+    // Evaluate each side for the whole batch, then apply the operator
+    // in a loop that the compiler can inline.
+    void evalBatch(const TableTuple *tuples, const std::vector<int> &selection, NValue *results) const
+    {
+        assert(m_left);
+        assert(m_right);
+        if (selection.empty()) {
+            return;
+        }
+        std::vector<NValue> rnvs(selection.size());
+        m_left->evalBatch(tuples, selection, results);
+        m_right->evalBatch(tuples, selection, &rnvs[0]);
+        for (size_t ii = 0; ii < selection.size(); ++ii) {
+            results[ii] = oper.op(results[ii], rnvs[ii]);
+        }
+    }
+
     std::string debugInfo(const std::string &spacer) const {
         return (spacer + "OptimizedOperatorExpression");
     }
@@ -50,6 +50,7 @@
 
 #include "expressions/abstractexpression.h"
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -75,6 +76,11 @@ public:
         return *m_paramValue;
     }
 
+    void evalBatch(const TableTuple *tuples, const std::vector<int> &selection, NValue *results) const {
+        assert(m_paramValue != NULL);
+        std::fill(results, results + selection.size(), *m_paramValue);
+    }
+
     bool hasParameter() const {
         // this class represents a parameter.
         return true;
@@ -90,6 +96,11 @@ public:
         return this->m_valueIdx;
     }
 
+    // The engine's slot for this parameter, which each execution of the plan refills
+    const voltdb::NValue* getParamValue() const {
+        return m_paramValue;
+    }
+
   private:
     int m_valueIdx;
 
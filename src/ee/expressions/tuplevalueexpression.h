@@ -83,6 +83,17 @@ class TupleValueExpression : public AbstractExpression {
         }
     }
 
+    void evalBatch(const TableTuple *tuples, const std::vector<int> &selection, NValue *results) const {
+        if (tuple_idx != 0) {
+            throw SerializableEEException("TupleValueExpression::"
+                                          "evalBatch:"
+                                          " Batches have no tuple 2 (possible planning error)");
+        }
+        for (size_t ii = 0; ii < selection.size(); ++ii) {
+            results[ii] = tuples[selection[ii]].getNValue(value_idx);
+        }
+    }
+
     std::string debugInfo(const std::string &spacer) const {
         std::ostringstream buffer;
         buffer << spacer << "Optimized Column Reference[" << tuple_idx << ", " << value_idx << "]\n";
@@ -91,6 +102,8 @@ class TupleValueExpression : public AbstractExpression {
 
     int getColumnId() const {return this->value_idx;}
 
+    int getTupleId() const {return this->tuple_idx;}
+
   protected:
 
     const int tuple_idx;           // which tuple. defaults to tuple1
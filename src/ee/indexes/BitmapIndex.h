@@ -0,0 +1,229 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BITMAPINDEX_H_
+#define BITMAPINDEX_H_
+
+#include <cassert>
+#include <limits>
+#include "boost/unordered_map.hpp"
+#include "indexes/tableindex.h"
+#include "indexes/TupleSlotMap.h"
+#include "common/tabletuple.h"
+#include "structures/CompressedBitmap.h"
+
+namespace voltdb {
+
+/**
+ * Index implemented as a hash table from each distinct key to a compressed
+ * bitmap of the slots of the tuples with that key. Meant for non-unique
+ * keys with few distinct values, where a tree or hash multimap would keep
+ * long runs of entries per key. Lookups are by equality only.
+ *
+ * Tuple slots are positions in the table's blocks, numbered by the
+ * TupleSlotMap of the table.
+ * @see TableIndex
+ */
+template<typename KeyType>
+class BitmapIndex : public TableIndex
+{
+    typedef typename KeyType::KeyEqualityChecker KeyEqualityChecker;
+    typedef typename KeyType::KeyHasher KeyHasher;
+    typedef boost::unordered_map<KeyType, CompressedBitmap, KeyHasher, KeyEqualityChecker> MapType;
+    typedef typename MapType::iterator MapIterator;
+    typedef typename MapType::const_iterator MapConstIterator;
+
+    // The bitmap being visited and the slot of the cursor's m_match
+    struct SlotIterator {
+        const CompressedBitmap *m_bitmap;
+        uint32_t m_slot;
+    };
+
+    static SlotIterator& castToIter(IndexCursor& cursor) {
+        return *reinterpret_cast<SlotIterator*> (cursor.m_keyIter);
+    }
+
+    void addEntryDo(const TableTuple *tuple, TableTuple *conflictTuple)
+    {
+        ++m_inserts;
+        uint32_t slot;
+        if ( ! m_slots->slotOf(tuple->address(), slot)) {
+            throwFatalException("Tried to index a tuple outside the blocks of its table");
+        }
+        if (m_entries[setKeyFromTuple(tuple)].add(slot)) {
+            ++m_size;
+        }
+    }
+
+    bool deleteEntryDo(const TableTuple *tuple)
+    {
+        ++m_deletes;
+        MapIterator iter = m_entries.find(setKeyFromTuple(tuple));
+        uint32_t slot;
+        if (iter == m_entries.end() ||
+            ! m_slots->slotOf(tuple->address(), slot) ||
+            ! iter->second.remove(slot)) {
+            return false;
+        }
+        if (iter->second.empty()) {
+            m_entries.erase(iter);
+        }
+        --m_size;
+        return true;
+    }
+
+    /**
+     * Update in place an index entry with a new tuple address
+     */
+    bool replaceEntryNoKeyChangeDo(const TableTuple &destinationTuple, const TableTuple &originalTuple)
+    {
+        assert(originalTuple.address() != destinationTuple.address());
+
+        // The moved tuple's slot follows its new position.
+        MapIterator iter = m_entries.find(setKeyFromTuple(&destinationTuple));
+        uint32_t originalSlot;
+        uint32_t destinationSlot;
+        if (iter == m_entries.end() ||
+            ! m_slots->slotOf(originalTuple.address(), originalSlot) ||
+            ! m_slots->slotOf(destinationTuple.address(), destinationSlot) ||
+            ! iter->second.remove(originalSlot)) {
+            return false;
+        }
+        iter->second.add(destinationSlot);
+        m_updates++;
+        return true;
+    }
+
+    bool keyUsesNonInlinedMemory() const { return KeyType::keyUsesNonInlinedMemory(); }
+
+    bool checkForIndexChangeDo(const TableTuple *lhs, const TableTuple *rhs) const {
+        return !(m_eq(setKeyFromTuple(lhs), setKeyFromTuple(rhs)));
+    }
+
+    bool existsDo(const TableTuple *persistentTuple) const {
+        MapConstIterator iter = m_entries.find(setKeyFromTuple(persistentTuple));
+        uint32_t slot;
+        return iter != m_entries.end() &&
+               m_slots->slotOf(persistentTuple->address(), slot) &&
+               iter->second.contains(slot);
+    }
+
+    bool moveToKey(const TableTuple *searchKey, IndexCursor& cursor) const {
+        return moveToBitmap(m_entries.find(KeyType(searchKey)), cursor);
+    }
+
+    bool moveToKeyByTuple(const TableTuple *persistentTuple, IndexCursor &cursor) const {
+        return moveToBitmap(m_entries.find(setKeyFromTuple(persistentTuple)), cursor);
+    }
+
+    TableTuple nextValueAtKey(IndexCursor& cursor) const {
+        if (cursor.m_match.isNullTuple()) {
+            return cursor.m_match;
+        }
+        TableTuple retval = cursor.m_match;
+
+        SlotIterator &slotIter = castToIter(cursor);
+        if (slotIter.m_slot == std::numeric_limits<uint32_t>::max()) {
+            cursor.m_match.move(NULL);
+        } else {
+            ++slotIter.m_slot;
+            moveToSlot(cursor);
+        }
+        return retval;
+    }
+
+    bool hasKey(const TableTuple *searchKey) const {
+        return m_entries.find(KeyType(searchKey)) != m_entries.end();
+    }
+
+    const TupleSlotMap* getTupleSlotMap() const { return m_slots; }
+
+    bool usesTupleSlots() const { return true; }
+
+    void setTupleSlotMap(const TupleSlotMap *slots) {
+        assert(m_size == 0);
+        m_slots = slots;
+    }
+
+    size_t getSize() const { return m_size; }
+
+    int64_t getMemoryEstimate() const
+    {
+        int64_t bytes = m_entries.bucket_count() * sizeof(void*) +
+                        m_entries.size() * (sizeof(typename MapType::value_type) + sizeof(void*));
+        for (MapConstIterator iter = m_entries.begin(); iter != m_entries.end(); ++iter) {
+            bytes += iter->second.getMemoryEstimate();
+        }
+        return bytes;
+    }
+
+    std::string getTypeName() const { return "BitmapIndex"; };
+
+    // Non-virtual (so "really-private") helper methods.
+    bool moveToBitmap(MapConstIterator iter, IndexCursor& cursor) const
+    {
+        if (iter == m_entries.end()) {
+            cursor.m_match.move(NULL);
+            return false;
+        }
+        SlotIterator &slotIter = castToIter(cursor);
+        slotIter.m_bitmap = &iter->second;
+        slotIter.m_slot = 0;
+        return moveToSlot(cursor);
+    }
+
+    // Moves m_match to the first tuple at or after the cursor's slot
+    bool moveToSlot(IndexCursor& cursor) const
+    {
+        SlotIterator &slotIter = castToIter(cursor);
+        if ( ! slotIter.m_bitmap->nextSlot(slotIter.m_slot, slotIter.m_slot)) {
+            cursor.m_match.move(NULL);
+            return false;
+        }
+        cursor.m_match.move(m_slots->addressOf(slotIter.m_slot));
+        return true;
+    }
+
+    const KeyType setKeyFromTuple(const TableTuple *tuple) const
+    {
+        KeyType result(tuple, m_scheme.columnIndices, m_scheme.indexedExpressions, m_keySchema);
+        return result;
+    }
+
+    MapType m_entries;
+    // The table's numbering of its tuples
+    const TupleSlotMap *m_slots;
+    // The number of indexed tuples
+    size_t m_size;
+
+    // comparison stuff
+    KeyEqualityChecker m_eq;
+
+public:
+    BitmapIndex(const TupleSchema *keySchema, const TableIndexScheme &scheme) :
+        TableIndex(keySchema, scheme),
+        m_entries(16, KeyHasher(keySchema), KeyEqualityChecker(keySchema)),
+        m_slots(NULL),
+        m_size(0),
+        m_eq(keySchema)
+    {}
+
+};
+
+}
+
+#endif // BITMAPINDEX_H_
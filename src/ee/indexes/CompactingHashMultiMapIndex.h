@@ -167,6 +167,8 @@ class CompactingHashMultiMapIndex : public TableIndex
 
     size_t getSize() const { return m_entries.size(); }
 
+    void ensureCapacity(uint32_t capacity) { m_entries.reserve(capacity); }
+
     int64_t getMemoryEstimate() const
     {
         return m_entries.bytesAllocated();
@@ -51,19 +51,26 @@
 #include "indexes/tableindex.h"
 #include "common/tabletuple.h"
 #include "structures/CompactingMap.h"
+#include "structures/CompactingBTree.h"
+
+#include "boost/type_traits/conditional.hpp"
 
 namespace voltdb {
 
 /**
  * Index implemented as a Binary Tree Multimap.
+ * With useBTree, the entries are kept in a CompactingBTree instead of
+ * the CompactingMap red-black tree.
  * @see TableIndex
  */
-template<typename KeyValuePair, bool hasRank>
+template<typename KeyValuePair, bool hasRank, bool useBTree = false>
 class CompactingTreeMultiMapIndex : public TableIndex
 {
     typedef typename KeyValuePair::first_type KeyType;
     typedef typename KeyType::KeyComparator KeyComparator;
-    typedef CompactingMap<KeyValuePair, KeyComparator, hasRank> MapType;
+    typedef typename boost::conditional<useBTree,
+                                        CompactingBTree<KeyValuePair, KeyComparator, hasRank>,
+                                        CompactingMap<KeyValuePair, KeyComparator, hasRank> >::type MapType;
     typedef typename MapType::iterator MapIterator;
     typedef std::pair<MapIterator, MapIterator> MapRange;
 
@@ -83,6 +90,18 @@ class CompactingTreeMultiMapIndex : public TableIndex
         m_entries.insert(setKeyFromTuple(tuple), tuple->address());
     }
 
+    void addEntriesDo(const std::vector<char*> &tupleAddresses)
+    {
+        std::vector<KeyValuePair> entries;
+        entries.reserve(tupleAddresses.size());
+        TableTuple tuple(getTupleSchema());
+        for (int i = 0; i < tupleAddresses.size(); ++i) {
+            tuple.move(tupleAddresses[i]);
+            entries.push_back(KeyValuePair(setKeyFromTuple(&tuple), tupleAddresses[i]));
+        }
+        m_inserts += static_cast<int>(m_entries.bulkInsert(entries));
+    }
+
     bool deleteEntryDo(const TableTuple *tuple)
     {
         ++m_deletes;
@@ -342,6 +361,37 @@ class CompactingTreeMultiMapIndex : public TableIndex
         }
     }
 
+    /**
+     * @See comments in parent class TableIndex
+     */
+    void skipEntries(int64_t skip, bool atKey, IndexCursor& cursor) const {
+        if (!hasRank) {
+            throwFatalException("Invoked skipEntries on a non-countable index");
+        }
+        MapIterator &mapIter = castToIter(cursor);
+        if (mapIter.isEnd() || skip <= 0) {
+            return;
+        }
+        if (atKey) {
+            if (cursor.m_match.isNullTuple()) {
+                return;
+            }
+            MapIterator &mapEndIter = castToEndIter(cursor);
+            const int64_t endRank = mapEndIter.isEnd() ? m_entries.size() + 1 : m_entries.rankOf(mapEndIter);
+            const int64_t rank = m_entries.rankOf(mapIter) + skip;
+            if (rank >= endRank) {
+                mapIter = mapEndIter;
+                cursor.m_match.move(NULL);
+            } else {
+                mapIter = m_entries.findRank(rank);
+                cursor.m_match.move(const_cast<void*>(mapIter.value()));
+            }
+            return;
+        }
+        const int64_t rank = m_entries.rankOf(mapIter);
+        mapIter = m_entries.findRank(cursor.m_forward ? rank + skip : rank - skip);
+    }
+
     size_t getSize() const { return m_entries.size(); }
 
     int64_t getMemoryEstimate() const
@@ -364,7 +414,7 @@ class CompactingTreeMultiMapIndex : public TableIndex
         return (ret);
     }
 
-    std::string getTypeName() const { return "CompactingTreeMultiMapIndex"; };
+    std::string getTypeName() const { return useBTree ? "CompactingBTreeMultiMapIndex" : "CompactingTreeMultiMapIndex"; };
 
     MapIterator findKey(const TableTuple *searchKey) const {
         KeyType tempKey(searchKey);
@@ -53,19 +53,26 @@
 #include "common/tabletuple.h"
 #include "indexes/tableindex.h"
 #include "structures/CompactingMap.h"
+#include "structures/CompactingBTree.h"
+
+#include "boost/type_traits/conditional.hpp"
 
 namespace voltdb {
 
 /**
  * Index implemented as a Binary Tree Unique Map.
+ * With useBTree, the entries are kept in a CompactingBTree instead of
+ * the CompactingMap red-black tree.
  * @see TableIndex
  */
-template<typename KeyValuePair, bool hasRank>
+template<typename KeyValuePair, bool hasRank, bool useBTree = false>
 class CompactingTreeUniqueIndex : public TableIndex
 {
     typedef typename KeyValuePair::first_type KeyType;
     typedef typename KeyType::KeyComparator KeyComparator;
-    typedef CompactingMap<KeyValuePair, KeyComparator, hasRank> MapType;
+    typedef typename boost::conditional<useBTree,
+                                        CompactingBTree<KeyValuePair, KeyComparator, hasRank>,
+                                        CompactingMap<KeyValuePair, KeyComparator, hasRank> >::type MapType;
     typedef typename MapType::iterator MapIterator;
 
     ~CompactingTreeUniqueIndex() {};
@@ -83,6 +90,18 @@ class CompactingTreeUniqueIndex : public TableIndex
         }
     }
 
+    void addEntriesDo(const std::vector<char*> &tupleAddresses)
+    {
+        std::vector<KeyValuePair> entries;
+        entries.reserve(tupleAddresses.size());
+        TableTuple tuple(getTupleSchema());
+        for (int i = 0; i < tupleAddresses.size(); ++i) {
+            tuple.move(tupleAddresses[i]);
+            entries.push_back(KeyValuePair(setKeyFromTuple(&tuple), tupleAddresses[i]));
+        }
+        m_inserts += static_cast<int>(m_entries.bulkInsert(entries));
+    }
+
     bool deleteEntryDo(const TableTuple *tuple)
     {
         ++m_deletes;
@@ -328,6 +347,29 @@ class CompactingTreeUniqueIndex : public TableIndex
         return m_entries.rankAsc(mapIter.key());
     }
 
+    /**
+     * @See comments in parent class TableIndex
+     */
+    void skipEntries(int64_t skip, bool atKey, IndexCursor& cursor) const {
+        if (!hasRank) {
+            throwFatalException("Invoked skipEntries on a non-countable index");
+        }
+        if (skip <= 0) {
+            return;
+        }
+        if (atKey) {
+            // At most one entry matches a unique key.
+            cursor.m_match.move(NULL);
+            return;
+        }
+        MapIterator &mapIter = castToIter(cursor);
+        if (mapIter.isEnd()) {
+            return;
+        }
+        const int64_t rank = m_entries.rankOf(mapIter);
+        mapIter = m_entries.findRank(cursor.m_forward ? rank + skip : rank - skip);
+    }
+
     size_t getSize() const { return m_entries.size(); }
 
     int64_t getMemoryEstimate() const
@@ -350,11 +392,11 @@ class CompactingTreeUniqueIndex : public TableIndex
         return (ret);
     }
 
-    std::string getTypeName() const { return "CompactingTreeUniqueIndex"; };
+    std::string getTypeName() const { return useBTree ? "CompactingBTreeUniqueIndex" : "CompactingTreeUniqueIndex"; };
 
     virtual TableIndex *cloneEmptyNonCountingTreeIndex() const
     {
-        return new CompactingTreeUniqueIndex<KeyValuePair, false >(TupleSchema::createTupleSchema(getKeySchema()), m_scheme);
+        return new CompactingTreeUniqueIndex<KeyValuePair, false, useBTree>(TupleSchema::createTupleSchema(getKeySchema()), m_scheme);
     }
 
 
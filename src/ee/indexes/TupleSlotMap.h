@@ -0,0 +1,121 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TUPLESLOTMAP_H_
+#define TUPLESLOTMAP_H_
+
+#include <cassert>
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Numbers the tuples of a table for its bitmap indexes, which keep sets of
+ * these slot numbers instead of tuple addresses. A tuple's slot is its
+ * position in the table's blocks: the number of its block times the most
+ * tuples a block holds, plus its offset in the block. PersistentTable
+ * numbers its blocks as it allocates and frees them, and freed numbers are
+ * reused first, which keeps the slots dense.
+ *
+ * Slots take no space per tuple, and all the bitmap indexes of a table
+ * share them, so the sets found by different indexes can be combined. A
+ * tuple that compaction moves gets a new slot, which each bitmap index
+ * remaps as the move is reported (see TableIndex::replaceEntryNoKeyChange).
+ */
+class TupleSlotMap {
+public:
+    TupleSlotMap(uint32_t tupleLength, uint32_t tuplesPerBlock)
+        : m_tupleLength(tupleLength), m_tuplesPerBlock(tuplesPerBlock)
+    {}
+
+    /** Numbers a block whose tuples start at storage */
+    void addBlock(char *storage)
+    {
+        uint32_t number;
+        if (m_freeNumbers.empty()) {
+            number = static_cast<uint32_t>(m_blocks.size());
+            m_blocks.push_back(storage);
+        }
+        else {
+            number = m_freeNumbers.back();
+            m_freeNumbers.pop_back();
+            m_blocks[number] = storage;
+        }
+        assert((static_cast<uint64_t>(number) + 1) * m_tuplesPerBlock <= UINT32_MAX);
+        m_numbersByStorage.insert(std::make_pair(storage, number));
+    }
+
+    /** Frees the number of a block that holds no more tuples */
+    void removeBlock(char *storage)
+    {
+        NumbersByStorage::iterator iter = m_numbersByStorage.find(storage);
+        assert(iter != m_numbersByStorage.end());
+        m_blocks[iter->second] = NULL;
+        m_freeNumbers.push_back(iter->second);
+        m_numbersByStorage.erase(iter);
+    }
+
+    /** @return false if the address is in none of the blocks. */
+    bool slotOf(const void *address, uint32_t &slot) const
+    {
+        const char *tuple = static_cast<const char*>(address);
+        NumbersByStorage::const_iterator iter = m_numbersByStorage.upper_bound(tuple);
+        if (iter == m_numbersByStorage.begin()) {
+            return false;
+        }
+        --iter;
+        uint64_t offset = (tuple - iter->first) / m_tupleLength;
+        if (offset >= m_tuplesPerBlock) {
+            return false;
+        }
+        slot = iter->second * m_tuplesPerBlock + static_cast<uint32_t>(offset);
+        return true;
+    }
+
+    void *addressOf(uint32_t slot) const
+    {
+        assert(slot / m_tuplesPerBlock < m_blocks.size() && m_blocks[slot / m_tuplesPerBlock] != NULL);
+        return m_blocks[slot / m_tuplesPerBlock] + static_cast<uint64_t>(slot % m_tuplesPerBlock) * m_tupleLength;
+    }
+
+    /** The number of blocks numbered */
+    size_t blockCount() const { return m_numbersByStorage.size(); }
+
+    int64_t getMemoryEstimate() const
+    {
+        // About a tree node of five words per block
+        return m_numbersByStorage.size() * 5 * sizeof(void*) +
+               m_blocks.capacity() * sizeof(char*) +
+               m_freeNumbers.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    typedef std::map<const char*, uint32_t> NumbersByStorage;
+
+    const uint32_t m_tupleLength;
+    const uint32_t m_tuplesPerBlock;
+    NumbersByStorage m_numbersByStorage;
+    // The storage of each numbered block, or NULL for a free number
+    std::vector<char*> m_blocks;
+    std::vector<uint32_t> m_freeNumbers;
+};
+
+} // namespace voltdb
+
+#endif // TUPLESLOTMAP_H_
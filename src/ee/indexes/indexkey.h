@@ -644,6 +644,286 @@ private:
     const TupleSchema *m_keySchema;
 };
 
+template <std::size_t keySize> struct NormalizedEqualityChecker;
+template <std::size_t keySize> struct NormalizedComparator;
+template <std::size_t keySize> struct NormalizedHasher;
+
+/**
+ * Order-preserving byte encoding of index key values. Each key column is
+ * encoded at a fixed offset so that comparing two encoded keys with memcmp
+ * gives the same result as comparing the key tuples column by column
+ * with NValue::compare:
+ *
+ *   integers and timestamps   big-endian with the sign bit flipped (their
+ *                             NULL sentinel is the type minimum, so it sorts first)
+ *   DECIMAL                   the 128-bit value big-endian, sign bit flipped
+ *   DOUBLE                    a NULL byte, then the IEEE bits flipped so that
+ *                             negatives sort before positives; NaN sorts
+ *                             below every other value and -0.0 equals 0.0
+ *   VARCHAR and VARBINARY     a NULL byte, the bytes zero-padded to the
+ *                             column's maximum byte length, then the
+ *                             big-endian length. VARCHAR stops copying at
+ *                             an embedded zero byte, matching the strncmp
+ *                             NValue uses to compare strings.
+ *
+ * Columns of other types (BOOLEAN, geospatial) are not supported.
+ */
+struct NormalizedKeyEncoding
+{
+    /** Bytes needed to encode a column, or -1 if its type is not supported */
+    static inline int32_t columnLength(const TupleSchema::ColumnInfo *columnInfo) {
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_TINYINT:
+            return 1;
+        case VALUE_TYPE_SMALLINT:
+            return 2;
+        case VALUE_TYPE_INTEGER:
+            return 4;
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            return 8;
+        case VALUE_TYPE_DOUBLE:
+            return 1 + 8;
+        case VALUE_TYPE_DECIMAL:
+            return 16;
+        case VALUE_TYPE_VARCHAR:
+        case VALUE_TYPE_VARBINARY: {
+            const int32_t maxBytes = maxObjectLength(columnInfo);
+            return 1 + maxBytes + lengthSuffixSize(maxBytes);
+        }
+        default:
+            return -1;
+        }
+    }
+
+    /** Bytes needed to encode a whole key, or -1 if any column is not supported */
+    static inline int32_t keyLength(const TupleSchema *keySchema) {
+        int32_t length = 0;
+        for (int ii = 0; ii < keySchema->columnCount(); ++ii) {
+            const int32_t columnBytes = columnLength(keySchema->getColumnInfo(ii));
+            if (columnBytes < 0) {
+                return -1;
+            }
+            length += columnBytes;
+        }
+        return length;
+    }
+
+    /** Encode one key column value at out, returning the position of the next column */
+    static inline char *encode(char *out, const NValue &value, const TupleSchema::ColumnInfo *columnInfo) {
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_TINYINT:
+            return storeSigned(out, ValuePeeker::peekTinyInt(value), 1);
+        case VALUE_TYPE_SMALLINT:
+            return storeSigned(out, ValuePeeker::peekSmallInt(value), 2);
+        case VALUE_TYPE_INTEGER:
+            return storeSigned(out, ValuePeeker::peekInteger(value), 4);
+        case VALUE_TYPE_BIGINT:
+            return storeSigned(out, ValuePeeker::peekBigInt(value), 8);
+        case VALUE_TYPE_TIMESTAMP:
+            return storeSigned(out, ValuePeeker::peekTimestamp(value), 8);
+        case VALUE_TYPE_DECIMAL: {
+            const TTInt decimal = ValuePeeker::peekDecimal(value);
+            out = storeBigEndian(out, decimal.table[1] ^ (1ULL << 63), 8);
+            return storeBigEndian(out, decimal.table[0], 8);
+        }
+        case VALUE_TYPE_DOUBLE: {
+            // Anything at or below DOUBLE_NULL reads back from a tuple as NULL.
+            const double doubleValue = value.isNull() ? DOUBLE_NULL : ValuePeeker::peekDouble(value);
+            if (doubleValue <= DOUBLE_NULL) {
+                ::memset(out, 0, 1 + 8);
+                return out + 1 + 8;
+            }
+            *out++ = 1;
+            if (std::isnan(doubleValue)) {
+                return storeBigEndian(out, 0, 8);
+            }
+            uint64_t bits;
+            const double canonical = doubleValue == 0.0 ? 0.0 : doubleValue;
+            ::memcpy(&bits, &canonical, sizeof(bits));
+            bits = (bits & (1ULL << 63)) ? ~bits : (bits | (1ULL << 63));
+            return storeBigEndian(out, bits, 8);
+        }
+        case VALUE_TYPE_VARCHAR:
+        case VALUE_TYPE_VARBINARY: {
+            const int32_t maxBytes = maxObjectLength(columnInfo);
+            const int32_t suffixSize = lengthSuffixSize(maxBytes);
+            if (value.isNull()) {
+                ::memset(out, 0, 1 + maxBytes + suffixSize);
+                return out + 1 + maxBytes + suffixSize;
+            }
+            *out++ = 1;
+            int32_t length;
+            const char *bytes = ValuePeeker::peekObject_withoutNull(value, &length);
+            if (length > maxBytes) {
+                throwFatalException("Index key value of %d bytes does not fit the %d byte key column",
+                                    length, maxBytes);
+            }
+            int32_t copied = length;
+            if (columnInfo->getVoltType() == VALUE_TYPE_VARCHAR) {
+                const void *zero = ::memchr(bytes, 0, length);
+                if (zero != NULL) {
+                    copied = static_cast<int32_t>(static_cast<const char*>(zero) - bytes);
+                }
+            }
+            ::memcpy(out, bytes, copied);
+            ::memset(out + copied, 0, maxBytes - copied);
+            return storeBigEndian(out + maxBytes, static_cast<uint64_t>(length), suffixSize);
+        }
+        default:
+            throwFatalException("Normalized index keys do not support column type %s",
+                                getTypeName(columnInfo->getVoltType()).c_str());
+        }
+        return out;
+    }
+
+private:
+    static inline int32_t maxObjectLength(const TupleSchema::ColumnInfo *columnInfo) {
+        if (columnInfo->getVoltType() == VALUE_TYPE_VARCHAR && ! columnInfo->inBytes) {
+            return static_cast<int32_t>(columnInfo->length) * MAX_BYTES_PER_UTF8_CHARACTER;
+        }
+        return static_cast<int32_t>(columnInfo->length);
+    }
+
+    static inline int32_t lengthSuffixSize(int32_t maxBytes) {
+        if (maxBytes <= UINT8_MAX) {
+            return 1;
+        }
+        return maxBytes <= UINT16_MAX ? 2 : 4;
+    }
+
+    static inline char *storeSigned(char *out, int64_t value, int bytes) {
+        const uint64_t signBit = 1ULL << (bytes * 8 - 1);
+        return storeBigEndian(out, static_cast<uint64_t>(value) ^ signBit, bytes);
+    }
+
+    static inline char *storeBigEndian(char *out, uint64_t value, int bytes) {
+        for (int ii = bytes - 1; ii >= 0; ii--) {
+            out[ii] = static_cast<char>(value & 0xFF);
+            value >>= 8;
+        }
+        return out + bytes;
+    }
+};
+
+/**
+ * Key object for indexes of mixed types that stores each key as an
+ * order-preserving byte string (see NormalizedKeyEncoding), so keys
+ * compare with a single memcmp instead of decoding NValues column by
+ * column. The values are copied into the key, so it never refers to
+ * out-of-line storage.
+ */
+template <std::size_t keySize>
+struct NormalizedKey
+{
+    typedef NormalizedEqualityChecker<keySize> KeyEqualityChecker;
+    typedef NormalizedComparator<keySize> KeyComparator;
+    typedef NormalizedHasher<keySize> KeyHasher;
+
+    static inline bool keyDependsOnTupleAddress() { return false; }
+    static inline bool keyUsesNonInlinedMemory() { return false; }
+
+    NormalizedKey() {
+        ::memset(data, 0, keySize * sizeof(char));
+    }
+
+    // Set a key from a key-schema tuple.
+    NormalizedKey(const TableTuple *tuple) {
+        assert(tuple);
+        const TupleSchema *keySchema = tuple->getSchema();
+        char *out = data;
+        const int columnCount = keySchema->columnCount();
+        for (int ii = 0; ii < columnCount; ++ii) {
+            out = NormalizedKeyEncoding::encode(out, tuple->getNValue(ii), keySchema->getColumnInfo(ii));
+        }
+        assert(out <= data + keySize);
+    }
+
+    // Set a key from a table-schema tuple.
+    NormalizedKey(const TableTuple *tuple, const std::vector<int> &indices,
+                  const std::vector<AbstractExpression*> &indexed_expressions, const TupleSchema *keySchema) {
+        assert(tuple);
+        char *out = data;
+        const int columnCount = keySchema->columnCount();
+        if (indexed_expressions.size() > 0) {
+            for (int ii = 0; ii < columnCount; ++ii) {
+                const TupleSchema::ColumnInfo *columnInfo = keySchema->getColumnInfo(ii);
+                NValue value = indexed_expressions[ii]->eval(tuple, NULL);
+                if (ValuePeeker::peekValueType(value) != columnInfo->getVoltType()) {
+                    value = value.castAs(columnInfo->getVoltType());
+                }
+                out = NormalizedKeyEncoding::encode(out, value, columnInfo);
+            }
+        } else {
+            for (int ii = 0; ii < columnCount; ++ii) {
+                out = NormalizedKeyEncoding::encode(out, tuple->getNValue(indices[ii]), keySchema->getColumnInfo(ii));
+            }
+        }
+        assert(out <= data + keySize);
+    }
+
+    // actual location of data
+    char data[keySize];
+};
+
+/**
+ * Function object returns -1/0/1 if lhs </==/> rhs.
+ * Required by CompactingMap keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedComparator
+{
+    /** Only the encoded prefix of the key is compared */
+    NormalizedComparator(const TupleSchema *keySchema)
+        : m_keyLength(NormalizedKeyEncoding::keyLength(keySchema))
+    {
+        assert(m_keyLength > 0 && m_keyLength <= static_cast<int32_t>(keySize));
+    }
+
+    inline int operator()(const NormalizedKey<keySize> &lhs, const NormalizedKey<keySize> &rhs) const {
+        const int result = ::memcmp(lhs.data, rhs.data, m_keyLength);
+        if (result < 0) return -1;
+        return result > 0 ? 1 : 0;
+    }
+private:
+    const int32_t m_keyLength;
+};
+
+/**
+ * Equality-checking function object
+ * Required by CompactingHashTable keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedEqualityChecker
+{
+    NormalizedEqualityChecker(const TupleSchema *keySchema)
+        : m_keyLength(NormalizedKeyEncoding::keyLength(keySchema)) {}
+
+    inline bool operator()(const NormalizedKey<keySize> &lhs, const NormalizedKey<keySize> &rhs) const {
+        return ::memcmp(lhs.data, rhs.data, m_keyLength) == 0;
+    }
+private:
+    const int32_t m_keyLength;
+};
+
+/**
+ * Hash function object for Normalized Keys.
+ * Required by CompactingHashTable keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedHasher
+{
+    NormalizedHasher(const TupleSchema *keySchema)
+        : m_keyLength(NormalizedKeyEncoding::keyLength(keySchema)) {}
+
+    inline size_t operator()(NormalizedKey<keySize> const &p) const
+    {
+        return boost::hash_range(p.data, p.data + m_keyLength);
+    }
+private:
+    const int32_t m_keyLength;
+};
+
 struct TupleKeyComparator;
 
 /*
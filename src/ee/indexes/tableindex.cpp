@@ -47,6 +47,8 @@
 #include "indexes/tableindex.h"
 #include "expressions/abstractexpression.h"
 #include "expressions/expressionutil.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "storage/TableCatalogDelegate.hpp"
 
 using namespace voltdb;
@@ -104,6 +106,70 @@ TableIndex::~TableIndex()
     delete getPredicate();
 }
 
+void TableIndex::copyKeyPrefix(const TableTuple &tuple, int prefixLength, TableTuple &keyTuple) const
+{
+    const std::vector<AbstractExpression*> &indexed_expressions = getIndexedExpressions();
+    for (int ii = 0; ii < prefixLength; ++ii) {
+        if (indexed_expressions.size() > 0) {
+            NValue value = indexed_expressions[ii]->eval(&tuple, NULL);
+            const ValueType keyType = m_keySchema->columnType(ii);
+            if (ValuePeeker::peekValueType(value) != keyType) {
+                value = value.castAs(keyType);
+            }
+            keyTuple.setNValue(ii, value);
+        } else {
+            keyTuple.setNValue(ii, tuple.getNValue(getColumnIndices()[ii]));
+        }
+    }
+}
+
+bool TableIndex::canMoveToNextPrefix(int prefixLength) const
+{
+    for (int ii = prefixLength; ii < m_keySchema->columnCount(); ++ii) {
+        switch (m_keySchema->columnType(ii)) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TableIndex::moveToNextPrefix(TableTuple &prefixKey, int prefixLength, IndexCursor& cursor) const
+{
+    assert(canMoveToNextPrefix(prefixLength));
+    // Every entry with this prefix sorts at or before the prefix followed
+    // by the largest value of each remaining column.
+    for (int ii = prefixLength; ii < m_keySchema->columnCount(); ++ii) {
+        switch (m_keySchema->columnType(ii)) {
+        case VALUE_TYPE_TINYINT:
+            prefixKey.setNValue(ii, ValueFactory::getTinyIntValue(INT8_MAX));
+            break;
+        case VALUE_TYPE_SMALLINT:
+            prefixKey.setNValue(ii, ValueFactory::getSmallIntValue(INT16_MAX));
+            break;
+        case VALUE_TYPE_INTEGER:
+            prefixKey.setNValue(ii, ValueFactory::getIntegerValue(INT32_MAX));
+            break;
+        case VALUE_TYPE_BIGINT:
+            prefixKey.setNValue(ii, ValueFactory::getBigIntValue(INT64_MAX));
+            break;
+        case VALUE_TYPE_TIMESTAMP:
+            prefixKey.setNValue(ii, ValueFactory::getTimestampValue(INT64_MAX));
+            break;
+        default:
+            throwFatalException("Cannot skip past an index key prefix followed by a %s column",
+                                voltdb::getTypeName(m_keySchema->columnType(ii)).c_str());
+        }
+    }
+    return moveToGreaterThanKey(&prefixKey, cursor);
+}
+
 std::string TableIndex::debug() const
 {
     std::ostringstream buffer;
@@ -173,6 +239,35 @@ void TableIndex::addEntry(const TableTuple *tuple, TableTuple *conflictTuple)
     addEntryDo(tuple, conflictTuple);
 }
 
+bool TableIndex::addEntries(const std::vector<char*> &tupleAddresses)
+{
+    const size_t sizeBefore = getSize();
+    if ( ! isPartialIndex()) {
+        addEntriesDo(tupleAddresses);
+        return getSize() - sizeBefore == tupleAddresses.size();
+    }
+    std::vector<char*> passing;
+    TableTuple tuple(getTupleSchema());
+    for (int i = 0; i < tupleAddresses.size(); ++i) {
+        tuple.move(tupleAddresses[i]);
+        if (getPredicate()->eval(&tuple, NULL).isTrue()) {
+            passing.push_back(tupleAddresses[i]);
+        }
+    }
+    addEntriesDo(passing);
+    return getSize() - sizeBefore == passing.size();
+}
+
+void TableIndex::addEntriesDo(const std::vector<char*> &tupleAddresses)
+{
+    ensureCapacity(static_cast<uint32_t>(getSize() + tupleAddresses.size()));
+    TableTuple tuple(getTupleSchema());
+    for (int i = 0; i < tupleAddresses.size(); ++i) {
+        tuple.move(tupleAddresses[i]);
+        addEntryDo(&tuple, NULL);
+    }
+}
+
 bool TableIndex::deleteEntry(const TableTuple *tuple)
 {
     if (isPartialIndex() && !getPredicate()->eval(tuple, NULL).isTrue()) {
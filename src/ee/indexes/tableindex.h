@@ -61,6 +61,7 @@
 namespace voltdb {
 
 class AbstractExpression;
+class TupleSlotMap;
 
 /**
  * Parameter for constructing TableIndex. TupleSchema, then key schema
@@ -222,6 +223,14 @@ public:
      */
     void addEntry(const TableTuple *tuple, TableTuple *conflictTuple);
 
+    /**
+     * adds index entries for many tuples at once, as when an index is
+     * built over a table that already has tuples. A tuple whose key is
+     * already in a unique index, or repeats the key of an earlier tuple
+     * in the list, is skipped.  Returns false if any tuple was skipped.
+     */
+    bool addEntries(const std::vector<char*> &tupleAddresses);
+
     /**
      * removes the index entry linked to given value (and tuple
      * pointer, if it's non-unique index).
@@ -377,6 +386,32 @@ public:
         throwFatalException("Invoked TableIndex virtual method advanceToNextKey which has no implementation");
     };
 
+    /**
+     * Skip-scan support for tree indexes, where the leading prefixLength
+     * key columns are not constrained by the search key.
+     *
+     * copyKeyPrefix sets the leading prefixLength columns of keyTuple to
+     * the key values of a tuple from the indexed table.
+     */
+    void copyKeyPrefix(const TableTuple &tuple, int prefixLength, TableTuple &keyTuple) const;
+
+    /**
+     * @return true if moveToNextPrefix() can seek past a prefix, which
+     * needs every key column after it to be an integer or a timestamp.
+     */
+    bool canMoveToNextPrefix(int prefixLength) const;
+
+    /**
+     * Like advanceToNextKey() but for a key prefix: moves the cursor, for
+     * use with nextValue(), to the first entry whose leading prefixLength
+     * key columns sort after those of prefixKey, skipping the rest of the
+     * entries with prefixKey's prefix. The key columns of prefixKey after
+     * the prefix are overwritten.
+     *
+     * @return true if there is no such entry.
+     */
+    bool moveToNextPrefix(TableTuple &prefixKey, int prefixLength, IndexCursor& cursor) const;
+
     /** retrieves from a primary key index the persistent tuple
      *  matching the given temp tuple.  The tuple's schema should be
      *  the table's schema, not the index's key schema.  */
@@ -408,6 +443,11 @@ public:
         return m_scheme.countable;
     }
 
+    inline TableIndexType getIndexType() const
+    {
+        return m_scheme.type;
+    }
+
     /**
      * Return TRUE if the index has a predicate.
      */
@@ -450,6 +490,41 @@ public:
     }
 
 
+    /**
+     * This function only supports countable tree index. It moves the cursor
+     * past the next skip entries that nextValueAtKey() (when atKey is true)
+     * or nextValue() would return, finding the new position by rank rather
+     * than visiting the skipped entries. The cursor runs out if fewer than
+     * skip entries remain.
+     */
+    virtual void skipEntries(int64_t skip, bool atKey, IndexCursor& cursor) const
+    {
+        throwFatalException("Invoked non-countable TableIndex virtual method skipEntries which has no implementation");
+    }
+
+    /**
+     * @return the numbering of the tuples in the slots of a bitmap index,
+     * or NULL for other indexes.
+     */
+    virtual const TupleSlotMap* getTupleSlotMap() const
+    {
+        return NULL;
+    }
+
+    /**
+     * Only bitmap indexes need a TupleSlotMap, which the table sets (see
+     * setTupleSlotMap) before adding any entry.
+     */
+    virtual bool usesTupleSlots() const
+    {
+        return false;
+    }
+
+    virtual void setTupleSlotMap(const TupleSlotMap *slots)
+    {
+        throwFatalException("Invoked non-bitmap TableIndex virtual method setTupleSlotMap which has no implementation");
+    }
+
     virtual size_t getSize() const = 0;
 
     // Return the amount of memory we think is allocated for this
@@ -545,6 +620,8 @@ protected:
 protected:
     // Index specific implementations
     virtual void addEntryDo(const TableTuple *tuple, TableTuple *conflictTuple) = 0;
+    // Adds the entries one at a time, after ensureCapacity for all of them
+    virtual void addEntriesDo(const std::vector<char*> &tupleAddresses);
     virtual bool deleteEntryDo(const TableTuple *tuple) = 0;
     virtual bool replaceEntryNoKeyChangeDo(const TableTuple &destinationTuple,
                                          const TableTuple &originalTuple) = 0;
@@ -44,6 +44,8 @@
  */
 
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include "indexes/tableindexfactory.h"
 #include "common/SerializableEEException.h"
@@ -58,43 +60,82 @@
 #include "indexes/CompactingHashUniqueIndex.h"
 #include "indexes/CompactingHashMultiMapIndex.h"
 #include "indexes/CoveringCellIndex.h"
+#include "indexes/BitmapIndex.h"
 
 namespace voltdb {
 
+static bool normalizedKeysFromEnvironment() {
+    const char* setting = ::getenv("VOLTDB_NORMALIZED_INDEX_KEYS");
+    return setting != NULL && ::strcmp(setting, "0") != 0 && ::strcmp(setting, "false") != 0;
+}
+
+bool TableIndexFactory::s_normalizedKeys = normalizedKeysFromEnvironment();
+
+// Normalized keys wider than the largest key bucket fall back to GenericKey
+// or TupleKey, which may store non-inlined values by reference.
+static const int MAX_NORMALIZED_KEY_SIZE = 256;
+
 class TableIndexPicker
 {
-    template <class TKeyType>
-    TableIndex *getInstanceForKeyType() const
+    template <class TKeyType, bool useBTree>
+    TableIndex *getTreeInstanceForKeyType() const
     {
         if (m_scheme.unique) {
-            if (m_type != BALANCED_TREE_INDEX) {
-                return new CompactingHashUniqueIndex<TKeyType >(m_keySchema, m_scheme);
-            } else if (m_scheme.countable) {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, true>(m_keySchema, m_scheme);
+            if (m_scheme.countable) {
+                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, true, useBTree>(m_keySchema, m_scheme);
             } else {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, false>(m_keySchema, m_scheme);
+                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, false, useBTree>(m_keySchema, m_scheme);
             }
         } else {
-            if (m_type != BALANCED_TREE_INDEX) {
-                return new CompactingHashMultiMapIndex<TKeyType >(m_keySchema, m_scheme);
-            } else if (m_scheme.countable) {
-                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, true>(m_keySchema, m_scheme);
+            if (m_scheme.countable) {
+                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, true, useBTree>(m_keySchema, m_scheme);
             } else {
-                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, false>(m_keySchema, m_scheme);
+                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, false, useBTree>(m_keySchema, m_scheme);
             }
         }
     }
 
+    // The B+-tree copies keys into its inner nodes, where they can outlive
+    // the entries they came from, so it is only used (when btreeCapable)
+    // for keys that do not point to out-of-line storage. The same goes for
+    // the bitmap index, which keeps the key of the first entry for each
+    // distinct value.
+    template <class TKeyType, bool btreeCapable>
+    TableIndex *getInstanceForKeyType() const
+    {
+        if (m_type == HASH_TABLE_INDEX) {
+            if (m_scheme.unique) {
+                return new CompactingHashUniqueIndex<TKeyType >(m_keySchema, m_scheme);
+            } else {
+                return new CompactingHashMultiMapIndex<TKeyType >(m_keySchema, m_scheme);
+            }
+        }
+        if (btreeCapable && m_type == BITMAP_INDEX && ! m_scheme.unique && ! m_scheme.countable &&
+            m_keySchema->getUninlinedObjectColumnCount() == 0) {
+            return new BitmapIndex<TKeyType>(m_keySchema, m_scheme);
+        }
+        if (btreeCapable && m_type == BTREE_INDEX && m_keySchema->getUninlinedObjectColumnCount() == 0) {
+            return getTreeInstanceForKeyType<TKeyType, btreeCapable>();
+        }
+        return getTreeInstanceForKeyType<TKeyType, false>();
+    }
+
     template <std::size_t KeySize>
     TableIndex *getInstanceIfKeyFits()
     {
+        if (m_normalizedKeySize > 0 && ! m_intsOnly) {
+            if (m_normalizedKeySize > KeySize) {
+                return NULL;
+            }
+            return getInstanceForKeyType<NormalizedKey<KeySize>, true>();
+        }
         if (m_keySize > KeySize) {
             return NULL;
         }
         if (m_intsOnly) {
             // The IntsKey size parameter ((KeySize-1)/8 + 1) is calculated to be
             // the number of 8-byte uint64's required to store KeySize packed bytes.
-            return getInstanceForKeyType<IntsKey<(KeySize-1)/8 + 1> >();
+            return getInstanceForKeyType<IntsKey<(KeySize-1)/8 + 1>, true>();
         }
         // Generic Key
         if (m_type == HASH_TABLE_INDEX) {
@@ -109,9 +150,9 @@ class TableIndexPicker
         // That's exactly what the GenericPersistentKey subtype of GenericKey does. This incurs extra overhead
         // for object copying and freeing, so is only enabled as needed.
         if (m_inlinesOrColumnsOnly) {
-            return getInstanceForKeyType<GenericKey<KeySize> >();
+            return getInstanceForKeyType<GenericKey<KeySize>, true>();
         }
-        return getInstanceForKeyType<GenericPersistentKey<KeySize> >();
+        return getInstanceForKeyType<GenericPersistentKey<KeySize>, false>();
     }
 
     template <int ColCount>
@@ -204,8 +245,16 @@ public:
         m_keySize(keySchema->tupleLength()),
         m_intsOnly(intsOnly),
         m_inlinesOrColumnsOnly(inlinesOrColumnsOnly),
+        m_normalizedKeySize(-1),
         m_type(scheme.type)
-    {}
+    {
+        if (TableIndexFactory::normalizedKeysEnabled()) {
+            const int normalizedKeySize = NormalizedKeyEncoding::keyLength(keySchema);
+            if (normalizedKeySize <= MAX_NORMALIZED_KEY_SIZE) {
+                m_normalizedKeySize = normalizedKeySize;
+            }
+        }
+    }
 
 private:
     const TableIndexScheme &m_scheme;
@@ -213,6 +262,8 @@ private:
     const int m_keySize;
     bool m_intsOnly;
     bool m_inlinesOrColumnsOnly;
+    // Encoded size of a NormalizedKey, or -1 when GenericKey is used instead
+    int m_normalizedKeySize;
     TableIndexType m_type;
 };
 
@@ -59,6 +59,17 @@ class TableIndexFactory {
 public:
     static TableIndex *getInstance(const TableIndexScheme &scheme);
     static TableIndex *cloneEmptyTreeIndex(const TableIndex& pkey_index);
+
+    /**
+     * When enabled, mixed-type keys that are not packed into IntsKeys are
+     * stored as memcmp-able NormalizedKeys instead of GenericKeys.
+     * Defaults to the VOLTDB_NORMALIZED_INDEX_KEYS environment variable.
+     */
+    static void setNormalizedKeysEnabled(bool enabled) { s_normalizedKeys = enabled; }
+    static bool normalizedKeysEnabled() { return s_normalizedKeys; }
+
+private:
+    static bool s_normalizedKeys;
 };
 
 }
@@ -336,6 +336,14 @@ AbstractExpression* AbstractPlanNode::loadExpressionFromJSONObject(const char* l
     return NULL;
 }
 
+void AbstractPlanNode::compileExpressions()
+{
+    map<PlanNodeType, AbstractPlanNode*>::const_iterator it;
+    for (it = m_inlineNodes.begin(); it != m_inlineNodes.end(); it++) {
+        it->second->compileExpressions();
+    }
+}
+
 // ------------------------------------------------------------------
 // UTILITY METHODS
 // ------------------------------------------------------------------
@@ -199,6 +199,13 @@ public:
 
     void setPlanNodeIdForTest(int32_t plannode_id) { m_planNodeId = plannode_id; }
 
+    /**
+     * Replace the expressions that this node and its inline nodes evaluate
+     * per tuple with specialized versions where ExpressionCompiler has one.
+     * Called once, when the plan is loaded, before the executors are built.
+     */
+    virtual void compileExpressions();
+
     /**
      * Load list of sort expressions and directions from a JSON object.
      * The pointers may be null if one of the vectors is not wanted.
@@ -46,6 +46,7 @@
 #include "abstractscannode.h"
 
 #include "execution/VoltDBEngine.h"
+#include "expressions/expressioncompiler.h"
 #include "storage/TableCatalogDelegate.hpp"
 
 namespace voltdb {
@@ -67,6 +68,12 @@ std::string AbstractScanPlanNode::debugInfo(const std::string &spacer) const
     return buffer.str();
 }
 
+void AbstractScanPlanNode::compileExpressions()
+{
+    AbstractPlanNode::compileExpressions();
+    m_compiledPredicate.reset(ExpressionCompiler::compile(m_predicate.get()));
+}
+
 void AbstractScanPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     m_target_table_name = obj.valueForKey("TARGET_TABLE_NAME").asStr();
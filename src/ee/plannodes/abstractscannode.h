@@ -64,7 +64,13 @@ public:
     void setTargetTableDelegate(TableCatalogDelegate* tcd) { m_tcd = tcd; } // DEPRECATED?
 
     std::string getTargetTableName() const { return m_target_table_name; } // DEPRECATED?
-    AbstractExpression* getPredicate() const { return m_predicate.get(); }
+    AbstractExpression* getPredicate() const
+    { return m_compiledPredicate ? m_compiledPredicate.get() : m_predicate.get(); }
+    // The predicate as planned, for callers that look into its subexpressions,
+    // which a compiled predicate doesn't expose
+    const AbstractExpression* getOriginalPredicate() const { return m_predicate.get(); }
+
+    void compileExpressions();
 
     bool isSubQuery() const { return m_isSubQuery; }
 
@@ -87,6 +93,8 @@ protected:
     // This is the predicate used to filter out tuples during the scan
     //
     boost::scoped_ptr<AbstractExpression> m_predicate;
+    // A specialized version of m_predicate, if it has one (see compileExpressions)
+    boost::scoped_ptr<AbstractExpression> m_compiledPredicate;
     // True if this scan represents a sub query
     bool m_isSubQuery;
     // True if this scan has a predicate that always evaluates to FALSE
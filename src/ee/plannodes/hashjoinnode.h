@@ -0,0 +1,60 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSTOREHASHJOINNODE_H
+#define HSTOREHASHJOINNODE_H
+
+#include "abstractjoinnode.h"
+
+namespace voltdb {
+
+/**
+ * Plan node for an equi-join of two input tables that builds an in-memory
+ * hash table over one input and probes it with the other.
+ *
+ * The i-th outer hash expression is evaluated against the outer tuple and
+ * must equal the i-th inner hash expression evaluated against the inner tuple.
+ * The executor checks those equalities itself, so the JOIN_PREDICATE only
+ * needs to carry whatever residual (non-equality) join conditions remain.
+ */
+class HashJoinPlanNode : public AbstractJoinPlanNode
+{
+public:
+    HashJoinPlanNode() { }
+    ~HashJoinPlanNode();
+    PlanNodeType getPlanNodeType() const;
+    std::string debugInfo(const std::string& spacer) const;
+
+    const std::vector<AbstractExpression*>& getOuterHashExpressions() const
+    { return m_outerHashExpressions; }
+
+    const std::vector<AbstractExpression*>& getInnerHashExpressions() const
+    { return m_innerHashExpressions; }
+
+protected:
+    void loadFromJSONObject(PlannerDomValue obj);
+
+    // Join keys evaluated against the outer (left) input tuple
+    OwningExpressionVector m_outerHashExpressions;
+
+    // Join keys evaluated against the inner (right) input tuple
+    OwningExpressionVector m_innerHashExpressions;
+};
+
+} // namespace voltdb
+
+#endif
@@ -65,6 +65,11 @@ std::string IndexScanPlanNode::debugInfo(const std::string &spacer) const
     buffer << spacer << "SortDirection["
            << sortDirectionToString(m_sort_direction) << "]\n";
 
+    if (m_skip_scan_prefix_length > 0) {
+        buffer << spacer << "SkipScanPrefixLength[" << m_skip_scan_prefix_length << "]"
+               << (m_skip_scan_distinct ? " Distinct\n" : "\n");
+    }
+
     buffer << spacer << "SearchKey Expressions:\n";
     for (int ctr = 0, cnt = (int)m_searchkey_expressions.size(); ctr < cnt; ctr++) {
         buffer << m_searchkey_expressions[ctr]->debug(spacer);
@@ -110,6 +115,13 @@ void IndexScanPlanNode::loadFromJSONObject(PlannerDomValue obj)
     m_skip_null_predicate.reset(loadExpressionFromJSONObject("SKIP_NULL_PREDICATE", obj));
 
     m_searchkey_expressions.loadExpressionArrayFromJSONObject("SEARCHKEY_EXPRESSIONS", obj);
+
+    if (obj.hasNonNullKey("SKIP_SCAN_PREFIX_LENGTH")) {
+        m_skip_scan_prefix_length = obj.valueForKey("SKIP_SCAN_PREFIX_LENGTH").asInt();
+    }
+    if (obj.hasNonNullKey("SKIP_SCAN_DISTINCT")) {
+        m_skip_scan_distinct = obj.valueForKey("SKIP_SCAN_DISTINCT").asBool();
+    }
 }
 
 } // namespace voltdb
@@ -58,6 +58,8 @@ public:
     IndexScanPlanNode()
         : m_lookup_type(INDEX_LOOKUP_TYPE_EQ)
         , m_sort_direction(SORT_DIRECTION_TYPE_INVALID)
+        , m_skip_scan_prefix_length(0)
+        , m_skip_scan_distinct(false)
     { }
     ~IndexScanPlanNode();
     PlanNodeType getPlanNodeType() const;
@@ -78,6 +80,10 @@ public:
 
     AbstractExpression* getSkipNullPredicate() const { return m_skip_null_predicate.get(); }
 
+    int getSkipScanPrefixLength() const { return m_skip_scan_prefix_length; }
+
+    bool isSkipScanDistinct() const { return m_skip_scan_distinct; }
+
 protected:
     void loadFromJSONObject(PlannerDomValue obj);
 
@@ -101,6 +107,16 @@ protected:
 
     // null row predicate for underflow edge case
     boost::scoped_ptr<AbstractExpression> m_skip_null_predicate;
+
+    // For a skip scan, the number of leading index key columns that the
+    // search key does not cover. The search key expressions then apply to
+    // the key columns after them, within each distinct prefix.
+    int m_skip_scan_prefix_length;
+
+    // For a skip scan, whether to return just the first entry of each
+    // prefix that passes the post expression, for DISTINCT or GROUP BY on
+    // the prefix columns.
+    bool m_skip_scan_distinct;
 };
 
 } // namespace voltdb
@@ -109,6 +109,10 @@ class PlanNodeFragment {
     // as part of the horrible ENG-1333 hack.
     bool hasDelete() const;
 
+    // true if chains of executors that support it should stream tuples
+    // to each other instead of materializing every intermediate result.
+    bool isPipelined() const { return m_isPipelined; }
+
     // produce a string describing pnf's content
     std::string debug();
 
@@ -126,6 +130,8 @@ class PlanNodeFragment {
     // Pointers to nodes in execution order grouped by substatement
     // The statement id is the key. The top statement (parent) always has id = 0
     std::map<int, std::vector<AbstractPlanNode*>* > m_stmtExecutionListMap;
+    // set by the optional PIPELINED key of the serialized plan
+    bool m_isPipelined;
 };
 
 
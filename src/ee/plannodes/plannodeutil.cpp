@@ -59,6 +59,7 @@
 #include "plannodes/mergereceivenode.h"
 #include "plannodes/nestloopnode.h"
 #include "plannodes/nestloopindexnode.h"
+#include "plannodes/hashjoinnode.h"
 #include "plannodes/projectionnode.h"
 #include "plannodes/orderbynode.h"
 #include "plannodes/receivenode.h"
@@ -129,6 +130,12 @@ voltdb::AbstractPlanNode* getEmptyPlanNode(voltdb::PlanNodeType type) {
             ret = new voltdb::NestLoopIndexPlanNode();
             break;
         // ------------------------------------------------------------------
+        // HashJoin
+        // ------------------------------------------------------------------
+        case (voltdb::PLAN_NODE_TYPE_HASHJOIN):
+            ret = new voltdb::HashJoinPlanNode();
+            break;
+        // ------------------------------------------------------------------
         // Update
         // ------------------------------------------------------------------
         case (voltdb::PLAN_NODE_TYPE_UPDATE):
@@ -45,6 +45,7 @@
 
 #include "projectionnode.h"
 
+#include "expressions/expressioncompiler.h"
 #include "storage/table.h"
 
 using namespace std;
@@ -75,6 +76,18 @@ std::string ProjectionPlanNode::debugInfo(const string& spacer) const
     return buffer.str();
 }
 
+void ProjectionPlanNode::compileExpressions()
+{
+    AbstractPlanNode::compileExpressions();
+    for (int ctr = 0, cnt = (int)m_outputColumnExpressions.size(); ctr < cnt; ctr++) {
+        AbstractExpression* compiled = ExpressionCompiler::compile(m_outputColumnExpressions[ctr]);
+        if (compiled != NULL) {
+            m_compiledExpressions.push_back(compiled);
+            m_outputColumnExpressions[ctr] = compiled;
+        }
+    }
+}
+
 void ProjectionPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     const std::vector<SchemaColumn*>& outputSchema = getOutputSchema();
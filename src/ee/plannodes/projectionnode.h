@@ -50,6 +50,8 @@
 
 #include "expressions/abstractexpression.h"
 
+#include "boost/ptr_container/ptr_vector.hpp"
+
 namespace voltdb {
 
 class ProjectionPlanNode : public AbstractPlanNode
@@ -74,6 +76,8 @@ public:
 
     std::string debugInfo(const std::string& spacer) const;
 
+    void compileExpressions();
+
 protected:
     void loadFromJSONObject(PlannerDomValue obj);
     //
@@ -92,6 +96,10 @@ protected:
     // or CalculatedValueExpression for projection with arithmetic calculation.
     // in ProjectionPlanNode
     std::vector<AbstractExpression*> m_outputColumnExpressions;
+
+    // The specialized expressions that compileExpressions put in place of
+    // some of the above, which remain owned by the output schema.
+    boost::ptr_vector<AbstractExpression> m_compiledExpressions;
 };
 
 } // namespace voltdb
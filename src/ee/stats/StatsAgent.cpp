@@ -20,6 +20,7 @@
 #include "common/ids.h"
 #include "common/tabletuple.h"
 #include "common/TupleSchema.h"
+#include "executors/ExecutorStats.h"
 #include "indexes/IndexStats.h"
 #include "storage/TableStats.h"
 #include "storage/temptable.h"
@@ -43,6 +44,8 @@ namespace
             return TableStats::generateEmptyTableStatsTable();
         case STATISTICS_SELECTOR_TYPE_INDEX:
             return IndexStats::generateEmptyIndexStatsTable();
+        case STATISTICS_SELECTOR_TYPE_EXECUTOR:
+            return ExecutorStats::generateEmptyExecutorStatsTable();
         default:
             throwFatalException("Attempted to get unsupported stats type");
         }
@@ -0,0 +1,152 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/AntiCache.h"
+#include "common/FatalException.hpp"
+
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+
+namespace voltdb {
+
+static std::string directoryFromEnvironment() {
+    const char* setting = ::getenv("VOLTDB_ANTICACHE_DIR");
+    return setting == NULL ? std::string() : std::string(setting);
+}
+
+static int64_t memoryLimitFromEnvironment() {
+    const char* setting = ::getenv("VOLTDB_ANTICACHE_MEMORY_LIMIT");
+#ifdef MREMAP_FIXED
+    if (setting != NULL && ::atol(setting) > 0 && ! directoryFromEnvironment().empty()) {
+        return static_cast<int64_t>(::atol(setting)) * 1024 * 1024;
+    }
+#endif
+    // Fetching a block back relies on Linux's mremap
+    return 0;
+}
+
+std::string AntiCache::s_directory = directoryFromEnvironment();
+int64_t AntiCache::s_memoryLimit = memoryLimitFromEnvironment();
+volatile int64_t AntiCache::s_clock = 0;
+
+std::size_t AntiCache::roundUp(std::size_t size) {
+    std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return (size + pageSize - 1) & ~(pageSize - 1);
+}
+
+char* AntiCache::allocate(std::size_t size) {
+    void* storage = ::mmap(0, roundUp(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (storage == MAP_FAILED) {
+        throwFatalException("Failed mmap: %s", strerror(errno));
+    }
+    return static_cast<char*>(storage);
+}
+
+void AntiCache::free(char* storage, std::size_t size) {
+    if (::munmap(storage, roundUp(size)) != 0) {
+        throwFatalException("Failed munmap: %s", strerror(errno));
+    }
+}
+
+AntiCacheStore::AntiCacheStore(std::size_t blockSize)
+    : m_tupleMemorySize(blockSize),
+      m_blockSize(AntiCache::roundUp(blockSize)),
+      m_fd(-1),
+      m_fileSize(0),
+      m_evictedBlockCount(0),
+      m_fetchedBlockCount(0)
+{
+    std::string path = AntiCache::directory() + "/voltdb-anticache-XXXXXX";
+    std::vector<char> pathBuffer(path.begin(), path.end());
+    pathBuffer.push_back('\0');
+    m_fd = ::mkstemp(&pathBuffer[0]);
+    if (m_fd < 0) {
+        throwFatalException("Failed to create anti-cache block store in %s: %s",
+                            AntiCache::directory().c_str(), strerror(errno));
+    }
+    ::unlink(&pathBuffer[0]);
+}
+
+AntiCacheStore::~AntiCacheStore() {
+    ::close(m_fd);
+}
+
+int64_t AntiCacheStore::evict(char* storage) {
+    int64_t offset;
+    if (m_freeOffsets.empty()) {
+        offset = m_fileSize;
+        m_fileSize += m_blockSize;
+    }
+    else {
+        offset = m_freeOffsets.back();
+        m_freeOffsets.pop_back();
+    }
+
+    std::size_t written = 0;
+    while (written < m_blockSize) {
+        ssize_t count = ::pwrite(m_fd, storage + written, m_blockSize - written, offset + written);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwFatalException("Failed to write an evicted tuple block: %s", strerror(errno));
+        }
+        written += count;
+    }
+
+    // Replaces the anonymous pages; the kernel reads them back on access
+    void* mapped = ::mmap(storage, m_blockSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_FIXED, m_fd, offset);
+    if (mapped == MAP_FAILED) {
+        throwFatalException("Failed to map an evicted tuple block: %s", strerror(errno));
+    }
+    m_evictedBlockCount++;
+    return offset;
+}
+
+void AntiCacheStore::fetch(char* storage, int64_t offset) {
+#ifdef MREMAP_FIXED
+    void* copy = ::mmap(0, m_blockSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (copy == MAP_FAILED) {
+        throwFatalException("Failed mmap: %s", strerror(errno));
+    }
+    ::memcpy(copy, storage, m_blockSize);
+    // Move the copy's pages over the file mapping, keeping the address
+    if (::mremap(copy, m_blockSize, m_blockSize, MREMAP_MAYMOVE | MREMAP_FIXED, storage) == MAP_FAILED) {
+        throwFatalException("Failed to fetch an evicted tuple block: %s", strerror(errno));
+    }
+    release(offset);
+    m_fetchedBlockCount++;
+#else
+    throwFatalException("Evicted tuple blocks can not be fetched on this platform");
+#endif
+}
+
+void AntiCacheStore::release(int64_t offset) {
+#if defined(FALLOC_FL_PUNCH_HOLE) && defined(FALLOC_FL_KEEP_SIZE)
+    // Only a hint; the space is reused either way
+    (void)::fallocate(m_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, m_blockSize);
+#endif
+    m_freeOffsets.push_back(offset);
+    m_evictedBlockCount--;
+}
+
+}
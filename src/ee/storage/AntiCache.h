@@ -0,0 +1,143 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTICACHE_H_
+#define ANTICACHE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Opt-in eviction of cold tuple blocks to a local block store, so a site's
+ * tables can outgrow its share of RAM when only part of the data is hot.
+ *
+ * Start the process with VOLTDB_ANTICACHE_DIR naming a local directory and
+ * VOLTDB_ANTICACHE_MEMORY_LIMIT set to a size in MB to turn it on. Tuple
+ * blocks are then mapped rather than allocated from the heap, and each
+ * tick, while a site's resident tuple memory is over the limit, the blocks
+ * it has gone longest without scanning or inserting into, by a clock that
+ * steps once a second for the whole process, are written to a
+ * per-table file and that file is mapped over them in place. Tuple
+ * addresses never change, so indexes keep working, and a read of an
+ * evicted tuple faults its page back in from the file. A scan or insert
+ * that reaches an evicted block fetches the whole block back into
+ * anonymous memory.
+ */
+class AntiCache {
+public:
+    /** True if tuple blocks may be evicted in this process */
+    static bool enabled() { return s_memoryLimit > 0; }
+
+    /** Tests turn anti-caching on and off directly */
+    static void setEnabled(const std::string &directory, int64_t memoryLimit) {
+        s_directory = directory;
+        s_memoryLimit = memoryLimit;
+    }
+
+    /** The directory block stores are created in */
+    static const std::string& directory() { return s_directory; }
+
+    /** The resident tuple memory per site above which blocks are evicted */
+    static int64_t memoryLimit() { return s_memoryLimit; }
+
+    /** The milliseconds of wall clock time per step of the access clock */
+    static const int64_t CLOCK_PERIOD_MILLIS = 1000;
+
+    /** The current access time, in CLOCK_PERIOD_MILLIS steps */
+    static int64_t clock() { return s_clock; }
+
+    /**
+     * Move the access clock up to the step that timeInMillis falls in.
+     * Every site's tick calls this, and the clock is shared by the
+     * process, so it follows the time rather than counting the calls;
+     * otherwise blocks would age faster on hosts with more sites.
+     */
+    static void advanceClock(int64_t timeInMillis) {
+        const int64_t step = timeInMillis / CLOCK_PERIOD_MILLIS;
+        int64_t current = s_clock;
+        while (current < step) {
+            int64_t seen = __sync_val_compare_and_swap(&s_clock, current, step);
+            if (seen == current) {
+                break;
+            }
+            current = seen;
+        }
+    }
+
+    /** The size blocks of the given size are mapped with, in whole pages */
+    static std::size_t roundUp(std::size_t size);
+
+    /** Map zeroed anonymous memory for a tuple block */
+    static char* allocate(std::size_t size);
+
+    /** Unmap a tuple block, evicted or not */
+    static void free(char* storage, std::size_t size);
+
+private:
+    static std::string s_directory;
+    static int64_t s_memoryLimit;
+    static volatile int64_t s_clock;
+};
+
+/**
+ * A file of evicted tuple blocks, all of one size, belonging to one table.
+ * The file is unlinked as soon as it is created, so it goes away with the
+ * process.
+ */
+class AntiCacheStore {
+public:
+    AntiCacheStore(std::size_t blockSize);
+    ~AntiCacheStore();
+
+    /**
+     * Write the block's storage to the file and map the file over it.
+     * Returns the file offset the block was written to.
+     */
+    int64_t evict(char* storage);
+
+    /** Copy an evicted block back into anonymous memory at the same address */
+    void fetch(char* storage, int64_t offset);
+
+    /** Free the file space of a block that is being freed while evicted */
+    void release(int64_t offset);
+
+    int64_t evictedBlockCount() const { return m_evictedBlockCount; }
+    int64_t evictedBytes() const { return m_evictedBlockCount * static_cast<int64_t>(m_tupleMemorySize); }
+    int64_t fetchedBlockCount() const { return m_fetchedBlockCount; }
+
+private:
+    // The blocks' tuple storage, and that rounded up to whole pages
+    const std::size_t m_tupleMemorySize;
+    const std::size_t m_blockSize;
+    int m_fd;
+    int64_t m_fileSize;
+    std::vector<int64_t> m_freeOffsets;
+    int64_t m_evictedBlockCount;
+    int64_t m_fetchedBlockCount;
+
+    // No implicit copies
+    AntiCacheStore(const AntiCacheStore&);
+    AntiCacheStore& operator=(const AntiCacheStore&);
+};
+
+}
+
+#endif /* ANTICACHE_H_ */
@@ -71,7 +71,7 @@ bool CopyOnWriteIterator::needToDirtyTuple(char *tupleAddress) {
      * we are looking for is probably the previous entry. Then check if the address fits
      * in the previous entry. If it doesn't then the block is something new.
      */
-    TBPtr block = PersistentTable::findBlock(tupleAddress, m_blocks, m_table->getTableAllocationSize());
+    TBPtr block = PersistentTable::findBlock(tupleAddress, m_blocks);
     if (block.get() == NULL) {
         // tuple not in snapshot region, don't care about this tuple
         return false;
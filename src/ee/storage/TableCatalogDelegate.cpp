@@ -186,9 +186,15 @@ getIndexIdFromMap(TableIndexType type, bool countable, bool isUnique,
         case HASH_TABLE_INDEX:
             retval += "H";
             break;
+        case BTREE_INDEX:
+            retval += "P"; // B+-tree; B is taken
+            break;
         case COVERING_CELL_INDEX:
             retval += "G"; // C is taken
             break;
+        case BITMAP_INDEX:
+            retval += "R"; // roaring-style bitmap; B is taken
+            break;
         default:
             // this would need to change if we added index types
             assert(false);
@@ -272,6 +278,75 @@ TableCatalogDelegate::getIndexIdString(const TableIndexScheme &indexScheme)
 }
 
 
+/**
+ * Locally defined function to find the columns of a table named in an
+ * environment variable such as VOLTDB_ZONE_MAP_COLUMNS, a comma separated
+ * list of TABLE.COLUMN names.
+ */
+static vector<int>
+getColumnsFromEnvironment(const char* variable, const string& tableName, const vector<string>& columnNames) {
+    vector<int> columns;
+    const char* setting = ::getenv(variable);
+    if (setting == NULL) {
+        return columns;
+    }
+    vector<string> names;
+    boost::split(names, setting, boost::is_any_of(","));
+    BOOST_FOREACH(string& name, names) {
+        boost::trim(name);
+        size_t dot = name.find('.');
+        if (dot == string::npos || ! boost::iequals(name.substr(0, dot), tableName)) {
+            continue;
+        }
+        for (int ii = 0; ii < columnNames.size(); ++ii) {
+            if (boost::iequals(name.substr(dot + 1), columnNames[ii])) {
+                columns.push_back(ii);
+            }
+        }
+    }
+    return columns;
+}
+
+/**
+ * Locally defined function to find a table's time to live in the
+ * VOLTDB_TABLE_TTL environment variable, a comma separated list of
+ * TABLE.COLUMN=SECONDS settings for timestamp columns.  Returns the
+ * column, or -1 if the table has no time to live.
+ */
+static int
+getTimeToLiveFromEnvironment(const string& tableName, const vector<string>& columnNames,
+                             const TupleSchema* schema, int64_t* ttlMicros) {
+    const char* setting = ::getenv("VOLTDB_TABLE_TTL");
+    if (setting == NULL) {
+        return -1;
+    }
+    vector<string> entries;
+    boost::split(entries, setting, boost::is_any_of(","));
+    BOOST_FOREACH(string& entry, entries) {
+        boost::trim(entry);
+        size_t dot = entry.find('.');
+        size_t equals = entry.find('=');
+        if (dot == string::npos || equals == string::npos || equals < dot ||
+            ! boost::iequals(entry.substr(0, dot), tableName)) {
+            continue;
+        }
+        const string columnName = entry.substr(dot + 1, equals - dot - 1);
+        for (int ii = 0; ii < columnNames.size(); ++ii) {
+            if (boost::iequals(columnName, columnNames[ii]) &&
+                schema->columnType(ii) == VALUE_TYPE_TIMESTAMP) {
+                try {
+                    *ttlMicros = boost::lexical_cast<int64_t>(entry.substr(equals + 1)) * 1000000;
+                }
+                catch (boost::bad_lexical_cast&) {
+                    return -1;
+                }
+                return ii;
+            }
+        }
+    }
+    return -1;
+}
+
 Table *TableCatalogDelegate::constructTableFromCatalog(catalog::Database const &catalogDatabase,
                                                        catalog::Table const &catalogTable,
                                                        int tableAllocationTargetSize)
@@ -448,6 +523,32 @@ Table *TableCatalogDelegate::constructTableFromCatalog(catalog::Database const &
         persistentTable->addIndex(index);
     }
 
+    persistentTable->setZoneMapColumns(getColumnsFromEnvironment("VOLTDB_ZONE_MAP_COLUMNS",
+                                                                 tableName, columnNames));
+    // The strings of a replicated table are all kept by its own dictionary,
+    // out of the site thread's compacting pool, whose frees move strings
+    // about -- a first step toward sharing one copy between sites
+    vector<int> dictionaryColumns;
+    if (partitionColumnIndex == -1) {
+        for (int ii = 0; ii < columnNames.size(); ++ii) {
+            dictionaryColumns.push_back(ii);
+        }
+    }
+    else {
+        dictionaryColumns = getColumnsFromEnvironment("VOLTDB_DICTIONARY_COLUMNS", tableName, columnNames);
+    }
+    persistentTable->setDictionaryColumns(dictionaryColumns);
+
+    // Transactions that expire rows run on just one copy of a replicated
+    // table, and the rows of a view come and go with its source table's
+    if (partitionColumnIndex != -1 && ! m_materialized) {
+        int64_t ttlMicros = 0;
+        int ttlColumn = getTimeToLiveFromEnvironment(tableName, columnNames, schema, &ttlMicros);
+        if (ttlColumn >= 0) {
+            persistentTable->setTimeToLive(ttlColumn, ttlMicros);
+        }
+    }
+
     return table;
 }
 
@@ -569,6 +670,7 @@ static void migrateChangedTuples(catalog::Table const &catalogTable,
 
     // going to run until the source table has no allocated blocks
     size_t blocksLeft = existingTable->allocatedBlockCount();
+    newTable->beginBulkIndexing();
     while (blocksLeft) {
 
         TableIterator &iterator = existingTable->iterator();
@@ -610,6 +712,7 @@ static void migrateChangedTuples(catalog::Table const &catalogTable,
             }
         }
     }
+    newTable->endBulkIndexing();
 
     // release any memory held by the default values --
     // normally you'd want this in a finally block, but since this code failing
@@ -40,6 +40,16 @@ vector<string> TableStats::generateTableStatsColumnNames() {
     columnNames.push_back("STRING_DATA_MEMORY");
     columnNames.push_back("TUPLE_LIMIT");
     columnNames.push_back("PERCENT_FULL");
+    columnNames.push_back("TUPLES_EXPIRED");
+    columnNames.push_back("EXPIRATION_TIME");
+    columnNames.push_back("COMPACTION_PENDING_MEMORY");
+    columnNames.push_back("COMPACTION_STEPS");
+    columnNames.push_back("COMPACTION_TIME");
+    columnNames.push_back("COMPACTION_MAX_PAUSE");
+    columnNames.push_back("EVICTED_BLOCKS");
+    columnNames.push_back("EVICTED_MEMORY");
+    columnNames.push_back("BLOCKS_FETCHED");
+    columnNames.push_back("TUPLE_SLACK_MEMORY");
     return columnNames;
 }
 
@@ -59,6 +69,16 @@ void TableStats::populateTableStatsSchema(
     types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
     types.push_back(VALUE_TYPE_INTEGER); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER)); allowNull.push_back(false);inBytes.push_back(false);
     types.push_back(VALUE_TYPE_INTEGER); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
 }
 
 TempTable* TableStats::generateEmptyTableStatsTable() {
@@ -86,7 +106,9 @@ TempTable* TableStats::generateEmptyTableStatsTable() {
 TableStats::TableStats(Table* table)
     : StatsSource(), m_table(table), m_lastTupleCount(0),
       m_lastAllocatedTupleMemory(0), m_lastOccupiedTupleMemory(0),
-      m_lastStringDataMemory(0)
+      m_lastStringDataMemory(0), m_lastExpiredTupleCount(0),
+      m_lastExpirationTime(0), m_lastCompactionStepCount(0),
+      m_lastCompactionTime(0), m_lastFetchedBlockCount(0)
 {
 }
 
@@ -131,6 +153,39 @@ void TableStats::updateStatsTuple(TableTuple *tuple) {
         occupied_tuple_mem_kb = persistentTable->occupiedTupleMemory() / 1024;
     }
     int64_t string_data_mem_kb = m_table->nonInlinedMemorySize() / 1024;
+    // Tuples deleted by the table's time to live, and the microseconds spent on it
+    int64_t expiredTupleCount = 0;
+    int64_t expirationTime = 0;
+    if (persistentTable) {
+        expiredTupleCount = persistentTable->expiredTupleCount();
+        expirationTime = persistentTable->expirationTime();
+    }
+    // Memory incremental compaction could still reclaim, and its progress
+    int64_t compaction_pending_mem_kb = 0;
+    int64_t compactionStepCount = 0;
+    int64_t compactionTime = 0;
+    int64_t maxCompactionPause = 0;
+    if (persistentTable) {
+        compaction_pending_mem_kb = persistentTable->reclaimableTupleMemory() / 1024;
+        compactionStepCount = persistentTable->compactionStepCount();
+        compactionTime = persistentTable->compactionTime();
+        maxCompactionPause = persistentTable->maxCompactionPause();
+    }
+    // Allocated tuple memory holding no tuple, including what blocks round off
+    int64_t slack_tuple_mem_kb = 0;
+    if (persistentTable) {
+        slack_tuple_mem_kb = (persistentTable->allocatedTupleMemory() -
+                              persistentTable->activeTupleCount() * persistentTable->getTupleLength()) / 1024;
+    }
+    // Blocks anti-caching has written out to disk, and fetched back
+    int64_t evictedBlockCount = 0;
+    int64_t evicted_mem_kb = 0;
+    int64_t fetchedBlockCount = 0;
+    if (persistentTable) {
+        evictedBlockCount = persistentTable->evictedBlockCount();
+        evicted_mem_kb = persistentTable->evictedTupleMemory() / 1024;
+        fetchedBlockCount = persistentTable->fetchedBlockCount();
+    }
 
     if (interval()) {
         tupleCount = tupleCount - m_lastTupleCount;
@@ -146,6 +201,22 @@ void TableStats::updateStatsTuple(TableTuple *tuple) {
         string_data_mem_kb =
             string_data_mem_kb - (m_lastStringDataMemory / 1024);
         m_lastStringDataMemory = m_table->nonInlinedMemorySize();
+        expiredTupleCount = expiredTupleCount - m_lastExpiredTupleCount;
+        expirationTime = expirationTime - m_lastExpirationTime;
+        if (persistentTable) {
+            m_lastExpiredTupleCount = persistentTable->expiredTupleCount();
+            m_lastExpirationTime = persistentTable->expirationTime();
+        }
+        compactionStepCount = compactionStepCount - m_lastCompactionStepCount;
+        compactionTime = compactionTime - m_lastCompactionTime;
+        if (persistentTable) {
+            m_lastCompactionStepCount = persistentTable->compactionStepCount();
+            m_lastCompactionTime = persistentTable->compactionTime();
+        }
+        fetchedBlockCount = fetchedBlockCount - m_lastFetchedBlockCount;
+        if (persistentTable) {
+            m_lastFetchedBlockCount = persistentTable->fetchedBlockCount();
+        }
     }
 
     tuple->setNValue(
@@ -166,6 +237,26 @@ void TableStats::updateStatsTuple(TableTuple *tuple) {
         percentage = static_cast<int32_t> (ceil(static_cast<double>(tupleCount) * 100.0 / tupleLimit));
     }
     tuple->setNValue(StatsSource::m_columnName2Index["PERCENT_FULL"],ValueFactory::getIntegerValue(percentage));
+    tuple->setNValue(StatsSource::m_columnName2Index["TUPLES_EXPIRED"],
+            ValueFactory::getBigIntValue(expiredTupleCount));
+    tuple->setNValue(StatsSource::m_columnName2Index["EXPIRATION_TIME"],
+            ValueFactory::getBigIntValue(expirationTime));
+    tuple->setNValue(StatsSource::m_columnName2Index["COMPACTION_PENDING_MEMORY"],
+            ValueFactory::getBigIntValue(compaction_pending_mem_kb));
+    tuple->setNValue(StatsSource::m_columnName2Index["COMPACTION_STEPS"],
+            ValueFactory::getBigIntValue(compactionStepCount));
+    tuple->setNValue(StatsSource::m_columnName2Index["COMPACTION_TIME"],
+            ValueFactory::getBigIntValue(compactionTime));
+    tuple->setNValue(StatsSource::m_columnName2Index["COMPACTION_MAX_PAUSE"],
+            ValueFactory::getBigIntValue(maxCompactionPause));
+    tuple->setNValue(StatsSource::m_columnName2Index["EVICTED_BLOCKS"],
+            ValueFactory::getBigIntValue(evictedBlockCount));
+    tuple->setNValue(StatsSource::m_columnName2Index["EVICTED_MEMORY"],
+            ValueFactory::getBigIntValue(evicted_mem_kb));
+    tuple->setNValue(StatsSource::m_columnName2Index["BLOCKS_FETCHED"],
+            ValueFactory::getBigIntValue(fetchedBlockCount));
+    tuple->setNValue(StatsSource::m_columnName2Index["TUPLE_SLACK_MEMORY"],
+            ValueFactory::getBigIntValue(slack_tuple_mem_kb));
 }
 
 /**
@@ -99,6 +99,11 @@ private:
     int64_t m_lastAllocatedTupleMemory;
     int64_t m_lastOccupiedTupleMemory;
     int64_t m_lastStringDataMemory;
+    int64_t m_lastExpiredTupleCount;
+    int64_t m_lastExpirationTime;
+    int64_t m_lastCompactionStepCount;
+    int64_t m_lastCompactionTime;
+    int64_t m_lastFetchedBlockCount;
 };
 
 }
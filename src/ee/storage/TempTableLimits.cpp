@@ -24,7 +24,7 @@
 
 namespace voltdb {
 
-void TempTableLimits::reduceAllocated(int bytes)
+void TempTableLimits::reduceAllocated(int64_t bytes)
 {
     m_currMemoryInBytes -= bytes;
     if (m_currMemoryInBytes < m_logThreshold) {
@@ -32,7 +32,7 @@ void TempTableLimits::reduceAllocated(int bytes)
     }
 }
 
-void TempTableLimits::increaseAllocated(int bytes)
+void TempTableLimits::increaseAllocated(int64_t bytes)
 {
     m_currMemoryInBytes += bytes;
     if (m_memoryLimit > 0 && m_currMemoryInBytes > m_memoryLimit) {
@@ -41,11 +41,12 @@ public:
      * Log once at INFO level to the SQL instance if the log threshold is set and it is crossed.
      * Throw a SQLException when the memory limit is exceeded.
      */
-    void increaseAllocated(int bytes);
-    void reduceAllocated(int bytes);
+    void increaseAllocated(int64_t bytes);
+    void reduceAllocated(int64_t bytes);
 
     int64_t getAllocated() const { return m_currMemoryInBytes; }
     int64_t getPeakMemoryInBytes() const { return m_peakMemoryInBytes; }
+    int64_t getMemoryLimit() const { return m_memoryLimit; }
     void resetPeakMemory() { m_peakMemoryInBytes = m_currMemoryInBytes; }
 
 private:
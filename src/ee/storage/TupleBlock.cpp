@@ -18,14 +18,21 @@
 #include "storage/table.h"
 #include <sys/mman.h>
 #include <errno.h>
+#include "common/HugePages.h"
 #include "common/ThreadLocalPool.h"
 
 namespace voltdb {
 
 volatile int tupleBlocksAllocated = 0;
 
-TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
+TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket, uint32_t tuplesPerBlock) :
         m_storage(NULL),
+        m_storageSize(table->m_tableAllocationSize),
+        m_hugePageStorageSize(0),
+        m_fromHugePagePool(false),
+        m_antiCacheStorageSize(0),
+        m_evictedOffset(-1),
+        m_lastAccess(AntiCache::clock()),
         m_references(0),
         m_tupleLength(table->m_tupleLength),
         m_tuplesPerBlock(table->m_tuplesPerBlock),
@@ -35,6 +42,10 @@ TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         m_bucket(bucket),
         m_bucketIndex(0)
 {
+    if (tuplesPerBlock != 0 && tuplesPerBlock < m_tuplesPerBlock) {
+        m_tuplesPerBlock = tuplesPerBlock;
+        m_storageSize = static_cast<std::size_t>(m_tupleLength) * tuplesPerBlock;
+    }
 #ifdef USE_MMAP
     size_t tableAllocationSize = static_cast<size_t> (m_tupleLength * m_tuplesPerBlock);
     m_storage = static_cast<char*>(::mmap( 0, tableAllocationSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 ));
@@ -43,7 +54,18 @@ TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         throwFatalException("Failed mmap");
     }
 #else
-    m_storage = new char[table->m_tableAllocationSize];
+    if (AntiCache::enabled()) {
+        // Evicting and fetching remap the storage, so it must be page aligned
+        m_antiCacheStorageSize = m_storageSize;
+        m_storage = AntiCache::allocate(m_antiCacheStorageSize);
+    }
+    else if (HugePages::worthwhile(m_storageSize)) {
+        m_hugePageStorageSize = m_storageSize;
+        m_storage = HugePages::allocate(m_hugePageStorageSize, &m_fromHugePagePool);
+    }
+    else {
+        m_storage = new char[m_storageSize];
+    }
 #endif
     tupleBlocksAllocated++;
 }
@@ -56,10 +78,32 @@ TupleBlock::~TupleBlock() {
         throwFatalException("Failed munmap");
     }
 #else
-    delete []m_storage;
+    if (m_antiCacheStorageSize != 0) {
+        if (m_evictedOffset >= 0) {
+            m_antiCacheStore->release(m_evictedOffset);
+        }
+        AntiCache::free(m_storage, m_antiCacheStorageSize);
+    }
+    else if (m_hugePageStorageSize != 0) {
+        HugePages::free(m_storage, m_hugePageStorageSize, m_fromHugePagePool);
+    }
+    else {
+        delete []m_storage;
+    }
 #endif
 }
 
+void TupleBlock::evict(const boost::shared_ptr<AntiCacheStore> &store) {
+    assert(isEvictable());
+    m_evictedOffset = store->evict(m_storage);
+    m_antiCacheStore = store;
+}
+
+void TupleBlock::fetch() {
+    m_antiCacheStore->fetch(m_storage, m_evictedOffset);
+    m_evictedOffset = -1;
+}
+
 std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementListener *listener) {
     assert(source != this);
     /*
@@ -32,6 +32,8 @@
 #include "boost_ext/FastAllocator.hpp"
 #include "common/ThreadLocalPool.h"
 #include "common/tabletuple.h"
+#include "storage/ZoneMap.h"
+#include "storage/AntiCache.h"
 #include <deque>
 
 namespace voltdb {
@@ -89,7 +91,11 @@ class TupleBlock {
     friend void ::intrusive_ptr_add_ref(voltdb::TupleBlock * p);
     friend void ::intrusive_ptr_release(voltdb::TupleBlock * p);
 public:
-    TupleBlock(Table *table, TBBucketPtr bucket);
+    /**
+     * A block for tuplesPerBlock of the table's tuples, or for the
+     * table's full block of tuples when tuplesPerBlock is 0.
+     */
+    TupleBlock(Table *table, TBBucketPtr bucket, uint32_t tuplesPerBlock = 0);
 
     void* operator new(std::size_t sz)
     {
@@ -156,6 +162,7 @@ public:
      * return them as a pair.
      */
     inline std::pair<char*, int> nextFreeTuple() {
+        touch();
         char *retval = NULL;
         if (!m_freeList.empty()) {
             m_lastCompactionOffset = 0;
@@ -218,6 +225,14 @@ public:
         return m_nextFreeTuple;
     }
 
+    inline uint32_t tupleCapacity() const {
+        return m_tuplesPerBlock;
+    }
+
+    inline std::size_t storageSize() const {
+        return m_storageSize;
+    }
+
     ~TupleBlock();
 
     inline uint32_t lastCompactionOffset() {
@@ -235,8 +250,55 @@ public:
     inline TBBucketPtr currentBucket() {
         return m_bucket;
     }
+
+    inline ZoneMap& zoneMap() {
+        return m_zoneMap;
+    }
+
+    inline const ZoneMap& zoneMap() const {
+        return m_zoneMap;
+    }
+
+    /**
+     * Note an access by a scan or an insert, bringing the block back into
+     * anonymous memory first if it was evicted.
+     */
+    inline void touch() {
+        if (m_evictedOffset >= 0) {
+            fetch();
+        }
+        m_lastAccess = AntiCache::clock();
+    }
+
+    inline bool isEvicted() const {
+        return m_evictedOffset >= 0;
+    }
+
+    /** True if the block's storage can be handed to an AntiCacheStore */
+    inline bool isEvictable() const {
+        return m_antiCacheStorageSize != 0 && m_evictedOffset < 0;
+    }
+
+    inline int64_t lastAccess() const {
+        return m_lastAccess;
+    }
+
+    /** Write the block out to the store, leaving the file mapped in its place */
+    void evict(const boost::shared_ptr<AntiCacheStore> &store);
 private:
+    void fetch();
+
     char*   m_storage;
+    std::size_t m_storageSize;
+    // Bytes mapped for m_storage by HugePages, or 0 when it came from new[]
+    std::size_t m_hugePageStorageSize;
+    bool m_fromHugePagePool;
+    // Bytes mapped for m_storage by AntiCache, or 0 when anti-caching is off
+    std::size_t m_antiCacheStorageSize;
+    // Where the block was written in m_antiCacheStore, or -1 while resident
+    int64_t m_evictedOffset;
+    int64_t m_lastAccess;
+    boost::shared_ptr<AntiCacheStore> m_antiCacheStore;
     uint32_t m_references;
     uint32_t m_tupleLength;
     uint32_t m_tuplesPerBlock;
@@ -255,6 +317,9 @@ private:
 
     TBBucketPtr m_bucket;
     int m_bucketIndex;
+
+    // Summaries of the table's zone map columns, if it has any
+    ZoneMap m_zoneMap;
 };
 
 /**
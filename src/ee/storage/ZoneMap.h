@@ -0,0 +1,110 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZONEMAP_H_
+#define ZONEMAP_H_
+
+#include <vector>
+#include <stdint.h>
+
+#include "common/tabletuple.h"
+#include "common/ValuePeeker.hpp"
+
+namespace voltdb {
+
+/**
+ * Summaries of the values one TupleBlock holds in its table's zone map
+ * columns (see PersistentTable::setZoneMapColumns): the least and greatest
+ * non-null value and the number of NULLs in each column.
+ *
+ * The null counts are exact.  The bounds only widen while the block has
+ * tuples -- deleting the least value does not raise the minimum -- so they
+ * may be loose but never wrong.  They start over when the block empties.
+ */
+class ZoneMap {
+public:
+    struct ColumnSummary {
+        ColumnSummary() : m_min(INT64_MAX), m_max(INT64_MIN), m_nullCount(0) {}
+
+        /** False if the block holds no non-null values in the column */
+        bool hasValues() const { return m_min <= m_max; }
+
+        int64_t m_min;
+        int64_t m_max;
+        uint32_t m_nullCount;
+    };
+
+    /** Only integer and timestamp columns can be summarized */
+    static bool isSummarizable(ValueType type) {
+        switch (type) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /** False for blocks of tables without zone map columns */
+    bool isEnabled() const { return ! m_summaries.empty(); }
+
+    /** Forget every value, keeping a summary for columnCount columns */
+    void reset(std::size_t columnCount) {
+        m_summaries.assign(columnCount, ColumnSummary());
+    }
+
+    const ColumnSummary& summary(int index) const { return m_summaries[index]; }
+
+    /** Account for a tuple stored in the block */
+    void add(const TableTuple &tuple, const std::vector<int> &columns) {
+        for (int ii = 0; ii < m_summaries.size(); ++ii) {
+            const NValue value = tuple.getNValue(columns[ii]);
+            ColumnSummary &summary = m_summaries[ii];
+            if (value.isNull()) {
+                ++summary.m_nullCount;
+                continue;
+            }
+            const int64_t rawValue = ValuePeeker::peekAsRawInt64(value);
+            if (rawValue < summary.m_min) {
+                summary.m_min = rawValue;
+            }
+            if (rawValue > summary.m_max) {
+                summary.m_max = rawValue;
+            }
+        }
+    }
+
+    /** Account for a tuple leaving the block or about to be overwritten */
+    void remove(const TableTuple &tuple, const std::vector<int> &columns) {
+        for (int ii = 0; ii < m_summaries.size(); ++ii) {
+            if (tuple.isNull(columns[ii])) {
+                assert(m_summaries[ii].m_nullCount > 0);
+                --m_summaries[ii].m_nullCount;
+            }
+        }
+    }
+
+private:
+    std::vector<ColumnSummary> m_summaries;
+};
+
+}
+
+#endif /* ZONEMAP_H_ */
@@ -0,0 +1,195 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/ZoneMapFilter.h"
+
+#include <algorithm>
+
+#include "common/ValuePeeker.hpp"
+#include "expressions/abstractexpression.h"
+#include "expressions/constantvalueexpression.h"
+#include "expressions/parametervalueexpression.h"
+#include "expressions/tuplevalueexpression.h"
+#include "storage/persistenttable.h"
+#include "storage/TupleBlock.h"
+#include "storage/ZoneMap.h"
+
+namespace voltdb {
+
+ZoneMapFilter::ZoneMapFilter(const PersistentTable *table, const AbstractExpression *predicate)
+    : m_neverMatches(false), m_blocksSkipped(0)
+{
+    if (table != NULL && predicate != NULL && ! table->zoneMapColumns().empty()) {
+        collectTerms(table, predicate);
+    }
+}
+
+// The index of the summary of the column, or -1 if it has none
+static int summaryIndexOf(const PersistentTable *table, int columnId) {
+    const std::vector<int> &columns = table->zoneMapColumns();
+    std::vector<int>::const_iterator found = std::find(columns.begin(), columns.end(), columnId);
+    if (found == columns.end()) {
+        return -1;
+    }
+    return static_cast<int>(found - columns.begin());
+}
+
+ZoneMapFilter::ZoneMapFilter(const PersistentTable *table, int column, ExpressionType op, int64_t value)
+    : m_neverMatches(false), m_blocksSkipped(0)
+{
+    int summaryIndex = summaryIndexOf(table, column);
+    if (summaryIndex >= 0) {
+        Term term = { summaryIndex, op, value };
+        m_terms.push_back(term);
+    }
+}
+
+static bool isConstantOrParameter(const AbstractExpression *expression) {
+    return dynamic_cast<const ConstantValueExpression*>(expression) != NULL ||
+        dynamic_cast<const ParameterValueExpression*>(expression) != NULL;
+}
+
+// The index of the summary of the scanned column, or -1 if it has none
+static int summaryIndexOf(const PersistentTable *table, const AbstractExpression *expression) {
+    const TupleValueExpression *column = dynamic_cast<const TupleValueExpression*>(expression);
+    if (column == NULL || column->getTupleId() != 0) {
+        return -1;
+    }
+    return summaryIndexOf(table, column->getColumnId());
+}
+
+// The operator that holds with its operands swapped
+static ExpressionType reverseComparison(ExpressionType op) {
+    switch (op) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        return EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        return EXPRESSION_TYPE_COMPARE_LESSTHAN;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+        return EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        return EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+    default:
+        return op;
+    }
+}
+
+void ZoneMapFilter::collectTerms(const PersistentTable *table, const AbstractExpression *predicate) {
+    // A compiled expression keeps its type but not its operands
+    if (predicate == NULL) {
+        return;
+    }
+    ExpressionType op = predicate->getExpressionType();
+    switch (op) {
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+        collectTerms(table, predicate->getLeft());
+        collectTerms(table, predicate->getRight());
+        return;
+    case EXPRESSION_TYPE_OPERATOR_IS_NULL: {
+        int summaryIndex = summaryIndexOf(table, predicate->getLeft());
+        if (summaryIndex >= 0) {
+            Term term = { summaryIndex, op, 0 };
+            m_terms.push_back(term);
+        }
+        return;
+    }
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        break;
+    default:
+        return;
+    }
+
+    const AbstractExpression *constant = predicate->getRight();
+    int summaryIndex = -1;
+    if (isConstantOrParameter(constant)) {
+        summaryIndex = summaryIndexOf(table, predicate->getLeft());
+    }
+    else if (isConstantOrParameter(predicate->getLeft())) {
+        constant = predicate->getLeft();
+        summaryIndex = summaryIndexOf(table, predicate->getRight());
+        op = reverseComparison(op);
+    }
+    if (summaryIndex < 0) {
+        return;
+    }
+
+    const NValue value = constant->eval(NULL, NULL);
+    if (value.isNull()) {
+        // every comparison with NULL is NULL
+        m_neverMatches = true;
+        return;
+    }
+    if ( ! ZoneMap::isSummarizable(ValuePeeker::peekValueType(value))) {
+        return;
+    }
+    Term term = { summaryIndex, op, ValuePeeker::peekAsRawInt64(value) };
+    m_terms.push_back(term);
+}
+
+bool ZoneMapFilter::mayMatch(const TupleBlock &block) {
+    const ZoneMap &zoneMap = block.zoneMap();
+    if ( ! zoneMap.isEnabled()) {
+        return true;
+    }
+    bool mayMatch = ! m_neverMatches;
+    for (int ii = 0; mayMatch && ii < m_terms.size(); ++ii) {
+        const Term &term = m_terms[ii];
+        const ZoneMap::ColumnSummary &summary = zoneMap.summary(term.m_summaryIndex);
+        if (term.m_op == EXPRESSION_TYPE_OPERATOR_IS_NULL) {
+            mayMatch = summary.m_nullCount > 0;
+            continue;
+        }
+        // comparisons with NULL never pass
+        if ( ! summary.hasValues()) {
+            mayMatch = false;
+            continue;
+        }
+        switch (term.m_op) {
+        case EXPRESSION_TYPE_COMPARE_EQUAL:
+            mayMatch = summary.m_min <= term.m_value && term.m_value <= summary.m_max;
+            break;
+        case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+            mayMatch = summary.m_min != term.m_value || summary.m_max != term.m_value;
+            break;
+        case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+            mayMatch = summary.m_min < term.m_value;
+            break;
+        case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+            mayMatch = summary.m_max > term.m_value;
+            break;
+        case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+            mayMatch = summary.m_min <= term.m_value;
+            break;
+        case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+            mayMatch = summary.m_max >= term.m_value;
+            break;
+        default:
+            break;
+        }
+    }
+    if ( ! mayMatch) {
+        ++m_blocksSkipped;
+    }
+    return mayMatch;
+}
+
+}
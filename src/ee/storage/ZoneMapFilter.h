@@ -0,0 +1,82 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZONEMAPFILTER_H_
+#define ZONEMAPFILTER_H_
+
+#include <vector>
+#include <stdint.h>
+
+#include "common/types.h"
+
+namespace voltdb {
+class AbstractExpression;
+class PersistentTable;
+class TupleBlock;
+
+/**
+ * The conditions a scan predicate puts on a table's zone map columns, for
+ * a TableIterator to skip the blocks whose ZoneMap proves that none of
+ * their tuples can pass the predicate.
+ *
+ * Only the predicate's top-level AND terms of the forms "column <op>
+ * constant-or-parameter" (with an integer or timestamp constant) and
+ * "column IS NULL" are used; the rest of the predicate is ignored, so the
+ * scan still has to evaluate all of it on the tuples it does not skip.
+ * Parameters are read when the filter is built.
+ */
+class ZoneMapFilter {
+public:
+    /**
+     * A NULL table or predicate makes an empty filter.  The predicate has
+     * to be the planned expression tree (see
+     * AbstractScanPlanNode::getOriginalPredicate), since a compiled one
+     * does not expose the terms.
+     */
+    ZoneMapFilter(const PersistentTable *table, const AbstractExpression *predicate);
+
+    /** A filter for the one condition "column <op> value" on an integer or timestamp column */
+    ZoneMapFilter(const PersistentTable *table, int column, ExpressionType op, int64_t value);
+
+    /** True if the predicate puts no usable condition on the zone map columns */
+    bool isEmpty() const { return m_terms.empty() && ! m_neverMatches; }
+
+    /** False if no tuple of the block can pass the predicate */
+    bool mayMatch(const TupleBlock &block);
+
+    /** The number of blocks mayMatch turned down */
+    int64_t blocksSkipped() const { return m_blocksSkipped; }
+
+private:
+    struct Term {
+        // index of the column in the table's zone map column list
+        int m_summaryIndex;
+        ExpressionType m_op;
+        int64_t m_value;
+    };
+
+    void collectTerms(const PersistentTable *table, const AbstractExpression *predicate);
+
+    std::vector<Term> m_terms;
+    // Set by a comparison with NULL, which no tuple passes
+    bool m_neverMatches;
+    int64_t m_blocksSkipped;
+};
+
+}
+
+#endif /* ZONEMAPFILTER_H_ */
@@ -72,6 +72,7 @@
 #include "common/RecoveryProtoMessage.h"
 #include "common/StreamPredicateList.h"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "catalog/catalog.h"
 #include "catalog/database.h"
 #include "catalog/table.h"
@@ -86,6 +87,7 @@
 #include <boost/scoped_ptr.hpp>
 
 #include <algorithm>    // std::find
+#include <cstdlib>
 #include <cassert>
 #include <cstdio>
 #include <sstream>
@@ -96,6 +98,13 @@ TableTuple keyTuple;
 
 #define TABLE_BLOCKSIZE 2097152
 
+static int minimumBlockSizeFromEnvironment() {
+    const char* setting = ::getenv("VOLTDB_MIN_BLOCK_SIZE");
+    return setting == NULL ? 0 : std::max(0, ::atoi(setting));
+}
+
+int PersistentTable::s_minimumBlockSize = minimumBlockSizeFromEnvironment();
+
 class SetAndRestorePendingDeleteFlag
 {
 public:
@@ -122,6 +131,16 @@ PersistentTable::PersistentTable(int partitionColumn, const char * signature, bo
     m_purgeExecutorVector(),
     m_stats(this),
     m_failedCompactionCount(0),
+    m_allocatedTupleCount(0),
+    m_allocatedTupleMemory(0),
+    m_compactionStepCount(0),
+    m_compactionTime(0),
+    m_maxCompactionPause(0),
+    m_ttlColumn(-1),
+    m_ttlMicros(0),
+    m_oldestTimeToLive(INT64_MIN),
+    m_expiredTupleCount(0),
+    m_expirationTime(0),
     m_invisibleTuplesPendingDeleteCount(0),
     m_surgeon(*this),
     m_isMaterialized(isMaterialized),
@@ -131,6 +150,8 @@ PersistentTable::PersistentTable(int partitionColumn, const char * signature, bo
     m_smallestUniqueIndexCrc(0),
     m_drTimestampColumnIndex(-1),
     m_pkeyIndex(NULL),
+    m_bulkIndexing(false),
+    m_bulkIndexingUnique(false),
     m_mvHandler(NULL),
     m_deltaTable(NULL),
     m_deltaTableActive(false)
@@ -178,6 +199,8 @@ void PersistentTable::initializeWithColumns(TupleSchema *schema,
     // note that any allocated memory in m_data is left alone
     // as is m_allocatedTuples
     m_data.clear();
+    m_allocatedTupleCount = 0;
+    m_allocatedTupleMemory = 0;
 }
 
 PersistentTable::~PersistentTable() {
@@ -618,6 +641,9 @@ void PersistentTable::insertPersistentTuple(TableTuple &source, bool fallible, b
     // Then copy the source into the target
     //
     target.copyForPersistentInsert(source); // tuple in freelist must be already cleared
+    if (m_stringDictionary != NULL) {
+        encodeDictionaryColumns(target);
+    }
 
     try {
         insertTupleCommon(source, target, fallible);
@@ -632,8 +658,22 @@ void PersistentTable::insertPersistentTuple(TableTuple &source, bool fallible, b
     }
 }
 
+inline void PersistentTable::lowerOldestTimeToLive(const TableTuple &tuple) {
+    if (m_ttlColumn < 0) {
+        return;
+    }
+    const NValue value = tuple.getNValue(m_ttlColumn);
+    if ( ! value.isNull() && ValuePeeker::peekTimestamp(value) < m_oldestTimeToLive) {
+        m_oldestTimeToLive = ValuePeeker::peekTimestamp(value);
+    }
+}
+
 void PersistentTable::insertTupleCommon(TableTuple &source, TableTuple &target,
                                         bool fallible, bool shouldDRStream) {
+    // First, since a failed insert takes the tuple back out with deleteTupleStorage
+    addToZoneMap(target);
+    lowerOldestTimeToLive(target);
+
     if (fallible) {
         // not null checks at first
         FAIL_IF(!checkNulls(target)) {
@@ -893,7 +933,13 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple &targetTupleToUp
     std::vector<char*> newObjects;
 
     // this is the actual write of the new values
+    removeFromZoneMap(targetTupleToUpdate);
     targetTupleToUpdate.copyForPersistentUpdate(sourceTupleWithNewValues, oldObjects, newObjects);
+    if (m_stringDictionary != NULL && ! newObjects.empty()) {
+        decreaseStringMemCount(encodeDictionaryColumns(targetTupleToUpdate, &newObjects));
+    }
+    addToZoneMap(targetTupleToUpdate);
+    lowerOldestTimeToLive(targetTupleToUpdate);
 
     if (uq) {
         /*
@@ -983,7 +1029,10 @@ void PersistentTable::updateTupleForUndo(char* tupleWithUnwantedValues,
 
     bool dirty = targetTupleToUpdate.isDirty();
     // this is the actual in-place revert to the old version
+    removeFromZoneMap(targetTupleToUpdate);
     targetTupleToUpdate.copy(sourceTupleWithNewValues);
+    addToZoneMap(targetTupleToUpdate);
+    lowerOldestTimeToLive(targetTupleToUpdate);
     if (dirty) {
         targetTupleToUpdate.setDirtyTrue();
     }
@@ -1121,7 +1170,7 @@ void PersistentTable::deleteTupleFinalize(TableTuple &target) {
  *  Indexes and views have been destroyed first.
  */
 void PersistentTable::deleteTupleForSchemaChange(TableTuple &target) {
-    TBPtr block = findBlock(target.address(), m_data, m_tableAllocationSize);
+    TBPtr block = findBlock(target.address(), m_data);
     // free object columns along with empty tuple block storage
     deleteTupleStorage(target, block, true);
 }
@@ -1232,19 +1281,32 @@ void PersistentTable::deleteFromAllIndexes(TableTuple *tuple) {
     }
 }
 
+inline bool PersistentTable::isBulkIndexed(const TableIndex *index) const {
+    return m_bulkIndexing && (m_bulkIndexingUnique || ! index->isUniqueIndex());
+}
+
 void PersistentTable::tryInsertOnAllIndexes(TableTuple *tuple, TableTuple *conflict) {
     for (int i = 0; i < static_cast<int>(m_indexes.size()); ++i) {
+        if (isBulkIndexed(m_indexes[i])) {
+            continue;
+        }
         m_indexes[i]->addEntry(tuple, conflict);
         FAIL_IF(!conflict->isNullTuple()) {
             VOLT_DEBUG("Failed to insert into index %s,%s",
                        m_indexes[i]->getTypeName().c_str(),
                        m_indexes[i]->getName().c_str());
             for (int j = 0; j < i; ++j) {
+                if (isBulkIndexed(m_indexes[j])) {
+                    continue;
+                }
                 m_indexes[j]->deleteEntry(tuple);
             }
             return;
         }
     }
+    if (m_bulkIndexing) {
+        m_bulkIndexTuples.push_back(tuple->address());
+    }
 }
 
 bool PersistentTable::checkUpdateOnUniqueIndexes(TableTuple &targetTupleToUpdate,
@@ -1363,6 +1425,10 @@ void PersistentTable::processLoadedTuple(TableTuple &tuple,
                                          int32_t &serializedTupleCount,
                                          size_t &tupleCountPosition,
                                          bool shouldDRStreamRows) {
+    // Deserialized strings are the tuple's own, so share them as an insert would
+    if (m_stringDictionary != NULL) {
+        encodeDictionaryColumns(tuple);
+    }
     try {
         insertTupleCommon(tuple, tuple, true, shouldDRStreamRows);
     }
@@ -1376,6 +1442,10 @@ void PersistentTable::processLoadedTuple(TableTuple &tuple,
         }
         serializedTupleCount++;
         tuple.serializeTo(*uniqueViolationOutput);
+        if ( ! m_bulkIndexTuples.empty() && m_bulkIndexTuples.back() == tuple.address()) {
+            // Failed after its unique index checks passed
+            m_bulkIndexTuples.pop_back();
+        }
         deleteTupleStorage(tuple);
     }
 }
@@ -1464,7 +1534,9 @@ void PersistentTable::processRecoveryMessage(RecoveryProtoMsg* message, Pool *po
                 index->ensureCapacity(tupleCount);
             }
         }
+        beginBulkIndexing(true);
         loadTuplesFromNoHeader(*message->stream(), pool);
+        endBulkIndexing();
         break;
     }
     default:
@@ -1513,6 +1585,8 @@ void PersistentTable::notifyBlockWasCompactedAway(TBPtr block) {
 // Call-back from TupleBlock::merge() for each tuple moved.
 void PersistentTable::notifyTupleMovement(TBPtr sourceBlock, TBPtr targetBlock,
                                           TableTuple &sourceTuple, TableTuple &targetTuple) {
+    removeFromZoneMap(targetTuple, sourceBlock);
+    addToZoneMap(targetTuple, targetBlock);
     if (m_tableStreamer != NULL) {
         m_tableStreamer->notifyTupleMovement(sourceBlock, targetBlock, sourceTuple, targetTuple);
     }
@@ -1607,6 +1681,10 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector *bucketVector)
         if (lightest->isEmpty()) {
             notifyBlockWasCompactedAway(lightest);
             m_data.erase(lightest->address());
+            if (m_tupleSlots != NULL) {
+                m_tupleSlots->removeBlock(lightest->address());
+            }
+            forgetBlockStorage(lightest);
             m_blocksWithSpace.erase(lightest);
             m_blocksNotPendingSnapshot.erase(lightest);
             m_blocksPendingSnapshot.erase(lightest);
@@ -1638,6 +1716,63 @@ void PersistentTable::doIdleCompaction() {
     }
 }
 
+bool PersistentTable::doCompactionStep() {
+    bool hadWork = false;
+    if (!m_blocksNotPendingSnapshot.empty()) {
+        hadWork = doCompactionWithinSubset(&m_blocksNotPendingSnapshotLoad);
+    }
+    if (!m_blocksPendingSnapshot.empty()) {
+        hadWork = doCompactionWithinSubset(&m_blocksPendingSnapshotLoad) || hadWork;
+    }
+    return hadWork;
+}
+
+int64_t PersistentTable::doIncrementalCompaction(int64_t budgetMicros) {
+    if (m_tableStreamer.get() != NULL && m_tableStreamer->hasStreamType(TABLE_STREAM_RECOVERY)) {
+        return 0;
+    }
+    boost::posix_time::ptime startTime(boost::posix_time::microsec_clock::universal_time());
+    int64_t elapsedMicros = 0;
+    do {
+        if (!doCompactionStep()) {
+            // The load buckets are missing blocks the predicate counts,
+            // see doForcedCompaction. Give up until the next attempt.
+            m_failedCompactionCount++;
+            break;
+        }
+        m_compactionStepCount++;
+        boost::posix_time::time_duration elapsed =
+            boost::posix_time::microsec_clock::universal_time() - startTime;
+        elapsedMicros = elapsed.total_microseconds();
+    } while (elapsedMicros < budgetMicros && compactionPredicate());
+    elapsedMicros = (boost::posix_time::microsec_clock::universal_time() - startTime).total_microseconds();
+
+    m_compactionTime += elapsedMicros;
+    m_maxCompactionPause = std::max(m_maxCompactionPause, elapsedMicros);
+    return elapsedMicros;
+}
+
+void PersistentTable::collectEvictableBlocks(std::vector<TBPtr> &blocks) {
+    const int64_t now = AntiCache::clock();
+    for (TBMapI iter = m_data.begin(); iter != m_data.end(); ++iter) {
+        TBPtr block = iter.data();
+        // Blocks with space are where the next inserts go
+        // A table's store holds only full size blocks
+        if (block->isEvictable() && block->lastAccess() < now &&
+                block->storageSize() == m_tableAllocationSize &&
+                m_blocksWithSpace.find(block) == m_blocksWithSpace.end()) {
+            blocks.push_back(block);
+        }
+    }
+}
+
+void PersistentTable::evictBlock(TBPtr block) {
+    if (m_antiCacheStore == NULL) {
+        m_antiCacheStore.reset(new AntiCacheStore(m_tableAllocationSize));
+    }
+    block->evict(m_antiCacheStore);
+}
+
 bool PersistentTable::doForcedCompaction() {
     if (m_tableStreamer.get() != NULL && m_tableStreamer->hasStreamType(TABLE_STREAM_RECOVERY)) {
         LogManager::getThreadLogger(LOGGERID_SQL)->log(LOGLEVEL_INFO,
@@ -1908,12 +2043,28 @@ TableIndex* PersistentTable::index(std::string name) const {
 void PersistentTable::addIndex(TableIndex *index) {
     assert(!isExistingTableIndex(m_indexes, index));
 
-    // fill the index with tuples... potentially the slow bit
+    // Bitmap indexes number the tuples by their place in the blocks, the
+    // same way for every index, so the tuples they find can be combined.
+    if (index->usesTupleSlots()) {
+        if (m_tupleSlots == NULL) {
+            m_tupleSlots.reset(new TupleSlotMap(m_tupleLength, m_tuplesPerBlock));
+            for (TBMapI iter = m_data.begin(); iter != m_data.end(); ++iter) {
+                m_tupleSlots->addBlock(iter.key());
+            }
+        }
+        index->setTupleSlotMap(m_tupleSlots.get());
+    }
+
+    // fill the index with tuples... potentially the slow bit,
+    // so sort them by key and build the index in one pass
+    std::vector<char*> tupleAddresses;
+    tupleAddresses.reserve(activeTupleCount());
     TableTuple tuple(m_schema);
     TableIterator iter = iterator();
     while (iter.next(tuple)) {
-        index->addEntry(&tuple, NULL);
+        tupleAddresses.push_back(tuple.address());
     }
+    index->addEntries(tupleAddresses);
 
     // add the index to the table
     if (index->isUniqueIndex()) {
@@ -1927,6 +2078,27 @@ void PersistentTable::addIndex(TableIndex *index) {
     polluteViews();
 }
 
+void PersistentTable::beginBulkIndexing(bool uniqueIndexesToo) {
+    assert(m_bulkIndexTuples.empty());
+    m_bulkIndexing = m_viewHandlers.empty();
+    m_bulkIndexingUnique = m_bulkIndexing && uniqueIndexesToo;
+}
+
+void PersistentTable::endBulkIndexing() {
+    if ( ! m_bulkIndexing) {
+        return;
+    }
+    BOOST_FOREACH(TableIndex *index, m_indexes) {
+        if (isBulkIndexed(index) && ! index->addEntries(m_bulkIndexTuples)) {
+            throwFatalException("Duplicate key in unique index %s while bulk loading table %s",
+                                index->getName().c_str(), m_name.c_str());
+        }
+    }
+    m_bulkIndexing = false;
+    m_bulkIndexingUnique = false;
+    std::vector<char*>().swap(m_bulkIndexTuples);
+}
+
 void PersistentTable::removeIndex(TableIndex *index) {
     assert(isExistingTableIndex(m_indexes, index));
 
@@ -1963,6 +2135,162 @@ void PersistentTable::setPrimaryKeyIndex(TableIndex *index) {
     m_pkeyIndex = index;
 }
 
+void PersistentTable::setZoneMapColumns(const std::vector<int> &columns) {
+    m_zoneMapColumns.clear();
+    BOOST_FOREACH(int column, columns) {
+        if (ZoneMap::isSummarizable(m_schema->columnType(column))) {
+            m_zoneMapColumns.push_back(column);
+        }
+    }
+
+    TableTuple tuple(m_schema);
+    for (TBMapI iter = m_data.begin(); iter != m_data.end(); ++iter) {
+        TBPtr block = iter.data();
+        block->zoneMap().reset(m_zoneMapColumns.size());
+        if (m_zoneMapColumns.empty()) {
+            continue;
+        }
+        for (uint32_t ii = 0; ii < block->unusedTupleBoundry(); ++ii) {
+            tuple.move(block->address() + m_tupleLength * ii);
+            if (tuple.isActive()) {
+                block->zoneMap().add(tuple, m_zoneMapColumns);
+            }
+        }
+    }
+}
+
+void PersistentTable::setDictionaryColumns(const std::vector<int> &columns) {
+    m_dictionaryColumns.clear();
+    BOOST_FOREACH(int column, columns) {
+        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(column);
+        if ((columnInfo->getVoltType() == VALUE_TYPE_VARCHAR ||
+             columnInfo->getVoltType() == VALUE_TYPE_VARBINARY) && ! columnInfo->inlined) {
+            m_dictionaryColumns.push_back(column);
+        }
+    }
+    if (m_dictionaryColumns.empty()) {
+        // Tuples may still hold its strings; they outlive it
+        m_stringDictionary.reset();
+    }
+    else if (m_stringDictionary == NULL) {
+        m_stringDictionary.reset(new StringDictionary(m_nonInlinedMemorySize));
+    }
+}
+
+std::size_t PersistentTable::encodeDictionaryColumns(TableTuple &tuple, std::vector<char*> *newObjects) {
+    std::size_t bytesFreed = 0;
+    BOOST_FOREACH(int column, m_dictionaryColumns) {
+        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(column);
+        StringRef** slot = reinterpret_cast<StringRef**>(tuple.getWritableDataPtr(columnInfo));
+        StringRef* sref = *slot;
+        if (sref == NULL || StringDictionary::isShared(sref)) {
+            continue;
+        }
+        int32_t length;
+        const char* bytes = sref->getObject(&length);
+        StringRef* shared = m_stringDictionary->intern(bytes, length);
+        if (newObjects != NULL) {
+            std::replace(newObjects->begin(), newObjects->end(),
+                         reinterpret_cast<char*>(sref), reinterpret_cast<char*>(shared));
+        }
+        bytesFreed += sref->getAllocatedSize();
+        StringRef::destroy(sref);
+        *slot = shared;
+    }
+    return bytesFreed;
+}
+
+void PersistentTable::setTimeToLive(int column, int64_t ttlMicros) {
+    assert(column < 0 || m_schema->columnType(column) == VALUE_TYPE_TIMESTAMP);
+    m_ttlColumn = column;
+    m_ttlMicros = ttlMicros;
+    m_oldestTimeToLive = INT64_MIN;
+}
+
+TableIndex *PersistentTable::timeToLiveIndex() const {
+    BOOST_FOREACH(TableIndex *index, m_indexes) {
+        if ((index->getIndexType() == BALANCED_TREE_INDEX || index->getIndexType() == BTREE_INDEX) &&
+            ! index->isPartialIndex() &&
+            index->getIndexedExpressions().empty() &&
+            index->getColumnIndices()[0] == m_ttlColumn) {
+            return index;
+        }
+    }
+    return NULL;
+}
+
+int PersistentTable::expireTuples(int64_t nowMicros, int maxTuples) {
+    const int64_t cutoff = nowMicros - m_ttlMicros;
+    if (m_ttlColumn < 0 || maxTuples <= 0 || cutoff <= m_oldestTimeToLive || activeTupleCount() == 0) {
+        return 0;
+    }
+    boost::posix_time::ptime startTime(boost::posix_time::microsec_clock::universal_time());
+
+    // Find the tuples first, since deleting them would upset the scan
+    std::vector<TableTuple> expired;
+    // The oldest timestamp that is not expiring, if the search finds it
+    int64_t oldestKept = INT64_MAX;
+    TableIndex *index = timeToLiveIndex();
+    if (index != NULL) {
+        // The index holds the oldest tuples first, after the NULLs, which
+        // sort before the oldest timestamp with any values after it
+        StandAloneTupleStorage keyStorage(index->getKeySchema());
+        TableTuple &searchKey = const_cast<TableTuple&>(keyStorage.tuple());
+        searchKey.setAllNulls();
+        searchKey.setNValue(0, ValueFactory::getTimestampValue(INT64_MIN + 1));
+        IndexCursor cursor(index->getTupleSchema());
+        index->moveToKeyOrGreater(&searchKey, cursor);
+        TableTuple tuple;
+        while (expired.size() < maxTuples && ! (tuple = index->nextValue(cursor)).isNullTuple()) {
+            const int64_t timestamp = ValuePeeker::peekTimestamp(tuple.getNValue(m_ttlColumn));
+            if (timestamp >= cutoff) {
+                oldestKept = timestamp;
+                break;
+            }
+            expired.push_back(tuple);
+        }
+    }
+    else {
+        ZoneMapFilter filter(this, m_ttlColumn, EXPRESSION_TYPE_COMPARE_LESSTHAN, cutoff);
+        TableTuple tuple(m_schema);
+        TableIterator ti = iterator();
+        if ( ! filter.isEmpty()) {
+            ti.setZoneMapFilter(&filter);
+            // Blocks the filter skips hold nothing older than the cutoff
+            oldestKept = cutoff;
+        }
+        while (expired.size() < maxTuples && ti.next(tuple)) {
+            const NValue value = tuple.getNValue(m_ttlColumn);
+            if (value.isNull()) {
+                continue;
+            }
+            const int64_t timestamp = ValuePeeker::peekTimestamp(value);
+            if (timestamp < cutoff) {
+                expired.push_back(tuple);
+            }
+            else if (timestamp < oldestKept) {
+                oldestKept = timestamp;
+            }
+        }
+    }
+
+    // A search that expires nothing has seen every tuple it would, while
+    // expired tuples come back if the transaction rolls back, so only an
+    // empty search can move the bound up.
+    if (expired.empty()) {
+        m_oldestTimeToLive = oldestKept;
+    }
+
+    BOOST_FOREACH(TableTuple &tuple, expired) {
+        deleteTuple(tuple, true);
+    }
+
+    boost::posix_time::ptime endTime(boost::posix_time::microsec_clock::universal_time());
+    m_expiredTupleCount += expired.size();
+    m_expirationTime += (endTime - startTime).total_microseconds();
+    return static_cast<int>(expired.size());
+}
+
 void PersistentTable::configureIndexStats() {
     // initialize stats for all the indexes for the table
     BOOST_FOREACH(TableIndex *index, m_indexes) {
@@ -67,11 +67,15 @@
 #include "storage/RecoveryContext.h"
 #include "storage/ElasticIndex.h"
 #include "storage/CopyOnWriteIterator.h"
+#include "storage/AntiCache.h"
 #include "common/UndoQuantumReleaseInterest.h"
 #include "common/ThreadLocalPool.h"
+#include "common/StringDictionary.h"
+#include "indexes/TupleSlotMap.h"
 
 class CompactionTest_BasicCompaction;
 class CompactionTest_CompactionWithCopyOnWrite;
+class CompactionTest_IncrementalCompaction;
 class CopyOnWriteTest;
 
 namespace catalog {
@@ -205,6 +209,7 @@ class PersistentTable : public Table, public UndoQuantumReleaseInterest,
     friend class ::CopyOnWriteTest;
     friend class ::CompactionTest_BasicCompaction;
     friend class ::CompactionTest_CompactionWithCopyOnWrite;
+    friend class ::CompactionTest_IncrementalCompaction;
     friend class CoveringCellIndexTest_TableCompaction;
     friend class MaterializedViewHandler;
     friend class ScopedDeltaTableContext;
@@ -228,8 +233,11 @@ public:
     }
 
     void notifyQuantumRelease() {
+        // Take one bounded compaction step rather than compacting until done,
+        // so a large delete does not stall the site thread on release. The
+        // rest is left to VoltDBEngine::tick.
         if (compactionPredicate()) {
-            doForcedCompaction();
+            doIncrementalCompaction(0);
         }
     }
 
@@ -304,11 +312,81 @@ public:
 
     void configureIndexStats();
 
+    /**
+     * Keep a ZoneMap in each block for these integer or timestamp columns,
+     * so that scans can skip blocks (see ZoneMapFilter).  Other columns are
+     * ignored.  The tuples already stored are summarized now.
+     */
+    void setZoneMapColumns(const std::vector<int> &columns);
+
+    const std::vector<int>& zoneMapColumns() const { return m_zoneMapColumns; }
+
+    /**
+     * Store each distinct value of these uninlined VARCHAR or VARBINARY
+     * columns once, in a StringDictionary, and have the tuples share it.
+     * Other columns are ignored.  Only values stored from now on are
+     * encoded.
+     */
+    void setDictionaryColumns(const std::vector<int> &columns);
+
+    const std::vector<int>& dictionaryColumns() const { return m_dictionaryColumns; }
+
+    /** The number of distinct values in the dictionary encoded columns */
+    std::size_t dictionarySize() const {
+        return m_stringDictionary == NULL ? 0 : m_stringDictionary->size();
+    }
+
+    /** The bytes of the distinct values, which nonInlinedMemorySize includes */
+    int64_t dictionaryMemorySize() const {
+        return m_stringDictionary == NULL ? 0 : m_stringDictionary->bytesAllocated();
+    }
+
+    /**
+     * Expire the tuples whose value in this timestamp column is older than
+     * ttlMicros (see expireTuples).  A column of -1 turns expiration off.
+     */
+    void setTimeToLive(int column, int64_t ttlMicros);
+
+    int timeToLiveColumn() const { return m_ttlColumn; }
+
+    /**
+     * Delete up to maxTuples tuples that have outlived the table's time to
+     * live as of nowMicros, oldest first if an index leads with the TTL
+     * column, and return how many were deleted.  This runs inside a
+     * read-write transaction, whose timestamp is nowMicros (see
+     * VoltDBEngine::expireTuples), so the deletes are undone and logged for
+     * DR with the rest of its work.  NULL timestamps never expire.
+     *
+     * Without such an index this scans the table, so once a search finds
+     * nothing to expire the oldest timestamp left is kept, and later calls
+     * return at once until the cutoff passes it.
+     */
+    int expireTuples(int64_t nowMicros, int maxTuples);
+
+    /** The number of tuples expireTuples has deleted */
+    int64_t expiredTupleCount() const { return m_expiredTupleCount; }
+
+    /** The time spent in expireTuples, in microseconds */
+    int64_t expirationTime() const { return m_expirationTime; }
+
     // mutating indexes
     void addIndex(TableIndex *index);
     void removeIndex(TableIndex *index);
     void setPrimaryKeyIndex(TableIndex *index);
 
+    /**
+     * Between these calls, as when loading a snapshot or migrating tuples,
+     * non-unique indexes are not updated tuple by tuple but all at once,
+     * in key order, by endBulkIndexing.  Unique indexes still check each
+     * tuple as it is inserted, unless uniqueIndexesToo is set for a load
+     * that has no way to report a duplicate key; endBulkIndexing then
+     * finds any duplicate as it merges and fails fatally, as the load
+     * would have.  Not done for tables that join views read, since those
+     * may scan this table's indexes as each tuple goes in.
+     */
+    void beginBulkIndexing(bool uniqueIndexesToo = false);
+    void endBulkIndexing();
+
     // ------------------------------------------------------------------
     // PERSISTENT TABLE OPERATIONS
     // ------------------------------------------------------------------
@@ -351,7 +429,7 @@ public:
     /*
      * Find the block a tuple belongs to. Returns TBPtr(NULL) if no block is found.
      */
-    static TBPtr findBlock(char *tuple, TBMap &blocks, int blockSize);
+    static TBPtr findBlock(char *tuple, TBMap &blocks);
 
     int partitionColumn() const { return m_partitionColumn; }
 
@@ -410,6 +488,47 @@ public:
 
     void doIdleCompaction();
 
+    /**
+     * Merge blocks a step at a time until the table no longer needs
+     * compacting or budgetMicros have been spent. At least one step is
+     * taken. Returns the microseconds spent.
+     */
+    int64_t doIncrementalCompaction(int64_t budgetMicros);
+
+    bool needsCompaction() {
+        return compactionPredicate();
+    }
+
+    // Memory held by allocated but unused tuples that compaction could free
+    int64_t reclaimableTupleMemory() const {
+        return (allocatedTupleCount() - activeTupleCount()) * m_tempTuple.tupleLength();
+    }
+
+    int64_t compactionStepCount() const { return m_compactionStepCount; }
+    int64_t compactionTime() const { return m_compactionTime; }
+    int64_t maxCompactionPause() const { return m_maxCompactionPause; }
+
+    /**
+     * Add the resident blocks that have not been scanned or inserted into
+     * since the clock last advanced to blocks, for anti-caching to evict.
+     */
+    void collectEvictableBlocks(std::vector<TBPtr> &blocks);
+
+    /** Write one of this table's blocks out to its anti-cache store */
+    void evictBlock(TBPtr block);
+
+    int64_t evictedBlockCount() const {
+        return m_antiCacheStore == NULL ? 0 : m_antiCacheStore->evictedBlockCount();
+    }
+
+    int64_t evictedTupleMemory() const {
+        return m_antiCacheStore == NULL ? 0 : m_antiCacheStore->evictedBytes();
+    }
+
+    int64_t fetchedBlockCount() const {
+        return m_antiCacheStore == NULL ? 0 : m_antiCacheStore->fetchedBlockCount();
+    }
+
     void printBucketInfo();
 
     void increaseStringMemCount(size_t bytes) {
@@ -424,6 +543,26 @@ public:
         return m_data.size();
     }
 
+    // Blocks come in different sizes when they start small
+    virtual int64_t allocatedTupleCount() const {
+        return m_allocatedTupleCount;
+    }
+
+    virtual int64_t allocatedTupleMemory() const {
+        return m_allocatedTupleMemory;
+    }
+
+    /**
+     * Size the first blocks of tables created from now on to hold about
+     * this many bytes of tuples, rather than a full block, and each later
+     * block to double the table's capacity until blocks are full size.
+     * Zero, the default, makes every block full size.  Set by the
+     * VOLTDB_MIN_BLOCK_SIZE environment variable.
+     */
+    static void setMinimumBlockSize(int bytes) { s_minimumBlockSize = bytes; }
+
+    static int minimumBlockSize() { return s_minimumBlockSize; }
+
     // This is a testability feature not intended for use in product logic.
     int visibleTupleCount() const { return m_tupleCount - m_invisibleTuplesPendingDeleteCount; }
 
@@ -524,6 +663,9 @@ public:
     std::pair<const TableIndex*, uint32_t> getUniqueIndexForDR();
 
     MaterializedViewHandler *materializedViewHandler() const { return m_mvHandler; }
+    // Maintaining views may scan this table while an updated or deleted
+    // tuple is still indexed but hidden as pending delete.
+    bool hasViews() const { return ! m_views.empty() || ! m_viewHandlers.empty(); }
     Table* deltaTable() const { return m_deltaTable; }
     bool isDeltaTableActive() { return m_deltaTableActive; }
 
@@ -581,6 +723,7 @@ private:
     void nextFreeTuple(TableTuple *tuple);
     bool doCompactionWithinSubset(TBBucketPtrVector *bucketVector);
     bool doForcedCompaction();  // Returns true if a compaction was performed
+    bool doCompactionStep();  // Returns true if any blocks were merged
 
     void insertIntoAllIndexes(TableTuple *tuple);
     void deleteFromAllIndexes(TableTuple *tuple);
@@ -636,6 +779,26 @@ private:
 
     TBPtr allocateNextBlock();
 
+    // Account for a block taken out of m_data
+    void forgetBlockStorage(TBPtr block);
+
+    // Whether index is left for endBulkIndexing to fill
+    bool isBulkIndexed(const TableIndex *index) const;
+
+    // A tree index that leads with the TTL column, for finding the oldest tuples
+    TableIndex *timeToLiveIndex() const;
+
+    // Keep m_oldestTimeToLive at or below the tuple's TTL column
+    void lowerOldestTimeToLive(const TableTuple &tuple);
+
+    // Account for a tuple stored in, or leaving, its block's zone map
+    void addToZoneMap(TableTuple &tuple, TBPtr block = TBPtr(NULL));
+    void removeFromZoneMap(TableTuple &tuple, TBPtr block = TBPtr(NULL));
+
+    // Swap the tuple's own copies of dictionary column values for shared
+    // ones, also in newObjects if given.  Returns the bytes freed.
+    std::size_t encodeDictionaryColumns(TableTuple &tuple, std::vector<char*> *newObjects = NULL);
+
     inline AbstractDRTupleStream *getDRTupleStream(ExecutorContext *ec) {
         if (isReplicatedTable()) {
             return ec->drReplicatedStream();
@@ -700,6 +863,40 @@ private:
     TBMap m_data;
     int m_failedCompactionCount;
 
+    // Tuple slots and bytes in m_data's blocks
+    int64_t m_allocatedTupleCount;
+    int64_t m_allocatedTupleMemory;
+
+    static int s_minimumBlockSize;
+
+    // Incremental compaction steps taken, and the microseconds they took
+    // in all and in the longest single pause
+    int64_t m_compactionStepCount;
+    int64_t m_compactionTime;
+    int64_t m_maxCompactionPause;
+
+    // Where this table's cold blocks are evicted to, once any have been
+    boost::shared_ptr<AntiCacheStore> m_antiCacheStore;
+
+    // Columns summarized by each block's ZoneMap
+    std::vector<int> m_zoneMapColumns;
+
+    // Uninlined columns whose values are shared through m_stringDictionary
+    std::vector<int> m_dictionaryColumns;
+    boost::scoped_ptr<StringDictionary> m_stringDictionary;
+
+    // Numbers the blocks for the bitmap indexes, once there are any
+    boost::scoped_ptr<TupleSlotMap> m_tupleSlots;
+
+    // Time to live of the tuples, by the timestamp in m_ttlColumn
+    int m_ttlColumn;
+    int64_t m_ttlMicros;
+    // No tuple has a non-NULL timestamp older than this, so expireTuples
+    // has nothing to find until its cutoff passes it
+    int64_t m_oldestTimeToLive;
+    int64_t m_expiredTupleCount;
+    int64_t m_expirationTime;
+
     // This is a testability feature not intended for use in product logic.
     int m_invisibleTuplesPendingDeleteCount;
 
@@ -728,6 +925,12 @@ private:
     std::vector<TableIndex*> m_uniqueIndexes;
     TableIndex *m_pkeyIndex;
 
+    // Tuples still to be added to non-unique indexes, and to unique ones
+    // too if m_bulkIndexingUnique, while bulk indexing
+    bool m_bulkIndexing;
+    bool m_bulkIndexingUnique;
+    std::vector<char*> m_bulkIndexTuples;
+
     // If I myself am a view table, I need to maintain a handler to handle the view update work.
     MaterializedViewHandler *m_mvHandler;
     // If I am a source table of a view, I will notify all the relevant view handlers
@@ -951,12 +1154,14 @@ inline void PersistentTable::deleteTupleStorage(TableTuple &tuple, TBPtr block,
     }
 
     if (block.get() == NULL) {
-        block = findBlock(tuple.address(), m_data, m_tableAllocationSize);
+        block = findBlock(tuple.address(), m_data);
         if (block.get() == NULL) {
             throwFatalException("Tried to find a tuple block for a tuple but couldn't find one");
         }
     }
 
+    removeFromZoneMap(tuple, block);
+
     bool transitioningToBlockWithSpace = !block->hasFreeTuples();
 
     int retval = block->freeTuple(tuple.address());
@@ -980,6 +1185,10 @@ inline void PersistentTable::deleteTupleStorage(TableTuple &tuple, TBPtr block,
         // Release the empty block unless it's the only remaining block and caller has requested not to do so.
         // The intent of doing so is to avoid block allocation cost at time tuple insertion into the table
         m_data.erase(block->address());
+        if (m_tupleSlots != NULL) {
+            m_tupleSlots->removeBlock(block->address());
+        }
+        forgetBlockStorage(block);
         m_blocksWithSpace.erase(block);
         m_blocksNotPendingSnapshot.erase(block);
         assert(m_blocksPendingSnapshot.find(block) == m_blocksPendingSnapshot.end());
@@ -991,7 +1200,7 @@ inline void PersistentTable::deleteTupleStorage(TableTuple &tuple, TBPtr block,
     }
 }
 
-inline TBPtr PersistentTable::findBlock(char *tuple, TBMap &blocks, int blockSize) {
+inline TBPtr PersistentTable::findBlock(char *tuple, TBMap &blocks) {
     if (!blocks.empty()) {
         TBMapI i = blocks.lower_bound(tuple);
 
@@ -1001,11 +1210,11 @@ inline TBPtr PersistentTable::findBlock(char *tuple, TBMap &blocks, int blockSiz
             i--;
         }
 
+        if (i.data().get() == NULL) {
+            throwFatalException("A block has gone missing in the tuple block map.");
+        }
         // If the tuple is within the block boundaries, we found the block
-        if (i.key() <= tuple && tuple < i.key() + blockSize) {
-            if (i.data().get() == NULL) {
-                throwFatalException("A block has gone missing in the tuple block map.");
-            }
+        if (i.key() <= tuple && tuple < i.key() + i.data()->storageSize()) {
             return i.data();
         }
     }
@@ -1013,13 +1222,59 @@ inline TBPtr PersistentTable::findBlock(char *tuple, TBMap &blocks, int blockSiz
     return TBPtr(NULL);
 }
 
+inline void PersistentTable::forgetBlockStorage(TBPtr block) {
+    m_allocatedTupleCount -= block->tupleCapacity();
+    m_allocatedTupleMemory -= block->storageSize();
+}
+
 inline TBPtr PersistentTable::allocateNextBlock() {
-    TBPtr block(new TupleBlock(this, m_blocksNotPendingSnapshotLoad[0]));
+    uint32_t tuplesPerBlock = 0;
+    if (s_minimumBlockSize > 0) {
+        // Double the table's capacity, from the smallest block up to full ones
+        int64_t smallest = std::max(1, s_minimumBlockSize / static_cast<int>(m_tupleLength));
+        tuplesPerBlock = static_cast<uint32_t>(std::min(static_cast<int64_t>(m_tuplesPerBlock),
+                                                        std::max(smallest, m_allocatedTupleCount)));
+    }
+    TBPtr block(new TupleBlock(this, m_blocksNotPendingSnapshotLoad[0], tuplesPerBlock));
     m_data.insert(block->address(), block);
+    if (m_tupleSlots != NULL) {
+        m_tupleSlots->addBlock(block->address());
+    }
+    m_allocatedTupleCount += block->tupleCapacity();
+    m_allocatedTupleMemory += block->storageSize();
     m_blocksNotPendingSnapshot.insert(block);
+    if ( ! m_zoneMapColumns.empty()) {
+        block->zoneMap().reset(m_zoneMapColumns.size());
+    }
     return block;
 }
 
+inline void PersistentTable::addToZoneMap(TableTuple &tuple, TBPtr block) {
+    if (m_zoneMapColumns.empty()) {
+        return;
+    }
+    if (block.get() == NULL) {
+        block = findBlock(tuple.address(), m_data);
+    }
+    block->zoneMap().add(tuple, m_zoneMapColumns);
+}
+
+inline void PersistentTable::removeFromZoneMap(TableTuple &tuple, TBPtr block) {
+    if (m_zoneMapColumns.empty()) {
+        return;
+    }
+    if (block.get() == NULL) {
+        block = findBlock(tuple.address(), m_data);
+    }
+    if (block->activeTuples() == 1) {
+        // the block is about to empty, so its bounds can start over
+        block->zoneMap().reset(m_zoneMapColumns.size());
+    }
+    else {
+        block->zoneMap().remove(tuple, m_zoneMapColumns);
+    }
+}
+
 inline TableTuple PersistentTable::lookupTupleByValues(TableTuple tuple) {
     return lookupTuple(tuple, LOOKUP_BY_VALUES);
 }
@@ -56,6 +56,7 @@
 #include "common/tabletuple.h"
 #include "common/Pool.hpp"
 #include "common/FatalException.hpp"
+#include "common/HugePages.h"
 #include "indexes/tableindex.h"
 #include "storage/tableiterator.h"
 #include "storage/persistenttable.h"
@@ -132,6 +133,11 @@ void Table::initializeWithColumns(TupleSchema *schema, const std::vector<string>
     } else {
         m_tableAllocationSize = m_tableAllocationTargetSize;
     }
+    if (HugePages::worthwhile(m_tableAllocationSize)) {
+        // Blocks are mapped in whole huge pages, so fill them with tuples
+        m_tableAllocationSize = static_cast<int>(HugePages::roundUp(m_tableAllocationSize));
+        m_tuplesPerBlock = m_tableAllocationSize / m_tupleLength;
+    }
 #endif
 #endif
 
@@ -137,7 +137,7 @@ class Table {
         return m_tempTuple;
     }
 
-    int64_t allocatedTupleCount() const {
+    virtual int64_t allocatedTupleCount() const {
         return allocatedBlockCount() * m_tuplesPerBlock;
     }
 
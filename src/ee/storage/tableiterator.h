@@ -51,6 +51,7 @@
 #include "common/tabletuple.h"
 #include "table.h"
 #include "storage/TupleIterator.h"
+#include "storage/ZoneMapFilter.h"
 
 namespace voltdb {
 
@@ -89,6 +90,14 @@ public:
         m_tempTableDeleteAsGo = flag;
     }
 
+    /**
+     * Skip the blocks of a persistent table that the filter turns down.
+     * The filter must outlive the scan.
+     */
+    void setZoneMapFilter(ZoneMapFilter *filter) {
+        m_zoneMapFilter = filter;
+    }
+
     bool operator ==(const TableIterator &other) const {
         return m_table == other.m_table && m_location == other.m_location;
     }
@@ -135,6 +144,7 @@ protected:
     std::vector<TBPtr>::iterator m_tempBlockIterator;
     bool m_tempTableIterator;
     bool m_tempTableDeleteAsGo;
+    ZoneMapFilter *m_zoneMapFilter;
 };
 
 inline TableIterator::TableIterator(Table *parent, std::vector<TBPtr>::iterator start)
@@ -147,7 +157,8 @@ inline TableIterator::TableIterator(Table *parent, std::vector<TBPtr>::iterator
       m_tuplesPerBlock(parent->m_tuplesPerBlock), m_currentBlock(NULL),
       m_tempBlockIterator(start),
       m_tempTableIterator(true),
-      m_tempTableDeleteAsGo(false)
+      m_tempTableDeleteAsGo(false),
+      m_zoneMapFilter(NULL)
     {
     }
 
@@ -164,7 +175,8 @@ inline TableIterator::TableIterator(Table *parent, TBMapI start)
       m_tuplesPerBlock(parent->m_tuplesPerBlock),
       m_currentBlock(NULL),
       m_tempTableIterator(false),
-      m_tempTableDeleteAsGo(false)
+      m_tempTableDeleteAsGo(false),
+      m_zoneMapFilter(NULL)
     {
     }
 
@@ -179,7 +191,8 @@ inline TableIterator::TableIterator(Table *parent)
       m_tuplesPerBlock(1),
       m_currentBlock(NULL),
       m_tempTableIterator(true),
-      m_tempTableDeleteAsGo(false)
+      m_tempTableDeleteAsGo(false),
+      m_zoneMapFilter(NULL)
     {
     }
 
@@ -196,6 +209,7 @@ inline void TableIterator::reset(std::vector<TBPtr>::iterator start) {
     m_currentBlock = NULL;
     m_tempTableIterator = true;
     m_tempTableDeleteAsGo = false;
+    m_zoneMapFilter = NULL;
 }
 
 inline void TableIterator::reset(TBMapI start) {
@@ -210,6 +224,7 @@ inline void TableIterator::reset(TBMapI start) {
     m_currentBlock = NULL;
     m_tempTableIterator = false;
     m_tempTableDeleteAsGo = false;
+    m_zoneMapFilter = NULL;
 }
 
 inline bool TableIterator::hasNext() {
@@ -237,6 +252,14 @@ inline bool TableIterator::persistentNext(TableTuple &out) {
             m_currentBlock = m_blockIterator.data();
             m_blockOffset = 0;
             m_blockIterator++;
+            if (m_zoneMapFilter != NULL && ! m_zoneMapFilter->mayMatch(*m_currentBlock)) {
+                // None of the block's tuples can pass the scan's predicate
+                m_foundTuples += m_currentBlock->activeTuples();
+                m_location += m_currentBlock->unusedTupleBoundry();
+                m_blockOffset = m_currentBlock->unusedTupleBoundry();
+                continue;
+            }
+            m_currentBlock->touch();
         } else {
             m_dataPtr += m_tupleLength;
         }
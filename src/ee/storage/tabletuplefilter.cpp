@@ -63,6 +63,7 @@ TableTupleFilter::TableTupleFilter() :
     m_tuplesPerBlock(),
     m_tupleLength(),
     m_prevBlockAddress(std::numeric_limits<uint64_t>::max()),
+    m_prevBlockLimit(0),
     m_prevBlockIndex(std::numeric_limits<uint64_t>::max()),
     m_lastActiveTupleIndex(std::numeric_limits<uint64_t>::max())
     {}
@@ -95,7 +96,7 @@ void TableTupleFilter::init(Table* table)
 
 uint64_t TableTupleFilter::findBlockIndex(uint64_t tupleAddress)
 {
-    if (m_prevBlockAddress > tupleAddress || (tupleAddress - m_prevBlockAddress)/ m_tupleLength >= m_tuplesPerBlock) {
+    if (m_prevBlockAddress > tupleAddress || tupleAddress >= m_prevBlockLimit) {
         // This tuple belongs to a different block that the last tuple did
         assert(!m_blocks.empty());
         std::vector<uint64_t>::iterator blockIter = std::lower_bound(m_blocks.begin(), m_blocks.end(), tupleAddress);
@@ -106,6 +107,12 @@ uint64_t TableTupleFilter::findBlockIndex(uint64_t tupleAddress)
             --blockIter;
         }
         m_prevBlockAddress = *blockIter;
+        // Blocks may hold fewer than m_tuplesPerBlock tuples, so the next
+        // block can start sooner
+        m_prevBlockLimit = m_prevBlockAddress + static_cast<uint64_t>(m_tuplesPerBlock) * m_tupleLength;
+        if (++blockIter != m_blocks.end()) {
+            m_prevBlockLimit = std::min(m_prevBlockLimit, *blockIter);
+        }
         assert(m_blockIndexes.find(m_prevBlockAddress) != m_blockIndexes.end());
         m_prevBlockIndex = m_blockIndexes.find(m_prevBlockAddress)->second;
     }
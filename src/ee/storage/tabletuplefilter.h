@@ -225,6 +225,9 @@ class TableTupleFilter {
     // excessive searches of m_blocks
     uint64_t m_prevBlockAddress;
 
+    // The address past the tuples of that block
+    uint64_t m_prevBlockLimit;
+
     // Previously accessed block index, cached to avoid excessive
     // lookups in m_blockIndexes
     uint64_t m_prevBlockIndex;
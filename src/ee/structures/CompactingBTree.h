@@ -0,0 +1,1161 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPACTINGBTREE_H_
+#define COMPACTINGBTREE_H_
+
+#include "ContiguousAllocator.h"
+#include "CompactingMap.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace voltdb {
+
+/**
+ * B+-tree with the same interface as CompactingMap, for tree indexes whose
+ * lookups and range scans are dominated by cache misses.
+ *
+ * All entries live in leaves of roughly 1KB that are chained in key order,
+ * so a scan reads consecutive memory and a lookup touches one node per
+ * level instead of one per key comparison. Inner nodes hold separator keys
+ * and, when hasRank is set, the number of entries under each child, which
+ * gives the ranks used by IndexCountExecutor in O(log n).
+ *
+ * Like CompactingMap, nodes are packed into ContiguousAllocator buffer
+ * chains (one for leaves, one for inner nodes). A freed node is filled
+ * with the last node of its chain so that memory can be returned.
+ *
+ * Entries and separators are copied around with plain assignment, and a
+ * separator may outlive the entry it was copied from, so keys must be
+ * self-contained values that do not own or reference other memory
+ * (IntsKey, or GenericKey without out-of-line columns).
+ * Key destructors are not called.
+ *
+ * As with CompactingMap, iterators are invalidated by any mutation.
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank=false>
+class CompactingBTree {
+    typedef typename KeyValuePair::first_type Key;
+    typedef typename KeyValuePair::second_type Data;
+protected:
+    static const int32_t NODE_BYTES = 1024;
+    static const int32_t MIN_FANOUT = 8;
+    static const int32_t LEAF_CAPACITY =
+        (NODE_BYTES / sizeof(KeyValuePair) < MIN_FANOUT) ? MIN_FANOUT :
+        static_cast<int32_t>(NODE_BYTES / sizeof(KeyValuePair));
+    static const int32_t INNER_CAPACITY =
+        (NODE_BYTES / (sizeof(Key) + sizeof(void*)) < MIN_FANOUT) ? MIN_FANOUT :
+        static_cast<int32_t>(NODE_BYTES / (sizeof(Key) + sizeof(void*)));
+    static const int32_t LEAF_MIN = LEAF_CAPACITY / 2;
+    static const int32_t INNER_MIN = INNER_CAPACITY / 2;
+    // Nodes per allocator buffer; small so that tiny indexes stay small.
+    static const int32_t LEAVES_PER_BUFFER = 64;
+    static const int32_t INNERS_PER_BUFFER = 16;
+
+    struct InnerNode;
+
+    struct Node {
+        InnerNode *parent;
+        // Entries in a leaf, children in an inner node
+        int32_t count;
+
+        Node() : parent(NULL), count(0) {}
+    };
+
+    struct LeafNode : public Node {
+        LeafNode *prev;
+        LeafNode *next;
+        KeyValuePair entries[LEAF_CAPACITY];
+
+        LeafNode() : prev(NULL), next(NULL) {}
+    };
+
+    /**
+     * keys[i], for 0 < i < count, separates children[i - 1] and children[i]:
+     * every key under children[i - 1] is <= keys[i] and every key under
+     * children[i] is >= keys[i]. keys[0] is unused.
+     */
+    struct InnerNode : public Node {
+        Node *children[INNER_CAPACITY];
+        // Entries under each child; only maintained with hasRank
+        int64_t counts[hasRank ? INNER_CAPACITY : 1];
+        Key keys[INNER_CAPACITY];
+    };
+
+    int64_t m_count;
+    Node *m_root;
+    // Number of inner node levels above the leaves
+    int32_t m_depth;
+    ContiguousAllocator m_leafAllocator;
+    ContiguousAllocator m_innerAllocator;
+    bool m_unique;
+
+    // The empty leaf that ends iteration in both directions. It is linked
+    // from the first and last leaves but its own links are never followed.
+    LeafNode m_endLeaf;
+
+    Compare m_comper;
+
+public:
+    class iterator {
+        friend class CompactingBTree<KeyValuePair, Compare, hasRank>;
+    protected:
+        LeafNode *m_leaf;
+        int32_t m_position;
+        iterator(LeafNode *leaf, int32_t position) : m_leaf(leaf), m_position(position) {}
+    public:
+        iterator() : m_leaf(NULL), m_position(0) {}
+        const Key &key() const { return m_leaf->entries[m_position].getKey(); }
+        const Data &value() const { return m_leaf->entries[m_position].getValue(); }
+        void setValue(const Data &value) { m_leaf->entries[m_position].setValue(value); }
+        void moveNext()
+        {
+            if (isEnd()) {
+                return;
+            }
+            if (++m_position == m_leaf->count) {
+                m_leaf = m_leaf->next;
+                m_position = 0;
+            }
+        }
+        void movePrev()
+        {
+            if (isEnd()) {
+                return;
+            }
+            if (m_position-- == 0) {
+                m_leaf = m_leaf->prev;
+                m_position = m_leaf->count == 0 ? 0 : m_leaf->count - 1;
+            }
+        }
+        bool isEnd() const { return m_leaf == NULL || m_leaf->count == 0; }
+        bool equals(const iterator &iter) const {
+            if (isEnd()) {
+                return iter.isEnd();
+            }
+            return m_leaf == iter.m_leaf && m_position == iter.m_position;
+        }
+    };
+
+    CompactingBTree(bool unique, Compare comper);
+
+    // A syntactically convenient analog to CompactingHashTable's insert function
+    const Data *insert(const Key &key, const Data &data);
+    bool erase(const Key &key);
+    bool erase(iterator &iter);
+    /**
+     * Add many entries at once, sorting them first.  Unless the tree already
+     * holds more entries than are being added, it is rebuilt bottom-up from
+     * the existing and new entries in order, as full as the occupancy rules
+     * allow.  As with insert, a key already in a unique tree is not added
+     * again.  Returns the number of entries added.
+     */
+    int64_t bulkInsert(std::vector<KeyValuePair> &entries);
+
+    iterator find(const Key &key) const;
+    iterator findRank(int64_t ith) const;
+    int64_t size() const { return m_count; }
+    iterator begin() const;
+    iterator rbegin() const;
+
+    iterator lowerBound(const Key &key) const { return normalize(descend<false>(key)); }
+    iterator upperBound(const Key &key) const
+    {
+        Key tmpKey(key);
+        setPointerValue(tmpKey, MAXPOINTER);
+        return normalize(descend<true>(tmpKey));
+    }
+
+    std::pair<iterator, iterator> equalRange(const Key &key) const
+    {
+        return std::pair<iterator, iterator>(lowerBound(key), upperBound(key));
+    }
+
+    size_t bytesAllocated() const
+    {
+        return m_leafAllocator.bytesAllocated() + m_innerAllocator.bytesAllocated();
+    }
+
+    // Must pass a key that already in map, or else return -1
+    int64_t rankAsc(const Key& key) const;
+    int64_t rankUpper(const Key& key) const;
+    // The 1-based position of the entry at iter, or -1 at the end
+    int64_t rankOf(const iterator &iter) const;
+
+    /**
+     * For debugging: verify ordering, links, occupancy and counts. SLOW.
+     */
+    bool verify() const;
+
+protected:
+    iterator end() const { return iterator(const_cast<LeafNode*>(&m_endLeaf), 0); }
+
+    // Turn a position one past the end of a leaf into the start of the next one.
+    iterator normalize(iterator iter) const
+    {
+        if (iter.m_leaf == NULL) {
+            return end();
+        }
+        if (iter.m_position == iter.m_leaf->count) {
+            return iterator(iter.m_leaf->next, 0);
+        }
+        return iter;
+    }
+
+    /**
+     * Find the leaf position of the first entry > key (UPPER) or >= key,
+     * which may be one past the end of that leaf, adding the number of
+     * entries before it to *before if that is not NULL.
+     */
+    template<bool UPPER>
+    iterator descend(const Key &key, int64_t *before = NULL) const;
+
+    template<bool UPPER>
+    inline int32_t childFor(const InnerNode *node, const Key &key) const;
+
+    template<bool UPPER>
+    inline int32_t positionIn(const LeafNode *leaf, const Key &key) const;
+
+    static int32_t childIndex(const InnerNode *parent, const Node *child)
+    {
+        int32_t ii = 0;
+        while (parent->children[ii] != child) {
+            ++ii;
+            assert(ii < parent->count);
+        }
+        return ii;
+    }
+
+    int64_t subtreeCount(const Node *node, int32_t height) const;
+    void addToCounts(Node *node, int64_t delta);
+
+    LeafNode *newLeaf() { return new (m_leafAllocator.alloc()) LeafNode(); }
+    InnerNode *newInner() { return new (m_innerAllocator.alloc()) InnerNode(); }
+
+    void insertAt(LeafNode *leaf, int32_t position, const Key &key, const Data &value);
+    LeafNode *splitLeaf(LeafNode *leaf);
+    InnerNode *splitInner(InnerNode *node);
+    void insertIntoParent(Node *left, const Key &separator, Node *right, int32_t height);
+
+    void eraseAt(LeafNode *leaf, int32_t position);
+    void rebalanceLeaf(LeafNode *leaf);
+    void rebalanceInner(InnerNode *node);
+    void removeChild(InnerNode *parent, int32_t index);
+
+    void freeLeaf(LeafNode *hole);
+    void freeInner(InnerNode *hole, InnerNode **tracked);
+
+    void clear();
+    void build(const std::vector<KeyValuePair> &entries);
+
+    bool verify(const Node *node, int32_t height, const Key *lower, const Key *upper,
+                int64_t *entries, int64_t *leaves, int64_t *inners) const;
+};
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+CompactingBTree<KeyValuePair, Compare, hasRank>::CompactingBTree(bool unique, Compare comper)
+    : m_count(0),
+      m_root(NULL),
+      m_depth(0),
+      m_leafAllocator(static_cast<int32_t>(sizeof(LeafNode)), LEAVES_PER_BUFFER),
+      m_innerAllocator(static_cast<int32_t>(sizeof(InnerNode)), INNERS_PER_BUFFER),
+      m_unique(unique),
+      m_comper(comper)
+{
+    m_endLeaf.prev = &m_endLeaf;
+    m_endLeaf.next = &m_endLeaf;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+template<bool UPPER>
+inline int32_t
+CompactingBTree<KeyValuePair, Compare, hasRank>::childFor(const InnerNode *node, const Key &key) const
+{
+    // The last child whose separator is < key (or <= key for UPPER)
+    int32_t low = 1;
+    int32_t high = node->count;
+    while (low < high) {
+        int32_t mid = (low + high) / 2;
+        int cmp = m_comper(node->keys[mid], key);
+        if (UPPER ? cmp <= 0 : cmp < 0) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low - 1;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+template<bool UPPER>
+inline int32_t
+CompactingBTree<KeyValuePair, Compare, hasRank>::positionIn(const LeafNode *leaf, const Key &key) const
+{
+    int32_t low = 0;
+    int32_t high = leaf->count;
+    while (low < high) {
+        int32_t mid = (low + high) / 2;
+        int cmp = m_comper(leaf->entries[mid].getKey(), key);
+        if (UPPER ? cmp <= 0 : cmp < 0) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+template<bool UPPER>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::descend(const Key &key, int64_t *before) const
+{
+    if (m_root == NULL) {
+        return iterator();
+    }
+    Node *node = m_root;
+    for (int32_t level = 0; level < m_depth; ++level) {
+        const InnerNode *inner = static_cast<const InnerNode*>(node);
+        int32_t child = childFor<UPPER>(inner, key);
+        if (before) {
+            for (int32_t ii = 0; ii < child; ++ii) {
+                *before += inner->counts[ii];
+            }
+        }
+        node = inner->children[child];
+    }
+    LeafNode *leaf = static_cast<LeafNode*>(node);
+    int32_t position = positionIn<UPPER>(leaf, key);
+    if (before) {
+        *before += position;
+    }
+    return iterator(leaf, position);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::find(const Key &key) const
+{
+    iterator iter = lowerBound(key);
+    if (iter.isEnd() || m_comper(iter.key(), key) != 0) {
+        return end();
+    }
+    return iter;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::findRank(int64_t ith) const
+{
+    if ((!hasRank) || ith < 1 || ith > m_count) {
+        return end();
+    }
+    // Ranks are 1-based; find the entry with ith - 1 entries before it.
+    int64_t remaining = ith - 1;
+    Node *node = m_root;
+    for (int32_t level = 0; level < m_depth; ++level) {
+        const InnerNode *inner = static_cast<const InnerNode*>(node);
+        int32_t child = 0;
+        while (remaining >= inner->counts[child]) {
+            remaining -= inner->counts[child];
+            ++child;
+            assert(child < inner->count);
+        }
+        node = inner->children[child];
+    }
+    return iterator(static_cast<LeafNode*>(node), static_cast<int32_t>(remaining));
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::begin() const
+{
+    if (m_count == 0) {
+        return iterator();
+    }
+    Node *node = m_root;
+    for (int32_t level = 0; level < m_depth; ++level) {
+        node = static_cast<InnerNode*>(node)->children[0];
+    }
+    return iterator(static_cast<LeafNode*>(node), 0);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::rbegin() const
+{
+    if (m_count == 0) {
+        return iterator();
+    }
+    Node *node = m_root;
+    for (int32_t level = 0; level < m_depth; ++level) {
+        InnerNode *inner = static_cast<InnerNode*>(node);
+        node = inner->children[inner->count - 1];
+    }
+    return iterator(static_cast<LeafNode*>(node), node->count - 1);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::rankAsc(const Key& key) const
+{
+    if (!hasRank) {
+        return -1;
+    }
+    if (find(key).isEnd()) {
+        return -1;
+    }
+    // Count the entries before the first one that matches regardless of pointer.
+    Key tmpKey(key);
+    setPointerValue(tmpKey, NULL);
+    int64_t before = 0;
+    descend<false>(tmpKey, &before);
+    return before + 1;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::rankUpper(const Key& key) const
+{
+    if (!hasRank) {
+        return -1;
+    }
+    if (m_unique) {
+        return rankAsc(key);
+    }
+    if (find(key).isEnd()) {
+        return -1;
+    }
+    Key tmpKey(key);
+    setPointerValue(tmpKey, MAXPOINTER);
+    int64_t before = 0;
+    descend<true>(tmpKey, &before);
+    return before;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::rankOf(const iterator &iter) const
+{
+    if ((!hasRank) || iter.isEnd()) {
+        return -1;
+    }
+    int64_t before = iter.m_position;
+    const Node *node = iter.m_leaf;
+    while (node->parent != NULL) {
+        const InnerNode *parent = node->parent;
+        const int32_t index = childIndex(parent, node);
+        for (int32_t ii = 0; ii < index; ++ii) {
+            before += parent->counts[ii];
+        }
+        node = parent;
+    }
+    return before + 1;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::subtreeCount(const Node *node, int32_t height) const
+{
+    if (height == 0) {
+        return node->count;
+    }
+    const InnerNode *inner = static_cast<const InnerNode*>(node);
+    int64_t total = 0;
+    for (int32_t ii = 0; ii < inner->count; ++ii) {
+        total += inner->counts[ii];
+    }
+    return total;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::addToCounts(Node *node, int64_t delta)
+{
+    if (!hasRank) {
+        return;
+    }
+    while (node->parent != NULL) {
+        InnerNode *parent = node->parent;
+        parent->counts[childIndex(parent, node)] += delta;
+        node = parent;
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+const typename CompactingBTree<KeyValuePair, Compare, hasRank>::Data *
+CompactingBTree<KeyValuePair, Compare, hasRank>::insert(const Key &key, const Data &value)
+{
+    if (m_root == NULL) {
+        LeafNode *leaf = newLeaf();
+        leaf->prev = &m_endLeaf;
+        leaf->next = &m_endLeaf;
+        m_root = leaf;
+        m_depth = 0;
+    }
+
+    // New duplicates go after existing ones, as in CompactingMap.
+    iterator iter = descend<true>(key);
+    LeafNode *leaf = iter.m_leaf;
+    int32_t position = iter.m_position;
+
+    if (m_unique) {
+        // The entry before the insert position is the greatest one <= key.
+        const KeyValuePair *previous = NULL;
+        if (position > 0) {
+            previous = &leaf->entries[position - 1];
+        }
+        else if (leaf->prev != &m_endLeaf) {
+            previous = &leaf->prev->entries[leaf->prev->count - 1];
+        }
+        if (previous && m_comper(previous->getKey(), key) == 0) {
+            return &previous->getValue();
+        }
+    }
+
+    addToCounts(leaf, 1);
+    if (leaf->count == LEAF_CAPACITY) {
+        LeafNode *right = splitLeaf(leaf);
+        if (position > leaf->count) {
+            position -= leaf->count;
+            leaf = right;
+        }
+    }
+    insertAt(leaf, position, key, value);
+    m_count++;
+    return NULL;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::insertAt(LeafNode *leaf, int32_t position,
+                                                               const Key &key, const Data &value)
+{
+    assert(leaf->count < LEAF_CAPACITY);
+    for (int32_t ii = leaf->count; ii > position; --ii) {
+        leaf->entries[ii] = leaf->entries[ii - 1];
+    }
+    leaf->entries[position].setKeyValuePair(key, value);
+    leaf->count++;
+    if (hasRank && leaf->parent) {
+        // addToCounts already counted this entry, possibly against the
+        // unsplit leaf, so re-derive this leaf's own count.
+        leaf->parent->counts[childIndex(leaf->parent, leaf)] = leaf->count;
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::LeafNode *
+CompactingBTree<KeyValuePair, Compare, hasRank>::splitLeaf(LeafNode *leaf)
+{
+    LeafNode *right = newLeaf();
+    int32_t keep = leaf->count / 2;
+    for (int32_t ii = keep; ii < leaf->count; ++ii) {
+        right->entries[ii - keep] = leaf->entries[ii];
+    }
+    right->count = leaf->count - keep;
+    leaf->count = keep;
+
+    right->next = leaf->next;
+    right->prev = leaf;
+    if (leaf->next != &m_endLeaf) {
+        leaf->next->prev = right;
+    }
+    leaf->next = right;
+
+    insertIntoParent(leaf, right->entries[0].getKey(), right, 0);
+    return right;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::InnerNode *
+CompactingBTree<KeyValuePair, Compare, hasRank>::splitInner(InnerNode *node)
+{
+    InnerNode *right = newInner();
+    int32_t keep = node->count / 2;
+    for (int32_t ii = keep; ii < node->count; ++ii) {
+        right->children[ii - keep] = node->children[ii];
+        right->children[ii - keep]->parent = right;
+        right->keys[ii - keep] = node->keys[ii];
+        if (hasRank) {
+            right->counts[ii - keep] = node->counts[ii];
+        }
+    }
+    right->count = node->count - keep;
+    node->count = keep;
+    // right->keys[0] is the separator between the halves; it moves up.
+    return right;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::insertIntoParent(Node *left, const Key &separator,
+                                                                       Node *right, int32_t height)
+{
+    InnerNode *parent = left->parent;
+    if (parent == NULL) {
+        InnerNode *root = newInner();
+        root->children[0] = left;
+        root->children[1] = right;
+        root->keys[1] = separator;
+        if (hasRank) {
+            root->counts[0] = subtreeCount(left, height);
+            root->counts[1] = subtreeCount(right, height);
+        }
+        root->count = 2;
+        left->parent = root;
+        right->parent = root;
+        m_root = root;
+        m_depth++;
+        return;
+    }
+
+    if (parent->count == INNER_CAPACITY) {
+        InnerNode *sibling = splitInner(parent);
+        insertIntoParent(parent, sibling->keys[0], sibling, height + 1);
+        if (left->parent == sibling) {
+            parent = sibling;
+        }
+    }
+
+    int32_t index = childIndex(parent, left) + 1;
+    for (int32_t ii = parent->count; ii > index; --ii) {
+        parent->children[ii] = parent->children[ii - 1];
+        parent->keys[ii] = parent->keys[ii - 1];
+        if (hasRank) {
+            parent->counts[ii] = parent->counts[ii - 1];
+        }
+    }
+    parent->children[index] = right;
+    parent->keys[index] = separator;
+    if (hasRank) {
+        parent->counts[index - 1] = subtreeCount(left, height);
+        parent->counts[index] = subtreeCount(right, height);
+    }
+    parent->count++;
+    right->parent = parent;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::bulkInsert(std::vector<KeyValuePair> &entries)
+{
+    const Compare &comper = m_comper;
+    // Stable, so that the first of several equal keys wins as it would one at a time
+    std::stable_sort(entries.begin(), entries.end(),
+                     [&comper](const KeyValuePair &lhs, const KeyValuePair &rhs) {
+                         return comper(lhs.getKey(), rhs.getKey()) < 0;
+                     });
+
+    if (m_count > static_cast<int64_t>(entries.size())) {
+        int64_t added = 0;
+        for (int64_t ii = 0; ii < static_cast<int64_t>(entries.size()); ++ii) {
+            if (insert(entries[ii].getKey(), entries[ii].getValue()) == NULL) {
+                ++added;
+            }
+        }
+        return added;
+    }
+
+    // Merge with the existing entries, which come first among equal keys
+    std::vector<KeyValuePair> merged;
+    merged.reserve(m_count + entries.size());
+    iterator iter = begin();
+    typename std::vector<KeyValuePair>::const_iterator next = entries.begin();
+    while (next != entries.end()) {
+        if ( ! iter.isEnd() && m_comper(iter.key(), next->getKey()) <= 0) {
+            merged.push_back(iter.m_leaf->entries[iter.m_position]);
+            iter.moveNext();
+        }
+        else {
+            merged.push_back(*next);
+            ++next;
+        }
+    }
+    for (; ! iter.isEnd(); iter.moveNext()) {
+        merged.push_back(iter.m_leaf->entries[iter.m_position]);
+    }
+    if (m_unique) {
+        merged.erase(std::unique(merged.begin(), merged.end(),
+                                 [&comper](const KeyValuePair &lhs, const KeyValuePair &rhs) {
+                                     return comper(lhs.getKey(), rhs.getKey()) == 0;
+                                 }),
+                     merged.end());
+    }
+    int64_t added = static_cast<int64_t>(merged.size()) - m_count;
+
+    clear();
+    build(merged);
+    return added;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::clear()
+{
+    while (m_leafAllocator.count() > 0) {
+        m_leafAllocator.trim();
+    }
+    while (m_innerAllocator.count() > 0) {
+        m_innerAllocator.trim();
+    }
+    m_root = NULL;
+    m_depth = 0;
+    m_count = 0;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::build(const std::vector<KeyValuePair> &entries)
+{
+    const int64_t entryCount = static_cast<int64_t>(entries.size());
+    if (entryCount == 0) {
+        return;
+    }
+
+    // Spreading entries evenly over the fewest nodes keeps every node but
+    // a lone root at least half full.
+    std::vector<Node*> level;
+    std::vector<Key> firstKeys;
+    std::vector<int64_t> counts;
+    const int64_t leafCount = (entryCount + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+    LeafNode *previous = &m_endLeaf;
+    int64_t done = 0;
+    for (int64_t ii = 0; ii < leafCount; ++ii) {
+        LeafNode *leaf = newLeaf();
+        const int64_t end = entryCount * (ii + 1) / leafCount;
+        for (; done < end; ++done) {
+            leaf->entries[leaf->count++] = entries[done];
+        }
+        leaf->prev = previous;
+        leaf->next = &m_endLeaf;
+        if (previous != &m_endLeaf) {
+            previous->next = leaf;
+        }
+        previous = leaf;
+        level.push_back(leaf);
+        firstKeys.push_back(leaf->entries[0].getKey());
+        counts.push_back(leaf->count);
+    }
+
+    m_depth = 0;
+    while (level.size() > 1) {
+        std::vector<Node*> parents;
+        std::vector<Key> parentKeys;
+        std::vector<int64_t> parentCounts;
+        const int64_t childCount = static_cast<int64_t>(level.size());
+        const int64_t innerCount = (childCount + INNER_CAPACITY - 1) / INNER_CAPACITY;
+        int64_t child = 0;
+        for (int64_t ii = 0; ii < innerCount; ++ii) {
+            InnerNode *inner = newInner();
+            int64_t total = 0;
+            const int64_t end = childCount * (ii + 1) / innerCount;
+            for (; child < end; ++child) {
+                inner->children[inner->count] = level[child];
+                inner->keys[inner->count] = firstKeys[child];
+                if (hasRank) {
+                    inner->counts[inner->count] = counts[child];
+                }
+                inner->count++;
+                level[child]->parent = inner;
+                total += counts[child];
+            }
+            parents.push_back(inner);
+            parentKeys.push_back(inner->keys[0]);
+            parentCounts.push_back(total);
+        }
+        level.swap(parents);
+        firstKeys.swap(parentKeys);
+        counts.swap(parentCounts);
+        m_depth++;
+    }
+    m_root = level[0];
+    m_root->parent = NULL;
+    m_count = entryCount;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::erase(const Key &key)
+{
+    iterator iter = find(key);
+    if (iter.isEnd()) {
+        return false;
+    }
+    eraseAt(iter.m_leaf, iter.m_position);
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::erase(iterator &iter)
+{
+    assert(!iter.isEnd());
+    eraseAt(iter.m_leaf, iter.m_position);
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::eraseAt(LeafNode *leaf, int32_t position)
+{
+    addToCounts(leaf, -1);
+    for (int32_t ii = position + 1; ii < leaf->count; ++ii) {
+        leaf->entries[ii - 1] = leaf->entries[ii];
+    }
+    leaf->count--;
+    m_count--;
+    rebalanceLeaf(leaf);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::removeChild(InnerNode *parent, int32_t index)
+{
+    for (int32_t ii = index + 1; ii < parent->count; ++ii) {
+        parent->children[ii - 1] = parent->children[ii];
+        parent->keys[ii - 1] = parent->keys[ii];
+        if (hasRank) {
+            parent->counts[ii - 1] = parent->counts[ii];
+        }
+    }
+    parent->count--;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::rebalanceLeaf(LeafNode *leaf)
+{
+    if (leaf == m_root) {
+        if (leaf->count == 0) {
+            freeLeaf(leaf);
+            m_root = NULL;
+        }
+        return;
+    }
+    if (leaf->count >= LEAF_MIN) {
+        return;
+    }
+
+    InnerNode *parent = leaf->parent;
+    int32_t index = childIndex(parent, leaf);
+    LeafNode *left = index > 0 ? static_cast<LeafNode*>(parent->children[index - 1]) : NULL;
+    LeafNode *right = index + 1 < parent->count ? static_cast<LeafNode*>(parent->children[index + 1]) : NULL;
+
+    if (left && left->count > LEAF_MIN) {
+        for (int32_t ii = leaf->count; ii > 0; --ii) {
+            leaf->entries[ii] = leaf->entries[ii - 1];
+        }
+        leaf->entries[0] = left->entries[left->count - 1];
+        leaf->count++;
+        left->count--;
+        parent->keys[index] = leaf->entries[0].getKey();
+        if (hasRank) {
+            parent->counts[index - 1]--;
+            parent->counts[index]++;
+        }
+        return;
+    }
+    if (right && right->count > LEAF_MIN) {
+        leaf->entries[leaf->count] = right->entries[0];
+        leaf->count++;
+        for (int32_t ii = 1; ii < right->count; ++ii) {
+            right->entries[ii - 1] = right->entries[ii];
+        }
+        right->count--;
+        parent->keys[index + 1] = right->entries[0].getKey();
+        if (hasRank) {
+            parent->counts[index]++;
+            parent->counts[index + 1]--;
+        }
+        return;
+    }
+
+    // Merge with a sibling; both are at most half full.
+    LeafNode *into = left ? left : leaf;
+    LeafNode *from = left ? leaf : right;
+    int32_t fromIndex = left ? index : index + 1;
+    for (int32_t ii = 0; ii < from->count; ++ii) {
+        into->entries[into->count + ii] = from->entries[ii];
+    }
+    into->count += from->count;
+    into->next = from->next;
+    if (from->next != &m_endLeaf) {
+        from->next->prev = into;
+    }
+    if (hasRank) {
+        parent->counts[fromIndex - 1] += parent->counts[fromIndex];
+    }
+    removeChild(parent, fromIndex);
+    freeLeaf(from);
+    rebalanceInner(parent);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::rebalanceInner(InnerNode *node)
+{
+    if (node == m_root) {
+        if (node->count == 1) {
+            m_root = node->children[0];
+            m_root->parent = NULL;
+            m_depth--;
+            freeInner(node, NULL);
+        }
+        return;
+    }
+    if (node->count >= INNER_MIN) {
+        return;
+    }
+
+    InnerNode *parent = node->parent;
+    int32_t index = childIndex(parent, node);
+    InnerNode *left = index > 0 ? static_cast<InnerNode*>(parent->children[index - 1]) : NULL;
+    InnerNode *right = index + 1 < parent->count ? static_cast<InnerNode*>(parent->children[index + 1]) : NULL;
+
+    if (left && left->count > INNER_MIN) {
+        for (int32_t ii = node->count; ii > 0; --ii) {
+            node->children[ii] = node->children[ii - 1];
+            node->keys[ii] = node->keys[ii - 1];
+            if (hasRank) {
+                node->counts[ii] = node->counts[ii - 1];
+            }
+        }
+        int32_t last = left->count - 1;
+        node->children[0] = left->children[last];
+        node->children[0]->parent = node;
+        node->keys[1] = parent->keys[index];
+        parent->keys[index] = left->keys[last];
+        if (hasRank) {
+            node->counts[0] = left->counts[last];
+            parent->counts[index - 1] -= left->counts[last];
+            parent->counts[index] += left->counts[last];
+        }
+        left->count--;
+        node->count++;
+        return;
+    }
+    if (right && right->count > INNER_MIN) {
+        int32_t last = node->count;
+        node->children[last] = right->children[0];
+        node->children[last]->parent = node;
+        node->keys[last] = parent->keys[index + 1];
+        parent->keys[index + 1] = right->keys[1];
+        if (hasRank) {
+            node->counts[last] = right->counts[0];
+            parent->counts[index] += right->counts[0];
+            parent->counts[index + 1] -= right->counts[0];
+        }
+        node->count++;
+        removeChild(right, 0);
+        return;
+    }
+
+    // Merge with a sibling, pulling down the separator between them.
+    InnerNode *into = left ? left : node;
+    InnerNode *from = left ? node : right;
+    int32_t fromIndex = left ? index : index + 1;
+    // The separator pulled down sits in front of from's first child.
+    into->keys[into->count] = parent->keys[fromIndex];
+    for (int32_t ii = 0; ii < from->count; ++ii) {
+        into->children[into->count + ii] = from->children[ii];
+        into->children[into->count + ii]->parent = into;
+        if (ii > 0) {
+            into->keys[into->count + ii] = from->keys[ii];
+        }
+        if (hasRank) {
+            into->counts[into->count + ii] = from->counts[ii];
+        }
+    }
+    into->count += from->count;
+    if (hasRank) {
+        parent->counts[fromIndex - 1] += parent->counts[fromIndex];
+    }
+    removeChild(parent, fromIndex);
+    freeInner(from, &parent);
+    rebalanceInner(parent);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::freeLeaf(LeafNode *hole)
+{
+    LeafNode *last = static_cast<LeafNode*>(m_leafAllocator.last());
+    if (last != hole) {
+        // Move the last leaf into the hole and repoint everything that
+        // referred to it.
+        if (last->parent) {
+            last->parent->children[childIndex(last->parent, last)] = hole;
+        }
+        else {
+            assert(last == m_root);
+            m_root = hole;
+        }
+        if (last->prev != &m_endLeaf) {
+            last->prev->next = hole;
+        }
+        if (last->next != &m_endLeaf) {
+            last->next->prev = hole;
+        }
+        hole->parent = last->parent;
+        hole->prev = last->prev;
+        hole->next = last->next;
+        hole->count = last->count;
+        for (int32_t ii = 0; ii < last->count; ++ii) {
+            hole->entries[ii] = last->entries[ii];
+        }
+    }
+    m_leafAllocator.trim();
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::freeInner(InnerNode *hole, InnerNode **tracked)
+{
+    InnerNode *last = static_cast<InnerNode*>(m_innerAllocator.last());
+    if (last != hole) {
+        if (last->parent) {
+            last->parent->children[childIndex(last->parent, last)] = hole;
+        }
+        else {
+            assert(last == m_root);
+            m_root = hole;
+        }
+        hole->parent = last->parent;
+        hole->count = last->count;
+        for (int32_t ii = 0; ii < last->count; ++ii) {
+            hole->children[ii] = last->children[ii];
+            hole->children[ii]->parent = hole;
+            hole->keys[ii] = last->keys[ii];
+            if (hasRank) {
+                hole->counts[ii] = last->counts[ii];
+            }
+        }
+        if (tracked && *tracked == last) {
+            *tracked = hole;
+        }
+    }
+    m_innerAllocator.trim();
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::verify() const
+{
+    if (m_root == NULL) {
+        if (m_count != 0 || m_leafAllocator.count() != 0 || m_innerAllocator.count() != 0) {
+            printf("empty tree has entries or nodes\n");
+            return false;
+        }
+        return true;
+    }
+    if (m_root->parent != NULL) {
+        printf("root has a parent\n");
+        return false;
+    }
+    int64_t entries = 0;
+    int64_t leaves = 0;
+    int64_t inners = 0;
+    if (!verify(m_root, m_depth, NULL, NULL, &entries, &leaves, &inners)) {
+        return false;
+    }
+    if (entries != m_count) {
+        printf("expected %ld entries but found %ld\n", (long)m_count, (long)entries);
+        return false;
+    }
+    if (leaves != m_leafAllocator.count() || inners != m_innerAllocator.count()) {
+        printf("allocated nodes are not all reachable\n");
+        return false;
+    }
+
+    // The leaf chain visits every entry in order, in both directions.
+    int64_t forward = 0;
+    const KeyValuePair *previous = NULL;
+    for (iterator iter = begin(); !iter.isEnd(); iter.moveNext()) {
+        const KeyValuePair &entry = iter.m_leaf->entries[iter.m_position];
+        int cmp = previous ? m_comper(previous->getKey(), entry.getKey()) : -1;
+        if (cmp > 0 || (m_unique && cmp == 0)) {
+            printf("leaf chain is out of order at entry %ld\n", (long)forward);
+            return false;
+        }
+        previous = &entry;
+        forward++;
+    }
+    int64_t backward = 0;
+    for (iterator iter = rbegin(); !iter.isEnd(); iter.movePrev()) {
+        backward++;
+    }
+    if (forward != m_count || backward != m_count) {
+        printf("leaf chain has %ld/%ld entries, expected %ld\n",
+               (long)forward, (long)backward, (long)m_count);
+        return false;
+    }
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::verify(const Node *node, int32_t height,
+                                                             const Key *lower, const Key *upper,
+                                                             int64_t *entries, int64_t *leaves,
+                                                             int64_t *inners) const
+{
+    if (height == 0) {
+        const LeafNode *leaf = static_cast<const LeafNode*>(node);
+        (*leaves)++;
+        int32_t minimum = LEAF_MIN;
+        if (node == m_root) {
+            minimum = 1;
+        }
+        if (leaf->count < minimum || leaf->count > LEAF_CAPACITY) {
+            printf("leaf has %d entries\n", leaf->count);
+            return false;
+        }
+        for (int32_t ii = 0; ii < leaf->count; ++ii) {
+            const Key &key = leaf->entries[ii].getKey();
+            if ((lower && m_comper(*lower, key) > 0) || (upper && m_comper(key, *upper) > 0)) {
+                printf("leaf entry is outside its separators\n");
+                return false;
+            }
+        }
+        *entries += leaf->count;
+        return true;
+    }
+
+    const InnerNode *inner = static_cast<const InnerNode*>(node);
+    (*inners)++;
+    int32_t minimum = INNER_MIN;
+    if (node == m_root) {
+        minimum = 2;
+    }
+    if (inner->count < minimum || inner->count > INNER_CAPACITY) {
+        printf("inner node has %d children\n", inner->count);
+        return false;
+    }
+    for (int32_t ii = 0; ii < inner->count; ++ii) {
+        const Node *child = inner->children[ii];
+        if (child->parent != inner) {
+            printf("child has the wrong parent\n");
+            return false;
+        }
+        const Key *childLower = ii == 0 ? lower : &inner->keys[ii];
+        const Key *childUpper = ii + 1 == inner->count ? upper : &inner->keys[ii + 1];
+        int64_t childEntries = 0;
+        if (!verify(child, height - 1, childLower, childUpper, &childEntries, leaves, inners)) {
+            return false;
+        }
+        if (hasRank && inner->counts[ii] != childEntries) {
+            printf("child count is %ld but the child has %ld entries\n",
+                   (long)inner->counts[ii], (long)childEntries);
+            return false;
+        }
+        *entries += childEntries;
+    }
+    return true;
+}
+
+} // namespace voltdb
+
+#endif // COMPACTINGBTREE_H_
@@ -46,6 +46,9 @@ namespace voltdb {
      *    doesn't support iteration over all values.
      * 4. It allocates over a megabyte when it only contains a single value. It's not as useful for
      *    smaller, more general usage.
+     * 5. It resizes incrementally. The old bucket array is kept alongside the new one, and each
+     *    insert or erase moves a few more of its buckets over, so that no single operation pays
+     *    for rehashing the whole table. Lookups check whichever array holds the key's bucket.
      */
     template<class K, class T, class H = boost::hash<K>, class EK = std::equal_to<K>, class ET = std::equal_to<T> >
     class CompactingHashTable {
@@ -75,10 +78,14 @@ namespace voltdb {
         // 20000 HashNodes per chunk is about 625k / chunk
         static const uint64_t ALLOCATOR_CHUNK_SIZE = 20000;
 
+        // old buckets moved to the new array by each insert or erase while resizing
+        static const uint64_t MIGRATE_BUCKETS_PER_OP = 64;
+
 #else // for MEMCHECK
         // for debugging with valgrind
         static const uint64_t BUCKET_INITIAL_INDEX = 0;
         static const uint64_t ALLOCATOR_CHUNK_SIZE = 2;
+        static const uint64_t MIGRATE_BUCKETS_PER_OP = 1;
 
 #endif // MEMCHECK
 
@@ -113,10 +120,13 @@ namespace voltdb {
         };
 
         HashNode **m_buckets;             // the array holding the buckets
+        HashNode **m_oldBuckets;          // buckets not yet moved to m_buckets, while resizing
         bool m_unique;                    // support unique
         uint64_t m_count;                 // number of items in the hash
         uint64_t m_uniqueCount;           // number of unique keys
         int m_sizeIndex;                  // current bucket count (from array)
+        int m_oldSizeIndex;               // bucket count of m_oldBuckets (from array)
+        uint64_t m_migratedBuckets;       // old buckets moved to m_buckets so far
         ContiguousAllocator m_allocator;  // allocator supporting compaction
         Hasher m_hasher;                  // instance of the hashing function
         KeyEqChecker m_keyEq;             // instance of the key eq checker
@@ -172,9 +182,20 @@ namespace voltdb {
         bool erase(iterator &iter);
         /** STL-ish size() method */
         size_t size() const { return m_count; }
+        /** grow the buckets once for this many keys, rather than while adding them */
+        void reserve(size_t keys);
 
         /** Return bytes used for this index */
-        size_t bytesAllocated() const { return m_allocator.bytesAllocated() + TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*); }
+        size_t bytesAllocated() const {
+            size_t bytes = m_allocator.bytesAllocated() + TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*);
+            if (m_oldBuckets) {
+                bytes += TABLE_SIZES[m_oldSizeIndex] * sizeof(HashNode*);
+            }
+            return bytes;
+        }
+
+        /** is an earlier resize still moving buckets? */
+        bool isResizing() const { return m_oldBuckets != NULL; }
 
         /** verification for debugging and testing */
         bool verify();
@@ -195,10 +216,15 @@ namespace voltdb {
         /** after remove, ensure memory for hashnodes is contiguous */
         void deleteAndFixup(HashNode *node);
 
-        /** see if the hash needs to grow or shrink */
-        void checkLoadFactor();
-        /** grow/shrink the hash table */
+        /** the bucket that holds, or would hold, keys with this hash */
+        HashNode **bucketFor(uint64_t hash) const;
+
+        /** see if the hash needs to grow or shrink (only grow, when adding) */
+        void checkLoadFactor(bool mayShrink = true);
+        /** start growing/shrinking the hash table */
         void resize(int newSizeIndex);
+        /** move up to count more old buckets into the resized table */
+        void migrateBuckets(uint64_t count);
     };
 
     template<class K, class T, class H, class EK, class ET>
@@ -246,10 +272,13 @@ namespace voltdb {
 
     template<class K, class T, class H, class EK, class ET>
     CompactingHashTable<K, T, H, EK, ET>::CompactingHashTable(bool unique, Hasher hasher, KeyEqChecker keyEq, DataEqChecker dataEq)
-    : m_unique(unique),
+    : m_oldBuckets(NULL),
+    m_unique(unique),
     m_count(0),
     m_uniqueCount(0),
     m_sizeIndex(BUCKET_INITIAL_INDEX),
+    m_oldSizeIndex(BUCKET_INITIAL_INDEX),
+    m_migratedBuckets(0),
     m_allocator((int32_t)(unique ? sizeof(HashNodeSmall) : sizeof(HashNode)), ALLOCATOR_CHUNK_SIZE),
     m_hasher(hasher),
     m_keyEq(keyEq),
@@ -264,6 +293,8 @@ namespace voltdb {
 
     template<class K, class T, class H, class EK, class ET>
     CompactingHashTable<K, T, H, EK, ET>::~CompactingHashTable() {
+        migrateBuckets(UINT64_MAX);
+
         // unlink all of the nodes, which will call destructors correctly
         for (size_t i = 0; i < TABLE_SIZES[m_sizeIndex]; ++i) {
             while (m_buckets[i]) {
@@ -288,16 +319,14 @@ namespace voltdb {
     template<class K, class T, class H, class EK, class ET>
     typename CompactingHashTable<K, T, H, EK, ET>::iterator CompactingHashTable<K, T, H, EK, ET>::find(const Key &key) const {
         uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        const HashNode *foundNode = find(m_buckets[bucketOffset], key);
+        const HashNode *foundNode = find(*bucketFor(hash), key);
         return iterator(foundNode);
     }
 
     template<class K, class T, class H, class EK, class ET>
     typename CompactingHashTable<K, T, H, EK, ET>::iterator CompactingHashTable<K, T, H, EK, ET>::find(const Key &key, const Data &value) const {
         uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        const HashNode *foundNode = find(m_buckets[bucketOffset], key, value);
+        const HashNode *foundNode = find(*bucketFor(hash), key, value);
         return iterator(foundNode);
     }
 
@@ -305,8 +334,8 @@ namespace voltdb {
     const typename CompactingHashTable<K, T, H, EK, ET>::Data *CompactingHashTable<K, T, H, EK, ET>::insert(const Key &key, const Data &value) {
         uint64_t hash = m_hasher(key);
 
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        return insert(&(m_buckets[bucketOffset]), hash, key, value);
+        migrateBuckets(MIGRATE_BUCKETS_PER_OP);
+        return insert(bucketFor(hash), hash, key, value);
     }
 
     template<class K, class T, class H, class EK, class ET>
@@ -314,11 +343,12 @@ namespace voltdb {
         assert(m_unique);
         HashNode *prevBucketNode = NULL;
         uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
+        migrateBuckets(MIGRATE_BUCKETS_PER_OP);
+        HashNode **bucket = bucketFor(hash);
 
-        for (HashNode *node = m_buckets[bucketOffset]; node; node = node->nextInBucket) {
+        for (HashNode *node = *bucket; node; node = node->nextInBucket) {
             if (m_keyEq(node->key, key)) {
-                removeUnique(&(m_buckets[bucketOffset]), prevBucketNode, node);
+                removeUnique(bucket, prevBucketNode, node);
                 deleteAndFixup(node);
                 checkLoadFactor();
                 return true;
@@ -333,13 +363,14 @@ namespace voltdb {
     bool CompactingHashTable<K, T, H, EK, ET>::erase(const Key &key, const Data &value) {
         HashNode *prevBucketNode = NULL, *keyHeadNode = NULL, *prevKeyNode = NULL;
         uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
+        migrateBuckets(MIGRATE_BUCKETS_PER_OP);
+        HashNode **bucket = bucketFor(hash);
 
-        for (HashNode *node = m_buckets[bucketOffset]; node; node = node->nextInBucket) {
+        for (HashNode *node = *bucket; node; node = node->nextInBucket) {
             if (m_keyEq(node->key, key)) {
                 if (m_unique) {
                     if (!m_dataEq(node->value, value)) return false;
-                    removeUnique(&(m_buckets[bucketOffset]), prevBucketNode, node);
+                    removeUnique(bucket, prevBucketNode, node);
                     deleteAndFixup(node);
                     checkLoadFactor();
                     return true;
@@ -347,7 +378,7 @@ namespace voltdb {
                 keyHeadNode = node;
                 for (node = keyHeadNode; node; node = node->nextWithKey) {
                     if (m_dataEq(node->value, value)) {
-                        remove(&(m_buckets[bucketOffset]), prevBucketNode, keyHeadNode, prevKeyNode, node);
+                        remove(bucket, prevBucketNode, keyHeadNode, prevKeyNode, node);
                         deleteAndFixup(node);
                         checkLoadFactor();
                         return true;
@@ -427,7 +458,7 @@ namespace voltdb {
             m_uniqueCount++;
         }
 
-        checkLoadFactor();
+        checkLoadFactor(false);
         return NULL;
     }
 
@@ -514,11 +545,11 @@ namespace voltdb {
         }
 
         // find the bucket for the last node
-        uint64_t bucketOffset = last->hash % TABLE_SIZES[m_sizeIndex];
+        HashNode **bucket = bucketFor(last->hash);
 
         // find the last node and what points to it
         HashNode *prevBucketNode = NULL, *keyHeadNode = NULL, *prevKeyNode = NULL;
-        for (HashNode *n = m_buckets[bucketOffset]; n; n = n->nextInBucket) {
+        for (HashNode *n = *bucket; n; n = n->nextInBucket) {
             prevKeyNode = NULL;
             keyHeadNode = n;
             if (m_unique) {
@@ -532,7 +563,7 @@ namespace voltdb {
                     prevBucketNode->nextInBucket = node;
                 }
                 else {
-                    m_buckets[bucketOffset] = node;
+                    *bucket = node;
                 }
 
                 // copy the last node over the deleted node
@@ -566,7 +597,7 @@ namespace voltdb {
                             prevBucketNode->nextInBucket = node;
                         }
                         else {
-                            m_buckets[bucketOffset] = node;
+                            *bucket = node;
                         }
                     }
 
@@ -594,13 +625,40 @@ namespace voltdb {
     }
 
     template<class K, class T, class H, class EK, class ET>
-    void CompactingHashTable<K, T, H, EK, ET>::checkLoadFactor() {
+    void CompactingHashTable<K, T, H, EK, ET>::reserve(size_t keys) {
+        int newSizeIndex = m_sizeIndex;
+        while ((keys * 100) / TABLE_SIZES[newSizeIndex] > MAX_LOAD_FACTOR) {
+            newSizeIndex++;
+        }
+        if (newSizeIndex != m_sizeIndex) {
+            resize(newSizeIndex);
+        }
+    }
+
+    template<class K, class T, class H, class EK, class ET>
+    typename CompactingHashTable<K, T, H, EK, ET>::HashNode **
+    CompactingHashTable<K, T, H, EK, ET>::bucketFor(uint64_t hash) const {
+        if (m_oldBuckets) {
+            uint64_t oldOffset = hash % TABLE_SIZES[m_oldSizeIndex];
+            if (oldOffset >= m_migratedBuckets) {
+                return &(m_oldBuckets[oldOffset]);
+            }
+        }
+        return &(m_buckets[hash % TABLE_SIZES[m_sizeIndex]]);
+    }
+
+    template<class K, class T, class H, class EK, class ET>
+    void CompactingHashTable<K, T, H, EK, ET>::checkLoadFactor(bool mayShrink) {
+        // the table being moved into already has room to spare
+        if (m_oldBuckets) {
+            return;
+        }
         uint64_t lf = (m_uniqueCount * 100) / TABLE_SIZES[m_sizeIndex];
         int newSizeIndex = m_sizeIndex;
         if (lf > MAX_LOAD_FACTOR) {
             newSizeIndex++;
         }
-        else if(lf < MIN_LOAD_FACTOR) {
+        else if (mayShrink && lf < MIN_LOAD_FACTOR) {
             // make sure the hash doesn't over-shrink
             if (newSizeIndex != BUCKET_INITIAL_INDEX) {
                 newSizeIndex--;
@@ -616,57 +674,83 @@ namespace voltdb {
         //std::cout << "DEBUG SIZING BUFFER" << newSizeIndex << std::endl;
         //std::cout.flush();
 
-        // create new double size buffer
+        // only one resize at a time
+        migrateBuckets(UINT64_MAX);
+
+        // create new double size buffer; anonymous mappings come zeroed,
+        // and writing every page of a big one here would be most of the stall
         void *memory = mmap(NULL, sizeof(HashNode*) * TABLE_SIZES[newSizeIndex], PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
         assert(memory);
-        HashNode **newBuckets = reinterpret_cast<HashNode**>(memory);
-        memset(newBuckets, 0, TABLE_SIZES[newSizeIndex] * sizeof(HashNode*));
 
-        // move all of the existing values
-        for (uint32_t i = 0; i < TABLE_SIZES[m_sizeIndex]; ++i) {
-            while (m_buckets[i]) {
-                HashNode *node = m_buckets[i];
-                m_buckets[i] = node->nextInBucket;
+        // existing values move over a few buckets per operation from here on
+        m_oldBuckets = m_buckets;
+        m_oldSizeIndex = m_sizeIndex;
+        m_migratedBuckets = 0;
+        m_buckets = reinterpret_cast<HashNode**>(memory);
+        m_sizeIndex = newSizeIndex;
+    }
 
-                uint64_t bucketOffset = node->hash % TABLE_SIZES[newSizeIndex];
-                node->nextInBucket = newBuckets[bucketOffset];
-                newBuckets[bucketOffset] = node;
+    template<class K, class T, class H, class EK, class ET>
+    void CompactingHashTable<K, T, H, EK, ET>::migrateBuckets(uint64_t count) {
+        if (!m_oldBuckets) {
+            return;
+        }
+        uint64_t oldBucketCount = TABLE_SIZES[m_oldSizeIndex];
+        uint64_t end = oldBucketCount;
+        if (count < oldBucketCount - m_migratedBuckets) {
+            end = m_migratedBuckets + count;
+        }
+        for (; m_migratedBuckets < end; ++m_migratedBuckets) {
+            HashNode **oldBucket = &(m_oldBuckets[m_migratedBuckets]);
+            while (*oldBucket) {
+                HashNode *node = *oldBucket;
+                *oldBucket = node->nextInBucket;
+
+                uint64_t bucketOffset = node->hash % TABLE_SIZES[m_sizeIndex];
+                node->nextInBucket = m_buckets[bucketOffset];
+                m_buckets[bucketOffset] = node;
             }
         }
 
-        // swap the table buffers
-        munmap(m_buckets, TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*));
-        m_buckets = newBuckets;
-        m_sizeIndex = newSizeIndex;
+        if (m_migratedBuckets == oldBucketCount) {
+            munmap(m_oldBuckets, oldBucketCount * sizeof(HashNode*));
+            m_oldBuckets = NULL;
+        }
     }
 
     template<class K, class T, class H, class EK, class ET>
     bool CompactingHashTable<K, T, H, EK, ET> ::verify() {
         size_t manualCount = 0;
 
-        for (uint64_t bucketi = 0; bucketi < TABLE_SIZES[m_sizeIndex]; ++bucketi) {
-            for (HashNode *node = m_buckets[bucketi]; node; node = node->nextInBucket) {
-                if (m_unique) {
-                    uint64_t hash = m_hasher(node->key);
-                    if (hash != node->hash) {
-                        printf("Node hash doesn't match expected value.\n");
-                        return false;
-                    }
-                    if ((hash % TABLE_SIZES[m_sizeIndex]) != bucketi) {
-                        printf("Node hash doesn't match expected bucket index.\n");
+        // while resizing, the unmoved old buckets hold the rest of the nodes
+        for (int array = 0; array < 2; ++array) {
+            HashNode **buckets = m_buckets;
+            uint64_t bucketCount = TABLE_SIZES[m_sizeIndex];
+            uint64_t firstBucket = 0;
+            if (array == 1) {
+                if (!m_oldBuckets) {
+                    break;
+                }
+                buckets = m_oldBuckets;
+                bucketCount = TABLE_SIZES[m_oldSizeIndex];
+                firstBucket = m_migratedBuckets;
+                for (uint64_t bucketi = 0; bucketi < firstBucket; ++bucketi) {
+                    if (buckets[bucketi]) {
+                        printf("Node found in an old bucket that was already moved.\n");
                         return false;
                     }
-
-                    ++manualCount;
                 }
-                else {
-                    for (HashNode *node2 = node; node2; node2 = node2->nextWithKey) {
+            }
+
+            for (uint64_t bucketi = firstBucket; bucketi < bucketCount; ++bucketi) {
+                for (HashNode *node = buckets[bucketi]; node; node = node->nextInBucket) {
+                    for (HashNode *node2 = node; node2; node2 = m_unique ? NULL : node2->nextWithKey) {
                         uint64_t hash = m_hasher(node2->key);
                         if (hash != node2->hash) {
                             printf("Node hash doesn't match expected value.\n");
                             return false;
                         }
-                        if ((hash % TABLE_SIZES[m_sizeIndex]) != bucketi) {
+                        if ((hash % bucketCount) != bucketi || bucketFor(hash) != &(buckets[bucketi])) {
                             printf("Node hash doesn't match expected bucket index.\n");
                             return false;
                         }
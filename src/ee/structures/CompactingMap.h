@@ -20,9 +20,11 @@
 
 #include "ContiguousAllocator.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <stdint.h>
 #include <utility>
+#include <vector>
 #include <limits>
 #include <cassert>
 
@@ -201,6 +203,14 @@ public:
     const Data *insert(const Key &key, const Data &data);
     bool erase(const Key &key);
     bool erase(iterator &iter);
+    /**
+     * Add many entries at once, sorting them first.  Unless the map already
+     * holds more entries than are being added, the tree is rebuilt bottom-up
+     * from the existing and new entries in order, with no rotations.
+     * As with insert, a key already in a unique map is not added again.
+     * Returns the number of entries added.
+     */
+    int64_t bulkInsert(std::vector<KeyValuePair> &entries);
 
     iterator find(const Key &key) const { return iterator(this, lookup(key)); }
     iterator findRank(int64_t ith) const { return iterator(this, lookupRank(ith)); }
@@ -230,6 +240,8 @@ public:
     // Must pass a key that already in map, or else return -1
     int64_t rankAsc(const Key& key) const;
     int64_t rankUpper(const Key& key) const;
+    // The 1-based position of the entry at iter, or -1 at the end
+    int64_t rankOf(const iterator &iter) const;
 
     /**
      * For debugging: verify the RB-tree constraints are met. SLOW.
@@ -244,6 +256,9 @@ protected:
     void erase(TreeNode *z);
     TreeNode *lookup(const Key &key) const;
     TreeNode *lookupRank(int64_t ith) const;
+    void clear();
+    TreeNode *buildSubtree(const KeyValuePair *entries, int64_t count, TreeNode *parent,
+                           int depth, int redDepth);
 
     inline int64_t getSubct(const TreeNode* x) const;
     inline void incSubct(TreeNode* x);
@@ -381,6 +396,104 @@ CompactingMap<KeyValuePair, Compare, hasRank>::insert(const Key &key, const Data
     return NULL;
 }
 
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingMap<KeyValuePair, Compare, hasRank>::bulkInsert(std::vector<KeyValuePair> &entries)
+{
+    const Compare &comper = m_comper;
+    // Stable, so that the first of several equal keys wins as it would one at a time
+    std::stable_sort(entries.begin(), entries.end(),
+                     [&comper](const KeyValuePair &lhs, const KeyValuePair &rhs) {
+                         return comper(lhs.getKey(), rhs.getKey()) < 0;
+                     });
+
+    if (m_count > static_cast<int64_t>(entries.size())) {
+        // Walking down a big tree in key order still beats a rebuild
+        int64_t added = 0;
+        for (int64_t ii = 0; ii < static_cast<int64_t>(entries.size()); ++ii) {
+            if (insert(entries[ii].getKey(), entries[ii].getValue()) == NULL) {
+                ++added;
+            }
+        }
+        return added;
+    }
+
+    // Merge with the existing entries, which come first among equal keys
+    std::vector<KeyValuePair> merged;
+    merged.reserve(m_count + entries.size());
+    iterator iter = begin();
+    typename std::vector<KeyValuePair>::const_iterator next = entries.begin();
+    while (next != entries.end()) {
+        if ( ! iter.isEnd() && m_comper(iter.key(), next->getKey()) <= 0) {
+            merged.push_back(iter.pair());
+            iter.moveNext();
+        }
+        else {
+            merged.push_back(*next);
+            ++next;
+        }
+    }
+    for (; ! iter.isEnd(); iter.moveNext()) {
+        merged.push_back(iter.pair());
+    }
+    if (m_unique) {
+        merged.erase(std::unique(merged.begin(), merged.end(),
+                                 [&comper](const KeyValuePair &lhs, const KeyValuePair &rhs) {
+                                     return comper(lhs.getKey(), rhs.getKey()) == 0;
+                                 }),
+                     merged.end());
+    }
+    int64_t added = static_cast<int64_t>(merged.size()) - m_count;
+
+    clear();
+    if ( ! merged.empty()) {
+        // Nodes on a partly filled last level are red; all the others are black.
+        int redDepth = 0;
+        while ((static_cast<int64_t>(2) << redDepth) <= static_cast<int64_t>(merged.size()) + 1) {
+            ++redDepth;
+        }
+        m_root = buildSubtree(&merged[0], static_cast<int64_t>(merged.size()), &NIL, 0, redDepth);
+        m_count = static_cast<int64_t>(merged.size());
+    }
+    assert(m_allocator.count() == m_count);
+    return added;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingMap<KeyValuePair, Compare, hasRank>::clear()
+{
+    iterator iter = begin();
+    while (!iter.isEnd()) {
+        iter.pair().~KeyValuePair();
+        iter.moveNext();
+    }
+    while (m_allocator.count() > 0) {
+        m_allocator.trim();
+    }
+    m_root = &NIL;
+    m_count = 0;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingMap<KeyValuePair, Compare, hasRank>::TreeNode *
+CompactingMap<KeyValuePair, Compare, hasRank>::buildSubtree(const KeyValuePair *entries, int64_t count,
+                                                            TreeNode *parent, int depth, int redDepth)
+{
+    if (count == 0) {
+        return &NIL;
+    }
+    // Halving keeps every path within one node of the shortest
+    int64_t middle = count / 2;
+    TreeNode *node = new (m_allocator) TreeNode(&NIL, parent);
+    node->kv = entries[middle];
+    node->color = (depth == redDepth) ? RED : BLACK;
+    node->left = buildSubtree(entries, middle, node, depth + 1, redDepth);
+    node->right = buildSubtree(entries + middle + 1, count - middle - 1, node, depth + 1, redDepth);
+    if (hasRank) {
+        updateSubct(node);
+    }
+    return node;
+}
+
 template<typename KeyValuePair, typename Compare, bool hasRank>
 typename CompactingMap<KeyValuePair, Compare, hasRank>::iterator
 CompactingMap<KeyValuePair, Compare, hasRank>::lowerBound(const Key &key) const
@@ -950,6 +1063,23 @@ int64_t CompactingMap<KeyValuePair, Compare, hasRank>::rankUpper(const Key& key)
     return rankAsc(it.key()) - 1;
 }
 
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingMap<KeyValuePair, Compare, hasRank>::rankOf(const iterator &iter) const
+{
+    if ((!hasRank) || iter.isEnd()) {
+        return -1;
+    }
+    const TreeNode *x = iter.m_node;
+    int64_t rank = getSubct(x->left) + 1;
+    while (x->parent != &NIL) {
+        if (x == x->parent->right) {
+            rank += getSubct(x->parent->left) + 1;
+        }
+        x = x->parent;
+    }
+    return rank;
+}
+
 template<typename KeyValuePair, typename Compare, bool hasRank>
 typename CompactingMap<KeyValuePair, Compare, hasRank>::TreeNode*
 CompactingMap<KeyValuePair, Compare, hasRank>::lookupRank(int64_t ith) const
@@ -97,6 +97,10 @@ namespace voltdb
     std::size_t getBytesAllocated() const
     { return m_allocator.bytesAllocated(); }
 
+    // Free the empty buffer kept for reuse, returning the bytes freed.
+    std::size_t releaseCachedBuffer()
+    { return m_allocator.releaseCachedBuffer(); }
+
     static int32_t FIXED_OVERHEAD_PER_ENTRY()
     { return static_cast<int32_t>(sizeof(Relocatable)); }
 
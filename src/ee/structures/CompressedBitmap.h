@@ -0,0 +1,271 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPRESSEDBITMAP_H_
+#define COMPRESSEDBITMAP_H_
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <stdint.h>
+
+namespace voltdb {
+
+    /**
+     * CompressedBitmap is a set of 32-bit unsigned integers, compressed in
+     * the manner of a roaring bitmap. The values are split by their high 16
+     * bits into containers, kept sorted by those bits. Each container holds
+     * the low 16 bits of its values either as a sorted array, while it has
+     * few of them, or as a 65536-bit bitset once it has more than fit in
+     * the same space.
+     *
+     * There is no iterator; nextSlot() finds the value at or after a given
+     * one.
+     */
+    class CompressedBitmap {
+    public:
+        CompressedBitmap() : m_cardinality(0) {}
+
+        /** @return false if value was already in the set */
+        bool add(uint32_t value) {
+            const uint16_t high = static_cast<uint16_t>(value >> 16);
+            std::vector<Container>::iterator iter = lowerBound(high);
+            if (iter == m_containers.end() || iter->high() != high) {
+                iter = m_containers.insert(iter, Container(high));
+            }
+            if ( ! iter->add(static_cast<uint16_t>(value))) {
+                return false;
+            }
+            ++m_cardinality;
+            return true;
+        }
+
+        /** @return false if value was not in the set */
+        bool remove(uint32_t value) {
+            const uint16_t high = static_cast<uint16_t>(value >> 16);
+            std::vector<Container>::iterator iter = lowerBound(high);
+            if (iter == m_containers.end() || iter->high() != high) {
+                return false;
+            }
+            if ( ! iter->remove(static_cast<uint16_t>(value))) {
+                return false;
+            }
+            if (iter->count() == 0) {
+                m_containers.erase(iter);
+            }
+            --m_cardinality;
+            return true;
+        }
+
+        bool contains(uint32_t value) const {
+            const uint16_t high = static_cast<uint16_t>(value >> 16);
+            std::vector<Container>::const_iterator iter = lowerBound(high);
+            return iter != m_containers.end() && iter->high() == high &&
+                   iter->contains(static_cast<uint16_t>(value));
+        }
+
+        /**
+         * Finds the smallest value in the set that is at least from.
+         * @return false if there is none.
+         */
+        bool nextSlot(uint32_t from, uint32_t &value) const {
+            const uint16_t fromHigh = static_cast<uint16_t>(from >> 16);
+            for (std::vector<Container>::const_iterator iter = lowerBound(fromHigh);
+                 iter != m_containers.end(); ++iter) {
+                const uint16_t fromLow = (iter->high() == fromHigh) ? static_cast<uint16_t>(from) : 0;
+                uint16_t low;
+                if (iter->next(fromLow, low)) {
+                    value = (static_cast<uint32_t>(iter->high()) << 16) | low;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool empty() const { return m_cardinality == 0; }
+
+        int64_t cardinality() const { return m_cardinality; }
+
+        void clear() {
+            m_containers.clear();
+            m_cardinality = 0;
+        }
+
+        void swap(CompressedBitmap &other) {
+            m_containers.swap(other.m_containers);
+            std::swap(m_cardinality, other.m_cardinality);
+        }
+
+        int64_t getMemoryEstimate() const {
+            int64_t bytes = m_containers.capacity() * sizeof(Container);
+            for (std::vector<Container>::const_iterator iter = m_containers.begin();
+                 iter != m_containers.end(); ++iter) {
+                bytes += iter->getMemoryEstimate();
+            }
+            return bytes;
+        }
+
+    private:
+        // An array container turns into a bitset when it would outgrow one
+        static const int32_t MAX_ARRAY_COUNT = 4096;
+        static const int32_t BITSET_WORDS = 65536 / 64;
+
+        class Container {
+        public:
+            explicit Container(uint16_t high) : m_high(high), m_count(0) {}
+
+            uint16_t high() const { return m_high; }
+            int32_t count() const { return m_count; }
+
+            bool add(uint16_t low) {
+                if (isBitset()) {
+                    uint64_t &word = m_bits[low >> 6];
+                    const uint64_t bit = uint64_t(1) << (low & 63);
+                    if (word & bit) {
+                        return false;
+                    }
+                    word |= bit;
+                }
+                else {
+                    std::vector<uint16_t>::iterator iter = std::lower_bound(m_values.begin(), m_values.end(), low);
+                    if (iter != m_values.end() && *iter == low) {
+                        return false;
+                    }
+                    if (m_count == MAX_ARRAY_COUNT) {
+                        toBitset();
+                        return add(low);
+                    }
+                    m_values.insert(iter, low);
+                }
+                ++m_count;
+                return true;
+            }
+
+            bool remove(uint16_t low) {
+                if (isBitset()) {
+                    uint64_t &word = m_bits[low >> 6];
+                    const uint64_t bit = uint64_t(1) << (low & 63);
+                    if ( ! (word & bit)) {
+                        return false;
+                    }
+                    word &= ~bit;
+                    --m_count;
+                    // Wait until the array would be well under its limit,
+                    // so that adds and removes around it don't convert back
+                    // and forth.
+                    if (m_count <= MAX_ARRAY_COUNT / 2) {
+                        toArray();
+                    }
+                    return true;
+                }
+                std::vector<uint16_t>::iterator iter = std::lower_bound(m_values.begin(), m_values.end(), low);
+                if (iter == m_values.end() || *iter != low) {
+                    return false;
+                }
+                m_values.erase(iter);
+                --m_count;
+                return true;
+            }
+
+            bool contains(uint16_t low) const {
+                if (isBitset()) {
+                    return (m_bits[low >> 6] >> (low & 63)) & 1;
+                }
+                return std::binary_search(m_values.begin(), m_values.end(), low);
+            }
+
+            bool next(uint16_t from, uint16_t &low) const {
+                if ( ! isBitset()) {
+                    std::vector<uint16_t>::const_iterator iter =
+                        std::lower_bound(m_values.begin(), m_values.end(), from);
+                    if (iter == m_values.end()) {
+                        return false;
+                    }
+                    low = *iter;
+                    return true;
+                }
+                int32_t wordIndex = from >> 6;
+                uint64_t word = m_bits[wordIndex] & (~uint64_t(0) << (from & 63));
+                while (word == 0) {
+                    if (++wordIndex == BITSET_WORDS) {
+                        return false;
+                    }
+                    word = m_bits[wordIndex];
+                }
+                low = static_cast<uint16_t>((wordIndex << 6) + __builtin_ctzll(word));
+                return true;
+            }
+
+            int64_t getMemoryEstimate() const {
+                return m_values.capacity() * sizeof(uint16_t) + m_bits.capacity() * sizeof(uint64_t);
+            }
+
+        private:
+            bool isBitset() const { return ! m_bits.empty(); }
+
+            void toBitset() {
+                assert( ! isBitset());
+                m_bits.assign(BITSET_WORDS, 0);
+                for (std::vector<uint16_t>::const_iterator iter = m_values.begin();
+                     iter != m_values.end(); ++iter) {
+                    m_bits[*iter >> 6] |= uint64_t(1) << (*iter & 63);
+                }
+                std::vector<uint16_t>().swap(m_values);
+            }
+
+            void toArray() {
+                assert(isBitset());
+                std::vector<uint16_t> values;
+                values.reserve(m_count);
+                for (int32_t ii = 0; ii < BITSET_WORDS; ii++) {
+                    for (uint64_t word = m_bits[ii]; word != 0; word &= word - 1) {
+                        values.push_back(static_cast<uint16_t>((ii << 6) + __builtin_ctzll(word)));
+                    }
+                }
+                m_values.swap(values);
+                std::vector<uint64_t>().swap(m_bits);
+            }
+
+            uint16_t m_high;
+            int32_t m_count;
+            // The sorted low bits, while there are at most MAX_ARRAY_COUNT
+            std::vector<uint16_t> m_values;
+            // BITSET_WORDS words once there are more, otherwise empty
+            std::vector<uint64_t> m_bits;
+        };
+
+        struct HighLess {
+            bool operator()(const Container &container, uint16_t high) const {
+                return container.high() < high;
+            }
+        };
+
+        std::vector<Container>::iterator lowerBound(uint16_t high) {
+            return std::lower_bound(m_containers.begin(), m_containers.end(), high, HighLess());
+        }
+
+        std::vector<Container>::const_iterator lowerBound(uint16_t high) const {
+            return std::lower_bound(m_containers.begin(), m_containers.end(), high, HighLess());
+        }
+
+        std::vector<Container> m_containers;
+        int64_t m_cardinality;
+    };
+
+} // namespace voltdb
+
+#endif // COMPRESSEDBITMAP_H_
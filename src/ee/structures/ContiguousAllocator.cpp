@@ -16,6 +16,7 @@
  */
 
 #include "ContiguousAllocator.h"
+#include "common/HugePages.h"
 
 #include <cassert>
 
@@ -24,7 +25,8 @@ using namespace voltdb;
 ContiguousAllocator::ContiguousAllocator(int32_t allocSize, int32_t chunkSize)
     : m_count(0),
       m_allocationSize(allocSize),
-      m_numberAllocationsPerBlock(chunkSize),
+      m_numberAllocationsPerBlock(allocationsPerBlock(allocSize, chunkSize)),
+      m_hugePages(HugePages::worthwhile(sizeof(Buffer) + static_cast<size_t>(allocSize) * chunkSize)),
       m_tail(NULL),
       m_blockCount(0),
       m_cachedBuffer(0) {}
@@ -32,11 +34,45 @@ ContiguousAllocator::ContiguousAllocator(int32_t allocSize, int32_t chunkSize)
 ContiguousAllocator::~ContiguousAllocator() {
     while (m_tail) {
         Buffer *buf = m_tail->prev;
-        free(m_tail);
+        freeBuffer(m_tail);
         m_tail = buf;
     }
     if (m_cachedBuffer != NULL) {
-        free(m_cachedBuffer);
+        freeBuffer(m_cachedBuffer);
+    }
+}
+
+int32_t ContiguousAllocator::allocationsPerBlock(int32_t allocSize, int32_t chunkSize) {
+    size_t blockSize = sizeof(Buffer) + static_cast<size_t>(allocSize) * chunkSize;
+    if ( ! HugePages::worthwhile(blockSize)) {
+        return chunkSize;
+    }
+    // Shrink the block to whole huge pages rather than map a mostly
+    // empty extra page for the last few allocations.
+    size_t pages = blockSize / HugePages::HUGE_PAGE_SIZE;
+    return static_cast<int32_t>((pages * HugePages::HUGE_PAGE_SIZE - sizeof(Buffer)) / allocSize);
+}
+
+ContiguousAllocator::Buffer *ContiguousAllocator::allocBuffer() {
+    size_t blockSize = sizeof(Buffer) + static_cast<size_t>(m_allocationSize) * m_numberAllocationsPerBlock;
+    if (m_hugePages) {
+        bool fromHugePagePool;
+        Buffer *buf = reinterpret_cast<Buffer*>(HugePages::allocate(blockSize, &fromHugePagePool));
+        buf->fromHugePagePool = fromHugePagePool;
+        return buf;
+    }
+    Buffer *buf = static_cast<Buffer*>(malloc(blockSize));
+    buf->fromHugePagePool = 0;
+    return buf;
+}
+
+void ContiguousAllocator::freeBuffer(Buffer *buf) {
+    if (m_hugePages) {
+        size_t blockSize = sizeof(Buffer) + static_cast<size_t>(m_allocationSize) * m_numberAllocationsPerBlock;
+        HugePages::free(reinterpret_cast<char*>(buf), blockSize, buf->fromHugePagePool != 0);
+    }
+    else {
+        free(buf);
     }
 }
 
@@ -48,16 +84,14 @@ void *ContiguousAllocator::alloc() {
 
     // if a new block is needed...
     if (blockOffset == 0) {
-        void *memory;
+        Buffer *buf;
         if (m_cachedBuffer != NULL) {
-            memory = static_cast<void *>(m_cachedBuffer);
+            buf = m_cachedBuffer;
             m_cachedBuffer = NULL;
         } else {
-            memory = static_cast<void *>(malloc(sizeof(Buffer) + m_allocationSize * m_numberAllocationsPerBlock));
+            buf = allocBuffer();
         }
 
-        Buffer *buf = reinterpret_cast<Buffer*>(memory);
-
         // for debugging
         //memset(buf, 0, sizeof(sizeof(Buffer) + m_allocSize * m_chunkSize));
 
@@ -100,12 +134,21 @@ void ContiguousAllocator::trim() {
         if (m_blockCount == 0) {
             m_cachedBuffer = m_tail;
         } else {
-            free(m_tail);
+            freeBuffer(m_tail);
         }
         m_tail = buf;
     }
 }
 
+size_t ContiguousAllocator::releaseCachedBuffer() {
+    if (m_cachedBuffer == NULL) {
+        return 0;
+    }
+    freeBuffer(m_cachedBuffer);
+    m_cachedBuffer = NULL;
+    return static_cast<size_t>(m_allocationSize) * static_cast<size_t>(m_numberAllocationsPerBlock);
+}
+
 size_t ContiguousAllocator::bytesAllocated() const {
     size_t total = static_cast<size_t>(m_blockCount) *
         static_cast<size_t>(m_allocationSize) *
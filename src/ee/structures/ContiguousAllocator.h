@@ -19,6 +19,7 @@
 #define CONTIGUOUSALLOCATOR_H_
 
 #include <cstdlib>
+#include <stdint.h>
 
 namespace voltdb {
 
@@ -34,6 +35,9 @@ namespace voltdb {
  * A *block* is a fixed size allocation, which has been obtained from
  * malloc(3). These are chained together.  They are all the same size
  * in bytes.  This size is set when the allocator is constructed.
+ * When huge pages are enabled (see HugePages) and a block is at least a
+ * huge page, blocks are mapped from huge pages instead, and the number of
+ * allocations per block is trimmed so that a block fills whole pages.
  *
  * The head of the chain of blocks is the *tail block*.  Blocks which
  * are not the tail block are completely full.
@@ -50,6 +54,9 @@ class ContiguousAllocator {
      */
     struct Buffer {
         Buffer *prev;
+        // Set for blocks mapped from the explicit huge page pool.
+        // A full word keeps the data aligned.
+        int64_t fromHugePagePool;
         char data[0];
     };
     /** This is the total number of allocations in use in all blocks. */
@@ -58,6 +65,8 @@ class ContiguousAllocator {
     const int32_t m_allocationSize;
     /** This is the number of allocations in each block in this allocator. */
     const int32_t m_numberAllocationsPerBlock;
+    /** True if blocks are mapped with HugePages rather than malloc'd. */
+    const bool m_hugePages;
     /**
      * This points to the tail buffer.  When m_count % m_chunkSize reaches
      * zero and we want a new node we must allocate a new block.  The address
@@ -73,6 +82,10 @@ class ContiguousAllocator {
      */
     Buffer *m_cachedBuffer;
 
+    static int32_t allocationsPerBlock(int32_t allocSize, int32_t chunkSize);
+    Buffer *allocBuffer();
+    void freeBuffer(Buffer *buf);
+
 public:
 
     /**
@@ -116,6 +129,15 @@ public:
      */
     size_t bytesAllocated() const;
 
+    /** Are blocks mapped with huge pages?  This is used in testing. */
+    bool usesHugePages() const { return m_hugePages; }
+
+    /**
+     * Free the cached last buffer, if any, rather than keep it for reuse.
+     * Return the number of bytes freed.
+     */
+    size_t releaseCachedBuffer();
+
     /** Do we have a cached last buffer?  This is used in testing. */
     bool hasCachedLastBuffer() const { return (m_cachedBuffer != NULL); }
 };
@@ -0,0 +1,331 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLATHASHMAP_H_
+#define FLATHASHMAP_H_
+
+#include "common/Pool.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <utility>
+#include <stdint.h>
+
+namespace voltdb {
+
+    /**
+     * FlatHashMap is an insert-only hash map with open addressing, for the short-lived maps built
+     * while executing a query, such as the groups of a hash aggregation or the values seen by a
+     * DISTINCT aggregate.
+     *
+     * It is special in that:
+     * 1. Entries live in one flat array, probed linearly, instead of in separately allocated
+     *    nodes, so a lookup touches one or two cache lines rather than walking a chain.
+     * 2. Alongside the entries is an array of one byte "control" tags holding 7 bits of each
+     *    entry's hash, so most non-matching entries are skipped without looking at them.  The
+     *    full hash is also kept with the entry, so the (possibly expensive) equality check only
+     *    runs for real candidates and growing never re-hashes a key.
+     * 3. All of its memory comes from a Pool.  Nothing is ever freed individually: the arrays
+     *    outgrown when the map doubles are simply left in the pool.  Keys and values are never
+     *    destroyed either, so they must not own memory outside the pool.
+     * 4. It supports only insert, find, iteration and clearing; there is no erase.
+     *
+     * Because the pool owns the memory, reset() must be called before (or instead of using the
+     * map after) the pool is purged.
+     */
+    template<class K, class V, class H = boost::hash<K>, class E = std::equal_to<K> >
+    class FlatHashMap {
+    public:
+        typedef K key_type;
+        typedef V mapped_type;
+        typedef std::pair<K, V> value_type;
+        typedef H hasher;
+        typedef E key_equal;
+
+        // capacity when the first entry is inserted; always a power of two
+        static const std::size_t INITIAL_CAPACITY = 16;
+        // grow when the map would be more than 7/8 full
+        static const std::size_t MAX_LOAD_NUMERATOR = 7;
+        static const std::size_t MAX_LOAD_DENOMINATOR = 8;
+
+    private:
+        // control tag of a slot that has never been used
+        static const uint8_t EMPTY = 0;
+        // control tags of used slots always have the high bit set
+        static const uint8_t USED = 0x80;
+
+        struct Slot {
+            std::size_t m_hash;
+            value_type m_value;
+        };
+
+    public:
+        class const_iterator;
+
+        class iterator {
+            friend class FlatHashMap;
+            friend class const_iterator;
+        public:
+            iterator() : m_map(NULL), m_index(0) {}
+
+            value_type& operator*() const { return m_map->m_slots[m_index].m_value; }
+            value_type* operator->() const { return &m_map->m_slots[m_index].m_value; }
+
+            iterator& operator++() {
+                m_index = m_map->nextUsed(m_index + 1);
+                return *this;
+            }
+            iterator operator++(int) {
+                iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const iterator& other) const { return m_index == other.m_index; }
+            bool operator!=(const iterator& other) const { return m_index != other.m_index; }
+
+        private:
+            iterator(const FlatHashMap* map, std::size_t index)
+                : m_map(const_cast<FlatHashMap*>(map)), m_index(index) {}
+
+            FlatHashMap* m_map;
+            std::size_t m_index;
+        };
+
+        class const_iterator {
+            friend class FlatHashMap;
+        public:
+            const_iterator() : m_map(NULL), m_index(0) {}
+            const_iterator(const iterator& it) : m_map(it.m_map), m_index(it.m_index) {}
+
+            const value_type& operator*() const { return m_map->m_slots[m_index].m_value; }
+            const value_type* operator->() const { return &m_map->m_slots[m_index].m_value; }
+
+            const_iterator& operator++() {
+                m_index = m_map->nextUsed(m_index + 1);
+                return *this;
+            }
+            const_iterator operator++(int) {
+                const_iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+            bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+        private:
+            const_iterator(const FlatHashMap* map, std::size_t index) : m_map(map), m_index(index) {}
+
+            const FlatHashMap* m_map;
+            std::size_t m_index;
+        };
+
+        explicit FlatHashMap(Pool* pool, const H& hash = H(), const E& equal = E())
+            : m_pool(pool)
+            , m_hasher(hash)
+            , m_keyEq(equal)
+            , m_control(NULL)
+            , m_slots(NULL)
+            , m_capacity(0)
+            , m_size(0)
+        {
+            assert(pool != NULL);
+        }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        std::size_t capacity() const { return m_capacity; }
+
+        iterator begin() { return iterator(this, nextUsed(0)); }
+        iterator end() { return iterator(this, m_capacity); }
+        const_iterator begin() const { return const_iterator(this, nextUsed(0)); }
+        const_iterator end() const { return const_iterator(this, m_capacity); }
+
+        iterator find(const K& key) {
+            return iterator(this, findIndex(key, hashOf(key)));
+        }
+        const_iterator find(const K& key) const {
+            return const_iterator(this, findIndex(key, hashOf(key)));
+        }
+
+        /**
+         * Insert the entry unless its key is already present.  Returns an iterator to the entry
+         * with the key, and whether it was inserted.
+         */
+        std::pair<iterator, bool> insert(const value_type& value) {
+            std::size_t hash = hashOf(value.first);
+            std::size_t index = findIndex(value.first, hash);
+            if (index != m_capacity) {
+                return std::make_pair(iterator(this, index), false);
+            }
+            if ((m_size + 1) * MAX_LOAD_DENOMINATOR > m_capacity * MAX_LOAD_NUMERATOR) {
+                grow();
+            }
+            index = emptyIndex(hash);
+            m_control[index] = tag(hash);
+            Slot& slot = m_slots[index];
+            slot.m_hash = hash;
+            new (&slot.m_value) value_type(value);
+            ++m_size;
+            return std::make_pair(iterator(this, index), true);
+        }
+
+        /** Remove all entries, keeping the current capacity. */
+        void clear() {
+            if (m_size != 0) {
+                ::memset(m_control, EMPTY, m_capacity);
+                m_size = 0;
+            }
+        }
+
+        /** Remove all entries and forget the arrays, for when the pool is being purged. */
+        void reset() {
+            m_control = NULL;
+            m_slots = NULL;
+            m_capacity = 0;
+            m_size = 0;
+        }
+
+    private:
+        // boost::hash of an integer is the integer itself, which would put runs of
+        // consecutive keys in the same home slot; mix all the bits in first.
+        std::size_t hashOf(const K& key) const {
+            uint64_t hash = m_hasher(key);
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            return static_cast<std::size_t>(hash);
+        }
+
+        static uint8_t tag(std::size_t hash) {
+            return static_cast<uint8_t>(USED | (hash & 0x7F));
+        }
+
+        // The low bits of the hash are used for the tag, so start probing from the others.
+        std::size_t home(std::size_t hash) const {
+            return (hash >> 7) & (m_capacity - 1);
+        }
+
+        std::size_t findIndex(const K& key, std::size_t hash) const {
+            if (m_size == 0) {
+                return m_capacity;
+            }
+            const uint8_t wanted = tag(hash);
+            const std::size_t mask = m_capacity - 1;
+            // The load limit guarantees an empty slot, which ends every probe.
+            for (std::size_t index = home(hash); ; index = (index + 1) & mask) {
+                const uint8_t control = m_control[index];
+                if (control == EMPTY) {
+                    return m_capacity;
+                }
+                if (control == wanted &&
+                    m_slots[index].m_hash == hash &&
+                    m_keyEq(m_slots[index].m_value.first, key)) {
+                    return index;
+                }
+            }
+        }
+
+        std::size_t emptyIndex(std::size_t hash) const {
+            const std::size_t mask = m_capacity - 1;
+            std::size_t index = home(hash);
+            while (m_control[index] != EMPTY) {
+                index = (index + 1) & mask;
+            }
+            return index;
+        }
+
+        std::size_t nextUsed(std::size_t index) const {
+            while (index < m_capacity && m_control[index] == EMPTY) {
+                ++index;
+            }
+            return index;
+        }
+
+        void grow() {
+            uint8_t* oldControl = m_control;
+            Slot* oldSlots = m_slots;
+            std::size_t oldCapacity = m_capacity;
+
+            m_capacity = (oldCapacity == 0) ? INITIAL_CAPACITY : oldCapacity * 2;
+            // Pool allocations are not aligned, so leave room to align the slots,
+            // which go first in the allocation, ahead of the control tags.
+            const std::size_t alignment = boost::alignment_of<Slot>::value;
+            char* storage = reinterpret_cast<char*>(m_pool->allocate(m_capacity * (sizeof(Slot) + 1) + alignment - 1));
+            storage += (alignment - reinterpret_cast<uintptr_t>(storage) % alignment) % alignment;
+            m_slots = reinterpret_cast<Slot*>(storage);
+            m_control = reinterpret_cast<uint8_t*>(storage + m_capacity * sizeof(Slot));
+            ::memset(m_control, EMPTY, m_capacity);
+
+            for (std::size_t ii = 0; ii < oldCapacity; ++ii) {
+                if (oldControl[ii] == EMPTY) {
+                    continue;
+                }
+                std::size_t index = emptyIndex(oldSlots[ii].m_hash);
+                m_control[index] = oldControl[ii];
+                ::memcpy(static_cast<void*>(&m_slots[index]), &oldSlots[ii], sizeof(Slot));
+            }
+        }
+
+        Pool* m_pool;              // where all the arrays come from
+        H m_hasher;                // instance of the hashing function
+        E m_keyEq;                 // instance of the key eq checker
+        uint8_t* m_control;        // one tag per slot: EMPTY, or USED plus 7 bits of hash
+        Slot* m_slots;             // the entries
+        std::size_t m_capacity;    // number of slots, a power of two
+        std::size_t m_size;        // number of used slots
+    };
+
+    /**
+     * A set with the same properties as FlatHashMap.
+     */
+    template<class K, class H = boost::hash<K>, class E = std::equal_to<K> >
+    class FlatHashSet {
+        struct NoValue {};
+        typedef FlatHashMap<K, NoValue, H, E> MapType;
+
+    public:
+        explicit FlatHashSet(Pool* pool, const H& hash = H(), const E& equal = E())
+            : m_map(pool, hash, equal)
+        {}
+
+        std::size_t size() const { return m_map.size(); }
+        bool empty() const { return m_map.empty(); }
+        bool contains(const K& key) const { return m_map.find(key) != m_map.end(); }
+
+        /** Returns true if the key was not already in the set. */
+        bool insert(const K& key) { return m_map.insert(std::make_pair(key, NoValue())).second; }
+
+        void clear() { m_map.clear(); }
+        void reset() { m_map.reset(); }
+
+    private:
+        MapType m_map;
+    };
+
+}
+
+#endif // FLATHASHMAP_H_
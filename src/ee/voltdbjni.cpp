@@ -106,6 +106,8 @@
 #include "common/TheHashinator.h"
 #include "common/Pool.hpp"
 #include "common/FatalException.hpp"
+#include "common/HugePages.h"
+#include "common/MemoryReclaimer.h"
 #include "common/SegvException.hpp"
 #include "common/RecoveryProtoMessage.h"
 #include "common/LegacyHashinator.h"
@@ -862,6 +864,22 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeToggl
     return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
 }
 
+/**
+ * Turns on or off the per-executor profiling reported by the EXECUTOR stats selector.
+ * @returns 0 on success.
+ */
+SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeSetExecutorProfiling
+(JNIEnv *env, jobject obj, jlong engine_ptr, jboolean enable)
+{
+    VOLT_DEBUG("nativeSetExecutorProfiling in C++ called");
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    if (engine) {
+        engine->setExecutorProfiling(enable == JNI_TRUE);
+        return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
+    }
+    return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
+}
+
 /**
  * Release the undo token
  * @returns JNI_TRUE on success. JNI_FALSE otherwise.
@@ -1247,6 +1265,36 @@ SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetT
     return ThreadLocalPool::getPoolAllocationSize();
 }
 
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetHugePageAllocations
+ * Signature: ()J
+ */
+SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetHugePageAllocations
+  (JNIEnv *, jclass) {
+    return HugePages::hugePageBytes();
+}
+
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetHugePageFallbackAllocations
+ * Signature: ()J
+ */
+SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetHugePageFallbackAllocations
+  (JNIEnv *, jclass) {
+    return HugePages::normalPageBytes();
+}
+
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetReclaimedMemory
+ * Signature: ()J
+ */
+SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetReclaimedMemory
+  (JNIEnv *, jclass) {
+    return MemoryReclaimer::bytesReturned();
+}
+
 /*
  * Class:     org_voltdb_jni_ExecutionEngine
  * Method:    nativeGetRSS
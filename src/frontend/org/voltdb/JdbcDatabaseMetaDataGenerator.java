@@ -514,7 +514,7 @@ public class JdbcDatabaseMetaDataGenerator
     private String getSortOrder(Index index)
     {
         String sort_order = null;
-        if (index.getType() == IndexType.BALANCED_TREE.getValue())
+        if (IndexType.isScannable(index.getType()))
         {
             sort_order = "A";
         }
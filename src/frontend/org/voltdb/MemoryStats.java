@@ -34,6 +34,9 @@ public class MemoryStats extends StatsSource {
         long indexMem = 0;
         long stringMem = 0;
         long pooledMem = 0;
+        long hugePageMem = 0;
+        long hugePageFallbackMem = 0;
+        long reclaimedMem = 0;
     }
     Map<Long, PartitionMemRow> m_memoryStats = new TreeMap<Long, PartitionMemRow>();
 
@@ -82,6 +85,9 @@ public class MemoryStats extends StatsSource {
         columns.add(new VoltTable.ColumnInfo("POOLEDMEMORY", VoltType.BIGINT));
         columns.add(new VoltTable.ColumnInfo("PHYSICALMEMORY", VoltType.BIGINT));
         columns.add(new VoltTable.ColumnInfo("JAVAMAXHEAP", VoltType.INTEGER));
+        columns.add(new VoltTable.ColumnInfo("HUGEPAGEMEMORY", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("HUGEPAGEFALLBACKMEMORY", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("RECLAIMEDMEMORY", VoltType.BIGINT));
     }
 
     @Override
@@ -95,6 +101,10 @@ public class MemoryStats extends StatsSource {
             totals.indexMem += pmr.indexMem;
             totals.stringMem += pmr.stringMem;
             totals.pooledMem += pmr.pooledMem;
+            // huge page mappings are counted per process, not per site
+            totals.hugePageMem = Math.max(totals.hugePageMem, pmr.hugePageMem);
+            totals.hugePageFallbackMem = Math.max(totals.hugePageFallbackMem, pmr.hugePageFallbackMem);
+            totals.reclaimedMem = Math.max(totals.reclaimedMem, pmr.reclaimedMem);
         }
 
         // get system statistics
@@ -119,6 +129,9 @@ public class MemoryStats extends StatsSource {
         //in kb to make math simpler with other mem values.
         rowValues[columnNameToIndex.get("PHYSICALMEMORY")] = PlatformProperties.getPlatformProperties().ramInMegabytes * 1024;
         rowValues[columnNameToIndex.get("JAVAMAXHEAP")] = Runtime.getRuntime().maxMemory() / 1024;
+        rowValues[columnNameToIndex.get("HUGEPAGEMEMORY")] = totals.hugePageMem / 1024;
+        rowValues[columnNameToIndex.get("HUGEPAGEFALLBACKMEMORY")] = totals.hugePageFallbackMem / 1024;
+        rowValues[columnNameToIndex.get("RECLAIMEDMEMORY")] = totals.reclaimedMem / 1024;
         super.updateStatsRow(rowKey, rowValues);
     }
 
@@ -128,7 +141,10 @@ public class MemoryStats extends StatsSource {
                                               long tupleAllocatedMem,
                                               long indexMem,
                                               long stringMem,
-                                              long pooledMemory) {
+                                              long pooledMemory,
+                                              long hugePageMemory,
+                                              long hugePageFallbackMemory,
+                                              long reclaimedMemory) {
         PartitionMemRow pmr = new PartitionMemRow();
         pmr.tupleCount = tupleCount;
         pmr.tupleDataMem = tupleDataMem;
@@ -136,6 +152,9 @@ public class MemoryStats extends StatsSource {
         pmr.indexMem = indexMem;
         pmr.stringMem = stringMem;
         pmr.pooledMem = pooledMemory;
+        pmr.hugePageMem = hugePageMemory;
+        pmr.hugePageFallbackMem = hugePageFallbackMemory;
+        pmr.reclaimedMem = reclaimedMemory;
         m_memoryStats.put(siteId, pmr);
     }
 }
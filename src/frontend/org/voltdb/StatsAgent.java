@@ -393,6 +393,9 @@ public class StatsAgent extends OpsAgent
         case INDEX:
             stats = collectStats(StatsSelector.INDEX, interval);
             break;
+        case EXECUTOR:
+            stats = collectStats(StatsSelector.EXECUTOR, interval);
+            break;
         case PROCEDURE:
         case PROCEDUREINPUT:
         case PROCEDUREOUTPUT:
@@ -56,5 +56,11 @@ public enum StatsSelector {
     CPU,            // Return CPU Stats
 
     COMMANDLOG,     // return number of outstanding bytes and txns on this node
-    IMPORTER
+    IMPORTER,
+
+    /*
+     * Per plan node timings from the EE.  The EE's selector enum matches this
+     * ordinal, so keep it last.
+     */
+    EXECUTOR
 }
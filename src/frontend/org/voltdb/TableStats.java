@@ -48,5 +48,15 @@ public class TableStats extends SiteStatsSource {
         columns.add(new ColumnInfo("STRING_DATA_MEMORY", VoltType.BIGINT));
         columns.add(new ColumnInfo("TUPLE_LIMIT", VoltType.INTEGER));
         columns.add(new ColumnInfo("PERCENT_FULL", VoltType.INTEGER));
+        columns.add(new ColumnInfo("TUPLES_EXPIRED", VoltType.BIGINT));
+        columns.add(new ColumnInfo("EXPIRATION_TIME", VoltType.BIGINT));
+        columns.add(new ColumnInfo("COMPACTION_PENDING_MEMORY", VoltType.BIGINT));
+        columns.add(new ColumnInfo("COMPACTION_STEPS", VoltType.BIGINT));
+        columns.add(new ColumnInfo("COMPACTION_TIME", VoltType.BIGINT));
+        columns.add(new ColumnInfo("COMPACTION_MAX_PAUSE", VoltType.BIGINT));
+        columns.add(new ColumnInfo("EVICTED_BLOCKS", VoltType.BIGINT));
+        columns.add(new ColumnInfo("EVICTED_MEMORY", VoltType.BIGINT));
+        columns.add(new ColumnInfo("BLOCKS_FETCHED", VoltType.BIGINT));
+        columns.add(new ColumnInfo("TUPLE_SLACK_MEMORY", VoltType.BIGINT));
     }
 }
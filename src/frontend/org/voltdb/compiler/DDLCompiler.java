@@ -206,6 +206,17 @@ public class DDLCompiler {
             }
             if (!processed) {
                 try {
+                    // HSQL doesn't know the USING clause of CREATE INDEX, so strip it
+                    // here and put the index type on the index once HSQL has made it.
+                    String indexName = null;
+                    String indexType = null;
+                    Matcher indexUsingMatcher = SQLParser.matchCreateIndexUsing(stmt.statement);
+                    if (indexUsingMatcher.matches()) {
+                        stmt.statement = indexUsingMatcher.group(1) + ";";
+                        indexName = indexUsingMatcher.group(2).toUpperCase();
+                        indexType = indexUsingMatcher.group(3).toUpperCase();
+                    }
+
                     //* enable to debug */ System.out.println("DEBUG: " + stmt.statement);
                     // kind of ugly.  We hex-encode each statement so we can
                     // avoid embedded newlines so we can delimit statements
@@ -223,6 +234,12 @@ public class DDLCompiler {
                         applyDiff(thisStmtDiff);
                     }
 
+                    if (indexType != null) {
+                        for (VoltXMLElement indexXML : m_schema.extractSubElements("index", "name", indexName)) {
+                            indexXML.attributes.put("indextype", indexType);
+                        }
+                    }
+
                     // special treatment for stream syntax
                     if (ddlStmtInfo.creatStream) {
                        processCreateStreamStatement(stmt, db, whichProcs);
@@ -2173,15 +2190,38 @@ public class DDLCompiler {
         index.setCountable(false);
 
         String indexNameNoCase = name.toLowerCase();
-        // The index is a hash iff:
+        String indexType = node.attributes.get("indextype");
+        // An index declared with USING BTREE or USING BITMAP gets that type.
+        // Otherwise the index is a hash iff:
         //   1. it does not have "tree" in the name, and
         //   2. it does have "hash" in the name, and
         //   3. it does not have an autogenerated name.
         // We don't think about the column type here, but see
         // below.
         if (has_geo_col) {
+            if (indexType != null) {
+                String emsg = "Cannot create index \"" + name + "\" USING " + indexType +
+                              " because GEOGRAPHY values can only be indexed by the default index type.";
+                throw compiler.new VoltCompilerException(emsg);
+            }
             index.setType(IndexType.COVERING_CELL_INDEX.getValue());
         }
+        else if ("BITMAP".equals(indexType)) {
+            if (unique || assumeUnique) {
+                String emsg = "Cannot create index \"" + name + "\" USING BITMAP because bitmap indexes cannot be unique.";
+                throw compiler.new VoltCompilerException(emsg);
+            }
+            // Bitmaps of the matching rows for each key value, for columns
+            // with few distinct values. The EE falls back to a balanced tree
+            // when the key can't be stored in it.
+            index.setType(IndexType.BITMAP.getValue());
+        }
+        else if ("BTREE".equals(indexType)) {
+            // A B+-tree, which the EE falls back to a balanced tree for
+            // when the key can't be stored in it.
+            index.setType(IndexType.BTREE.getValue());
+            index.setCountable(true);
+        }
         else if (( ! indexNameNoCase.contains("tree") ) && indexNameNoCase.contains("hash") &&
                  ! indexNameNoCase.startsWith(HSQLInterface.AUTO_GEN_PRIMARY_KEY_PREFIX.toLowerCase())) {
             // If the column type is not an integer, we cannot
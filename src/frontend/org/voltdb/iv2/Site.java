@@ -116,6 +116,10 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
     private static final double m_taskLogReplayRatio =
             Double.valueOf(System.getProperty("TASKLOG_REPLAY_RATIO", "0.6"));
 
+    // Collect per plan node statistics in the EE (see ExecutorStats)
+    private static final boolean EXECUTOR_PROFILING =
+            Boolean.valueOf(System.getProperty("EXECUTOR_PROFILING", "false"));
+
     // Set to false trigger shutdown.
     volatile boolean m_shouldContinue = true;
 
@@ -160,6 +164,7 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
     // Stats
     final TableStats m_tableStats;
     final IndexStats m_indexStats;
+    final ExecutorStats m_executorStats;
     final MemoryStats m_memStats;
 
     // Each execution site manages snapshot using a SnapshotSiteProcessor
@@ -616,11 +621,21 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
             agent.registerStatsSource(StatsSelector.INDEX,
                                       m_siteId,
                                       m_indexStats);
+            if (EXECUTOR_PROFILING) {
+                m_executorStats = new ExecutorStats(m_siteId);
+                agent.registerStatsSource(StatsSelector.EXECUTOR,
+                                          m_siteId,
+                                          m_executorStats);
+            }
+            else {
+                m_executorStats = null;
+            }
             m_memStats = memStats;
         } else {
             // MPI doesn't need to track these stats
             m_tableStats = null;
             m_indexStats = null;
+            m_executorStats = null;
             m_memStats = null;
         }
     }
@@ -666,6 +681,9 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
             m_non_voltdb_backend = null;
             m_ee = initializeEE();
         }
+        if (m_executorStats != null) {
+            m_ee.setExecutorProfiling(true);
+        }
 
         m_snapshotter = new SnapshotSiteProcessor(m_scheduler,
         m_snapshotPriority,
@@ -1281,6 +1299,18 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
                 m_indexStats.resetStatsTable();
             }
 
+            // update executor stats, whose rows are keyed by fragment and plan node
+            if (m_executorStats != null) {
+                final VoltTable[] s3 =
+                    m_ee.getStats(StatsSelector.EXECUTOR, tableIds, false, time);
+                if ((s3 != null) && (s3.length > 0)) {
+                    m_executorStats.setStatsTable(s3[0]);
+                }
+                else {
+                    m_executorStats.resetStatsTable();
+                }
+            }
+
             // update the rolled up memory statistics
             if (m_memStats != null) {
                 m_memStats.eeUpdateMemStats(m_siteId,
@@ -1289,7 +1319,10 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
                                             tupleAllocatedMem,
                                             indexMem,
                                             stringMem,
-                                            m_ee.getThreadLocalPoolAllocations());
+                                            m_ee.getThreadLocalPoolAllocations(),
+                                            m_ee.getHugePageAllocations(),
+                                            m_ee.getHugePageFallbackAllocations(),
+                                            m_ee.getReclaimedMemory());
             }
         }
     }
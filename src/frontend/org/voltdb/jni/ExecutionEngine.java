@@ -650,6 +650,15 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
 
     public abstract long getThreadLocalPoolAllocations();
 
+    /** Bytes of EE storage mapped from the explicit huge page pool */
+    public abstract long getHugePageAllocations();
+
+    /** Bytes of EE storage that wanted huge pages but got normal, THP-advised pages */
+    public abstract long getHugePageFallbackAllocations();
+
+    /** Bytes the EE's allocators have freed to stay under its high-water mark */
+    public abstract long getReclaimedMemory();
+
     public abstract byte[] loadTable(
         int tableId, VoltTable table, long txnId, long spHandle,
         long lastCommittedSpHandle, long uniqueId, boolean returnUniqueViolations, boolean shouldDRStream,
@@ -695,6 +704,12 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
      */
     public abstract void toggleProfiler(int toggle);
 
+    /**
+     * Instruct the EE to start/stop collecting the per-executor statistics
+     * reported under StatsSelector.EXECUTOR.
+     */
+    public abstract void setExecutorProfiling(boolean enable);
+
     /**
      * Release all undo actions up to and including the specified undo token
      * @param undoToken The undo token.
@@ -942,6 +957,13 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
      */
     protected native int nativeToggleProfiler(long pointer, int mode);
 
+    /**
+     * Turn per-executor profiling within the execution engine on or off
+     * @param enable true to collect executor statistics
+     * @return 0 on success.
+     */
+    protected native int nativeSetExecutorProfiling(long pointer, boolean enable);
+
     /**
      * Use the EE's hashinator to compute the partition to which the
      * value provided in the input parameter buffer maps.  This is
@@ -962,6 +984,26 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
      */
     protected static native long nativeGetThreadLocalPoolAllocations();
 
+    /**
+     * Retrieve the process wide count of bytes mapped from the huge page pool
+     * @return
+     */
+    protected static native long nativeGetHugePageAllocations();
+
+    /**
+     * Retrieve the process wide count of bytes that fell back to normal pages
+     * advised to become transparent huge pages
+     * @return
+     */
+    protected static native long nativeGetHugePageFallbackAllocations();
+
+    /**
+     * Retrieve the process wide count of resident bytes returned to the OS
+     * after the EE passed its RSS high-water mark
+     * @return
+     */
+    protected static native long nativeGetReclaimedMemory();
+
     /**
      * @param nextUndoToken The undo token to associate with future work
      * @return true for success false for failure
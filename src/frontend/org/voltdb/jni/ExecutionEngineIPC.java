@@ -955,6 +955,13 @@ public class ExecutionEngineIPC extends ExecutionEngine {
     public void toggleProfiler(final int toggle) {
     }
 
+    /**
+     * Unsupported implementation of setExecutorProfiling
+     */
+    @Override
+    public void setExecutorProfiling(final boolean enable) {
+    }
+
 
     @Override
     public byte[] loadTable(final int tableId, final VoltTable table, final long txnId,
@@ -1533,6 +1540,22 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         }
     }
 
+    // The IPC backend is a test harness; its huge page usage isn't reported.
+    @Override
+    public long getHugePageAllocations() {
+        return 0L;
+    }
+
+    @Override
+    public long getHugePageFallbackAllocations() {
+        return 0L;
+    }
+
+    @Override
+    public long getReclaimedMemory() {
+        return 0L;
+    }
+
     @Override
     public byte[] executeTask(TaskType taskType, ByteBuffer task) {
         m_data.clear();
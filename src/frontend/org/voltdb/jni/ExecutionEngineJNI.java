@@ -473,6 +473,11 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         nativeToggleProfiler(pointer, toggle);
     }
 
+    @Override
+    public void setExecutorProfiling(final boolean enable) {
+        nativeSetExecutorProfiling(pointer, enable);
+    }
+
     @Override
     public boolean releaseUndoToken(final long undoToken) {
         return nativeReleaseUndoToken(pointer, undoToken);
@@ -621,6 +626,21 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         return nativeGetThreadLocalPoolAllocations();
     }
 
+    @Override
+    public long getHugePageAllocations() {
+        return nativeGetHugePageAllocations();
+    }
+
+    @Override
+    public long getHugePageFallbackAllocations() {
+        return nativeGetHugePageFallbackAllocations();
+    }
+
+    @Override
+    public long getReclaimedMemory() {
+        return nativeGetReclaimedMemory();
+    }
+
     /*
      * Instead of using the reusable output buffer to get results for the next batch,
      * use this buffer allocated by the EE. This is for one time use.
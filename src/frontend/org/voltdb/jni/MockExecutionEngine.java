@@ -163,6 +163,10 @@ public class MockExecutionEngine extends ExecutionEngine {
     public void toggleProfiler(final int toggle) {
     }
 
+    @Override
+    public void setExecutorProfiling(final boolean enable) {
+    }
+
     @Override
     public boolean undoUndoToken(final long undoToken) {
         return false;
@@ -228,6 +232,21 @@ public class MockExecutionEngine extends ExecutionEngine {
         return 0L;
     }
 
+    @Override
+    public long getHugePageAllocations() {
+        return 0L;
+    }
+
+    @Override
+    public long getHugePageFallbackAllocations() {
+        return 0L;
+    }
+
+    @Override
+    public long getReclaimedMemory() {
+        return 0L;
+    }
+
     @Override
     public byte[] executeTask(TaskType taskType, ByteBuffer task) {
         throw new UnsupportedOperationException();
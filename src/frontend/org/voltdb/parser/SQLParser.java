@@ -379,6 +379,16 @@ public class SQLParser extends SQLPatternFactory
             "\\s*;\\z"                              // (end statement)
             );
 
+    private static final Pattern PAT_CREATE_INDEX_USING = Pattern.compile(
+            "(?i)" +                                // (ignore case)
+            "\\A"  +                                // start statement
+            "(CREATE\\s+(?:UNIQUE\\s+|ASSUMEUNIQUE\\s+)?" + // (1) statement without USING clause
+            "INDEX\\s+([\\w$]+)" +                 //     (2) <index name>
+            "\\s+ON\\s+.+?)" +                     //     ON <table> (...) [WHERE ...]
+            "\\s+USING\\s+(BTREE|BITMAP)" +        // (3) USING <index type>
+            "\\s*;\\z",                            // (end statement)
+            Pattern.DOTALL);
+
     //========== Patterns from SQLCommand ==========
 
     private static final String EndOfLineCommentPatternString =
@@ -663,6 +673,16 @@ public class SQLParser extends SQLPatternFactory
         return PAT_CREATE_STREAM.matcher(statement);
     }
 
+    /**
+     * Match statement against the CREATE INDEX ... USING <index type> pattern
+     * @param statement  statement to match against
+     * @return           pattern matcher object
+     */
+    public static Matcher matchCreateIndexUsing(String statement)
+    {
+        return PAT_CREATE_INDEX_USING.matcher(statement);
+    }
+
     /**
      * Match statement against DR table pattern
      * @param statement  statement to match against
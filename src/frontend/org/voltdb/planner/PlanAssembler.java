@@ -2553,6 +2553,17 @@ public class PlanAssembler {
         indexScanNode.setForGroupingOnly();
         indexScanNode.setBindings(maxCoveredBindings);
 
+        // Grouping by the leading columns of the index with no aggregate
+        // functions needs just one row per group, so the EE can seek from
+        // group to group. Not under a join, whose other side could still
+        // need the rest of a group's rows.
+        if (foundAllGroupByCoveredIndex &&
+                ! m_parsedSelect.hasAggregateExpression() &&
+                pickedUpIndex.getExpressionsjson().isEmpty() &&
+                (root.getParentCount() == 0 || root.getParent(0) instanceof SendPlanNode)) {
+            indexScanNode.setSkipScanDistinct(groupBys.size());
+        }
+
         gbInfo.m_coveredGroupByColumns = maxCoveredGroupByColumns;
         gbInfo.m_canBeFullySerialized = foundAllGroupByCoveredIndex;
         return indexScanNode;
@@ -112,7 +112,7 @@ public class ScanDeterminizer {
                 continue;
             }
             // skip hash indexes
-            else if (index.getType() != IndexType.BALANCED_TREE.getValue()) {
+            else if ( ! IndexType.isScannable(index.getType())) {
                 continue;
             }
             // skip partial indexes
@@ -62,7 +62,9 @@ public class IndexScanPlanNode extends AbstractScanPlanNode {
         KEY_ITERATE,
         LOOKUP_TYPE,
         PURPOSE,
-        SORT_DIRECTION;
+        SORT_DIRECTION,
+        SKIP_SCAN_PREFIX_LENGTH,
+        SKIP_SCAN_DISTINCT;
     }
 
     /**
@@ -110,6 +112,12 @@ public class IndexScanPlanNode extends AbstractScanPlanNode {
 
     private int m_purpose = FOR_SCANNING_PERFORMANCE_OR_ORDERING;
 
+    // The number of leading index key columns that the EE skips through,
+    // one distinct prefix at a time, and whether it takes just the first
+    // entry of each prefix that passes the post-filter
+    private int m_skipScanPrefixLength = 0;
+    private boolean m_skipScanDistinct = false;
+
     // Post-filters that got eliminated by exactly matched partial index filters
     private final List<AbstractExpression> m_eliminatedPostFilterExpressions = new ArrayList<AbstractExpression>();
 
@@ -601,7 +609,8 @@ public class IndexScanPlanNode extends AbstractScanPlanNode {
         int tuplesToRead = 0;
 
         // Assign minor priorities for different index types (tiebreakers).
-        if (m_catalogIndex.getType() == IndexType.HASH_TABLE.getValue()) {
+        if ((m_catalogIndex.getType() == IndexType.HASH_TABLE.getValue()) ||
+            (m_catalogIndex.getType() == IndexType.BITMAP.getValue())) {
             tuplesToRead = 2;
         }
         else if ((m_catalogIndex.getType() == IndexType.BALANCED_TREE.getValue()) ||
@@ -713,6 +722,12 @@ public class IndexScanPlanNode extends AbstractScanPlanNode {
         if (m_purpose != FOR_SCANNING_PERFORMANCE_OR_ORDERING) {
             stringer.keySymbolValuePair(Members.PURPOSE.name(), m_purpose);
         }
+        if (m_skipScanPrefixLength > 0) {
+            stringer.keySymbolValuePair(Members.SKIP_SCAN_PREFIX_LENGTH.name(), m_skipScanPrefixLength);
+            if (m_skipScanDistinct) {
+                stringer.keySymbolValuePair(Members.SKIP_SCAN_DISTINCT.name(), true);
+            }
+        }
         stringer.keySymbolValuePair(Members.TARGET_INDEX_NAME.name(), m_targetIndexName);
         if (m_searchkeyExpressions.size() > 0) {
             stringer.key(Members.SEARCHKEY_EXPRESSIONS.name()).array(m_searchkeyExpressions);
@@ -738,6 +753,10 @@ public class IndexScanPlanNode extends AbstractScanPlanNode {
         m_sortDirection = SortDirectionType.get( jobj.getString( Members.SORT_DIRECTION.name() ) );
         m_purpose = jobj.has(Members.PURPOSE.name()) ?
                 jobj.getInt(Members.PURPOSE.name()) : FOR_SCANNING_PERFORMANCE_OR_ORDERING;
+        m_skipScanPrefixLength = jobj.has(Members.SKIP_SCAN_PREFIX_LENGTH.name()) ?
+                jobj.getInt(Members.SKIP_SCAN_PREFIX_LENGTH.name()) : 0;
+        m_skipScanDistinct = jobj.has(Members.SKIP_SCAN_DISTINCT.name()) &&
+                jobj.getBoolean(Members.SKIP_SCAN_DISTINCT.name());
         m_targetIndexName = jobj.getString(Members.TARGET_INDEX_NAME.name());
         m_catalogIndex = db.getTables().get(super.m_targetTableName).getIndexes().get(m_targetIndexName);
         //load end_expression
@@ -770,6 +789,9 @@ public class IndexScanPlanNode extends AbstractScanPlanNode {
             if (m_purpose == FOR_DETERMINISM) {
                 usageInfo = " (for deterministic order only)";
             }
+            else if (m_purpose == FOR_GROUPING && m_skipScanDistinct) {
+                usageInfo = " (for optimized grouping only, skipping to each distinct group)";
+            }
             else if (m_purpose == FOR_GROUPING) {
                 usageInfo = " (for optimized grouping only)";
             }
@@ -939,6 +961,22 @@ public class IndexScanPlanNode extends AbstractScanPlanNode {
         return m_purpose == FOR_GROUPING;
     }
 
+    /**
+     * Have the EE return just the first entry of each distinct prefix of
+     * the leading index key columns, seeking from one prefix to the next
+     * instead of scanning every entry.  Only for a scan with no search keys
+     * whose parent needs no more than one row of each group.
+     */
+    public void setSkipScanDistinct(int prefixLength) {
+        assert(m_searchkeyExpressions.isEmpty());
+        m_skipScanPrefixLength = prefixLength;
+        m_skipScanDistinct = true;
+    }
+
+    public boolean isSkipScanDistinct() {
+        return m_skipScanDistinct;
+    }
+
     public void setEliminatedPostFilters(List<AbstractExpression> exprs) {
         for (AbstractExpression expr : exprs) {
             m_eliminatedPostFilterExpressions.add(expr.clone());
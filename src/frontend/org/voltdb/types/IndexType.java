@@ -30,6 +30,7 @@ public enum IndexType {
     HASH_TABLE          (2),
     BTREE               (3),
     COVERING_CELL_INDEX (4),
+    BITMAP              (5),
     ;
 
     IndexType(int val) {
@@ -90,6 +91,7 @@ public enum IndexType {
         case BTREE:
         case HASH_TABLE:
         case COVERING_CELL_INDEX:
+        case BITMAP:
             return "";
         case INVALID:
         }
@@ -113,6 +115,7 @@ public enum IndexType {
         case BTREE:
             return true;
         case HASH_TABLE:
+        case BITMAP:
         case INVALID:
             return false;
         }
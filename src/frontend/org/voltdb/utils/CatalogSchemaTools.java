@@ -54,6 +54,7 @@ import org.voltdb.compilereport.TableAnnotation;
 import org.voltdb.expressions.AbstractExpression;
 import org.voltdb.planner.parseinfo.StmtTargetTableScan;
 import org.voltdb.types.ConstraintType;
+import org.voltdb.types.IndexType;
 
 /**
  *
@@ -386,6 +387,12 @@ public abstract class CatalogSchemaTools {
                     e.printStackTrace();
                 }
             }
+            if (catalog_idx.getType() == IndexType.BTREE.getValue()) {
+                sb.append(" USING BTREE");
+            }
+            else if (catalog_idx.getType() == IndexType.BITMAP.getValue()) {
+                sb.append(" USING BITMAP");
+            }
             sb.append(";\n");
         }
 
@@ -345,6 +345,16 @@ public abstract class CatalogSizing {
             isize.widthMin += TUPLE_MAP_ENTRY + MIN_CELLS * CELL_MAP_ENTRY;
             isize.widthMax += TUPLE_MAP_ENTRY + MAX_CELLS * CELL_MAP_ENTRY;
         }
+        else if (index.getType() == IndexType.BITMAP.getValue()) {
+            // Bitmap indexes keep the key once per distinct value, which is
+            // ignored here, and a bit or a 2 byte array entry per row.
+            // The rows are numbered in a map shared by the table's bitmap
+            // indexes, at about 40 bytes per row.
+            final long BITMAP_ENTRY_SIZE = 2;
+            final long SLOT_MAP_ENTRY_SIZE = 40;
+            isize.widthMin = BITMAP_ENTRY_SIZE;
+            isize.widthMax = BITMAP_ENTRY_SIZE + SLOT_MAP_ENTRY_SIZE;
+        }
         else {
             // Tree indexes have a 40 byte overhead per row.
             isize.widthMin += TREE_MAP_ENTRY_OVERHEAD + TUPLE_PTR_SIZE;
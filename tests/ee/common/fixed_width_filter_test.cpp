@@ -0,0 +1,161 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include "harness.h"
+#include "common/FixedWidthFilter.h"
+#include "common/value_defs.h"
+
+using namespace voltdb;
+
+static const FixedWidthFilter::Op ALL_OPS[] = {
+    FixedWidthFilter::EQ,
+    FixedWidthFilter::NE,
+    FixedWidthFilter::LT,
+    FixedWidthFilter::GT,
+    FixedWidthFilter::LTE,
+    FixedWidthFilter::GTE
+};
+
+static const FixedWidthFilter::InstructionSet ALL_INSTRUCTION_SETS[] = {
+    FixedWidthFilter::SCALAR,
+    FixedWidthFilter::SSE42,
+    FixedWidthFilter::AVX2
+};
+
+static bool expectedResult(FixedWidthFilter::Op op, int64_t lhs, int64_t rhs) {
+    switch (op) {
+    case FixedWidthFilter::EQ:  return lhs == rhs;
+    case FixedWidthFilter::NE:  return lhs != rhs;
+    case FixedWidthFilter::LT:  return lhs < rhs;
+    case FixedWidthFilter::GT:  return lhs > rhs;
+    case FixedWidthFilter::LTE: return lhs <= rhs;
+    default:                    return lhs >= rhs;
+    }
+}
+
+class FixedWidthFilterTest : public Test {
+public:
+    // Run every supported kernel for op over values and check the positions it keeps.
+    void checkAllKernels(FixedWidthFilter::Op op, const std::vector<int64_t>& values,
+                         int64_t rhs, int64_t nullValue) {
+        // Positions that are not just indexes, to check that they are carried along
+        std::vector<int> positions;
+        std::vector<int> expected;
+        for (size_t ii = 0; ii < values.size(); ++ii) {
+            positions.push_back(static_cast<int>(ii * 3 + 1));
+            if (values[ii] != nullValue && expectedResult(op, values[ii], rhs)) {
+                expected.push_back(positions.back());
+            }
+        }
+
+        for (int ii = 0; ii < 3; ++ii) {
+            FixedWidthFilter::Kernel kernel = FixedWidthFilter::get(op, ALL_INSTRUCTION_SETS[ii]);
+            if ( ! FixedWidthFilter::isSupported(ALL_INSTRUCTION_SETS[ii])) {
+                ASSERT_TRUE(kernel == NULL);
+                continue;
+            }
+            ASSERT_TRUE(kernel != NULL);
+            std::vector<int> actual(positions);
+            size_t kept = kernel(values.empty() ? NULL : &values[0],
+                                 actual.empty() ? NULL : &actual[0],
+                                 values.size(), rhs, nullValue);
+            ASSERT_EQ(expected.size(), kept);
+            for (size_t jj = 0; jj < kept; ++jj) {
+                ASSERT_EQ(expected[jj], actual[jj]);
+            }
+        }
+    }
+};
+
+TEST_F(FixedWidthFilterTest, ScalarAlwaysSupported) {
+    ASSERT_TRUE(FixedWidthFilter::isSupported(FixedWidthFilter::SCALAR));
+    for (int op = 0; op < 6; ++op) {
+        ASSERT_TRUE(FixedWidthFilter::get(ALL_OPS[op]) != NULL);
+    }
+}
+
+TEST_F(FixedWidthFilterTest, SmallCounts) {
+    // Lengths around the vector widths, so that the scalar tails are used
+    for (size_t count = 0; count < 10; ++count) {
+        std::vector<int64_t> values;
+        for (size_t ii = 0; ii < count; ++ii) {
+            values.push_back(static_cast<int64_t>(ii % 4) - 1);
+        }
+        for (int op = 0; op < 6; ++op) {
+            checkAllKernels(ALL_OPS[op], values, 1, INT64_NULL);
+        }
+    }
+}
+
+TEST_F(FixedWidthFilterTest, RandomValuesWithNulls) {
+    srand(42);
+    std::vector<int64_t> values;
+    for (int ii = 0; ii < 1001; ++ii) {
+        if (rand() % 10 == 0) {
+            values.push_back(INT64_NULL);
+        }
+        else {
+            values.push_back(rand() % 200 - 100);
+        }
+    }
+    for (int op = 0; op < 6; ++op) {
+        checkAllKernels(ALL_OPS[op], values, 0, INT64_NULL);
+        checkAllKernels(ALL_OPS[op], values, 57, INT64_NULL);
+        checkAllKernels(ALL_OPS[op], values, -100, INT64_NULL);
+    }
+}
+
+TEST_F(FixedWidthFilterTest, WidenedNulls) {
+    // A widened INTEGER column has INT32_NULL for NULL, which must not match
+    // anything even though it is an ordinary 64-bit value.
+    std::vector<int64_t> values;
+    for (int ii = 0; ii < 100; ++ii) {
+        values.push_back(ii % 7 == 0 ? INT32_NULL : ii - 50);
+    }
+    for (int op = 0; op < 6; ++op) {
+        checkAllKernels(ALL_OPS[op], values, 10, INT32_NULL);
+        checkAllKernels(ALL_OPS[op], values, INT32_NULL + 1, INT32_NULL);
+    }
+}
+
+TEST_F(FixedWidthFilterTest, Extremes) {
+    std::vector<int64_t> values;
+    values.push_back(INT64_MAX);
+    values.push_back(INT64_NULL + 1);
+    values.push_back(0);
+    values.push_back(-1);
+    values.push_back(INT64_NULL);
+    values.push_back(INT64_MAX - 1);
+    for (int op = 0; op < 6; ++op) {
+        checkAllKernels(ALL_OPS[op], values, INT64_MAX, INT64_NULL);
+        checkAllKernels(ALL_OPS[op], values, INT64_NULL + 1, INT64_NULL);
+        checkAllKernels(ALL_OPS[op], values, -1, INT64_NULL);
+    }
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
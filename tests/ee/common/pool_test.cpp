@@ -51,7 +51,9 @@
 
 #include "harness.h"
 
+#include "common/MemoryReclaimer.h"
 #include "common/Pool.hpp"
+#include "common/ThreadLocalPool.h"
 
 using namespace std;
 using namespace voltdb;
@@ -110,6 +112,47 @@ TEST_F(PoolTest, OversizeTest) {
     EXPECT_NE(space, NULL);
 }
 
+#ifndef MEMCHECK
+TEST_F(PoolTest, ReleaseSurplusChunksTest) {
+    Pool testPool(262144, 4);
+    for (int ii = 0; ii < 4; ii++) {
+        EXPECT_NE(testPool.allocate(200000), NULL);
+    }
+    EXPECT_EQ(4 * 262144, testPool.getAllocatedMemory());
+    // Nothing is past the chunk in use
+    EXPECT_EQ(0, testPool.releaseSurplusChunks());
+
+    // The purged pool keeps its chunks for reuse until they are released
+    testPool.purge();
+    EXPECT_EQ(4 * 262144, testPool.getAllocatedMemory());
+    EXPECT_EQ(3 * 262144, testPool.releaseSurplusChunks());
+    EXPECT_EQ(262144, testPool.getAllocatedMemory());
+    EXPECT_NE(testPool.allocate(200000), NULL);
+    EXPECT_NE(testPool.allocate(200000), NULL);
+    EXPECT_EQ(2 * 262144, testPool.getAllocatedMemory());
+}
+
+TEST_F(PoolTest, ReclaimTest) {
+    ThreadLocalPool threadLocalPool;
+    Pool testPool(262144, 4);
+    for (int ii = 0; ii < 4; ii++) {
+        EXPECT_NE(testPool.allocate(200000), NULL);
+    }
+    testPool.purge();
+
+    // Only the bytes the pool actually frees are counted
+    const int64_t interval = MemoryReclaimer::RECLAIM_INTERVAL_MILLIS;
+    const int64_t returned = MemoryReclaimer::bytesReturned();
+    EXPECT_TRUE(MemoryReclaimer::reclaim(testPool, interval));
+    EXPECT_EQ(3 * 262144, MemoryReclaimer::bytesReturned() - returned);
+
+    // The heap isn't trimmed again until the interval has passed
+    EXPECT_FALSE(MemoryReclaimer::reclaim(testPool, 2 * interval - 1));
+    EXPECT_EQ(3 * 262144, MemoryReclaimer::bytesReturned() - returned);
+    EXPECT_TRUE(MemoryReclaimer::reclaim(testPool, 2 * interval));
+}
+#endif
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,452 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "catalog/cluster.h"
+#include "catalog/constraint.h"
+#include "catalog/table.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+#include "test_utils/plan_testing_config.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+extern DBConfig hashAggDB;
+
+const int NUM_TABLE_ROWS_AAA = 30000;
+const int NUM_TABLE_COLS_AAA = 3;
+const int NUM_GROUPS = 6000;
+const int NUM_OUTPUT_COLS = 4;
+
+// Table BBB holds NUM_TABLE_ROWS_BBB rows of strings too long to inline
+const int NUM_TABLE_ROWS_BBB = 24000;
+const int VARCHAR_LENGTH = 100;
+
+// Small enough that only some of the groups fit in memory, and that
+// some of the spilled partitions have to be spilled again
+const int64_t SPILLING_MEMORY_LIMIT = 768 * 1024;
+
+int AAAData[NUM_TABLE_ROWS_AAA * NUM_TABLE_COLS_AAA];
+
+/*
+ * Row i of AAA is ((i * 7919) % NUM_GROUPS, i, i % 4), so every group
+ * has NUM_TABLE_ROWS_AAA / NUM_GROUPS rows spread throughout the table.
+ */
+void fillAAAData() {
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; ++i) {
+        AAAData[i * NUM_TABLE_COLS_AAA] = (i * 7919) % NUM_GROUPS;
+        AAAData[i * NUM_TABLE_COLS_AAA + 1] = i;
+        AAAData[i * NUM_TABLE_COLS_AAA + 2] = i % 4;
+    }
+}
+
+std::string columnJSON(int idx, int valueType = 5, int valueSize = 0) {
+    std::ostringstream out;
+    out << "{\"COLUMN_IDX\": " << idx << ", \"TYPE\": 32, \"VALUE_TYPE\": " << valueType;
+    if (valueSize > 0) {
+        out << ", \"VALUE_SIZE\": " << valueSize;
+    }
+    out << "}";
+    return out.str();
+}
+
+std::string outputColumnJSON(const char *name, int idx, int valueType, int valueSize = 0) {
+    std::ostringstream out;
+    out << "{\"COLUMN_NAME\": \"" << name << "\", \"EXPRESSION\": "
+        << columnJSON(idx, valueType, valueSize) << "}";
+    return out.str();
+}
+
+/*
+ * Row i of BBB is (groupName((i * 7919) % NUM_GROUPS), valueName(i)),
+ * which sort the same way as their numbers.
+ */
+std::string groupName(int group) {
+    char name[VARCHAR_LENGTH];
+    snprintf(name, sizeof(name), "group %06d of the table of strings that are too long to inline", group);
+    return name;
+}
+
+std::string valueName(int row) {
+    char name[VARCHAR_LENGTH];
+    snprintf(name, sizeof(name), "value %06d of the table of strings that are too long to inline", row);
+    return name;
+}
+
+/*
+ * The plan is
+ *     SEND <- ORDERBY(A) <- HASHAGGREGATE <- SEQSCAN(BBB)
+ * for
+ *     SELECT A, MIN(B), MAX(B) FROM BBB GROUP BY A ORDER BY A;
+ */
+std::string stringAggregatePlan() {
+    std::ostringstream out;
+    out << "{\"EXECUTE_LIST\": [4, 3, 2, 1], \"PLAN_NODES\": ["
+        << "{\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"}, "
+        << "{\"CHILDREN_IDS\": [3], \"ID\": 2, \"PLAN_NODE_TYPE\": \"ORDERBY\", \"SORT_COLUMNS\": ["
+        << "{\"SORT_DIRECTION\": \"ASC\", \"SORT_EXPRESSION\": " << columnJSON(0, 9, VARCHAR_LENGTH) << "}]}, "
+        << "{\"CHILDREN_IDS\": [4], \"ID\": 3, \"PLAN_NODE_TYPE\": \"HASHAGGREGATE\", "
+        << "\"GROUPBY_EXPRESSIONS\": [" << columnJSON(0, 9, VARCHAR_LENGTH) << "], "
+        << "\"AGGREGATE_COLUMNS\": ["
+        << "{\"AGGREGATE_TYPE\": \"AGGREGATE_MIN\", \"AGGREGATE_DISTINCT\": 0, "
+        << "\"AGGREGATE_OUTPUT_COLUMN\": 1, \"AGGREGATE_EXPRESSION\": " << columnJSON(1, 9, VARCHAR_LENGTH) << "}, "
+        << "{\"AGGREGATE_TYPE\": \"AGGREGATE_MAX\", \"AGGREGATE_DISTINCT\": 0, "
+        << "\"AGGREGATE_OUTPUT_COLUMN\": 2, \"AGGREGATE_EXPRESSION\": " << columnJSON(1, 9, VARCHAR_LENGTH) << "}"
+        << "], \"OUTPUT_SCHEMA\": ["
+        << outputColumnJSON("A", 0, 9, VARCHAR_LENGTH) << ", "
+        << outputColumnJSON("MINB", 1, 9, VARCHAR_LENGTH) << ", "
+        << outputColumnJSON("MAXB", 2, 9, VARCHAR_LENGTH)
+        << "]}, "
+        << "{\"ID\": 4, \"PLAN_NODE_TYPE\": \"SEQSCAN\", \"OUTPUT_SCHEMA\": ["
+        << outputColumnJSON("A", 0, 9, VARCHAR_LENGTH) << ", "
+        << outputColumnJSON("B", 1, 9, VARCHAR_LENGTH)
+        << "], \"TARGET_TABLE_ALIAS\": \"BBB\", \"TARGET_TABLE_NAME\": \"BBB\"}]}";
+    return out.str();
+}
+
+/*
+ * The plan is
+ *     SEND <- ORDERBY(A) <- HASHAGGREGATE <- SEQSCAN(AAA)
+ * for either
+ *     SELECT A, COUNT(*), SUM(B), COUNT(DISTINCT C) FROM AAA GROUP BY A ORDER BY A;
+ * or, without aggregates,
+ *     SELECT DISTINCT A FROM AAA ORDER BY A;
+ */
+std::string hashAggregatePlan(bool withAggregates) {
+    std::ostringstream out;
+    out << "{\"EXECUTE_LIST\": [4, 3, 2, 1], \"PLAN_NODES\": ["
+        << "{\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"}, "
+        << "{\"CHILDREN_IDS\": [3], \"ID\": 2, \"PLAN_NODE_TYPE\": \"ORDERBY\", \"SORT_COLUMNS\": ["
+        << "{\"SORT_DIRECTION\": \"ASC\", \"SORT_EXPRESSION\": " << columnJSON(0) << "}]}, "
+        << "{\"CHILDREN_IDS\": [4], \"ID\": 3, \"PLAN_NODE_TYPE\": \"HASHAGGREGATE\", "
+        << "\"GROUPBY_EXPRESSIONS\": [" << columnJSON(0) << "], "
+        << "\"AGGREGATE_COLUMNS\": [";
+    if (withAggregates) {
+        out << "{\"AGGREGATE_TYPE\": \"AGGREGATE_COUNT_STAR\", \"AGGREGATE_DISTINCT\": 0, "
+            << "\"AGGREGATE_OUTPUT_COLUMN\": 1}, "
+            << "{\"AGGREGATE_TYPE\": \"AGGREGATE_SUM\", \"AGGREGATE_DISTINCT\": 0, "
+            << "\"AGGREGATE_OUTPUT_COLUMN\": 2, \"AGGREGATE_EXPRESSION\": " << columnJSON(1) << "}, "
+            << "{\"AGGREGATE_TYPE\": \"AGGREGATE_COUNT\", \"AGGREGATE_DISTINCT\": 1, "
+            << "\"AGGREGATE_OUTPUT_COLUMN\": 3, \"AGGREGATE_EXPRESSION\": " << columnJSON(2) << "}";
+    }
+    out << "], \"OUTPUT_SCHEMA\": [" << outputColumnJSON("A", 0, 5);
+    if (withAggregates) {
+        out << ", " << outputColumnJSON("CNT", 1, 6)
+            << ", " << outputColumnJSON("S", 2, 6)
+            << ", " << outputColumnJSON("DC", 3, 6);
+    }
+    out << "]}, "
+        << "{\"ID\": 4, \"PLAN_NODE_TYPE\": \"SEQSCAN\", \"OUTPUT_SCHEMA\": ["
+        << outputColumnJSON("A", 0, 5) << ", "
+        << outputColumnJSON("B", 1, 5) << ", "
+        << outputColumnJSON("C", 2, 5)
+        << "], \"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\"}]}";
+    return out.str();
+}
+}
+
+class HashAggregateSpillTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    HashAggregateSpillTest() {
+        fillAAAData();
+    }
+
+    /** Compute the expected result of hashAggregatePlan from AAAData. */
+    std::vector<int> expectedAnswer(bool withAggregates) {
+        std::vector<int> count(NUM_GROUPS, 0);
+        std::vector<int> sum(NUM_GROUPS, 0);
+        std::vector<std::set<int> > distinct(NUM_GROUPS);
+        for (int i = 0; i < NUM_TABLE_ROWS_AAA; ++i) {
+            const int *row = &AAAData[i * NUM_TABLE_COLS_AAA];
+            count[row[0]]++;
+            sum[row[0]] += row[1];
+            distinct[row[0]].insert(row[2]);
+        }
+        std::vector<int> answer;
+        for (int group = 0; group < NUM_GROUPS; ++group) {
+            answer.push_back(group);
+            if (withAggregates) {
+                answer.push_back(count[group]);
+                answer.push_back(sum[group]);
+                answer.push_back(static_cast<int>(distinct[group].size()));
+            }
+        }
+        return answer;
+    }
+
+    void runAggregate(bool withAggregates) {
+        executeFragment(++m_fragmentNumber, hashAggregatePlan(withAggregates).c_str());
+        std::vector<int> answer = expectedAnswer(withAggregates);
+        validateResult(&answer[0], NUM_GROUPS, withAggregates ? NUM_OUTPUT_COLS : 1);
+    }
+
+    void fillBBB() {
+        voltdb::PersistentTable *table = getPersistentTableAndId("BBB", NULL);
+        ASSERT_TRUE(table != NULL);
+        for (int i = 0; i < NUM_TABLE_ROWS_BBB; ++i) {
+            voltdb::TableTuple &tuple = table->tempTuple();
+            tuple.setNValue(0, voltdb::ValueFactory::getTempStringValue(groupName((i * 7919) % NUM_GROUPS)));
+            tuple.setNValue(1, voltdb::ValueFactory::getTempStringValue(valueName(i)));
+            ASSERT_TRUE(table->insertTuple(tuple));
+        }
+    }
+
+    static std::string peekString(const voltdb::TableTuple &tuple, int column) {
+        int32_t length;
+        const char *value = voltdb::ValuePeeker::peekObject_withoutNull(tuple.getNValue(column), &length);
+        return std::string(value, length);
+    }
+
+    /** Run stringAggregatePlan and check every string of the result. */
+    void runStringAggregate() {
+        fillBBB();
+        executeFragment(++m_fragmentNumber, stringAggregatePlan().c_str());
+
+        std::vector<int> minRow(NUM_GROUPS, NUM_TABLE_ROWS_BBB);
+        std::vector<int> maxRow(NUM_GROUPS, -1);
+        for (int i = 0; i < NUM_TABLE_ROWS_BBB; ++i) {
+            int group = (i * 7919) % NUM_GROUPS;
+            minRow[group] = std::min(minRow[group], i);
+            maxRow[group] = std::max(maxRow[group], i);
+        }
+
+        voltdb::Pool resultPool;
+        boost::scoped_ptr<voltdb::TempTable> result(
+                voltdb::loadTableFrom(m_result_buffer.get(), m_engine->getResultsSize(), &resultPool));
+        ASSERT_TRUE(result != NULL);
+        ASSERT_EQ(NUM_GROUPS, result->activeTupleCount());
+        voltdb::TableTuple tuple(result->schema());
+        voltdb::TableIterator &iter = result->iterator();
+        for (int group = 0; group < NUM_GROUPS; ++group) {
+            ASSERT_TRUE(iter.next(tuple));
+            ASSERT_EQ(groupName(group), peekString(tuple, 0));
+            ASSERT_EQ(valueName(minRow[group]), peekString(tuple, 1));
+            ASSERT_EQ(valueName(maxRow[group]), peekString(tuple, 2));
+        }
+    }
+};
+
+TEST_F(HashAggregateSpillTest, GroupByInMemory) {
+    initialize(hashAggDB, (uint32_t)time(NULL));
+    runAggregate(true);
+}
+
+/*
+ * With a small temp table memory limit only some of the groups are
+ * started in memory and the input tuples of the others are spilled.
+ */
+TEST_F(HashAggregateSpillTest, GroupBySpilled) {
+    initialize(hashAggDB, (uint32_t)time(NULL), SPILLING_MEMORY_LIMIT);
+    runAggregate(true);
+}
+
+/*
+ * Without aggregates each group is output as soon as it is started,
+ * so the spilled groups must not repeat any of those.
+ */
+TEST_F(HashAggregateSpillTest, DistinctSpilled) {
+    initialize(hashAggDB, (uint32_t)time(NULL), SPILLING_MEMORY_LIMIT);
+    runAggregate(false);
+}
+
+/*
+ * The groups' keys and MIN/MAX results are strings held in pools that are
+ * purged as each spilled partition is aggregated, before the ORDER BY
+ * reads the output.
+ */
+TEST_F(HashAggregateSpillTest, StringsInMemory) {
+    initialize(hashAggDB, (uint32_t)time(NULL));
+    runStringAggregate();
+}
+
+TEST_F(HashAggregateSpillTest, StringsSpilled) {
+    initialize(hashAggDB, (uint32_t)time(NULL), SPILLING_MEMORY_LIMIT);
+    runStringAggregate();
+}
+
+namespace {
+const char *AAA_ColumnNames[] = {
+    "A",
+    "B",
+    "C",
+};
+
+const TableConfig AAAConfig = {
+    "AAA",
+    AAA_ColumnNames,
+    NUM_TABLE_ROWS_AAA,
+    NUM_TABLE_COLS_AAA,
+    AAAData
+};
+
+const TableConfig *allTables[] = {
+    &AAAConfig,
+};
+
+DBConfig hashAggDB =
+{
+    //
+    // DDL.
+    //
+    "create table AAA (\n"
+    "  A integer,\n"
+    "  B integer,\n"
+    "  C integer\n"
+    " );\n"
+    "create table BBB (\n"
+    "  A varchar(100),\n"
+    "  B varchar(100)\n"
+    " );\n"
+    " ",
+    //
+    // Catalog String
+    //
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV adminport 0\n"
+    "set $PREV adminstartup false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database groups administrator\n"
+    "set /clusters#cluster/databases#database/groups#administrator admin true\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database groups user\n"
+    "set /clusters#cluster/databases#database/groups#user admin false\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database tables AAA\n"
+    "set /clusters#cluster/databases#database/tables#AAA isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"AAA|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns A\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns B\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns C\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database tables BBB\n"
+    "set /clusters#cluster/databases#database/tables#BBB isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"BBB|vv\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns A\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#A index 0\n"
+    "set $PREV type 9\n"
+    "set $PREV size 100\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns B\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#B index 1\n"
+    "set $PREV type 9\n"
+    "set $PREV size 100\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "",
+    1,
+    allTables
+};
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,404 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "catalog/cluster.h"
+#include "catalog/constraint.h"
+#include "catalog/table.h"
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+#include "test_utils/plan_testing_config.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include <sstream>
+#include <string>
+
+namespace {
+extern DBConfig hashJoinDB;
+
+const int NULL_INT = INT32_NULL;
+
+/*
+ * The plan is always
+ *     SEND <- ORDERBY(all columns) <- HASHJOIN(outer.A = inner.A) <- SEQSCAN(outer), SEQSCAN(inner)
+ * so that the answer does not depend on which side gets hashed.
+ */
+std::string columnJSON(int idx, int tableIdx) {
+    std::ostringstream out;
+    out << "{\"COLUMN_IDX\": " << idx << ", ";
+    if (tableIdx != 0) {
+        out << "\"TABLE_IDX\": " << tableIdx << ", ";
+    }
+    out << "\"TYPE\": 32, \"VALUE_TYPE\": 5}";
+    return out.str();
+}
+
+std::string seqScanJSON(int id, const char *tableName) {
+    std::ostringstream out;
+    out << "{\"ID\": " << id << ", \"INLINE_NODES\": [{\"ID\": " << (id + 1) << ", \"OUTPUT_SCHEMA\": [";
+    const char *names[] = { "A", "B", "C" };
+    for (int col = 0; col < 3; ++col) {
+        out << (col ? ", " : "") << "{\"COLUMN_NAME\": \"" << names[col]
+            << "\", \"EXPRESSION\": " << columnJSON(col, 0) << "}";
+    }
+    out << "], \"PLAN_NODE_TYPE\": \"PROJECTION\"}], \"PLAN_NODE_TYPE\": \"SEQSCAN\", "
+        << "\"TARGET_TABLE_ALIAS\": \"" << tableName << "\", \"TARGET_TABLE_NAME\": \"" << tableName << "\"}";
+    return out.str();
+}
+
+std::string hashJoinPlan(const char *joinType,
+                         const char *outerTable,
+                         const char *innerTable,
+                         const char *joinPredicate = "null") {
+    std::ostringstream out;
+    out << "{\"EXECUTE_LIST\": [4, 6, 3, 2, 1], \"PLAN_NODES\": ["
+        << "{\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"}, "
+        << "{\"CHILDREN_IDS\": [3], \"ID\": 2, \"PLAN_NODE_TYPE\": \"ORDERBY\", \"SORT_COLUMNS\": [";
+    for (int col = 0; col < 6; ++col) {
+        out << (col ? ", " : "") << "{\"SORT_DIRECTION\": \"ASC\", \"SORT_EXPRESSION\": "
+            << columnJSON(col, 0) << "}";
+    }
+    out << "]}, "
+        << "{\"CHILDREN_IDS\": [4, 6], \"ID\": 3, "
+        << "\"OUTER_HASH_EXPRESSIONS\": [" << columnJSON(0, 0) << "], "
+        << "\"INNER_HASH_EXPRESSIONS\": [" << columnJSON(0, 1) << "], "
+        << "\"JOIN_PREDICATE\": " << joinPredicate << ", "
+        << "\"JOIN_TYPE\": \"" << joinType << "\", \"OUTPUT_SCHEMA\": [";
+    for (int col = 0; col < 6; ++col) {
+        out << (col ? ", " : "") << "{\"COLUMN_NAME\": \"C" << col << "\", \"EXPRESSION\": "
+            << columnJSON(col, 0) << "}";
+    }
+    out << "], \"PLAN_NODE_TYPE\": \"HASHJOIN\", \"PRE_JOIN_PREDICATE\": null, \"WHERE_PREDICATE\": null}, "
+        << seqScanJSON(4, outerTable) << ", "
+        << seqScanJSON(6, innerTable) << "]}";
+    return out.str();
+}
+}
+
+class HashJoinExecutorTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    HashJoinExecutorTest() {
+        initialize(hashJoinDB);
+    }
+
+    void runJoin(const std::string &plan, const int *answer, int nRows) {
+        executeFragment(m_fragmentNumber, plan.c_str());
+        validateResult(answer, nRows, 6);
+    }
+};
+
+/*
+ * AAA has more rows than BBB, so with AAA as the outer table the
+ * inner table is hashed and AAA is streamed through it.
+ */
+TEST_F(HashJoinExecutorTest, InnerJoin) {
+    const int answer[] = {
+        1, 10, 100, 1, 11, 101,
+        3, 30, 300, 3, 33, 303,
+        3, 30, 300, 3, 34, 304,
+        3, 31, 301, 3, 33, 303,
+        3, 31, 301, 3, 34, 304,
+    };
+    runJoin(hashJoinPlan("INNER", "AAA", "BBB"), answer, 5);
+}
+
+TEST_F(HashJoinExecutorTest, InnerJoinWithResidualPredicate) {
+    // AAA.B < BBB.B - 2
+    const char *predicate =
+        "{\"LEFT\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+        "\"RIGHT\": {\"LEFT\": {\"COLUMN_IDX\": 1, \"TABLE_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+        "\"RIGHT\": {\"ISNULL\": false, \"TYPE\": 30, \"VALUE\": 2, \"VALUE_TYPE\": 5}, "
+        "\"TYPE\": 2, \"VALUE_TYPE\": 6}, "
+        "\"TYPE\": 12, \"VALUE_TYPE\": 23}";
+    const int answer[] = {
+        3, 30, 300, 3, 33, 303,
+        3, 30, 300, 3, 34, 304,
+        3, 31, 301, 3, 34, 304,
+    };
+    runJoin(hashJoinPlan("INNER", "AAA", "BBB", predicate), answer, 3);
+}
+
+TEST_F(HashJoinExecutorTest, LeftJoinHashingInner) {
+    const int answer[] = {
+        NULL_INT, 50, 500, NULL_INT, NULL_INT, NULL_INT,
+        1, 10, 100, 1, 11, 101,
+        2, 20, 200, NULL_INT, NULL_INT, NULL_INT,
+        3, 30, 300, 3, 33, 303,
+        3, 30, 300, 3, 34, 304,
+        3, 31, 301, 3, 33, 303,
+        3, 31, 301, 3, 34, 304,
+        4, 40, 400, NULL_INT, NULL_INT, NULL_INT,
+    };
+    runJoin(hashJoinPlan("LEFT", "AAA", "BBB"), answer, 8);
+}
+
+/*
+ * With BBB as the outer table the outer side is the smaller one and gets
+ * hashed, so unmatched outer tuples are only found after probing.
+ */
+TEST_F(HashJoinExecutorTest, LeftJoinHashingOuter) {
+    const int answer[] = {
+        NULL_INT, 55, 505, NULL_INT, NULL_INT, NULL_INT,
+        1, 11, 101, 1, 10, 100,
+        3, 33, 303, 3, 30, 300,
+        3, 33, 303, 3, 31, 301,
+        3, 34, 304, 3, 30, 300,
+        3, 34, 304, 3, 31, 301,
+    };
+    runJoin(hashJoinPlan("LEFT", "BBB", "AAA"), answer, 6);
+}
+
+TEST_F(HashJoinExecutorTest, FullJoinHashingInner) {
+    const int answer[] = {
+        NULL_INT, NULL_INT, NULL_INT, NULL_INT, 55, 505,
+        NULL_INT, 50, 500, NULL_INT, NULL_INT, NULL_INT,
+        1, 10, 100, 1, 11, 101,
+        2, 20, 200, NULL_INT, NULL_INT, NULL_INT,
+        3, 30, 300, 3, 33, 303,
+        3, 30, 300, 3, 34, 304,
+        3, 31, 301, 3, 33, 303,
+        3, 31, 301, 3, 34, 304,
+        4, 40, 400, NULL_INT, NULL_INT, NULL_INT,
+    };
+    runJoin(hashJoinPlan("FULL", "AAA", "BBB"), answer, 9);
+}
+
+TEST_F(HashJoinExecutorTest, FullJoinHashingOuter) {
+    const int answer[] = {
+        NULL_INT, NULL_INT, NULL_INT, NULL_INT, 50, 500,
+        NULL_INT, NULL_INT, NULL_INT, 2, 20, 200,
+        NULL_INT, NULL_INT, NULL_INT, 4, 40, 400,
+        NULL_INT, 55, 505, NULL_INT, NULL_INT, NULL_INT,
+        1, 11, 101, 1, 10, 100,
+        3, 33, 303, 3, 30, 300,
+        3, 33, 303, 3, 31, 301,
+        3, 34, 304, 3, 30, 300,
+        3, 34, 304, 3, 31, 301,
+    };
+    runJoin(hashJoinPlan("FULL", "BBB", "AAA"), answer, 9);
+}
+
+namespace {
+const char *AAA_ColumnNames[] = {
+    "A",
+    "B",
+    "C",
+};
+const char *BBB_ColumnNames[] = {
+    "A",
+    "B",
+    "C",
+};
+
+const int NUM_TABLE_ROWS_AAA = 6;
+const int NUM_TABLE_COLS_AAA = 3;
+const int AAAData[NUM_TABLE_ROWS_AAA * NUM_TABLE_COLS_AAA] = {
+           1, 10,100,
+           2, 20,200,
+           3, 30,300,
+           3, 31,301,
+           4, 40,400,
+    NULL_INT, 50,500,
+};
+
+const int NUM_TABLE_ROWS_BBB = 4;
+const int NUM_TABLE_COLS_BBB = 3;
+const int BBBData[NUM_TABLE_ROWS_BBB * NUM_TABLE_COLS_BBB] = {
+           1, 11,101,
+           3, 33,303,
+           3, 34,304,
+    NULL_INT, 55,505,
+};
+
+const TableConfig AAAConfig = {
+    "AAA",
+    AAA_ColumnNames,
+    NUM_TABLE_ROWS_AAA,
+    NUM_TABLE_COLS_AAA,
+    AAAData
+};
+const TableConfig BBBConfig = {
+    "BBB",
+    BBB_ColumnNames,
+    NUM_TABLE_ROWS_BBB,
+    NUM_TABLE_COLS_BBB,
+    BBBData
+};
+
+const TableConfig *allTables[] = {
+    &AAAConfig,
+    &BBBConfig,
+};
+
+DBConfig hashJoinDB =
+{
+    //
+    // DDL.
+    //
+    "create table AAA (\n"
+    "  A integer,\n"
+    "  B integer,\n"
+    "  C integer\n"
+    " );\n"
+    " \n"
+    " create table BBB (\n"
+    "  A integer,\n"
+    "  B integer,\n"
+    "  C integer\n"
+    " );\n"
+    " ",
+    //
+    // Catalog String
+    //
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV adminport 0\n"
+    "set $PREV adminstartup false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database groups administrator\n"
+    "set /clusters#cluster/databases#database/groups#administrator admin true\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database groups user\n"
+    "set /clusters#cluster/databases#database/groups#user admin false\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database tables AAA\n"
+    "set /clusters#cluster/databases#database/tables#AAA isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"AAA|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns A\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns B\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns C\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database tables BBB\n"
+    "set /clusters#cluster/databases#database/tables#BBB isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"BBB|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns A\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns B\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns C\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "",
+    2,
+    allTables
+};
+}
+
+int main() {
+     return TestSuite::globalInstance()->runAll();
+}
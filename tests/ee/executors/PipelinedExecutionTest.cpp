@@ -0,0 +1,415 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "catalog/cluster.h"
+#include "catalog/constraint.h"
+#include "catalog/table.h"
+#include "execution/ExecutorVector.h"
+#include "common/ValuePeeker.hpp"
+#include "executors/abstractexecutor.h"
+#include "executors/ExecutorStats.h"
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+#include "test_utils/plan_testing_config.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include <string>
+
+namespace {
+extern DBConfig pipelineDB;
+
+/*
+ * select A, C from AAA where B > 10 limit 3 offset 1;
+ *     SEND <- LIMIT <- PROJECTION <- SEQSCAN
+ * A pipelined vector runs all of it but the SEND from the LIMIT.
+ */
+const char *scanProjectLimitPlan =
+    "{\"EXECUTE_LIST\": [4, 3, 2, 1], %s\"PLAN_NODES\": ["
+    "{\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"}, "
+    "{\"CHILDREN_IDS\": [3], \"ID\": 2, \"PLAN_NODE_TYPE\": \"LIMIT\", \"LIMIT\": 3, \"OFFSET\": 1}, "
+    "{\"CHILDREN_IDS\": [4], \"ID\": 3, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": ["
+    "    {\"COLUMN_NAME\": \"A\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "    {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}}]}, "
+    "{\"ID\": 4, \"PLAN_NODE_TYPE\": \"SEQSCAN\", \"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", "
+    "    \"OUTPUT_SCHEMA\": ["
+    "        {\"COLUMN_NAME\": \"A\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "        {\"COLUMN_NAME\": \"B\", \"EXPRESSION\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "        {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}}], "
+    "    \"PREDICATE\": {\"LEFT\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+    "                  \"RIGHT\": {\"ISNULL\": false, \"TYPE\": 30, \"VALUE\": 10, \"VALUE_TYPE\": 5}, "
+    "                  \"TYPE\": 13, \"VALUE_TYPE\": 23}}"
+    "]}";
+
+/*
+ * select A, C from AAA where B > 10 order by A desc limit 3 offset 1;
+ *     SEND <- LIMIT <- ORDERBY <- PROJECTION <- SEQSCAN
+ * The ORDERBY is blocking, so only PROJECTION <- SEQSCAN is pipelined.
+ */
+const char *scanProjectSortLimitPlan =
+    "{\"EXECUTE_LIST\": [5, 4, 3, 2, 1], %s\"PLAN_NODES\": ["
+    "{\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"}, "
+    "{\"CHILDREN_IDS\": [3], \"ID\": 2, \"PLAN_NODE_TYPE\": \"LIMIT\", \"LIMIT\": 3, \"OFFSET\": 1}, "
+    "{\"CHILDREN_IDS\": [4], \"ID\": 3, \"PLAN_NODE_TYPE\": \"ORDERBY\", \"SORT_COLUMNS\": ["
+    "    {\"SORT_DIRECTION\": \"DESC\", \"SORT_EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}]}, "
+    "{\"CHILDREN_IDS\": [5], \"ID\": 4, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": ["
+    "    {\"COLUMN_NAME\": \"A\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "    {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}}]}, "
+    "{\"ID\": 5, \"PLAN_NODE_TYPE\": \"SEQSCAN\", \"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", "
+    "    \"OUTPUT_SCHEMA\": ["
+    "        {\"COLUMN_NAME\": \"A\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "        {\"COLUMN_NAME\": \"B\", \"EXPRESSION\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "        {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}}], "
+    "    \"PREDICATE\": {\"LEFT\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+    "                  \"RIGHT\": {\"ISNULL\": false, \"TYPE\": 30, \"VALUE\": 10, \"VALUE_TYPE\": 5}, "
+    "                  \"TYPE\": 13, \"VALUE_TYPE\": 23}}"
+    "]}";
+
+/*
+ * select A, C from AAA where <predicate>;
+ *     SEND <- PROJECTION <- SEQSCAN
+ */
+const char *scanFilterProjectPlan =
+    "{\"EXECUTE_LIST\": [3, 2, 1], %s\"PLAN_NODES\": ["
+    "{\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"}, "
+    "{\"CHILDREN_IDS\": [3], \"ID\": 2, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": ["
+    "    {\"COLUMN_NAME\": \"A\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "    {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}}]}, "
+    "{\"ID\": 3, \"PLAN_NODE_TYPE\": \"SEQSCAN\", \"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", "
+    "    \"OUTPUT_SCHEMA\": ["
+    "        {\"COLUMN_NAME\": \"A\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "        {\"COLUMN_NAME\": \"B\", \"EXPRESSION\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}}, "
+    "        {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}}], "
+    "    \"PREDICATE\": %s}"
+    "]}";
+
+// A = 3 AND B = 30
+const char *columnsEqualConstantsPredicate =
+    "{\"TYPE\": 20, \"VALUE_TYPE\": 23, "
+    " \"LEFT\": {\"LEFT\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+    "           \"RIGHT\": {\"ISNULL\": false, \"TYPE\": 30, \"VALUE\": 3, \"VALUE_TYPE\": 5}, "
+    "           \"TYPE\": 10, \"VALUE_TYPE\": 23}, "
+    " \"RIGHT\": {\"LEFT\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+    "            \"RIGHT\": {\"ISNULL\": false, \"TYPE\": 30, \"VALUE\": 30, \"VALUE_TYPE\": 5}, "
+    "            \"TYPE\": 10, \"VALUE_TYPE\": 23}}";
+
+// C / (A - A) = 0 AND A > 100, which fails on any tuple the scan reads
+const char *divideByZeroUnlessSkippedPredicate =
+    "{\"TYPE\": 20, \"VALUE_TYPE\": 23, "
+    " \"LEFT\": {\"LEFT\": {\"TYPE\": 4, \"VALUE_TYPE\": 6, "
+    "                     \"LEFT\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+    "                     \"RIGHT\": {\"TYPE\": 2, \"VALUE_TYPE\": 6, "
+    "                                \"LEFT\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+    "                                \"RIGHT\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}}, "
+    "           \"RIGHT\": {\"ISNULL\": false, \"TYPE\": 30, \"VALUE\": 0, \"VALUE_TYPE\": 6}, "
+    "           \"TYPE\": 10, \"VALUE_TYPE\": 23}, "
+    " \"RIGHT\": {\"LEFT\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+    "            \"RIGHT\": {\"ISNULL\": false, \"TYPE\": 30, \"VALUE\": 100, \"VALUE_TYPE\": 5}, "
+    "            \"TYPE\": 13, \"VALUE_TYPE\": 23}}";
+
+std::string makePlan(const char *planFormat, bool pipelined) {
+    char plan[4096];
+    snprintf(plan, sizeof(plan), planFormat, pipelined ? "\"PIPELINED\": true, " : "");
+    return plan;
+}
+
+std::string makeFilterPlan(const char *predicate, bool pipelined) {
+    char plan[8192];
+    snprintf(plan, sizeof(plan), scanFilterProjectPlan,
+             pipelined ? "\"PIPELINED\": true, " : "", predicate);
+    return plan;
+}
+}
+
+class PipelinedExecutionTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    PipelinedExecutionTest() {
+        initialize(pipelineDB);
+    }
+
+    void runPlan(const std::string &plan, const int *answer, int nRows) {
+        executeFragment(m_fragmentNumber, plan.c_str());
+        validateResult(answer, nRows, 2);
+    }
+
+    // Run the plan as the given fragment, returning the engine's error code
+    int tryPlan(int fragmentId, const std::string &plan) {
+        m_topend->addPlan(fragmentId, plan.c_str());
+        m_engine->resetReusedResultOutputBuffer();
+        memset(m_parameter_buffer.get(), 0, 4 * 1024);
+        voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+        int64_t fragment = fragmentId;
+        return m_engine->executePlanFragments(1, &fragment, NULL, emptyParams, 1000, 1000, 1000, 1000, 1);
+    }
+
+    size_t executorCount(const std::string &plan) {
+        boost::shared_ptr<voltdb::ExecutorVector> ev =
+            voltdb::ExecutorVector::fromJsonPlan(m_engine.get(), plan, m_fragmentNumber + 1);
+        return ev->getExecutorList().size();
+    }
+};
+
+/*
+ * Executor profiling counts rows going in and out of each scheduled executor.
+ * The stats tuple starts with five columns common to all stats sources.
+ */
+TEST_F(PipelinedExecutionTest, ExecutorProfiling) {
+    const int FRAGMENT_ID = 5, PLAN_NODE_ID = 6, INVOCATIONS = 8, TUPLES_IN = 10, TUPLES_OUT = 11;
+    const int answer[] = {
+        5, 500,
+        4, 400,
+        3, 300,
+    };
+    // Leaves the engine ready to run fragments
+    runPlan(makePlan(scanProjectSortLimitPlan, false), answer, 3);
+
+    m_engine->setExecutorProfiling(true);
+    boost::shared_ptr<voltdb::ExecutorVector> ev =
+        voltdb::ExecutorVector::fromJsonPlan(m_engine.get(), makePlan(scanProjectSortLimitPlan, false), 42);
+    m_engine->executePlanFragment(ev.get(), NULL);
+    m_engine->executePlanFragment(ev.get(), NULL);
+
+    // SEQSCAN, PROJECTION, ORDERBY, LIMIT, SEND
+    const int expectedIn[] = { 0, 5, 5, 5, 3 };
+    const int expectedOut[] = { 5, 5, 5, 3, 0 };
+    const std::vector<voltdb::AbstractExecutor*>& executors = ev->getExecutorList();
+    ASSERT_TRUE(executors.size() == 5);
+    for (int ii = 0; ii < 5; ++ii) {
+        voltdb::ExecutorStats* stats = executors[ii]->getExecutorStats();
+        ASSERT_TRUE(stats != NULL);
+        voltdb::TableTuple* tuple = stats->getStatsTuple(false, 0);
+        EXPECT_EQ(42, voltdb::ValuePeeker::peekAsBigInt(tuple->getNValue(FRAGMENT_ID)));
+        EXPECT_EQ(5 - ii, voltdb::ValuePeeker::peekAsBigInt(tuple->getNValue(PLAN_NODE_ID)));
+        EXPECT_EQ(2, voltdb::ValuePeeker::peekAsBigInt(tuple->getNValue(INVOCATIONS)));
+        EXPECT_EQ(2 * expectedIn[ii], voltdb::ValuePeeker::peekAsBigInt(tuple->getNValue(TUPLES_IN)));
+        EXPECT_EQ(2 * expectedOut[ii], voltdb::ValuePeeker::peekAsBigInt(tuple->getNValue(TUPLES_OUT)));
+    }
+
+    // The interval view starts over after each read
+    voltdb::TableTuple* tuple = executors[0]->getExecutorStats()->getStatsTuple(true, 0);
+    EXPECT_EQ(2, voltdb::ValuePeeker::peekAsBigInt(tuple->getNValue(INVOCATIONS)));
+    tuple = executors[0]->getExecutorStats()->getStatsTuple(true, 0);
+    EXPECT_EQ(0, voltdb::ValuePeeker::peekAsBigInt(tuple->getNValue(INVOCATIONS)));
+
+    EXPECT_EQ(1, m_engine->getStats(voltdb::STATISTICS_SELECTOR_TYPE_EXECUTOR, NULL, 0, false, 0));
+
+    m_engine->setExecutorProfiling(false);
+    ev->setProfiling(false);
+    EXPECT_TRUE(executors[0]->getExecutorStats() == NULL);
+}
+
+TEST_F(PipelinedExecutionTest, ChainedExecutorsAreNotScheduled) {
+    EXPECT_EQ(4, executorCount(makePlan(scanProjectLimitPlan, false)));
+    EXPECT_EQ(2, executorCount(makePlan(scanProjectLimitPlan, true)));
+    EXPECT_EQ(5, executorCount(makePlan(scanProjectSortLimitPlan, false)));
+    EXPECT_EQ(4, executorCount(makePlan(scanProjectSortLimitPlan, true)));
+}
+
+TEST_F(PipelinedExecutionTest, ScanProjectLimitMaterialized) {
+    const int answer[] = {
+        3, 300,
+        4, 400,
+        5, 500,
+    };
+    runPlan(makePlan(scanProjectLimitPlan, false), answer, 3);
+}
+
+TEST_F(PipelinedExecutionTest, ScanProjectLimitPipelined) {
+    const int answer[] = {
+        3, 300,
+        4, 400,
+        5, 500,
+    };
+    runPlan(makePlan(scanProjectLimitPlan, true), answer, 3);
+}
+
+TEST_F(PipelinedExecutionTest, BlockingSortPipelined) {
+    const int answer[] = {
+        5, 500,
+        4, 400,
+        3, 300,
+    };
+    runPlan(makePlan(scanProjectSortLimitPlan, true), answer, 3);
+}
+
+/*
+ * Scan predicates are compiled when the plan is loaded, and the zone map
+ * filter has to see through that to the terms of the planned predicate.
+ */
+TEST_F(PipelinedExecutionTest, ZoneMapsWithCompiledPredicates) {
+    const int answer[] = {
+        3, 300,
+    };
+    // Without zone maps every tuple is read, so the probe fails.
+    EXPECT_NE(ENGINE_ERRORCODE_SUCCESS,
+              tryPlan(200, makeFilterPlan(divideByZeroUnlessSkippedPredicate, false)));
+
+    std::vector<int> zoneMapColumns;
+    zoneMapColumns.push_back(0);
+    zoneMapColumns.push_back(1);
+    dynamic_cast<voltdb::PersistentTable*>(m_engine->getTable("AAA"))->setZoneMapColumns(zoneMapColumns);
+
+    for (int pipelined = 0; pipelined < 2; ++pipelined) {
+        ASSERT_EQ(ENGINE_ERRORCODE_SUCCESS,
+                  tryPlan(210 + pipelined, makeFilterPlan(columnsEqualConstantsPredicate, pipelined)));
+        validateResult(answer, 1, 2);
+
+        // The block holding every tuple has no A above 100, so it's skipped.
+        ASSERT_EQ(ENGINE_ERRORCODE_SUCCESS,
+                  tryPlan(220 + pipelined, makeFilterPlan(divideByZeroUnlessSkippedPredicate, pipelined)));
+        validateResult(answer, 0, 2);
+    }
+}
+
+namespace {
+const char *AAA_ColumnNames[] = {
+    "A",
+    "B",
+    "C",
+};
+
+const int NUM_TABLE_ROWS_AAA = 6;
+const int NUM_TABLE_COLS_AAA = 3;
+const int AAAData[NUM_TABLE_ROWS_AAA * NUM_TABLE_COLS_AAA] = {
+      1, 10,100,
+      2, 20,200,
+      3, 30,300,
+      4, 40,400,
+      5, 50,500,
+      6, 60,600,
+};
+
+const TableConfig AAAConfig = {
+    "AAA",
+    AAA_ColumnNames,
+    NUM_TABLE_ROWS_AAA,
+    NUM_TABLE_COLS_AAA,
+    AAAData
+};
+
+const TableConfig *allTables[] = {
+    &AAAConfig,
+};
+
+DBConfig pipelineDB =
+{
+    //
+    // DDL.
+    //
+    "create table AAA (\n"
+    "  A integer,\n"
+    "  B integer,\n"
+    "  C integer\n"
+    " );\n"
+    " ",
+    //
+    // Catalog String
+    //
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV adminport 0\n"
+    "set $PREV adminstartup false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database groups administrator\n"
+    "set /clusters#cluster/databases#database/groups#administrator admin true\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database groups user\n"
+    "set /clusters#cluster/databases#database/groups#user admin false\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database tables AAA\n"
+    "set /clusters#cluster/databases#database/tables#AAA isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"AAA|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns A\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns B\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns C\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "",
+    1,
+    allTables
+};
+}
+
+int main() {
+     return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,297 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "common/TupleSchema.h"
+#include "common/ValuePeeker.hpp"
+#include "common/NValue.hpp"
+#include "common/Pool.hpp"
+#include "common/SQLException.h"
+#include "common/ValueFactory.hpp"
+#include "executors/spilledsortruns.h"
+#include "executors/tuplespillfile.h"
+#include "expressions/tuplevalueexpression.h"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+#include "boost/scoped_array.hpp"
+#include "boost/scoped_ptr.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace voltdb;
+
+// Long enough to be stored outside the tuple
+static const int32_t NAME_LENGTH = 80;
+
+static TempTable* createTempTable() {
+    std::vector<ValueType> all_types;
+    all_types.push_back(VALUE_TYPE_BIGINT);
+    all_types.push_back(VALUE_TYPE_VARCHAR);
+    std::vector<bool> column_allow_null(2, true);
+    std::vector<int32_t> all_inline_lengths;
+    all_inline_lengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    all_inline_lengths.push_back(NAME_LENGTH);
+    TupleSchema* schema = TupleSchema::createTupleSchemaForTest(all_types,
+                                                                all_inline_lengths,
+                                                                column_allow_null);
+    std::vector<std::string> names(2);
+    return TableFactory::buildTempTable("a_table", schema, names, NULL);
+}
+
+static std::string nameFor(int value) {
+    std::ostringstream out;
+    out << "value number " << value;
+    return out.str();
+}
+
+class SpilledSortRunsTest : public Test
+{
+public:
+    SpilledSortRunsTest()
+        : m_tempDstTable(createTempTable())
+        , m_key(0, 0)
+    {
+        m_keys.push_back(&m_key);
+    }
+
+    ~SpilledSortRunsTest()
+    {
+        for (size_t i = 0; i < m_blocks.size(); ++i) {
+            delete [] m_blocks[i];
+        }
+    }
+
+    // TupleComparer keeps references, so the directions live in the fixture.
+    AbstractExecutor::TupleComparer comparer(SortDirectionType direction) {
+        m_dirs.assign(1, direction);
+        return AbstractExecutor::TupleComparer(m_keys, m_dirs);
+    }
+
+    /** Build tuples for the values, sort them, and write them as one run. */
+    void addRun(SpilledSortRuns& runs,
+                AbstractExecutor::TupleComparer comp,
+                const std::vector<int>& values,
+                std::vector<int>& allValues)
+    {
+        TableTuple tuple(m_tempDstTable->schema());
+        char* block = new char[values.size() * tuple.tupleLength() + 1];
+        m_blocks.push_back(block);
+        std::vector<TableTuple> tuples;
+        for (size_t i = 0; i < values.size(); ++i) {
+            tuple.move(block + i * tuple.tupleLength());
+            tuple.setNValue(0, ValueFactory::getBigIntValue(values[i]));
+            NValue name = ValueFactory::getStringValue(nameFor(values[i]), &m_sourcePool);
+            tuple.setNValueAllocateForObjectCopies(1, name, &m_sourcePool);
+            tuples.push_back(tuple);
+            allValues.push_back(values[i]);
+        }
+        std::sort(tuples.begin(), tuples.end(), comp);
+        runs.writeRun(tuples.begin(), tuples.end());
+    }
+
+    void validateResults(std::vector<int>& expected, int limit = -1, int offset = 0) {
+        size_t first = std::min(static_cast<size_t>(offset), expected.size());
+        size_t size = expected.size() - first;
+        if (limit >= 0) {
+            size = std::min(size, static_cast<size_t>(limit));
+        }
+        ASSERT_EQ(size, m_tempDstTable->activeTupleCount());
+
+        int i = 0;
+        TableIterator iterator = m_tempDstTable->iterator();
+        TableTuple tuple(m_tempDstTable->schema());
+        while (iterator.next(tuple)) {
+            int value = expected[first + i++];
+            ASSERT_EQ(value, ValuePeeker::peekAsBigInt(tuple.getNValue(0)));
+            int32_t length;
+            const char* name = ValuePeeker::peekObject_withoutNull(tuple.getNValue(1), &length);
+            ASSERT_EQ(nameFor(value), std::string(name, length));
+        }
+        m_tempDstTable->deleteAllTempTuples();
+    }
+
+    TempTable* getDstTempTable() {
+        return m_tempDstTable.get();
+    }
+
+protected:
+    Pool m_sourcePool;
+    Pool m_mergePool;
+
+private:
+    boost::scoped_ptr<TempTable> m_tempDstTable;
+    TupleValueExpression m_key;
+    std::vector<AbstractExpression*> m_keys;
+    std::vector<SortDirectionType> m_dirs;
+    std::vector<char*> m_blocks;
+};
+
+TEST_F(SpilledSortRunsTest, noRunsTest)
+{
+    SpilledSortRuns runs(getDstTempTable()->schema());
+    std::vector<int> empty;
+    AbstractExecutor::TupleComparer comp = comparer(SORT_DIRECTION_TYPE_ASC);
+    addRun(runs, comp, empty, empty);
+    ASSERT_EQ(0, runs.runCount());
+
+    runs.mergeRuns(comp, -1, 0, getDstTempTable(), &m_mergePool, NULL);
+    validateResults(empty);
+}
+
+TEST_F(SpilledSortRunsTest, singleRunTest)
+{
+    SpilledSortRuns runs(getDstTempTable()->schema());
+    AbstractExecutor::TupleComparer comp = comparer(SORT_DIRECTION_TYPE_ASC);
+    std::vector<int> values;
+    values.push_back(7);
+    values.push_back(3);
+    values.push_back(5);
+    values.push_back(3);
+    std::vector<int> all;
+    addRun(runs, comp, values, all);
+    ASSERT_EQ(1, runs.runCount());
+
+    runs.mergeRuns(comp, -1, 0, getDstTempTable(), &m_mergePool, NULL);
+    std::sort(all.begin(), all.end());
+    validateResults(all);
+}
+
+TEST_F(SpilledSortRunsTest, multipleRunsTest)
+{
+    SpilledSortRuns runs(getDstTempTable()->schema());
+    AbstractExecutor::TupleComparer comp = comparer(SORT_DIRECTION_TYPE_ASC);
+    std::vector<int> all;
+    // Enough runs and tuples that reading back a run crosses buffer boundaries.
+    for (int run = 0; run < 5; ++run) {
+        std::vector<int> values;
+        for (int i = 0; i < 2000; ++i) {
+            values.push_back((i * 7919 + run * 104729) % 10007);
+        }
+        addRun(runs, comp, values, all);
+    }
+    ASSERT_EQ(5, runs.runCount());
+
+    runs.mergeRuns(comp, -1, 0, getDstTempTable(), &m_mergePool, NULL);
+    std::sort(all.begin(), all.end());
+    validateResults(all);
+}
+
+TEST_F(SpilledSortRunsTest, descendingTest)
+{
+    SpilledSortRuns runs(getDstTempTable()->schema());
+    AbstractExecutor::TupleComparer comp = comparer(SORT_DIRECTION_TYPE_DESC);
+    std::vector<int> all;
+    for (int run = 0; run < 3; ++run) {
+        std::vector<int> values;
+        for (int i = 0; i < 10; ++i) {
+            values.push_back(i * 3 + run);
+        }
+        addRun(runs, comp, values, all);
+    }
+
+    runs.mergeRuns(comp, -1, 0, getDstTempTable(), &m_mergePool, NULL);
+    std::sort(all.rbegin(), all.rend());
+    validateResults(all);
+}
+
+TEST_F(SpilledSortRunsTest, limitOffsetTest)
+{
+    AbstractExecutor::TupleComparer comp = comparer(SORT_DIRECTION_TYPE_ASC);
+    std::vector<int> all;
+    SpilledSortRuns runs(getDstTempTable()->schema());
+    for (int run = 0; run < 4; ++run) {
+        std::vector<int> values;
+        for (int i = 0; i < 25; ++i) {
+            values.push_back(i * 4 + (3 - run));
+        }
+        addRun(runs, comp, values, all);
+    }
+    std::sort(all.begin(), all.end());
+
+    // The runs can be merged again; each merge reads them from the start.
+    runs.mergeRuns(comp, 10, 0, getDstTempTable(), &m_mergePool, NULL);
+    validateResults(all, 10, 0);
+
+    runs.mergeRuns(comp, 10, 45, getDstTempTable(), &m_mergePool, NULL);
+    validateResults(all, 10, 45);
+
+    runs.mergeRuns(comp, 10, 95, getDstTempTable(), &m_mergePool, NULL);
+    validateResults(all, 10, 95);
+
+    runs.mergeRuns(comp, 0, 0, getDstTempTable(), &m_mergePool, NULL);
+    validateResults(all, 0, 0);
+}
+
+TEST_F(SpilledSortRunsTest, skippedTuplesKeepNoStringsTest)
+{
+    SpilledSortRuns runs(getDstTempTable()->schema());
+    AbstractExecutor::TupleComparer comp = comparer(SORT_DIRECTION_TYPE_ASC);
+    std::vector<int> all;
+    for (int run = 0; run < 5; ++run) {
+        std::vector<int> values;
+        for (int i = 0; i < 2000; ++i) {
+            values.push_back(i * 5 + run);
+        }
+        addRun(runs, comp, values, all);
+    }
+    std::sort(all.begin(), all.end());
+
+    // Only the names of the ten tuples in the output are left in the
+    // merge pool, which they don't take past its first chunk.
+    runs.mergeRuns(comp, 10, 9000, getDstTempTable(), &m_mergePool, NULL);
+    ASSERT_EQ(TEMP_POOL_CHUNK_SIZE, m_mergePool.getAllocatedMemory());
+    validateResults(all, 10, 9000);
+}
+
+// A scratch directory that can't be written fails the query cleanly
+TEST_F(SpilledSortRunsTest, unwritableScratchDirectoryTest)
+{
+    const std::string scratchDirectory = TupleSpillFile::scratchDirectory();
+    TupleSpillFile::setScratchDirectory("/nonexistent/voltdb/spill");
+    AbstractExecutor::TupleComparer comp = comparer(SORT_DIRECTION_TYPE_ASC);
+    std::vector<int> values;
+    std::vector<int> allValues;
+    for (int i = 0; i < 10; ++i) {
+        values.push_back(i);
+    }
+    bool threw = false;
+    try {
+        SpilledSortRuns runs(getDstTempTable()->schema());
+        addRun(runs, comp, values, allValues);
+    }
+    catch (const SQLException& e) {
+        threw = true;
+        EXPECT_NE(std::string::npos, e.message().find("/nonexistent/voltdb/spill"));
+    }
+    TupleSpillFile::setScratchDirectory(scratchDirectory);
+    EXPECT_TRUE(threw);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,244 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Checks that AbstractExpression::filterBatch and evalBatch agree with
+ * eval for the expression types that override them, over a table that
+ * has NULLs in every column.
+ */
+
+#include <vector>
+
+#include "harness.h"
+
+#include "common/NValue.hpp"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "expressions/expressions.h"
+
+using namespace std;
+using namespace voltdb;
+
+// Columns of the test tuples
+enum { COL_BIGINT, COL_INTEGER, COL_TINYINT, COL_DOUBLE, COL_TIMESTAMP, COLUMN_COUNT };
+
+static const int TUPLE_COUNT = 300;
+
+class BatchEvaluationTest : public Test {
+public:
+    BatchEvaluationTest() {
+        std::vector<ValueType> types;
+        types.push_back(VALUE_TYPE_BIGINT);
+        types.push_back(VALUE_TYPE_INTEGER);
+        types.push_back(VALUE_TYPE_TINYINT);
+        types.push_back(VALUE_TYPE_DOUBLE);
+        types.push_back(VALUE_TYPE_TIMESTAMP);
+        std::vector<int32_t> lengths;
+        for (int ii = 0; ii < COLUMN_COUNT; ++ii) {
+            lengths.push_back(NValue::getTupleStorageSize(types[ii]));
+        }
+        std::vector<bool> allowNull(COLUMN_COUNT, true);
+        m_schema = TupleSchema::createTupleSchemaForTest(types, lengths, allowNull);
+
+        const int tupleSize = m_schema->tupleLength() + TUPLE_HEADER_SIZE;
+        m_storage.resize(TUPLE_COUNT * tupleSize);
+        for (int ii = 0; ii < TUPLE_COUNT; ++ii) {
+            TableTuple tuple(&m_storage[ii * tupleSize], m_schema);
+            tuple.setNValue(COL_BIGINT, ii % 11 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_BIGINT) :
+                            ValueFactory::getBigIntValue(ii - 150));
+            tuple.setNValue(COL_INTEGER, ii % 13 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_INTEGER) :
+                            ValueFactory::getIntegerValue((ii * 7) % 50));
+            tuple.setNValue(COL_TINYINT, ii % 17 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_TINYINT) :
+                            ValueFactory::getTinyIntValue(static_cast<int8_t>(ii % 5)));
+            tuple.setNValue(COL_DOUBLE, ii % 19 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_DOUBLE) :
+                            ValueFactory::getDoubleValue(ii / 10.0));
+            tuple.setNValue(COL_TIMESTAMP, ii % 23 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_TIMESTAMP) :
+                            ValueFactory::getTimestampValue(ii * 1000));
+            m_tuples.push_back(tuple);
+        }
+        for (int ii = 0; ii < TUPLE_COUNT; ++ii) {
+            m_all.push_back(ii);
+        }
+    }
+
+    ~BatchEvaluationTest() {
+        TupleSchema::freeTupleSchema(m_schema);
+    }
+
+protected:
+    // Check filterBatch of expr over selection against eval of each tuple.
+    void checkFilter(const AbstractExpression* expr, const std::vector<int>& selection) {
+        std::vector<int> expected;
+        for (size_t ii = 0; ii < selection.size(); ++ii) {
+            if (expr->eval(&m_tuples[selection[ii]], NULL).isTrue()) {
+                expected.push_back(selection[ii]);
+            }
+        }
+        std::vector<int> actual(selection);
+        expr->filterBatch(&m_tuples[0], actual);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t ii = 0; ii < expected.size(); ++ii) {
+            ASSERT_EQ(expected[ii], actual[ii]);
+        }
+    }
+
+    void checkFilter(const AbstractExpression* expr) {
+        checkFilter(expr, m_all);
+    }
+
+    // Check evalBatch of expr over all the tuples against eval of each tuple.
+    void checkEval(const AbstractExpression* expr) {
+        std::vector<NValue> results(m_all.size());
+        expr->evalBatch(&m_tuples[0], m_all, &results[0]);
+        for (size_t ii = 0; ii < m_all.size(); ++ii) {
+            NValue expected = expr->eval(&m_tuples[ii], NULL);
+            ASSERT_EQ(expected.isNull(), results[ii].isNull());
+            if ( ! expected.isNull()) {
+                ASSERT_EQ(0, expected.compare(results[ii]));
+            }
+        }
+    }
+
+    static AbstractExpression* column(int idx) {
+        return new TupleValueExpression(0, idx);
+    }
+
+    static AbstractExpression* constant(const NValue& value) {
+        return new ConstantValueExpression(value);
+    }
+
+    TupleSchema* m_schema;
+    std::vector<char> m_storage;
+    std::vector<TableTuple> m_tuples;
+    std::vector<int> m_all;
+};
+
+TEST_F(BatchEvaluationTest, FixedWidthComparisons) {
+    // Each integer width, and each operator, compared with a constant
+    ComparisonExpression<CmpLt> lt(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                   column(COL_BIGINT), constant(ValueFactory::getBigIntValue(20)));
+    checkFilter(&lt);
+    ComparisonExpression<CmpGte> gte(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                                     column(COL_INTEGER), constant(ValueFactory::getBigIntValue(25)));
+    checkFilter(&gte);
+    ComparisonExpression<CmpEq> eq(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                   column(COL_TINYINT), constant(ValueFactory::getIntegerValue(3)));
+    checkFilter(&eq);
+    ComparisonExpression<CmpNe> ne(EXPRESSION_TYPE_COMPARE_NOTEQUAL,
+                                   column(COL_TINYINT), constant(ValueFactory::getTinyIntValue(3)));
+    checkFilter(&ne);
+    ComparisonExpression<CmpGt> gt(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                   column(COL_TIMESTAMP), constant(ValueFactory::getTimestampValue(100000)));
+    checkFilter(&gt);
+    ComparisonExpression<CmpLte> lte(EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                                     column(COL_BIGINT), constant(ValueFactory::getBigIntValue(-100)));
+    checkFilter(&lte);
+
+    // A parameter works like a constant.
+    NValue param = ValueFactory::getBigIntValue(10);
+    ComparisonExpression<CmpLt> paramLt(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                        column(COL_INTEGER), new ParameterValueExpression(0, &param));
+    checkFilter(&paramLt);
+
+    // Nothing is equal to NULL.
+    ComparisonExpression<CmpEq> eqNull(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                       column(COL_BIGINT), constant(NValue::getNullValue(VALUE_TYPE_BIGINT)));
+    std::vector<int> selection(m_all);
+    eqNull.filterBatch(&m_tuples[0], selection);
+    ASSERT_TRUE(selection.empty());
+}
+
+TEST_F(BatchEvaluationTest, GeneralComparisons) {
+    // A double constant, a column on each side, and a column on the right
+    // all take the NValue path.
+    ComparisonExpression<CmpGt> doubleGt(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                         column(COL_BIGINT), constant(ValueFactory::getDoubleValue(-50.5)));
+    checkFilter(&doubleGt);
+    ComparisonExpression<CmpLt> columns(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                        column(COL_BIGINT), column(COL_INTEGER));
+    checkFilter(&columns);
+    ComparisonExpression<CmpLte> reversed(EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                                          constant(ValueFactory::getDoubleValue(12.5)), column(COL_DOUBLE));
+    checkFilter(&reversed);
+    ComparisonExpression<CmpNotDistinct> notDistinct(EXPRESSION_TYPE_COMPARE_NOTDISTINCT,
+                                                     column(COL_BIGINT), column(COL_BIGINT));
+    checkFilter(&notDistinct);
+}
+
+TEST_F(BatchEvaluationTest, Conjunctions) {
+    AbstractExpression* lt = new ComparisonExpression<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+            column(COL_BIGINT), constant(ValueFactory::getBigIntValue(100)));
+    AbstractExpression* gte = new ComparisonExpression<CmpGte>(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+            column(COL_INTEGER), constant(ValueFactory::getBigIntValue(7)));
+    AbstractExpression* eq = new ComparisonExpression<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+            column(COL_TINYINT), constant(ValueFactory::getBigIntValue(3)));
+    AbstractExpression* both = new ConjunctionExpression<ConjunctionAnd>(EXPRESSION_TYPE_CONJUNCTION_AND, lt, gte);
+    ConjunctionExpression<ConjunctionOr> either(EXPRESSION_TYPE_CONJUNCTION_OR, both, eq);
+    checkFilter(&either);
+    checkFilter(both);
+
+    // Start from a partial selection.
+    std::vector<int> odd;
+    for (int ii = 1; ii < TUPLE_COUNT; ii += 2) {
+        odd.push_back(ii);
+    }
+    checkFilter(&either, odd);
+    checkFilter(both, odd);
+}
+
+TEST_F(BatchEvaluationTest, FallBackToEval) {
+    // NOT has no batch implementation of its own.
+    OperatorNotExpression notExpr(new ComparisonExpression<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+            column(COL_BIGINT), constant(ValueFactory::getBigIntValue(0))));
+    checkFilter(&notExpr);
+    checkEval(&notExpr);
+}
+
+TEST_F(BatchEvaluationTest, Projections) {
+    TupleValueExpression doubleColumn(0, COL_DOUBLE);
+    checkEval(&doubleColumn);
+    NValue param = ValueFactory::getIntegerValue(4);
+    ParameterValueExpression paramExpr(0, &param);
+    checkEval(&paramExpr);
+
+    OperatorExpression<OpPlus> plus(EXPRESSION_TYPE_OPERATOR_PLUS, column(COL_BIGINT), column(COL_INTEGER));
+    checkEval(&plus);
+    OperatorExpression<OpMultiply> times(EXPRESSION_TYPE_OPERATOR_MULTIPLY,
+                                         column(COL_TINYINT), constant(ValueFactory::getBigIntValue(3)));
+    checkEval(&times);
+    OperatorExpression<OpMinus> minus(EXPRESSION_TYPE_OPERATOR_MINUS,
+                                      column(COL_DOUBLE), new OperatorExpression<OpDivide>(
+                                              EXPRESSION_TYPE_OPERATOR_DIVIDE,
+                                              column(COL_BIGINT), constant(ValueFactory::getDoubleValue(2.0))));
+    checkEval(&minus);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,288 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*
+ * Checks that the expressions ExpressionCompiler specializes evaluate the
+ * same as the originals, including for NULLs and for parameters of types
+ * that the specialization does not handle.
+ */
+
+#include <vector>
+
+#include "harness.h"
+
+#include "common/NValue.hpp"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "expressions/expressioncompiler.h"
+#include "expressions/expressions.h"
+#include "expressions/expressionutil.h"
+
+#include "boost/scoped_ptr.hpp"
+
+using namespace std;
+using namespace voltdb;
+
+// Columns of the test tuples
+enum { COL_BIGINT, COL_INTEGER, COL_SMALLINT, COL_TINYINT, COL_TIMESTAMP, COL_DOUBLE, COLUMN_COUNT };
+
+static const int TUPLE_COUNT = 200;
+
+class CompiledExpressionTest : public Test {
+public:
+    CompiledExpressionTest() {
+        m_types.push_back(VALUE_TYPE_BIGINT);
+        m_types.push_back(VALUE_TYPE_INTEGER);
+        m_types.push_back(VALUE_TYPE_SMALLINT);
+        m_types.push_back(VALUE_TYPE_TINYINT);
+        m_types.push_back(VALUE_TYPE_TIMESTAMP);
+        m_types.push_back(VALUE_TYPE_DOUBLE);
+        std::vector<int32_t> lengths;
+        for (int ii = 0; ii < COLUMN_COUNT; ++ii) {
+            lengths.push_back(NValue::getTupleStorageSize(m_types[ii]));
+        }
+        std::vector<bool> allowNull(COLUMN_COUNT, true);
+        m_schema = TupleSchema::createTupleSchemaForTest(m_types, lengths, allowNull);
+
+        const int tupleSize = m_schema->tupleLength() + TUPLE_HEADER_SIZE;
+        m_storage.resize(TUPLE_COUNT * tupleSize);
+        for (int ii = 0; ii < TUPLE_COUNT; ++ii) {
+            TableTuple tuple(&m_storage[ii * tupleSize], m_schema);
+            tuple.setNValue(COL_BIGINT, ii % 11 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_BIGINT) :
+                            ValueFactory::getBigIntValue(ii - 100));
+            tuple.setNValue(COL_INTEGER, ii % 13 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_INTEGER) :
+                            ValueFactory::getIntegerValue((ii * 7) % 50));
+            tuple.setNValue(COL_SMALLINT, ii % 7 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_SMALLINT) :
+                            ValueFactory::getSmallIntValue(static_cast<int16_t>(ii % 30 - 15)));
+            tuple.setNValue(COL_TINYINT, ii % 17 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_TINYINT) :
+                            ValueFactory::getTinyIntValue(static_cast<int8_t>(ii % 5)));
+            tuple.setNValue(COL_TIMESTAMP, ii % 23 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_TIMESTAMP) :
+                            ValueFactory::getTimestampValue(ii * 1000));
+            tuple.setNValue(COL_DOUBLE, ii % 19 == 0 ?
+                            NValue::getNullValue(VALUE_TYPE_DOUBLE) :
+                            ValueFactory::getDoubleValue(ii / 10.0));
+            m_tuples.push_back(tuple);
+        }
+        for (int ii = 0; ii < TUPLE_COUNT; ++ii) {
+            m_all.push_back(ii);
+        }
+    }
+
+    ~CompiledExpressionTest() {
+        TupleSchema::freeTupleSchema(m_schema);
+    }
+
+protected:
+    // Check that expr compiles, and that the result agrees with expr on every tuple.
+    void checkCompiled(const AbstractExpression* expr) {
+        boost::scoped_ptr<AbstractExpression> compiled(ExpressionCompiler::compile(expr));
+        ASSERT_TRUE(compiled);
+        ASSERT_EQ(expr->getValueType(), compiled->getValueType());
+        for (int ii = 0; ii < TUPLE_COUNT; ++ii) {
+            NValue expected = expr->eval(&m_tuples[ii], NULL);
+            NValue actual = compiled->eval(&m_tuples[ii], NULL);
+            ASSERT_EQ(expected.isNull(), actual.isNull());
+            if ( ! expected.isNull()) {
+                ASSERT_EQ(0, expected.compare(actual));
+            }
+        }
+        if (expr->getValueType() == VALUE_TYPE_BOOLEAN) {
+            std::vector<int> expected(m_all);
+            expr->filterBatch(&m_tuples[0], expected);
+            std::vector<int> actual(m_all);
+            compiled->filterBatch(&m_tuples[0], actual);
+            ASSERT_TRUE(expected == actual);
+        }
+    }
+
+    AbstractExpression* column(int idx) const {
+        AbstractExpression* tve = new TupleValueExpression(0, idx);
+        tve->setValueType(m_types[idx]);
+        return tve;
+    }
+
+    static AbstractExpression* constant(const NValue& value) {
+        return new ConstantValueExpression(value);
+    }
+
+    template <typename OP>
+    static AbstractExpression* comparison(ExpressionType type, AbstractExpression* left,
+                                          AbstractExpression* right) {
+        AbstractExpression* expr = new ComparisonExpression<OP>(type, left, right);
+        expr->setValueType(VALUE_TYPE_BOOLEAN);
+        return expr;
+    }
+
+    static AbstractExpression* conjunction(ExpressionType type, AbstractExpression* left,
+                                           AbstractExpression* right) {
+        AbstractExpression* expr = ExpressionUtil::conjunctionFactory(type, left, right);
+        expr->setValueType(VALUE_TYPE_BOOLEAN);
+        return expr;
+    }
+
+    std::vector<ValueType> m_types;
+    TupleSchema* m_schema;
+    std::vector<char> m_storage;
+    std::vector<TableTuple> m_tuples;
+    std::vector<int> m_all;
+};
+
+TEST_F(CompiledExpressionTest, ColumnComparisons) {
+    // Each integer width, and each operator, compared with a constant
+    const int columns[] = { COL_BIGINT, COL_INTEGER, COL_SMALLINT, COL_TINYINT };
+    for (int ii = 0; ii < 4; ++ii) {
+        const NValue value = ValueFactory::getIntegerValue(3);
+        boost::scoped_ptr<AbstractExpression> eq(comparison<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+                column(columns[ii]), constant(value)));
+        checkCompiled(eq.get());
+        boost::scoped_ptr<AbstractExpression> ne(comparison<CmpNe>(EXPRESSION_TYPE_COMPARE_NOTEQUAL,
+                column(columns[ii]), constant(value)));
+        checkCompiled(ne.get());
+        boost::scoped_ptr<AbstractExpression> lt(comparison<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                column(columns[ii]), constant(value)));
+        checkCompiled(lt.get());
+        boost::scoped_ptr<AbstractExpression> gt(comparison<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                column(columns[ii]), constant(value)));
+        checkCompiled(gt.get());
+        boost::scoped_ptr<AbstractExpression> lte(comparison<CmpLte>(EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                column(columns[ii]), constant(value)));
+        checkCompiled(lte.get());
+        boost::scoped_ptr<AbstractExpression> gte(comparison<CmpGte>(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                column(columns[ii]), constant(value)));
+        checkCompiled(gte.get());
+    }
+
+    boost::scoped_ptr<AbstractExpression> timestamp(comparison<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+            column(COL_TIMESTAMP), constant(ValueFactory::getTimestampValue(50000))));
+    checkCompiled(timestamp.get());
+
+    // Nothing is equal to NULL.
+    boost::scoped_ptr<AbstractExpression> eqNull(comparison<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+            column(COL_BIGINT), constant(NValue::getNullValue(VALUE_TYPE_BIGINT))));
+    checkCompiled(eqNull.get());
+
+    // The constant may be on the left.
+    boost::scoped_ptr<AbstractExpression> reversed(comparison<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+            constant(ValueFactory::getBigIntValue(20)), column(COL_INTEGER)));
+    checkCompiled(reversed.get());
+}
+
+TEST_F(CompiledExpressionTest, Parameters) {
+    NValue param = ValueFactory::getBigIntValue(10);
+    boost::scoped_ptr<AbstractExpression> lt(comparison<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+            column(COL_INTEGER), new ParameterValueExpression(0, &param)));
+    checkCompiled(lt.get());
+
+    // The compiled expression sees each new value of the parameter.
+    param = ValueFactory::getBigIntValue(-5);
+    checkCompiled(lt.get());
+    param = NValue::getNullValue(VALUE_TYPE_BIGINT);
+    checkCompiled(lt.get());
+
+    // A parameter that is not an integer falls back on the original expression.
+    param = ValueFactory::getDoubleValue(20.5);
+    checkCompiled(lt.get());
+}
+
+TEST_F(CompiledExpressionTest, Conjunctions) {
+    // Compiled terms mixed with others, nested, with NULLs in every column
+    AbstractExpression* lt = comparison<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+            column(COL_BIGINT), constant(ValueFactory::getBigIntValue(50)));
+    AbstractExpression* doubleGt = comparison<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+            column(COL_DOUBLE), constant(ValueFactory::getDoubleValue(3.5)));
+    AbstractExpression* eq = comparison<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+            column(COL_TINYINT), constant(ValueFactory::getBigIntValue(2)));
+    AbstractExpression* gte = comparison<CmpGte>(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+            column(COL_SMALLINT), constant(ValueFactory::getBigIntValue(0)));
+    boost::scoped_ptr<AbstractExpression> expr(
+        conjunction(EXPRESSION_TYPE_CONJUNCTION_OR,
+                    conjunction(EXPRESSION_TYPE_CONJUNCTION_AND,
+                                conjunction(EXPRESSION_TYPE_CONJUNCTION_AND, lt, doubleGt), eq),
+                    gte));
+    checkCompiled(expr.get());
+    checkCompiled(expr->getLeft());
+
+    // A conjunction without any terms to specialize is left alone.
+    boost::scoped_ptr<AbstractExpression> doubles(
+        conjunction(EXPRESSION_TYPE_CONJUNCTION_AND,
+                    comparison<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                      column(COL_DOUBLE), constant(ValueFactory::getDoubleValue(1.5))),
+                    comparison<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                      column(COL_BIGINT), column(COL_INTEGER))));
+    ASSERT_TRUE(ExpressionCompiler::compile(doubles.get()) == NULL);
+}
+
+TEST_F(CompiledExpressionTest, CaseWhen) {
+    // CASE WHEN integer_col > 20 THEN bigint_col
+    //      ELSE CASE WHEN tinyint_col = 1 THEN -1 ELSE 0 END END
+    AbstractExpression* innerCase = new OperatorCaseWhenExpression(VALUE_TYPE_BIGINT,
+            comparison<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+                              column(COL_TINYINT), constant(ValueFactory::getBigIntValue(1))),
+            new OperatorAlternativeExpression(constant(ValueFactory::getBigIntValue(-1)),
+                                              constant(ValueFactory::getBigIntValue(0))));
+    innerCase->setValueType(VALUE_TYPE_BIGINT);
+    boost::scoped_ptr<AbstractExpression> outerCase(new OperatorCaseWhenExpression(VALUE_TYPE_BIGINT,
+            comparison<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                              column(COL_INTEGER), constant(ValueFactory::getBigIntValue(20))),
+            new OperatorAlternativeExpression(column(COL_BIGINT), innerCase)));
+    outerCase->setValueType(VALUE_TYPE_BIGINT);
+    checkCompiled(outerCase.get());
+}
+
+TEST_F(CompiledExpressionTest, NotCompiled) {
+    // Neither a double column nor two columns can be specialized.
+    boost::scoped_ptr<AbstractExpression> doubleGt(comparison<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+            column(COL_DOUBLE), constant(ValueFactory::getDoubleValue(1.5))));
+    ASSERT_TRUE(ExpressionCompiler::compile(doubleGt.get()) == NULL);
+    boost::scoped_ptr<AbstractExpression> columns(comparison<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+            column(COL_BIGINT), column(COL_INTEGER)));
+    ASSERT_TRUE(ExpressionCompiler::compile(columns.get()) == NULL);
+    boost::scoped_ptr<AbstractExpression> integerDouble(comparison<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+            column(COL_BIGINT), constant(ValueFactory::getDoubleValue(1.5))));
+    ASSERT_TRUE(ExpressionCompiler::compile(integerDouble.get()) == NULL);
+
+    // A compiled expression is not compiled again.
+    boost::scoped_ptr<AbstractExpression> lt(comparison<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+            column(COL_BIGINT), constant(ValueFactory::getBigIntValue(5))));
+    boost::scoped_ptr<AbstractExpression> compiled(ExpressionCompiler::compile(lt.get()));
+    ASSERT_TRUE(ExpressionCompiler::compile(compiled.get()) == NULL);
+}
+
+TEST_F(CompiledExpressionTest, ColumnTypeMismatch) {
+    // A plan that expects a BIGINT where the tuple has an INTEGER still gets
+    // the right answers, from the original expression.
+    AbstractExpression* tve = column(COL_INTEGER);
+    tve->setValueType(VALUE_TYPE_BIGINT);
+    boost::scoped_ptr<AbstractExpression> gt(comparison<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+            tve, constant(ValueFactory::getBigIntValue(25))));
+    checkCompiled(gt.get());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -25,6 +25,7 @@
 #include "common/common.h"
 #include "common/NValue.hpp"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "common/tabletuple.h"
 #include "indexes/tableindex.h"
 #include "indexes/indexkey.h"
@@ -255,6 +256,147 @@ TEST_F(CompactingTreeMultiIndexTest, SimpleDeleteTuple) {
     delete tuple4;
 }
 
+// Skipping entries by rank lands where stepping through them one by one would.
+TEST_F(CompactingTreeMultiIndexTest, SkipEntries) {
+    vector<int> columnIndices;
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+
+    columnIndices.push_back(0);
+    columnTypes.push_back(VALUE_TYPE_BIGINT);
+    columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    columnAllowNull.push_back(false);
+
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(columnTypes,
+                                                         columnLengths,
+                                                         columnAllowNull);
+
+    TableIndexScheme scheme("test_index", BALANCED_TREE_INDEX,
+                            columnIndices, TableIndex::simplyIndexColumns(),
+                            false, true, schema);
+    TableIndex *index = TableIndexFactory::getInstance(scheme);
+    ASSERT_TRUE(index->isCountableIndex());
+
+    // Four entries for each key
+    const int entryCount = 100;
+    vector<TableTuple*> tuples;
+    for (int ii = 0; ii < entryCount; ii++) {
+        tuples.push_back(newTuple(schema, 0, ii / 4));
+        index->addEntry(tuples.back(), NULL);
+    }
+
+    for (int skip = 0; skip <= entryCount; skip += 7) {
+        for (int forward = 0; forward < 2; forward++) {
+            IndexCursor stepped(index->getTupleSchema());
+            IndexCursor skipped(index->getTupleSchema());
+            index->moveToEnd(forward, stepped);
+            index->moveToEnd(forward, skipped);
+            for (int ii = 0; ii < skip; ii++) {
+                index->nextValue(stepped);
+            }
+            index->skipEntries(skip, false, skipped);
+            TableTuple expected = index->nextValue(stepped);
+            TableTuple actual = index->nextValue(skipped);
+            EXPECT_EQ(expected.isNullTuple(), actual.isNullTuple());
+            EXPECT_EQ(expected.address(), actual.address());
+        }
+    }
+
+    // Within the entries for one key
+    TableTuple searchKey(index->getKeySchema());
+    char searchKeyData[8];
+    searchKey.moveNoHeader(searchKeyData);
+    searchKey.setNValue(0, ValueFactory::getBigIntValue(10));
+    for (int skip = 0; skip <= 4; skip++) {
+        IndexCursor stepped(index->getTupleSchema());
+        IndexCursor skipped(index->getTupleSchema());
+        EXPECT_TRUE(index->moveToKey(&searchKey, stepped));
+        EXPECT_TRUE(index->moveToKey(&searchKey, skipped));
+        for (int ii = 0; ii < skip; ii++) {
+            index->nextValueAtKey(stepped);
+        }
+        index->skipEntries(skip, true, skipped);
+        TableTuple expected = index->nextValueAtKey(stepped);
+        TableTuple actual = index->nextValueAtKey(skipped);
+        EXPECT_EQ(skip == 4, actual.isNullTuple());
+        EXPECT_EQ(expected.address(), actual.address());
+    }
+
+    delete index;
+    TupleSchema::freeTupleSchema(schema);
+    for (int ii = 0; ii < entryCount; ii++) {
+        delete[] tuples[ii]->address();
+        delete tuples[ii];
+    }
+}
+
+// A skip scan visits one entry per distinct leading column value.
+TEST_F(CompactingTreeMultiIndexTest, MoveToNextPrefix) {
+    vector<int> columnIndices;
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+
+    for (int ii = 0; ii < 2; ii++) {
+        columnIndices.push_back(ii);
+        columnTypes.push_back(VALUE_TYPE_BIGINT);
+        columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        columnAllowNull.push_back(true);
+    }
+
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(columnTypes,
+                                                         columnLengths,
+                                                         columnAllowNull);
+
+    TableIndexScheme scheme("test_index", BALANCED_TREE_INDEX,
+                            columnIndices, TableIndex::simplyIndexColumns(),
+                            false, false, schema);
+    TableIndex *index = TableIndexFactory::getInstance(scheme);
+    ASSERT_TRUE(index->canMoveToNextPrefix(1));
+
+    // Five prefixes, each with many entries, some at the largest value
+    const int prefixCount = 5;
+    const int entriesPerPrefix = 50;
+    vector<TableTuple*> tuples;
+    for (int prefix = 0; prefix < prefixCount; prefix++) {
+        for (int ii = 0; ii < entriesPerPrefix; ii++) {
+            TableTuple *tuple = newTuple(schema, 0, prefix * 10);
+            tuple->setNValue(1, ValueFactory::getBigIntValue(ii % 3 == 0 ? INT64_MAX : ii));
+            index->addEntry(tuple, NULL);
+            tuples.push_back(tuple);
+        }
+    }
+
+    TableTuple prefixKey(index->getKeySchema());
+    char *prefixKeyData = new char[prefixKey.tupleLength()];
+    prefixKey.moveNoHeader(prefixKeyData);
+
+    IndexCursor cursor(index->getTupleSchema());
+    index->moveToEnd(true, cursor);
+    TableTuple tuple = index->nextValue(cursor);
+    int visited = 0;
+    while ( ! tuple.isNullTuple()) {
+        EXPECT_EQ(visited * 10, ValuePeeker::peekBigInt(tuple.getNValue(0)));
+        ++visited;
+        prefixKey.setAllNulls();
+        index->copyKeyPrefix(tuple, 1, prefixKey);
+        EXPECT_EQ(0, prefixKey.getNValue(0).compare(tuple.getNValue(0)));
+        bool isEnd = index->moveToNextPrefix(prefixKey, 1, cursor);
+        tuple = index->nextValue(cursor);
+        EXPECT_EQ(isEnd, tuple.isNullTuple());
+    }
+    EXPECT_EQ(prefixCount, visited);
+
+    delete [] prefixKeyData;
+    delete index;
+    TupleSchema::freeTupleSchema(schema);
+    for (int ii = 0; ii < tuples.size(); ii++) {
+        delete[] tuples[ii]->address();
+        delete tuples[ii];
+    }
+}
+
 static int VERBOSE = 0;
 
 // create three types of index and test their performace of delete
@@ -23,12 +23,17 @@
 
 #include "harness.h"
 #include "indexes/indexkey.h"
+#include "indexes/tableindex.h"
+#include "indexes/tableindexfactory.h"
 #include "common/NValue.hpp"
 #include "common/ValueFactory.hpp"
 #include "common/TupleSchema.h"
 #include "common/tabletuple.h"
 #include "common/ThreadLocalPool.h"
 
+#include <cstdlib>
+#include <limits>
+
 using namespace voltdb;
 
 class IndexKeyTest : public Test {
@@ -443,6 +448,202 @@ TEST_F(IndexKeyTest, Int64Packing2Int32sWithSecondNull) {
     voltdb::TupleSchema::freeTupleSchema(keySchema);
 }
 
+/*
+ * Build a key schema covering every type NormalizedKey supports, including
+ * an inlined and a non-inlined VARCHAR, and fill it with values chosen to
+ * produce ties, NULLs, NaN, signed zeros, prefixes and embedded zero bytes.
+ */
+static voltdb::TupleSchema *createMixedKeySchema() {
+    std::vector<voltdb::ValueType> columnTypes;
+    std::vector<int32_t> columnLengths;
+    columnTypes.push_back(voltdb::VALUE_TYPE_INTEGER);
+    columnLengths.push_back(NValue::getTupleStorageSize(voltdb::VALUE_TYPE_INTEGER));
+    columnTypes.push_back(voltdb::VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(8);
+    columnTypes.push_back(voltdb::VALUE_TYPE_DOUBLE);
+    columnLengths.push_back(NValue::getTupleStorageSize(voltdb::VALUE_TYPE_DOUBLE));
+    columnTypes.push_back(voltdb::VALUE_TYPE_DECIMAL);
+    columnLengths.push_back(NValue::getTupleStorageSize(voltdb::VALUE_TYPE_DECIMAL));
+    columnTypes.push_back(voltdb::VALUE_TYPE_VARBINARY);
+    columnLengths.push_back(12);
+    columnTypes.push_back(voltdb::VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(20);
+    std::vector<bool> columnAllowNull(columnTypes.size(), true);
+    return voltdb::TupleSchema::createTupleSchemaForTest(columnTypes, columnLengths, columnAllowNull);
+}
+
+static NValue mixedKeyValue(int column, int choice, std::vector<NValue> &allocated) {
+    static const char *strings[] = { "", "a", "ab", "abc", "b", "a\0", "a\0b", "a\0c", "\xff" };
+    static const int stringLengths[] = { 0, 1, 2, 3, 1, 2, 3, 3, 1 };
+    static const double doubles[] = { -1.5, -0.0, 0.0, 2.25, 1e300, -1e300 };
+    static const char *decimals[] = { "-12.5", "0", "0.000000000001", "99999.75", "-0.5" };
+    switch (column) {
+    case 0:
+        return choice % 5 == 0 ? NValue::getNullValue(voltdb::VALUE_TYPE_INTEGER) :
+                                 ValueFactory::getIntegerValue(choice % 3 - 1);
+    case 1:
+    case 5: {
+        if (choice % 10 == 0) {
+            return ValueFactory::getNullStringValue();
+        }
+        const int pick = choice % 9;
+        NValue value = ValueFactory::getStringValue(std::string(strings[pick], stringLengths[pick]));
+        allocated.push_back(value);
+        return value;
+    }
+    case 2:
+        if (choice % 8 == 6) {
+            return NValue::getNullValue(voltdb::VALUE_TYPE_DOUBLE);
+        }
+        if (choice % 8 == 7) {
+            return ValueFactory::getDoubleValue(std::numeric_limits<double>::quiet_NaN());
+        }
+        return ValueFactory::getDoubleValue(doubles[choice % 6]);
+    case 3:
+        if (choice % 6 == 5) {
+            return NValue::getNullValue(voltdb::VALUE_TYPE_DECIMAL);
+        }
+        return ValueFactory::getDecimalValueFromString(decimals[choice % 5]);
+    default: {
+        if (choice % 7 == 0) {
+            return ValueFactory::getNullBinaryValue();
+        }
+        static const unsigned char bytes[] = { 0x00, 0x00, 0x7f, 0x80, 0xff };
+        NValue value = ValueFactory::getBinaryValue(bytes + choice % 3, choice % 4);
+        allocated.push_back(value);
+        return value;
+    }
+    }
+}
+
+static int signOf(int comparison) {
+    return comparison < 0 ? -1 : (comparison > 0 ? 1 : 0);
+}
+
+TEST_F(IndexKeyTest, NormalizedKeyMatchesGenericKey) {
+    voltdb::TupleSchema *keySchema = createMixedKeySchema();
+    ASSERT_TRUE(NormalizedKeyEncoding::keyLength(keySchema) > 0);
+    ASSERT_TRUE(NormalizedKeyEncoding::keyLength(keySchema) <= 256);
+
+    voltdb::GenericKey<256>::KeyComparator genericComparator(keySchema);
+    voltdb::NormalizedKey<256>::KeyComparator comparator(keySchema);
+    voltdb::NormalizedKey<256>::KeyEqualityChecker equality(keySchema);
+    voltdb::NormalizedKey<256>::KeyHasher hasher(keySchema);
+
+    const int tupleCount = 300;
+    std::vector<NValue> allocated;
+    std::vector<char*> storage;
+    std::vector<voltdb::GenericKey<256> > genericKeys;
+    std::vector<voltdb::NormalizedKey<256> > normalizedKeys;
+    srand(7);
+    for (int ii = 0; ii < tupleCount; ++ii) {
+        voltdb::TableTuple tuple(keySchema);
+        storage.push_back(new char[tuple.tupleLength()]);
+        tuple.move(storage.back());
+        for (int col = 0; col < keySchema->columnCount(); ++col) {
+            tuple.setNValue(col, mixedKeyValue(col, rand(), allocated));
+        }
+        genericKeys.push_back(voltdb::GenericKey<256>(&tuple));
+        normalizedKeys.push_back(voltdb::NormalizedKey<256>(&tuple));
+    }
+
+    for (int ii = 0; ii < tupleCount; ++ii) {
+        for (int jj = 0; jj < tupleCount; ++jj) {
+            const int expected = signOf(genericComparator(genericKeys[ii], genericKeys[jj]));
+            ASSERT_EQ(expected, comparator(normalizedKeys[ii], normalizedKeys[jj]));
+            ASSERT_EQ(expected == 0, equality(normalizedKeys[ii], normalizedKeys[jj]));
+            if (expected == 0) {
+                ASSERT_EQ(hasher(normalizedKeys[ii]), hasher(normalizedKeys[jj]));
+            }
+        }
+    }
+
+    for (int ii = 0; ii < tupleCount; ++ii) {
+        delete [] storage[ii];
+    }
+    for (int ii = 0; ii < allocated.size(); ++ii) {
+        allocated[ii].free();
+    }
+    voltdb::TupleSchema::freeTupleSchema(keySchema);
+}
+
+TEST_F(IndexKeyTest, NormalizedKeyIndex) {
+    voltdb::TupleSchema *tupleSchema = createMixedKeySchema();
+    std::vector<int> columnIndices;
+    columnIndices.push_back(5);
+    columnIndices.push_back(2);
+    columnIndices.push_back(0);
+
+    TableIndexFactory::setNormalizedKeysEnabled(true);
+    voltdb::TableIndexScheme scheme("normalized", voltdb::BALANCED_TREE_INDEX, columnIndices,
+                                    TableIndex::simplyIndexColumns(), false, true, tupleSchema);
+    voltdb::TableIndex *index = voltdb::TableIndexFactory::getInstance(scheme);
+    TableIndexFactory::setNormalizedKeysEnabled(false);
+    // GenericKey would report the non-inlined VARCHAR column.
+    ASSERT_FALSE(index->keyUsesNonInlinedMemory());
+
+    const int tupleCount = 200;
+    std::vector<NValue> allocated;
+    std::vector<char*> storage;
+    srand(11);
+    for (int ii = 0; ii < tupleCount; ++ii) {
+        voltdb::TableTuple tuple(tupleSchema);
+        storage.push_back(new char[tuple.tupleLength()]);
+        tuple.move(storage.back());
+        for (int col = 0; col < tupleSchema->columnCount(); ++col) {
+            tuple.setNValue(col, mixedKeyValue(col, rand(), allocated));
+        }
+        index->addEntry(&tuple, NULL);
+    }
+    ASSERT_EQ(tupleCount, index->getSize());
+
+    // A scan returns the tuples in key order and every key can be looked up.
+    IndexCursor cursor(index->getTupleSchema());
+    index->moveToEnd(true, cursor);
+    voltdb::TableTuple previous(tupleSchema);
+    int visited = 0;
+    for (voltdb::TableTuple tuple = index->nextValue(cursor); ! tuple.isNullTuple(); tuple = index->nextValue(cursor)) {
+        if ( ! previous.isNullTuple()) {
+            int comparison = 0;
+            for (int ii = 0; comparison == 0 && ii < columnIndices.size(); ++ii) {
+                comparison = previous.getNValue(columnIndices[ii]).compare(tuple.getNValue(columnIndices[ii]));
+            }
+            ASSERT_TRUE(comparison <= 0);
+        }
+        previous = tuple;
+        ++visited;
+    }
+    ASSERT_EQ(tupleCount, visited);
+
+    voltdb::TableTuple searchKey(index->getKeySchema());
+    char *searchKeyStorage = new char[searchKey.tupleLength()];
+    searchKey.move(searchKeyStorage);
+    for (int ii = 0; ii < tupleCount; ++ii) {
+        voltdb::TableTuple tuple(storage[ii], tupleSchema);
+        for (int col = 0; col < columnIndices.size(); ++col) {
+            searchKey.setNValue(col, tuple.getNValue(columnIndices[col]));
+        }
+        IndexCursor keyCursor(index->getTupleSchema());
+        ASSERT_TRUE(index->moveToKey(&searchKey, keyCursor));
+        bool found = false;
+        for (voltdb::TableTuple match = index->nextValueAtKey(keyCursor); ! match.isNullTuple();
+             match = index->nextValueAtKey(keyCursor)) {
+            found = found || match.address() == tuple.address();
+        }
+        ASSERT_TRUE(found);
+    }
+
+    delete [] searchKeyStorage;
+    delete index;
+    for (int ii = 0; ii < tupleCount; ++ii) {
+        delete [] storage[ii];
+    }
+    for (int ii = 0; ii < allocated.size(); ++ii) {
+        allocated[ii].free();
+    }
+    voltdb::TupleSchema::freeTupleSchema(tupleSchema);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -56,6 +56,7 @@
 #include "common/common.h"
 #include "common/NValue.hpp"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "common/debuglog.h"
 #include "common/SerializableEEException.h"
 #include "common/tabletuple.h"
@@ -68,6 +69,7 @@
 #include "storage/DRTupleStream.h"
 #include "indexes/tableindex.h"
 #include "indexes/tableindexfactory.h"
+#include "indexes/TupleSlotMap.h"
 #include "execution/VoltDBEngine.h"
 #include "common/ThreadLocalPool.h"
 #include "common/FixUnusedAssertHack.h"
@@ -268,7 +270,7 @@ public:
     }
 
     void init(std::string name, TableIndexType type, std::vector<int32_t> &ix_columnIndices,
-              std::vector<ValueType> &ix_columnTypes, bool unique)
+              std::vector<ValueType> &ix_columnTypes, bool unique, int tableAllocationTargetSize = 0)
     {
         bool countable = true;
         TupleSchema *initiallyNullTupleSchema = NULL;
@@ -315,7 +317,8 @@ public:
         int partitionCount = 1;
         m_engine->initialize(0, 0, 0, 0, "", 0, 1024, DEFAULT_TEMP_TABLE_MEMORY, false);
         m_engine->updateHashinator(HASHINATOR_LEGACY, (char*)&partitionCount, NULL, 0);
-        table = dynamic_cast<PersistentTable*>(TableFactory::getPersistentTable(database_id, (const string)"test_table", schema, columnNames, signature));
+        table = dynamic_cast<PersistentTable*>(TableFactory::getPersistentTable(database_id, (const string)"test_table", schema, columnNames, signature,
+                                                                                false, -1, false, false, tableAllocationTargetSize));
 
         TableIndex *pkeyIndex = TableIndexFactory::TableIndexFactory::getInstance(pkeyScheme);
         assert(pkeyIndex);
@@ -819,6 +822,251 @@ TEST_F(IndexTest, TupleKeyUnique) {
     delete[] searchkey.address();
 }
 
+/**
+ * A non-unique B+-tree index whose runs of equal keys span several leaves,
+ * checked before and after deleting a quarter of the rows.
+ */
+TEST_F(IndexTest, BTreeMulti) {
+    vector<int> ixb_column_indices;
+    vector<ValueType> ixb_column_types;
+    ixb_column_indices.push_back(1);
+    ixb_column_indices.push_back(2);
+    ixb_column_types.push_back(VALUE_TYPE_BIGINT);
+    ixb_column_types.push_back(VALUE_TYPE_BIGINT);
+    init("ixb",
+         BTREE_INDEX,
+         ixb_column_indices,
+         ixb_column_types,
+         false);
+
+    TableIndex* index = table->index("ixb");
+    EXPECT_TRUE(index != NULL);
+    EXPECT_EQ(std::string("CompactingBTreeMultiMapIndex"), index->getTypeName());
+
+    IndexCursor indexCursor(index->getTupleSchema());
+    vector<ValueType> keyColumnTypes(2, VALUE_TYPE_BIGINT);
+    vector<int32_t>
+        keyColumnLengths(2, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    vector<bool> keyColumnAllowNull(2, true);
+    TupleSchema* keySchema =
+        TupleSchema::createTupleSchemaForTest(keyColumnTypes,
+                                       keyColumnLengths,
+                                       keyColumnAllowNull);
+    TableTuple searchkey(keySchema);
+    searchkey.move(new char[searchkey.tupleLength()]);
+    TableTuple tuple(table->schema());
+
+    for (int pass = 0; pass < 2; ++pass) {
+        // The second pass runs after rows with id % 4 == 0 are deleted.
+        int64_t before = 0;
+        for (int64_t mod2 = 0; mod2 < 2; ++mod2) {
+            for (int64_t mod3 = 0; mod3 < 3; ++mod3) {
+                int64_t expected = 0;
+                for (int64_t i = 1; i <= NUM_OF_TUPLES; ++i) {
+                    if (i % 2 == mod2 && i % 3 == mod3 && (pass == 0 || i % 4 != 0)) {
+                        ++expected;
+                    }
+                }
+                searchkey.setNValue(0, ValueFactory::getBigIntValue(mod2));
+                searchkey.setNValue(1, ValueFactory::getBigIntValue(mod3));
+                EXPECT_TRUE(index->moveToKey(&searchkey, indexCursor));
+                int64_t found = 0;
+                while ( ! (tuple = index->nextValueAtKey(indexCursor)).isNullTuple()) {
+                    EXPECT_TRUE(ValueFactory::getBigIntValue(mod2).op_equals(tuple.getNValue(1)).isTrue());
+                    EXPECT_TRUE(ValueFactory::getBigIntValue(mod3).op_equals(tuple.getNValue(2)).isTrue());
+                    ++found;
+                }
+                EXPECT_EQ(expected, found);
+                EXPECT_EQ(before + 1, index->getCounterGET(&searchkey, false, indexCursor));
+                EXPECT_EQ(before + expected, index->getCounterGET(&searchkey, true, indexCursor));
+                EXPECT_EQ(before + expected, index->getCounterLET(&searchkey, true, indexCursor));
+                before += expected;
+            }
+        }
+        EXPECT_EQ(before, static_cast<int64_t>(index->getSize()));
+
+        if (pass == 0) {
+            vector<char*> deletes;
+            index->moveToEnd(true, indexCursor);
+            while ( ! (tuple = index->nextValue(indexCursor)).isNullTuple()) {
+                if (ValuePeeker::peekAsBigInt(tuple.getNValue(0)) % 4 == 0) {
+                    deletes.push_back(tuple.address());
+                }
+            }
+            BOOST_FOREACH(char* address, deletes) {
+                tuple.move(address);
+                table->deleteTuple(tuple, true);
+            }
+        }
+    }
+
+    TupleSchema::freeTupleSchema(keySchema);
+    delete[] searchkey.address();
+}
+
+/**
+ * Two bitmap indexes on the same table share its tuple slots. Lookups are
+ * checked before and after deleting a quarter of the rows.
+ */
+TEST_F(IndexTest, BitmapMulti) {
+    vector<int> im_column_indices;
+    vector<ValueType> im_column_types;
+    im_column_indices.push_back(3);
+    im_column_types.push_back(VALUE_TYPE_BIGINT);
+    init("im",
+         BALANCED_TREE_INDEX,
+         im_column_indices,
+         im_column_types,
+         false);
+
+    vector<TableIndex*> bitmaps;
+    for (int column = 1; column <= 2; ++column) {
+        TableIndexScheme scheme(column == 1 ? "bitmap_mod2" : "bitmap_mod3", BITMAP_INDEX,
+                                vector<int>(1, column), TableIndex::simplyIndexColumns(),
+                                false, false, table->schema());
+        TableIndex* index = TableIndexFactory::getInstance(scheme);
+        EXPECT_EQ(std::string("BitmapIndex"), index->getTypeName());
+        table->addIndex(index);
+        bitmaps.push_back(index);
+    }
+    EXPECT_TRUE(bitmaps[0]->getTupleSlotMap() != NULL);
+    EXPECT_TRUE(bitmaps[0]->getTupleSlotMap() == bitmaps[1]->getTupleSlotMap());
+
+    IndexCursor indexCursor(table->schema());
+    vector<ValueType> keyColumnTypes(1, VALUE_TYPE_BIGINT);
+    vector<int32_t> keyColumnLengths(1, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    vector<bool> keyColumnAllowNull(1, true);
+    TupleSchema* keySchema =
+        TupleSchema::createTupleSchemaForTest(keyColumnTypes,
+                                       keyColumnLengths,
+                                       keyColumnAllowNull);
+    TableTuple searchkey(keySchema);
+    searchkey.move(new char[searchkey.tupleLength()]);
+    TableTuple tuple(table->schema());
+
+    for (int pass = 0; pass < 2; ++pass) {
+        // The second pass runs after rows with id % 4 == 0 are deleted.
+        for (int64_t mod3 = 0; mod3 < 3; ++mod3) {
+            int64_t expected = 0;
+            for (int64_t i = 1; i <= NUM_OF_TUPLES; ++i) {
+                if (i % 3 == mod3 && (pass == 0 || i % 4 != 0)) {
+                    ++expected;
+                }
+            }
+            searchkey.setNValue(0, ValueFactory::getBigIntValue(mod3));
+            EXPECT_TRUE(bitmaps[1]->moveToKey(&searchkey, indexCursor));
+            int64_t found = 0;
+            while ( ! (tuple = bitmaps[1]->nextValueAtKey(indexCursor)).isNullTuple()) {
+                EXPECT_TRUE(ValueFactory::getBigIntValue(mod3).op_equals(tuple.getNValue(2)).isTrue());
+                EXPECT_TRUE(bitmaps[1]->exists(&tuple));
+                ++found;
+            }
+            EXPECT_EQ(expected, found);
+        }
+
+        if (pass == 0) {
+            vector<char*> deletes;
+            TableIterator iterator = table->iterator();
+            while (iterator.next(tuple)) {
+                if (ValuePeeker::peekAsBigInt(tuple.getNValue(0)) % 4 == 0) {
+                    deletes.push_back(tuple.address());
+                }
+            }
+            BOOST_FOREACH(char* address, deletes) {
+                tuple.move(address);
+                table->deleteTuple(tuple, true);
+            }
+            EXPECT_EQ(NUM_OF_TUPLES - deletes.size(), bitmaps[0]->getSize());
+            EXPECT_EQ(NUM_OF_TUPLES - deletes.size(), bitmaps[1]->getSize());
+        }
+    }
+
+    TupleSchema::freeTupleSchema(keySchema);
+    delete[] searchkey.address();
+}
+
+/**
+ * A tuple's slot is its place in the table's blocks, so the bitmap indexes
+ * move the tuples that compaction moves to their new slots.
+ */
+TEST_F(IndexTest, BitmapCompaction) {
+    vector<int> im_column_indices;
+    vector<ValueType> im_column_types;
+    im_column_indices.push_back(3);
+    im_column_types.push_back(VALUE_TYPE_BIGINT);
+    // Blocks of about a hundred tuples
+    init("im",
+         BALANCED_TREE_INDEX,
+         im_column_indices,
+         im_column_types,
+         false,
+         4096);
+
+    vector<TableIndex*> bitmaps;
+    for (int column = 1; column <= 2; ++column) {
+        TableIndexScheme scheme(column == 1 ? "bitmap_mod2" : "bitmap_mod3", BITMAP_INDEX,
+                                vector<int>(1, column), TableIndex::simplyIndexColumns(),
+                                false, false, table->schema());
+        TableIndex* index = TableIndexFactory::getInstance(scheme);
+        table->addIndex(index);
+        bitmaps.push_back(index);
+    }
+
+    // Keep every fourth row
+    TableTuple tuple(table->schema());
+    vector<char*> deletes;
+    TableIterator iterator = table->iterator();
+    while (iterator.next(tuple)) {
+        if (ValuePeeker::peekAsBigInt(tuple.getNValue(0)) % 4 != 0) {
+            deletes.push_back(tuple.address());
+        }
+    }
+    BOOST_FOREACH(char* address, deletes) {
+        tuple.move(address);
+        table->deleteTuple(tuple, false);
+    }
+    const size_t blockCount = table->allocatedBlockCount();
+    for (int ii = 0; ii < 100 && table->allocatedBlockCount() > 3; ++ii) {
+        table->doIdleCompaction();
+    }
+    ASSERT_GT(blockCount, table->allocatedBlockCount());
+    EXPECT_EQ(table->allocatedBlockCount(), bitmaps[0]->getTupleSlotMap()->blockCount());
+    EXPECT_EQ(NUM_OF_TUPLES / 4, bitmaps[0]->getSize());
+    EXPECT_EQ(NUM_OF_TUPLES / 4, bitmaps[1]->getSize());
+
+    vector<ValueType> keyColumnTypes(1, VALUE_TYPE_BIGINT);
+    vector<int32_t> keyColumnLengths(1, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    vector<bool> keyColumnAllowNull(1, true);
+    TupleSchema* keySchema =
+        TupleSchema::createTupleSchemaForTest(keyColumnTypes,
+                                       keyColumnLengths,
+                                       keyColumnAllowNull);
+    TableTuple searchkey(keySchema);
+    searchkey.move(new char[searchkey.tupleLength()]);
+    IndexCursor indexCursor(table->schema());
+    for (int64_t mod3 = 0; mod3 < 3; ++mod3) {
+        searchkey.setNValue(0, ValueFactory::getBigIntValue(mod3));
+        EXPECT_TRUE(bitmaps[1]->moveToKey(&searchkey, indexCursor));
+        int64_t found = 0;
+        while ( ! (tuple = bitmaps[1]->nextValueAtKey(indexCursor)).isNullTuple()) {
+            EXPECT_TRUE(tuple.isActive());
+            EXPECT_EQ(0, ValuePeeker::peekAsBigInt(tuple.getNValue(0)) % 4);
+            EXPECT_EQ(mod3, ValuePeeker::peekAsBigInt(tuple.getNValue(2)));
+            ++found;
+        }
+        int64_t expected = 0;
+        for (int64_t i = 4; i <= NUM_OF_TUPLES; i += 4) {
+            if (i % 3 == mod3) {
+                ++expected;
+            }
+        }
+        EXPECT_EQ(expected, found);
+    }
+
+    TupleSchema::freeTupleSchema(keySchema);
+    delete[] searchkey.address();
+}
+
 /**
  * The next test case aims to test the re-entrant unique tree index feature.
  * The search key values and data preparation work are all borrowed from the previous
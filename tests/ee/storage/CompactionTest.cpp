@@ -370,6 +370,60 @@ TEST_F(CompactionTest, BasicCompaction) {
     ASSERT_EQ( m_table->activeTupleCount(), 0);
 }
 
+TEST_F(CompactionTest, IncrementalCompaction) {
+    initTable();
+#ifdef MEMCHECK
+    int tupleCount = 1000;
+#else
+    int tupleCount = 645260;
+#endif
+    addRandomUniqueTuples( m_table, tupleCount);
+
+    voltdb::TableIndex *pkeyIndex = m_table->primaryKeyIndex();
+    TableTuple key(pkeyIndex->getKeySchema());
+    boost::scoped_array<char> backingStore(new char[pkeyIndex->getKeySchema()->tupleLength()]);
+    key.moveNoHeader(backingStore.get());
+    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
+    for (int ii = 0; ii < tupleCount; ii += 2) {
+        key.setNValue(0, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(pkeyIndex->moveToKey(&key, indexCursor));
+        TableTuple tuple = pkeyIndex->nextValueAtKey(indexCursor);
+        m_table->deleteTuple(tuple, true);
+    }
+    ASSERT_TRUE(m_table->needsCompaction());
+    int64_t reclaimable = m_table->reclaimableTupleMemory();
+    ASSERT_TRUE(reclaimable > 0);
+
+    // With no budget, each call takes a single step
+    int calls = 0;
+    while (m_table->needsCompaction() && calls < tupleCount) {
+        m_table->doIncrementalCompaction(0);
+        calls++;
+        ASSERT_EQ(calls, m_table->compactionStepCount());
+    }
+    ASSERT_TRUE(calls > 1);
+    ASSERT_FALSE(m_table->needsCompaction());
+    ASSERT_TRUE(m_table->reclaimableTupleMemory() < reclaimable);
+    ASSERT_TRUE(m_table->maxCompactionPause() <= m_table->compactionTime());
+    ASSERT_EQ(tupleCount / 2, m_table->activeTupleCount());
+
+    TableIterator& iter = m_table->iterator();
+    TableTuple tuple(m_table->schema());
+    int found = 0;
+    while (iter.next(tuple)) {
+        int32_t pkey = ValuePeeker::peekAsInteger(tuple.getNValue(0));
+        ASSERT_EQ(1, pkey % 2);
+        key.setNValue(0, ValueFactory::getIntegerValue(pkey));
+        for (int ii = 0; ii < 4; ii++) {
+            ASSERT_TRUE(m_table->m_indexes[ii]->moveToKey(&key, indexCursor));
+            TableTuple indexTuple = m_table->m_indexes[ii]->nextValueAtKey(indexCursor);
+            ASSERT_EQ(indexTuple.address(), tuple.address());
+        }
+        found++;
+    }
+    ASSERT_EQ(tupleCount / 2, found);
+}
+
 TEST_F(CompactionTest, CompactionWithCopyOnWrite) {
     initTable();
 #ifdef MEMCHECK
@@ -125,6 +125,27 @@ TEST_F(TempTableLimitsTest, CheckLimitException)
     EXPECT_TRUE(threw);
 }
 
+TEST_F(TempTableLimitsTest, CheckLargeAllocations)
+{
+    // Sizes past INT_MAX count in full rather than wrapping
+    const int64_t fiveGB = 5LL * 1024 * 1024 * 1024;
+    TempTableLimits unlimited(-1);
+    unlimited.increaseAllocated(fiveGB);
+    EXPECT_EQ(fiveGB, unlimited.getAllocated());
+    unlimited.reduceAllocated(fiveGB);
+    EXPECT_EQ(0, unlimited.getAllocated());
+
+    TempTableLimits dut(1024 * 1024 * 100);
+    bool threw = false;
+    try {
+        dut.increaseAllocated(fiveGB);
+    }
+    catch (SQLException& sqle) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
 int main()
 {
     return TestSuite::globalInstance()->runAll();
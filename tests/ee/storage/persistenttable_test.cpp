@@ -29,28 +29,46 @@
 #include "harness.h"
 #include "test_utils/ScopedTupleSchema.hpp"
 
+#include "common/serializeio.h"
 #include "common/tabletuple.h"
 #include "common/types.h"
 #include "common/TupleSchemaBuilder.h"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "execution/VoltDBEngine.h"
+#include "expressions/expressions.h"
+#include "indexes/tableindex.h"
+#include "indexes/tableindexfactory.h"
+#include "storage/AntiCache.h"
 #include "storage/table.h"
 #include "storage/persistenttable.h"
 #include "storage/tablefactory.h"
 #include "storage/tableutil.h"
+#include "storage/tabletuplefilter.h"
+#include "storage/ZoneMapFilter.h"
 
+using voltdb::AbstractExpression;
+using voltdb::AntiCache;
 using voltdb::ExecutorContext;
 using voltdb::NValue;
 using voltdb::PersistentTable;
 using voltdb::Table;
 using voltdb::TableFactory;
+using voltdb::TBPtr;
+using voltdb::TableIndex;
+using voltdb::TableIndexFactory;
+using voltdb::TableIndexScheme;
 using voltdb::TableIterator;
 using voltdb::TableTuple;
+using voltdb::TableTupleFilter;
 using voltdb::TupleSchemaBuilder;
 using voltdb::VALUE_TYPE_BIGINT;
+using voltdb::VALUE_TYPE_INTEGER;
+using voltdb::VALUE_TYPE_TIMESTAMP;
 using voltdb::VALUE_TYPE_VARCHAR;
 using voltdb::ValueFactory;
 using voltdb::VoltDBEngine;
+using voltdb::ZoneMapFilter;
 using voltdb::tableutil;
 
 class PersistentTableTest : public Test {
@@ -166,6 +184,68 @@ protected:
         return payload;
     }
 
+    // Count the tuples passing the predicate, checking the count against
+    // a scan that skips no blocks
+    int countWithZoneMaps(PersistentTable *table,
+                                 const AbstractExpression *predicate,
+                                 int64_t *blocksSkipped) {
+        ZoneMapFilter filter(table, predicate);
+        TableTuple tuple(table->schema());
+        TableIterator iterator = table->iterator();
+        iterator.setZoneMapFilter(&filter);
+        int count = 0;
+        while (iterator.next(tuple)) {
+            if (predicate->eval(&tuple, NULL).isTrue()) {
+                ++count;
+            }
+        }
+        *blocksSkipped = filter.blocksSkipped();
+
+        int expected = 0;
+        iterator = table->iterator();
+        while (iterator.next(tuple)) {
+            if (predicate->eval(&tuple, NULL).isTrue()) {
+                ++expected;
+            }
+        }
+        EXPECT_EQ(expected, count);
+        return count;
+    }
+
+    // A table of (TS, ID) rows, inserted with TS ascending by a second
+    // per row from 0, but NULL in every tenth row
+    PersistentTable* createExpiringTable(const char* name, int rows) {
+        TupleSchemaBuilder builder(2);
+        builder.setColumnAtIndex(0, VALUE_TYPE_TIMESTAMP, true);
+        builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT, false);
+        std::vector<std::string> columnNames;
+        columnNames.push_back("TS");
+        columnNames.push_back("ID");
+        char signature[20];
+        PersistentTable* table = dynamic_cast<PersistentTable*>(
+            TableFactory::getPersistentTable(0, name, builder.build(), columnNames, signature,
+                                             false, -1, false, false, 4096));
+        voltdb::StandAloneTupleStorage storage(table->schema());
+        TableTuple &srcTuple = const_cast<TableTuple&>(storage.tuple());
+        for (int i = 0; i < rows; ++i) {
+            srcTuple.setNValue(0, i % 10 == 5 ? NValue::getNullValue(VALUE_TYPE_TIMESTAMP) :
+                               ValueFactory::getTimestampValue(i * 1000000LL));
+            srcTuple.setNValue(1, ValueFactory::getBigIntValue(i));
+            table->insertTuple(srcTuple);
+        }
+        return table;
+    }
+
+    // Check that no tuple older than the cutoff is left
+    void checkExpired(PersistentTable* table, int64_t cutoffMicros) {
+        TableTuple tuple(table->schema());
+        TableIterator iterator = table->iterator();
+        while (iterator.next(tuple)) {
+            NValue ts = tuple.getNValue(0);
+            ASSERT_TRUE(ts.isNull() || voltdb::ValuePeeker::peekTimestamp(ts) >= cutoffMicros);
+        }
+    }
+
 private:
     boost::scoped_ptr<VoltDBEngine> m_engine;
     int64_t m_undoToken;
@@ -312,6 +392,494 @@ TEST_F(PersistentTableTest, TruncateTableTest) {
     ASSERT_EQ(1, table->allocatedBlockCount());
 }
 
+TEST_F(PersistentTableTest, DictionaryColumns) {
+    getEngine()->loadCatalog(0, catalogPayload());
+    PersistentTable *table = dynamic_cast<PersistentTable*>(getEngine()->getTable("T"));
+    ASSERT_NE(NULL, table);
+    // T is replicated, so its dictionary keeps all of its strings
+    ASSERT_EQ(1, table->dictionaryColumns().size());
+    EXPECT_EQ(1, table->dictionaryColumns()[0]);
+    // The BIGINT key is ignored
+    std::vector<int> dictionaryColumns;
+    dictionaryColumns.push_back(0);
+    dictionaryColumns.push_back(1);
+    table->setDictionaryColumns(dictionaryColumns);
+    ASSERT_EQ(1, table->dictionaryColumns().size());
+
+    NValue stringNValues[] = {
+        ValueFactory::getTempStringValue("Je me souviens"),
+        ValueFactory::getTempStringValue("Ut Incepit Fidelis Sic Permanet"),
+        ValueFactory::getTempStringValue("Splendor sine occasu")
+    };
+    voltdb::StandAloneTupleStorage storage(table->schema());
+    TableTuple &srcTuple = const_cast<TableTuple&>(storage.tuple());
+    beginWork();
+    for (int i = 0; i < 30; ++i) {
+        srcTuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        srcTuple.setNValue(1, stringNValues[i % 3]);
+        table->insertTuple(srcTuple);
+    }
+    commit();
+    EXPECT_EQ(3, table->dictionarySize());
+    // The tuples share the strings rather than owning them, so the table
+    // is charged for each value once
+    const int64_t threeValuesSize = table->nonInlinedMemorySize();
+    EXPECT_EQ(table->dictionaryMemorySize(), threeValuesSize);
+    EXPECT_LT(0, threeValuesSize);
+
+    TableTuple tuple(table->schema());
+    TableIterator iterator = table->iterator();
+    while (iterator.next(tuple)) {
+        int64_t key = voltdb::ValuePeeker::peekBigInt(tuple.getNValue(0));
+        EXPECT_EQ(0, tuple.getNValue(1).compare(stringNValues[key % 3]));
+    }
+
+    // A new value is added by an update and dropped by its rollback
+    beginWork();
+    iterator = table->iterator();
+    ASSERT_TRUE(iterator.next(tuple));
+    TableTuple& tempTuple = table->copyIntoTempTuple(tuple);
+    tempTuple.setNValue(1, ValueFactory::getTempStringValue("Nunavut Sannginivut"));
+    table->updateTupleWithSpecificIndexes(tuple, tempTuple, table->allIndexes());
+    EXPECT_EQ(4, table->dictionarySize());
+    EXPECT_LT(threeValuesSize, table->nonInlinedMemorySize());
+    rollback();
+    EXPECT_EQ(3, table->dictionarySize());
+    EXPECT_EQ(threeValuesSize, table->nonInlinedMemorySize());
+
+    // A value goes when its last tuple does
+    beginWork();
+    std::vector<char*> deleted;
+    iterator = table->iterator();
+    while (iterator.next(tuple)) {
+        if (tuple.getNValue(1).compare(stringNValues[0]) == 0) {
+            deleted.push_back(tuple.address());
+        }
+    }
+    ASSERT_EQ(10, deleted.size());
+    for (int i = 0; i < deleted.size(); ++i) {
+        tuple.move(deleted[i]);
+        table->deleteTuple(tuple, true);
+    }
+    commit();
+    EXPECT_EQ(20, table->activeTupleCount());
+    EXPECT_EQ(2, table->dictionarySize());
+    EXPECT_EQ(table->dictionaryMemorySize(), table->nonInlinedMemorySize());
+    EXPECT_GT(threeValuesSize, table->nonInlinedMemorySize());
+
+    // Restored tuples share the values as inserted ones do
+    voltdb::CopySerializeOutput serializeOut;
+    table->serializeTo(serializeOut);
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_BIGINT, false);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 256, true);
+    std::vector<std::string> columnNames;
+    columnNames.push_back("PK");
+    columnNames.push_back("DATA");
+    char signature[20];
+    boost::scoped_ptr<PersistentTable> restored(dynamic_cast<PersistentTable*>(
+        TableFactory::getPersistentTable(0, "RESTORED", builder.build(), columnNames, signature)));
+    restored->setDictionaryColumns(dictionaryColumns);
+    voltdb::ReferenceSerializeInputBE serializeIn(serializeOut.data() + sizeof(int32_t),
+                                                  serializeOut.size() - sizeof(int32_t));
+    beginWork();
+    restored->loadTuplesFrom(serializeIn, NULL, NULL);
+    commit();
+    EXPECT_EQ(20, restored->activeTupleCount());
+    EXPECT_EQ(2, restored->dictionarySize());
+    EXPECT_EQ(restored->dictionaryMemorySize(), restored->nonInlinedMemorySize());
+    EXPECT_EQ(table->nonInlinedMemorySize(), restored->nonInlinedMemorySize());
+    TableTuple restoredTuple(restored->schema());
+    TableIterator restoredIterator = restored->iterator();
+    while (restoredIterator.next(restoredTuple)) {
+        int64_t key = voltdb::ValuePeeker::peekBigInt(restoredTuple.getNValue(0));
+        EXPECT_EQ(0, restoredTuple.getNValue(1).compare(stringNValues[key % 3]));
+    }
+}
+
+TEST_F(PersistentTableTest, ZoneMaps) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_BIGINT, false);
+    builder.setColumnAtIndex(1, VALUE_TYPE_INTEGER, true);
+    std::vector<std::string> columnNames;
+    columnNames.push_back("TS");
+    columnNames.push_back("N");
+    char signature[20];
+    // Small blocks, so the table spans a few of them
+    boost::scoped_ptr<PersistentTable> table(dynamic_cast<PersistentTable*>(
+        TableFactory::getPersistentTable(0, "Z", builder.build(), columnNames, signature,
+                                         false, -1, false, false, 4096)));
+    std::vector<int> zoneMapColumns;
+    zoneMapColumns.push_back(0);
+    zoneMapColumns.push_back(1);
+    table->setZoneMapColumns(zoneMapColumns);
+    ASSERT_EQ(2, table->zoneMapColumns().size());
+
+    // TS ascends with the insertion order and N is NULL in the first rows
+    const int tuplesToInsert = 3000;
+    voltdb::StandAloneTupleStorage storage(table->schema());
+    TableTuple &srcTuple = const_cast<TableTuple&>(storage.tuple());
+    beginWork();
+    for (int i = 0; i < tuplesToInsert; ++i) {
+        srcTuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        srcTuple.setNValue(1, i < 600 ? NValue::getNullValue(VALUE_TYPE_INTEGER) :
+                           ValueFactory::getIntegerValue(i));
+        table->insertTuple(srcTuple);
+    }
+    commit();
+    ASSERT_TRUE(table->allocatedBlockCount() > 4);
+
+    boost::scoped_ptr<AbstractExpression> recent(
+        new voltdb::ComparisonExpression<voltdb::CmpGte>(
+            voltdb::EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+            new voltdb::TupleValueExpression(0, 0),
+            new voltdb::ConstantValueExpression(ValueFactory::getBigIntValue(2500))));
+    // 100 > TS, with the column on the right
+    boost::scoped_ptr<AbstractExpression> early(
+        new voltdb::ComparisonExpression<voltdb::CmpGt>(
+            voltdb::EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+            new voltdb::ConstantValueExpression(ValueFactory::getBigIntValue(100)),
+            new voltdb::TupleValueExpression(0, 0)));
+    boost::scoped_ptr<AbstractExpression> nullN(
+        new voltdb::OperatorIsNullExpression(new voltdb::TupleValueExpression(0, 1)));
+
+    int64_t blocksSkipped;
+    EXPECT_EQ(500, countWithZoneMaps(table.get(), recent.get(), &blocksSkipped));
+    EXPECT_TRUE(blocksSkipped > 0);
+    EXPECT_EQ(100, countWithZoneMaps(table.get(), early.get(), &blocksSkipped));
+    EXPECT_TRUE(blocksSkipped > 0);
+    EXPECT_EQ(600, countWithZoneMaps(table.get(), nullN.get(), &blocksSkipped));
+    EXPECT_TRUE(blocksSkipped > 0);
+
+    // Delete the rows with NULLs and every other row, which compacts the
+    // table on commit; the summaries have to follow the moved tuples
+    size_t blockCount = table->allocatedBlockCount();
+    beginWork();
+    TableTuple tuple(table->schema());
+    TableIterator iterator = table->iterator();
+    std::vector<TableTuple> doomed;
+    while (iterator.next(tuple)) {
+        int64_t ts = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(0));
+        if (ts < 600 || ts % 2 == 0) {
+            doomed.push_back(tuple);
+        }
+    }
+    for (int i = 0; i < doomed.size(); ++i) {
+        table->deleteTuple(doomed[i], true);
+    }
+    commit();
+    ASSERT_TRUE(table->allocatedBlockCount() < blockCount);
+
+    EXPECT_EQ(0, countWithZoneMaps(table.get(), nullN.get(), &blocksSkipped));
+    EXPECT_EQ(table->allocatedBlockCount(), blocksSkipped);
+    EXPECT_EQ(250, countWithZoneMaps(table.get(), recent.get(), &blocksSkipped));
+    EXPECT_EQ(0, countWithZoneMaps(table.get(), early.get(), &blocksSkipped));
+
+    // Move one early row past the others
+    beginWork();
+    iterator = table->iterator();
+    do {
+        ASSERT_TRUE(iterator.next(tuple));
+    } while (voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(0)) != 601);
+    TableTuple &tempTuple = table->copyIntoTempTuple(tuple);
+    tempTuple.setNValue(0, ValueFactory::getBigIntValue(10000));
+    table->updateTupleWithSpecificIndexes(tuple, tempTuple, table->allIndexes());
+    commit();
+    EXPECT_EQ(251, countWithZoneMaps(table.get(), recent.get(), &blocksSkipped));
+}
+
+TEST_F(PersistentTableTest, TimeToLive) {
+    // Rows 0 to 499 are older than 100 seconds at 600 seconds,
+    // and 50 of them have a NULL timestamp
+    const int64_t now = 600 * 1000000LL;
+    const int64_t cutoff = 500 * 1000000LL;
+
+    // Without an index, the table is scanned
+    boost::scoped_ptr<PersistentTable> scanned(createExpiringTable("SCANNED", 1000));
+    EXPECT_EQ(0, scanned->expireTuples(now, 1000));
+    scanned->setTimeToLive(0, 100 * 1000000LL);
+    std::vector<int> zoneMapColumns(1, 0);
+    scanned->setZoneMapColumns(zoneMapColumns);
+    beginWork();
+    EXPECT_EQ(300, scanned->expireTuples(now, 300));
+    commit();
+    EXPECT_EQ(700, scanned->activeTupleCount());
+    beginWork();
+    EXPECT_EQ(150, scanned->expireTuples(now, 300));
+    EXPECT_EQ(0, scanned->expireTuples(now, 300));
+    commit();
+    EXPECT_EQ(550, scanned->activeTupleCount());
+    EXPECT_EQ(450, scanned->expiredTupleCount());
+    checkExpired(scanned.get(), cutoff);
+
+    // With an index led by the timestamp, the oldest go first
+    boost::scoped_ptr<PersistentTable> indexed(createExpiringTable("INDEXED", 1000));
+    std::vector<int> columnIndices;
+    columnIndices.push_back(0);
+    columnIndices.push_back(1);
+    TableIndexScheme scheme("TS_ID", voltdb::BALANCED_TREE_INDEX,
+                            columnIndices, TableIndex::simplyIndexColumns(),
+                            true, true, indexed->schema());
+    indexed->addIndex(TableIndexFactory::getInstance(scheme));
+    indexed->setTimeToLive(0, 100 * 1000000LL);
+    beginWork();
+    EXPECT_EQ(300, indexed->expireTuples(now, 300));
+    commit();
+    checkExpired(indexed.get(), (300 + 300 / 9) * 1000000LL);
+
+    // Expiring is undone with the rest of the transaction
+    beginWork();
+    EXPECT_EQ(150, indexed->expireTuples(now, 300));
+    rollback();
+    EXPECT_EQ(700, indexed->activeTupleCount());
+    EXPECT_EQ(700, indexed->allIndexes()[0]->getSize());
+
+    beginWork();
+    EXPECT_EQ(150, indexed->expireTuples(now, 300));
+    EXPECT_EQ(0, indexed->expireTuples(now, 300));
+    commit();
+    EXPECT_EQ(550, indexed->activeTupleCount());
+    EXPECT_EQ(550, indexed->allIndexes()[0]->getSize());
+    checkExpired(indexed.get(), cutoff);
+
+    // Once nothing expires, only a later cutoff or an older tuple finds more
+    voltdb::StandAloneTupleStorage storage(indexed->schema());
+    TableTuple &old = const_cast<TableTuple&>(storage.tuple());
+    old.setNValue(0, ValueFactory::getTimestampValue(1000000LL));
+    old.setNValue(1, ValueFactory::getBigIntValue(1000));
+    PersistentTable* tables[] = { scanned.get(), indexed.get() };
+    for (int i = 0; i < 2; ++i) {
+        PersistentTable* table = tables[i];
+        beginWork();
+        EXPECT_EQ(0, table->expireTuples(now, 300));
+        table->insertTuple(old);
+        EXPECT_EQ(1, table->expireTuples(now, 300));
+        EXPECT_EQ(90, table->expireTuples(now + 100 * 1000000LL, 300));
+        commit();
+        EXPECT_EQ(460, table->activeTupleCount());
+        checkExpired(table, cutoff + 100 * 1000000LL);
+    }
+}
+
+TEST_F(PersistentTableTest, AntiCache) {
+    // Any limit evicts every block that is cold
+    AntiCache::setEnabled("/tmp", 1);
+    boost::scoped_ptr<PersistentTable> table(createExpiringTable("COLD", 2000));
+    std::vector<int> columnIndices(1, 1);
+    TableIndexScheme scheme("ID", voltdb::BALANCED_TREE_INDEX,
+                            columnIndices, TableIndex::simplyIndexColumns(),
+                            true, true, table->schema());
+    table->addIndex(TableIndexFactory::getInstance(scheme));
+
+    // Nothing is cold until the clock moves past the inserts
+    std::vector<TBPtr> blocks;
+    table->collectEvictableBlocks(blocks);
+    EXPECT_EQ(0, blocks.size());
+    AntiCache::advanceClock((AntiCache::clock() + 1) * AntiCache::CLOCK_PERIOD_MILLIS);
+    // The clock only moves forward, whichever site's tick reports the time
+    const int64_t now = AntiCache::clock();
+    AntiCache::advanceClock(0);
+    EXPECT_EQ(now, AntiCache::clock());
+    AntiCache::advanceClock(now * AntiCache::CLOCK_PERIOD_MILLIS + AntiCache::CLOCK_PERIOD_MILLIS - 1);
+    EXPECT_EQ(now, AntiCache::clock());
+    table->collectEvictableBlocks(blocks);
+    ASSERT_TRUE(blocks.size() > 2);
+    for (int i = 0; i < blocks.size(); ++i) {
+        table->evictBlock(blocks[i]);
+    }
+    const int64_t evictedBlocks = static_cast<int64_t>(blocks.size());
+    EXPECT_EQ(evictedBlocks, table->evictedBlockCount());
+    EXPECT_EQ(evictedBlocks * table->getTableAllocationSize(), table->evictedTupleMemory());
+    blocks.clear();
+    table->collectEvictableBlocks(blocks);
+    EXPECT_EQ(0, blocks.size());
+
+    // Index lookups read evicted tuples in place
+    TableIndex* index = table->allIndexes()[0];
+    voltdb::IndexCursor cursor(index->getTupleSchema());
+    voltdb::StandAloneTupleStorage storage(table->schema());
+    TableTuple &searchTuple = const_cast<TableTuple&>(storage.tuple());
+    searchTuple.setNValue(1, ValueFactory::getBigIntValue(1234));
+    ASSERT_TRUE(index->moveToKeyByTuple(&searchTuple, cursor));
+    TableTuple found = index->nextValueAtKey(cursor);
+    EXPECT_EQ(1234000000LL, voltdb::ValuePeeker::peekTimestamp(found.getNValue(0)));
+    EXPECT_EQ(evictedBlocks, table->evictedBlockCount());
+    EXPECT_EQ(0, table->fetchedBlockCount());
+
+    // A scan brings every block back
+    TableTuple tuple(table->schema());
+    TableIterator iterator = table->iterator();
+    int64_t sum = 0;
+    while (iterator.next(tuple)) {
+        sum += voltdb::ValuePeeker::peekBigInt(tuple.getNValue(1));
+    }
+    EXPECT_EQ(2000 * 1999 / 2, sum);
+    EXPECT_EQ(0, table->evictedBlockCount());
+    EXPECT_EQ(evictedBlocks, table->fetchedBlockCount());
+    AntiCache::setEnabled("", 0);
+}
+
+TEST_F(PersistentTableTest, AdaptiveBlockSizes) {
+    // Blocks start at about 1KB rather than the default 2MB
+    PersistentTable::setMinimumBlockSize(1024);
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_BIGINT, false);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT, false);
+    std::vector<std::string> columnNames;
+    columnNames.push_back("ID");
+    columnNames.push_back("N");
+    char signature[20];
+    boost::scoped_ptr<PersistentTable> table(dynamic_cast<PersistentTable*>(
+        TableFactory::getPersistentTable(0, "SMALL", builder.build(), columnNames, signature)));
+    const int64_t tupleLength = table->getTupleLength();
+    const int64_t smallest = 1024 / tupleLength;
+    ASSERT_EQ(1, table->allocatedBlockCount());
+    EXPECT_EQ(smallest, table->allocatedTupleCount());
+    EXPECT_EQ(smallest * tupleLength, table->allocatedTupleMemory());
+
+    // Each new block doubles the capacity
+    voltdb::StandAloneTupleStorage storage(table->schema());
+    TableTuple &srcTuple = const_cast<TableTuple&>(storage.tuple());
+    const int tuplesToInsert = static_cast<int>(smallest * 16);
+    beginWork();
+    for (int i = 0; i < tuplesToInsert; ++i) {
+        srcTuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        srcTuple.setNValue(1, ValueFactory::getBigIntValue(i % 7));
+        table->insertTuple(srcTuple);
+    }
+    commit();
+    EXPECT_EQ(5, table->allocatedBlockCount());
+    EXPECT_EQ(tuplesToInsert, table->allocatedTupleCount());
+    EXPECT_EQ(tuplesToInsert * tupleLength, table->allocatedTupleMemory());
+    EXPECT_TRUE(table->allocatedTupleMemory() < table->getTableAllocationSize());
+
+    // Tuples are found in blocks of every size
+    TableTupleFilter filter;
+    filter.init(table.get());
+    TableTuple tuple(table->schema());
+    TableIterator iterator = table->iterator();
+    int64_t sum = 0;
+    while (iterator.next(tuple)) {
+        sum += voltdb::ValuePeeker::peekBigInt(tuple.getNValue(0));
+        EXPECT_EQ(reinterpret_cast<uint64_t>(tuple.address()),
+                  filter.getTupleAddress(filter.updateTuple(tuple, TableTupleFilter::ACTIVE_TUPLE)));
+    }
+    EXPECT_EQ(static_cast<int64_t>(tuplesToInsert) * (tuplesToInsert - 1) / 2, sum);
+
+    // Emptied blocks give back their own size
+    std::vector<char*> deleted;
+    iterator = table->iterator();
+    while (iterator.next(tuple)) {
+        if (voltdb::ValuePeeker::peekBigInt(tuple.getNValue(0)) < smallest * 2) {
+            deleted.push_back(tuple.address());
+        }
+    }
+    beginWork();
+    for (int i = 0; i < deleted.size(); ++i) {
+        tuple.move(deleted[i]);
+        table->deleteTuple(tuple, true);
+    }
+    commit();
+    EXPECT_EQ(3, table->allocatedBlockCount());
+    EXPECT_EQ(tuplesToInsert - smallest * 2, table->allocatedTupleCount());
+    EXPECT_EQ((tuplesToInsert - smallest * 2) * tupleLength, table->allocatedTupleMemory());
+    PersistentTable::setMinimumBlockSize(0);
+}
+
+TEST_F(PersistentTableTest, BulkIndexing) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_BIGINT, false);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT, false);
+    std::vector<std::string> columnNames;
+    columnNames.push_back("ID");
+    columnNames.push_back("N");
+    char signature[20];
+    boost::scoped_ptr<PersistentTable> table(dynamic_cast<PersistentTable*>(
+        TableFactory::getPersistentTable(0, "BULK", builder.build(), columnNames, signature)));
+    std::vector<int> idColumn(1, 0);
+    std::vector<int> nColumn(1, 1);
+    TableIndex *unique = TableIndexFactory::getInstance(
+        TableIndexScheme("ID", voltdb::BALANCED_TREE_INDEX, idColumn,
+                         TableIndex::simplyIndexColumns(), true, true, table->schema()));
+    TableIndex *tree = TableIndexFactory::getInstance(
+        TableIndexScheme("N_TREE", voltdb::BALANCED_TREE_INDEX, nColumn,
+                         TableIndex::simplyIndexColumns(), false, true, table->schema()));
+    TableIndex *hash = TableIndexFactory::getInstance(
+        TableIndexScheme("N_HASH", voltdb::HASH_TABLE_INDEX, nColumn,
+                         TableIndex::simplyIndexColumns(), false, false, table->schema()));
+    table->addIndex(unique);
+    table->addIndex(tree);
+    table->addIndex(hash);
+
+    // Only the unique index is kept up to date until the end
+    voltdb::StandAloneTupleStorage storage(table->schema());
+    TableTuple &srcTuple = const_cast<TableTuple&>(storage.tuple());
+    beginWork();
+    table->beginBulkIndexing();
+    for (int i = 0; i < 5000; ++i) {
+        srcTuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        srcTuple.setNValue(1, ValueFactory::getBigIntValue((i * 7919) % 100));
+        table->insertTuple(srcTuple);
+    }
+    EXPECT_EQ(5000, unique->getSize());
+    EXPECT_EQ(0, tree->getSize());
+    EXPECT_EQ(0, hash->getSize());
+    table->endBulkIndexing();
+    commit();
+    EXPECT_EQ(5000, tree->getSize());
+    EXPECT_EQ(5000, hash->getSize());
+
+    // A load that cannot report duplicates leaves the unique index too
+    beginWork();
+    table->beginBulkIndexing(true);
+    for (int i = 5000; i < 10000; ++i) {
+        srcTuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        srcTuple.setNValue(1, ValueFactory::getBigIntValue((i * 7919) % 100));
+        table->insertTuple(srcTuple);
+    }
+    EXPECT_EQ(5000, unique->getSize());
+    EXPECT_EQ(5000, tree->getSize());
+    table->endBulkIndexing();
+    commit();
+    EXPECT_EQ(10000, unique->getSize());
+    EXPECT_EQ(10000, tree->getSize());
+    EXPECT_EQ(10000, hash->getSize());
+
+    // An index added to a populated table is built in one pass
+    TableIndex *added = TableIndexFactory::getInstance(
+        TableIndexScheme("N_ADDED", voltdb::BALANCED_TREE_INDEX, nColumn,
+                         TableIndex::simplyIndexColumns(), false, true, table->schema()));
+    table->addIndex(added);
+    EXPECT_EQ(10000, added->getSize());
+    TableTuple tuple(table->schema());
+    TableIterator iterator = table->iterator();
+    while (iterator.next(tuple)) {
+        EXPECT_TRUE(tree->exists(&tuple));
+        EXPECT_TRUE(hash->exists(&tuple));
+        EXPECT_TRUE(added->exists(&tuple));
+    }
+
+    // Every entry can be found again to delete it
+    std::vector<char*> addresses;
+    iterator = table->iterator();
+    while (iterator.next(tuple)) {
+        addresses.push_back(tuple.address());
+    }
+    // A key already in a unique index is skipped, and reported
+    EXPECT_FALSE(unique->addEntries(std::vector<char*>(1, addresses[0])));
+    EXPECT_EQ(10000, unique->getSize());
+    beginWork();
+    for (int i = 0; i < addresses.size(); ++i) {
+        tuple.move(addresses[i]);
+        table->deleteTuple(tuple, true);
+    }
+    commit();
+    EXPECT_EQ(0, unique->getSize());
+    EXPECT_EQ(0, tree->getSize());
+    EXPECT_EQ(0, hash->getSize());
+    EXPECT_EQ(0, added->getSize());
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,280 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include "harness.h"
+#include "structures/CompactingBTree.h"
+#include "structures/CompactingMap.h"
+
+using namespace voltdb;
+
+class IntComparator {
+public:
+    inline int operator()(const int &lhs, const int &rhs) const {
+        if (lhs > rhs) return 1;
+        else if (lhs < rhs) return -1;
+        else return 0;
+    }
+};
+
+typedef NormalKeyValuePair<int, int> IntPair;
+typedef CompactingBTree<IntPair, IntComparator, true> RankedBTree;
+typedef CompactingMap<IntPair, IntComparator, true> RankedMap;
+typedef CompactingBTree<IntPair, IntComparator, false> PlainBTree;
+
+class CompactingBTreeTest : public Test {
+public:
+    // The B+-tree must agree with the red-black tree on every read.
+    template <typename BTree>
+    void checkSame(const BTree &btree, const RankedMap &map, bool ranks) {
+        ASSERT_TRUE(btree.verify());
+        ASSERT_EQ(map.size(), btree.size());
+        ASSERT_EQ(map.size() == 0, btree.bytesAllocated() == 0);
+
+        typename BTree::iterator bi = btree.begin();
+        RankedMap::iterator mi = map.begin();
+        int64_t rank = 1;
+        while (!mi.isEnd()) {
+            ASSERT_FALSE(bi.isEnd());
+            ASSERT_EQ(mi.key(), bi.key());
+            ASSERT_EQ(mi.value(), bi.value());
+            if (ranks) {
+                ASSERT_EQ(map.rankAsc(mi.key()), btree.rankAsc(bi.key()));
+                ASSERT_EQ(map.rankUpper(mi.key()), btree.rankUpper(bi.key()));
+                ASSERT_EQ(mi.key(), btree.findRank(rank).key());
+                ASSERT_EQ(mi.value(), btree.findRank(rank).value());
+                ASSERT_EQ(rank, map.rankOf(mi));
+                ASSERT_EQ(rank, btree.rankOf(bi));
+            }
+            mi.moveNext();
+            bi.moveNext();
+            ++rank;
+        }
+        ASSERT_TRUE(bi.isEnd());
+        if (ranks) {
+            ASSERT_TRUE(btree.findRank(rank).isEnd());
+            ASSERT_TRUE(btree.findRank(0).isEnd());
+            ASSERT_EQ(-1, btree.rankOf(bi));
+        }
+
+        // Backwards, through the leaf chain
+        bi = btree.rbegin();
+        mi = map.rbegin();
+        while (!mi.isEnd()) {
+            ASSERT_FALSE(bi.isEnd());
+            ASSERT_EQ(mi.value(), bi.value());
+            mi.movePrev();
+            bi.movePrev();
+        }
+        ASSERT_TRUE(bi.isEnd());
+    }
+
+    template <typename BTree>
+    void checkBounds(const BTree &btree, const RankedMap &map, int key) {
+        checkSameIterator(btree.lowerBound(key), map.lowerBound(key));
+        checkSameIterator(btree.upperBound(key), map.upperBound(key));
+        checkSameIterator(btree.find(key), map.find(key));
+        if (map.find(key).isEnd()) {
+            ASSERT_EQ(-1, btree.rankAsc(key));
+        }
+    }
+
+    template <typename Iterator>
+    void checkSameIterator(Iterator bi, RankedMap::iterator mi) {
+        ASSERT_EQ(mi.isEnd(), bi.isEnd());
+        if (!mi.isEnd()) {
+            ASSERT_EQ(mi.key(), bi.key());
+            ASSERT_EQ(mi.value(), bi.value());
+        }
+    }
+};
+
+TEST_F(CompactingBTreeTest, Empty) {
+    RankedBTree btree(true, IntComparator());
+    ASSERT_TRUE(btree.verify());
+    ASSERT_TRUE(btree.begin().isEnd());
+    ASSERT_TRUE(btree.rbegin().isEnd());
+    ASSERT_TRUE(btree.find(1).isEnd());
+    ASSERT_TRUE(btree.lowerBound(1).isEnd());
+    ASSERT_TRUE(btree.upperBound(1).isEnd());
+    ASSERT_TRUE(btree.findRank(1).isEnd());
+    ASSERT_EQ(-1, btree.rankAsc(1));
+    ASSERT_FALSE(btree.erase(1));
+    ASSERT_TRUE(btree.bytesAllocated() == 0);
+}
+
+TEST_F(CompactingBTreeTest, UniqueInsertsAndDeletes) {
+    RankedBTree btree(true, IntComparator());
+    RankedMap map(true, IntComparator());
+    srand(0);
+    // Enough entries for a few levels of inner nodes
+    for (int ii = 0; ii < 20000; ++ii) {
+        int val = rand() % 10000;
+        const int *conflict = btree.insert(val, ii);
+        const int *expected = map.insert(val, ii);
+        ASSERT_EQ(expected == NULL, conflict == NULL);
+        if (conflict) {
+            ASSERT_EQ(*expected, *conflict);
+        }
+    }
+    checkSame(btree, map, true);
+    for (int key = -1; key <= 10000; key += 7) {
+        checkBounds(btree, map, key);
+    }
+
+    for (int ii = 0; ii < 20000; ++ii) {
+        int val = rand() % 10000;
+        ASSERT_EQ(map.erase(val), btree.erase(val));
+        if (ii % 1000 == 0) {
+            checkSame(btree, map, true);
+        }
+    }
+    checkSame(btree, map, true);
+
+    // Emptying the tree gives back all of its memory
+    while (btree.size() > 0) {
+        RankedBTree::iterator iter = btree.begin();
+        ASSERT_TRUE(btree.erase(iter));
+    }
+    ASSERT_TRUE(btree.verify());
+    ASSERT_TRUE(btree.bytesAllocated() == 0);
+}
+
+TEST_F(CompactingBTreeTest, Duplicates) {
+    RankedBTree btree(false, IntComparator());
+    RankedMap map(false, IntComparator());
+    srand(1);
+    for (int ii = 0; ii < 10000; ++ii) {
+        // Runs of equal keys that span several leaves
+        int val = rand() % 50;
+        ASSERT_TRUE(btree.insert(val, ii) == NULL);
+        ASSERT_TRUE(map.insert(val, ii) == NULL);
+    }
+    checkSame(btree, map, true);
+    for (int key = -1; key <= 50; ++key) {
+        checkBounds(btree, map, key);
+    }
+
+    for (int ii = 0; ii < 9000; ++ii) {
+        int val = rand() % 50;
+        ASSERT_EQ(map.erase(val), btree.erase(val));
+    }
+    checkSame(btree, map, true);
+}
+
+TEST_F(CompactingBTreeTest, Mixed) {
+    PlainBTree btree(true, IntComparator());
+    RankedMap map(true, IntComparator());
+    srand(2);
+    for (int ii = 0; ii < 50000; ++ii) {
+        int val = rand() % 2000;
+        if (rand() % 3 == 0) {
+            ASSERT_EQ(map.erase(val), btree.erase(val));
+        }
+        else {
+            ASSERT_EQ(map.insert(val, val) == NULL, btree.insert(val, val) == NULL);
+        }
+        if (ii % 5000 == 0) {
+            checkSame(btree, map, false);
+        }
+    }
+    checkSame(btree, map, false);
+
+    // Values can be updated in place
+    for (PlainBTree::iterator iter = btree.begin(); !iter.isEnd(); iter.moveNext()) {
+        iter.setValue(iter.key() * 2);
+    }
+    PlainBTree::iterator iter = btree.find(map.begin().key());
+    ASSERT_EQ(map.begin().key() * 2, iter.value());
+}
+
+TEST_F(CompactingBTreeTest, BulkInsert) {
+    RankedBTree btree(true, IntComparator());
+    RankedMap map(true, IntComparator());
+    srand(3);
+    // Building from nothing, then merging in a bigger batch, then
+    // adding a batch too small to be worth a rebuild
+    const int batches[] = { 3000, 5000, 100 };
+    for (int batch = 0; batch < 3; ++batch) {
+        std::vector<IntPair> entries;
+        for (int ii = 0; ii < batches[batch]; ++ii) {
+            int val = rand() % 20000;
+            entries.push_back(IntPair(val, ii));
+            map.insert(val, ii);
+        }
+        int64_t before = btree.size();
+        ASSERT_EQ(map.size() - before, btree.bulkInsert(entries));
+        checkSame(btree, map, true);
+    }
+    for (int key = -1; key <= 20000; key += 13) {
+        checkBounds(btree, map, key);
+    }
+
+    // Still a valid tree to insert into and erase from
+    for (int ii = 0; ii < 20000; ++ii) {
+        int val = rand() % 20000;
+        if (rand() % 2 == 0) {
+            ASSERT_EQ(map.erase(val), btree.erase(val));
+        }
+        else {
+            ASSERT_EQ(map.insert(val, val) == NULL, btree.insert(val, val) == NULL);
+        }
+    }
+    checkSame(btree, map, true);
+
+    // Duplicates are kept in a non-unique tree
+    RankedBTree multi(false, IntComparator());
+    RankedMap multiMap(false, IntComparator());
+    std::vector<IntPair> entries;
+    for (int ii = 0; ii < 5000; ++ii) {
+        entries.push_back(IntPair(ii % 40, ii));
+        multiMap.insert(ii % 40, ii);
+    }
+    ASSERT_EQ(5000, multi.bulkInsert(entries));
+    checkSame(multi, multiMap, true);
+}
+
+TEST_F(CompactingBTreeTest, IteratorsStopAtTheEnds) {
+    PlainBTree btree(true, IntComparator());
+    for (int ii = 0; ii < 1000; ++ii) {
+        btree.insert(ii, ii);
+    }
+    PlainBTree::iterator iter = btree.begin();
+    iter.movePrev();
+    ASSERT_TRUE(iter.isEnd());
+    iter.moveNext();
+    ASSERT_TRUE(iter.isEnd());
+
+    iter = btree.rbegin();
+    ASSERT_EQ(999, iter.key());
+    iter.moveNext();
+    ASSERT_TRUE(iter.isEnd());
+    ASSERT_TRUE(iter.equals(btree.upperBound(999)));
+    ASSERT_TRUE(iter.equals(PlainBTree::iterator()));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
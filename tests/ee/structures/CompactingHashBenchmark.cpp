@@ -0,0 +1,99 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Measures the latency of individual inserts into a CompactingHashTable
+ * keyed like a unique hash index, to show how long the slowest inserts
+ * (the ones that resize the table) hold up the site thread.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <time.h>
+#include <vector>
+
+#include "harness.h"
+#include "structures/CompactingHashTable.h"
+
+using namespace voltdb;
+using namespace std;
+
+int64_t getNanosNow() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void printPercentile(const std::vector<int64_t>& sorted, double percentile) {
+    size_t index = static_cast<size_t>(percentile / 100.0 * static_cast<double>(sorted.size() - 1));
+    std::cout << "  p" << percentile << ": " << sorted[index] << " ns" << std::endl;
+}
+
+void benchmarkInsertLatency(int64_t rows, bool unique) {
+    CompactingHashTable<uint64_t, uint64_t> table(unique);
+    std::vector<int64_t> latencies(rows);
+    int64_t resizes = 0;
+    bool resizing = false;
+
+    int64_t start = getNanosNow();
+    for (int64_t i = 0; i < rows; i++) {
+        // Scrambled but distinct keys, or about four of each for the multimap
+        uint64_t key = static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL;
+        if (!unique) {
+            key = static_cast<uint64_t>(rand()) % (rows / 4 + 1);
+        }
+        int64_t before = getNanosNow();
+        table.insert(key, i);
+        latencies[i] = getNanosNow() - before;
+        if (table.isResizing() && !resizing) {
+            ++resizes;
+        }
+        resizing = table.isResizing();
+    }
+    int64_t total = getNanosNow() - start;
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "Benchmark: " << (unique ? "unique" : "multimap") << " inserts, " << rows
+              << " rows, " << resizes << " resizes, " << total / 1000 << " microseconds total" << std::endl;
+    printPercentile(latencies, 50);
+    printPercentile(latencies, 99);
+    printPercentile(latencies, 99.99);
+    std::cout << "  max: " << latencies.back() << " ns" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    if ((argc > 1 && *argv[1] == '-') || argc <= 1) {
+        printf("To run a benchmark, execute %s with command line arguments: ("
+                "rows<int>)\n",
+                argv[0]);
+        return 0;
+    }
+    int64_t rows = std::atol(argv[1]);
+
+    srand(static_cast<unsigned int>(getNanosNow() % 1000000));
+    benchmarkInsertLatency(rows, true);
+    benchmarkInsertLatency(rows, false);
+    return 0;
+}
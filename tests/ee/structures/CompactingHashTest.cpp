@@ -301,6 +301,49 @@ TEST_F(CompactingHashTest, ShrinkAndGrowMulti) {
     volt.verify();
 }
 
+TEST_F(CompactingHashTest, IncrementalResize) {
+    voltdb::CompactingHashTable<uint64_t,uint64_t> volt(false);
+
+    // Grow until a resize starts, then check that everything can still
+    // be found, added and removed while the old buckets are moved over
+    uint64_t keys = 0;
+    while (!volt.isResizing()) {
+        ASSERT_TRUE(volt.insert(keys, keys) == NULL);
+        ++keys;
+    }
+    ASSERT_TRUE(volt.verify());
+    for (uint64_t i = 0; i < keys; i++) {
+        ASSERT_FALSE(volt.find(i).isEnd());
+    }
+    int operations = 0;
+    while (volt.isResizing()) {
+        // A duplicate, and a delete of an older key
+        ASSERT_TRUE(volt.insert(operations, keys + operations) == NULL);
+        ASSERT_TRUE(volt.erase(keys - 1 - operations, keys - 1 - operations));
+        if (operations % 100 == 0) {
+            ASSERT_TRUE(volt.verify());
+        }
+        ++operations;
+    }
+    ASSERT_TRUE(operations > 1);
+    ASSERT_TRUE(volt.verify());
+    ASSERT_EQ(keys, volt.size());
+    for (uint64_t i = 0; i < operations; i++) {
+        ASSERT_FALSE(volt.find(i, keys + i).isEnd());
+        ASSERT_TRUE(volt.find(keys - 1 - i).isEnd());
+    }
+
+    // Shrink back down, which also moves buckets a few at a time
+    for (uint64_t i = 0; i < keys - operations; i++) {
+        ASSERT_TRUE(volt.erase(i, i));
+    }
+    for (uint64_t i = 0; i < operations; i++) {
+        ASSERT_TRUE(volt.erase(i, keys + i));
+    }
+    ASSERT_TRUE(volt.verify());
+    ASSERT_EQ(0, volt.size());
+}
+
 TEST_F(CompactingHashTest, Benchmark) {
     const int ITERATIONS = 10000;
 
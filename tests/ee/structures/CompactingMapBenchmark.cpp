@@ -32,6 +32,7 @@
 
 #include "harness.h"
 #include "structures/CompactingMap.h"
+#include "structures/CompactingBTree.h"
 #include "structures/CompactingHashTable.h"
 
 using namespace voltdb;
@@ -79,6 +80,7 @@ int* getRandomValues(int size, int max) {
 #define VoltHash 2
 #define STLMap 3
 #define BoostUnorderedMap 4
+#define VoltBTree 5
 std::string mapCategoryToString(int mapCategory) {
     switch(mapCategory) {
     case VoltMap:
@@ -89,6 +91,8 @@ std::string mapCategoryToString(int mapCategory) {
         return "STLMap";
     case BoostUnorderedMap:
         return "BoostUnorderedMap";
+    case VoltBTree:
+        return "VoltBTree";
     default:
         return "invalid";
     }
@@ -135,7 +139,8 @@ private:
 
 void resultPrinter(std::string name, int scale,
         BenchmarkRecorder benVoltMap, BenchmarkRecorder benStl,
-        BenchmarkRecorder benBoost, BenchmarkRecorder benVoltHash) {
+        BenchmarkRecorder benBoost, BenchmarkRecorder benVoltHash,
+        BenchmarkRecorder benVoltBTree) {
     std::cout << "Benchmark: " << name << ", scale size " << scale << "\n";
 
     std::vector<BenchmarkRecorder> result;
@@ -143,6 +148,7 @@ void resultPrinter(std::string name, int scale,
     result.push_back(benStl);
     result.push_back(benBoost);
     result.push_back(benVoltHash);
+    result.push_back(benVoltBTree);
 
     for (int i = 0; i < result.size(); i++) {
         BenchmarkRecorder ben = result[i];
@@ -168,7 +174,8 @@ void BenchmarkRun(
         bool runVoltMap,
         bool runStlMap,
         bool runBoostMap,
-        bool runVoltHash) {
+        bool runVoltHash,
+        bool runVoltBTree) {
     int BIGGEST_VAL = DATA_SCALE;
     int ITERATIONS = DATA_SCALE / 10; // for 10% LOOK UP and DELETE
 
@@ -185,6 +192,7 @@ void BenchmarkRun(
             "runStlMap = %s\n"
             "runBoostMap = %s\n"
             "runVoltHash = %s\n"
+            "runVoltBTree = %s\n"
             "=============\n",
             DATA_SCALE,
             SLEEP_IN_SECONDS,
@@ -196,7 +204,8 @@ void BenchmarkRun(
             interpret(runVoltMap),
             interpret(runStlMap),
             interpret(runBoostMap),
-            interpret(runVoltHash)
+            interpret(runVoltHash),
+            interpret(runVoltBTree)
     );
 
     string str;
@@ -209,12 +218,14 @@ void BenchmarkRun(
 
     boost::unordered_multimap<int, int> boostMap;
     voltdb::CompactingHashTable<int,int> voltHash(false);
+    voltdb::CompactingBTree<NormalKeyValuePair<int, int>, IntComparator, false> voltBTree(false, IntComparator());
 
     // Iterators
     voltdb::CompactingMap<NormalKeyValuePair<int, int>, IntComparator, false>::iterator iter_volt_map;
     std::multimap<int, int>::const_iterator iter_stl;
     boost::unordered_multimap<int,int>::iterator iter_boost_map;
     voltdb::CompactingHashTable<int,int>::iterator iter_volt_hash;
+    voltdb::CompactingBTree<NormalKeyValuePair<int, int>, IntComparator, false>::iterator iter_volt_btree;
 
     //
     // INSERT the data
@@ -223,7 +234,8 @@ void BenchmarkRun(
     sleep(SLEEP_IN_SECONDS);
 
     {
-        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash);
+        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash),
+                benVoltBTree(VoltBTree);
         if (runVoltMap) {
             benVoltMap.start();
             for (int i = 0; i < DATA_SCALE; i++) {
@@ -233,6 +245,15 @@ void BenchmarkRun(
             benVoltMap.stop();
         }
 
+        if (runVoltBTree) {
+            benVoltBTree.start();
+            for (int i = 0; i < DATA_SCALE; i++) {
+                int val = input[i];
+                voltBTree.insert(val, val);
+            }
+            benVoltBTree.stop();
+        }
+
         if (runStlMap) {
             benStl.start();
             for (int i = 0; i < DATA_SCALE; i++) {
@@ -260,14 +281,15 @@ void BenchmarkRun(
             benVoltHash.stop();
         }
 
-        resultPrinter("INSERT", DATA_SCALE, benVoltMap, benStl, benBoost, benVoltHash);
+        resultPrinter("INSERT", DATA_SCALE, benVoltMap, benStl, benBoost, benVoltHash, benVoltBTree);
     }
 
     //
     // SCAN
     //
     if (runScan) {
-        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash);
+        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash),
+                benVoltBTree(VoltBTree);
 
         printf("Preparing to run SCAN benchmark in %d seconds...\n", SLEEP_IN_SECONDS);
         sleep(SLEEP_IN_SECONDS);
@@ -279,6 +301,7 @@ void BenchmarkRun(
             // clean up
             if (i == WARM_UP) {
                 benVoltMap.reset();
+                benVoltBTree.reset();
                 benStl.reset();
                 printf("Finish warm up...\n");
             }
@@ -292,6 +315,15 @@ void BenchmarkRun(
                 benVoltMap.stop();
             }
 
+            if (runVoltBTree) {
+                iter_volt_btree = voltBTree.begin();
+                benVoltBTree.start();
+                while(! iter_volt_btree.isEnd()) {
+                    iter_volt_btree.moveNext();
+                }
+                benVoltBTree.stop();
+            }
+
             if (runStlMap) {
                 iter_stl = stlMap.begin();
                 benStl.start();
@@ -301,14 +333,15 @@ void BenchmarkRun(
                 benStl.stop();
             }
         }
-        resultPrinter("SCAN", DATA_SCALE, benVoltMap, benStl, benBoost, benVoltHash);
+        resultPrinter("SCAN", DATA_SCALE, benVoltMap, benStl, benBoost, benVoltHash, benVoltBTree);
     }
 
     //
     // SCAN WITHOUT END CHECK
     //
     if (runScanNoEndCheck) {
-        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash);
+        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash),
+                benVoltBTree(VoltBTree);
         printf("Preparing to run Scan benchmark without END() function call in %d seconds...\n", SLEEP_IN_SECONDS);
         sleep(SLEEP_IN_SECONDS);
 
@@ -316,6 +349,7 @@ void BenchmarkRun(
             // clean up
             if (i == WARM_UP) {
                 benVoltMap.reset();
+                benVoltBTree.reset();
                 benStl.reset();
                 printf("Finish warm up...\n");
             }
@@ -330,6 +364,15 @@ void BenchmarkRun(
                 benVoltMap.stop();
             }
 
+            if (runVoltBTree) {
+                iter_volt_btree = voltBTree.begin();
+                benVoltBTree.start();
+                for (int i = 0; i < DATA_SCALE; i++) {
+                    iter_volt_btree.moveNext();
+                }
+                benVoltBTree.stop();
+            }
+
             if (runStlMap) {
                 iter_stl = stlMap.begin();
                 benStl.start();
@@ -339,7 +382,7 @@ void BenchmarkRun(
                 benStl.stop();
             }
         }
-        resultPrinter("SCAN without END() factor", DATA_SCALE, benVoltMap, benStl, benBoost, benVoltHash);
+        resultPrinter("SCAN without END() factor", DATA_SCALE, benVoltMap, benStl, benBoost, benVoltHash, benVoltBTree);
     }
 
 
@@ -347,7 +390,8 @@ void BenchmarkRun(
     // LOOKUP
     //
     if (runLookup) {
-        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash);
+        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash),
+                benVoltBTree(VoltBTree);
         int* keys = getRandomValues(ITERATIONS, BIGGEST_VAL);
 
         printf("Preparing to run LOOKUP benchmark in %d seconds...\n", SLEEP_IN_SECONDS);
@@ -357,6 +401,7 @@ void BenchmarkRun(
             // clean up
             if (i == WARM_UP) {
                 benVoltMap.reset();
+                benVoltBTree.reset();
                 benStl.reset();
                 benBoost.reset();
                 benVoltHash.reset();
@@ -372,6 +417,15 @@ void BenchmarkRun(
                 benVoltMap.stop();
             }
 
+            if (runVoltBTree) {
+                benVoltBTree.start();
+                for (int i = 0; i< ITERATIONS; i++) {
+                    int val = keys[i];
+                    iter_volt_btree = voltBTree.find(val);
+                }
+                benVoltBTree.stop();
+            }
+
             if (runStlMap) {
                 benStl.start();
                 for (int i = 0; i< ITERATIONS; i++) {
@@ -399,14 +453,15 @@ void BenchmarkRun(
                 benVoltHash.stop();
             }
         }
-        resultPrinter("LOOKUP", ITERATIONS, benVoltMap, benStl, benBoost, benVoltHash);
+        resultPrinter("LOOKUP", ITERATIONS, benVoltMap, benStl, benBoost, benVoltHash, benVoltBTree);
     }
 
     //
     // DELETE
     //
     if (runDelete) {
-        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash);
+        BenchmarkRecorder benVoltMap(VoltMap), benStl(STLMap), benBoost(BoostUnorderedMap), benVoltHash(VoltHash),
+                benVoltBTree(VoltBTree);
         int* deletes = getRandomValues(ITERATIONS, BIGGEST_VAL);
         printf("Preparing to run DELETE benchmark in %d seconds...\n", SLEEP_IN_SECONDS);
         sleep(SLEEP_IN_SECONDS);
@@ -420,6 +475,15 @@ void BenchmarkRun(
             benVoltMap.stop();
         }
 
+        if (runVoltBTree) {
+            benVoltBTree.start();
+            for (int i = 0; i< ITERATIONS; i++) {
+                int val = deletes[i];
+                voltBTree.erase(val);
+            }
+            benVoltBTree.stop();
+        }
+
         if (runStlMap) {
             benStl.start();
             for (int i = 0; i< ITERATIONS; i++) {
@@ -447,7 +511,7 @@ void BenchmarkRun(
             benVoltHash.stop();
         }
 
-        resultPrinter("DELETE", ITERATIONS, benVoltMap, benStl, benBoost, benVoltHash);
+        resultPrinter("DELETE", ITERATIONS, benVoltMap, benStl, benBoost, benVoltHash, benVoltBTree);
     }
 
     // still holds the data before the destructor gets called
@@ -468,15 +532,16 @@ void BenchmarkRunWrapper(int DATA_SCALE, int SLEEP_IN_SECONDS, int READON_OPS_RE
     if (len > ++i) runLookup = params.at(i);
     if (len > ++i) runDelete = params.at(i);
 
-    bool runVoltMap = true, runStlMap=false, runBoostMap=false, runVoltHash=false;
+    bool runVoltMap = true, runStlMap=false, runBoostMap=false, runVoltHash=false, runVoltBTree=false;
     if (len > ++i) runVoltMap = params.at(i);
     if (len > ++i) runStlMap = params.at(i);
     if (len > ++i) runBoostMap = params.at(i);
     if (len > ++i) runVoltHash = params.at(i);
+    if (len > ++i) runVoltBTree = params.at(i);
 
     BenchmarkRun(DATA_SCALE, SLEEP_IN_SECONDS, READON_OPS_REPEAT,
             runScan, runScanNoEndCheck, runLookup, runDelete,
-            runVoltMap, runStlMap, runBoostMap, runVoltHash);
+            runVoltMap, runStlMap, runBoostMap, runVoltHash, runVoltBTree);
 }
 
 bool isTrue(char* arg) {
@@ -505,7 +570,8 @@ int main(int argc, char *argv[]) {
                 "runVoltMap<0, 1>, "
                 "runStlMap<0, 1>, "
                 "runBoostMap<0, 1>, "
-                "runVoltHash<0, 1>)\n",
+                "runVoltHash<0, 1>, "
+                "runVoltBTree<0, 1>)\n",
                 argv[0]);
         return 0;
     }
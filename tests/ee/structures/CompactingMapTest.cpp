@@ -27,6 +27,7 @@
 #include <cstdlib>
 #include <cstdio>
 #include <sys/time.h>
+#include <vector>
 #include "harness.h"
 #include "structures/CompactingMap.h"
 #include "common/FixUnusedAssertHack.h"
@@ -497,6 +498,50 @@ TEST_F(CompactingMapTest, Trivial) {
     ASSERT_TRUE(m.verify());
 }
 
+TEST_F(CompactingMapTest, BulkInsert) {
+    typedef voltdb::CompactingMap<NormalKeyValuePair<int, int>, IntComparator, true> RankedMap;
+    RankedMap bulk(true, IntComparator());
+    RankedMap single(true, IntComparator());
+    srand(0);
+    // Empty, then smaller than the batch, then bigger than the batch
+    const int batches[] = { 1, 2, 1000, 1500, 50 };
+    for (int batch = 0; batch < 5; ++batch) {
+        std::vector<NormalKeyValuePair<int, int> > entries;
+        for (int i = 0; i < batches[batch]; ++i) {
+            int val = rand() % 5000;
+            entries.push_back(NormalKeyValuePair<int, int>(val, i));
+            single.insert(val, i);
+        }
+        int64_t before = bulk.size();
+        ASSERT_EQ(single.size() - before, bulk.bulkInsert(entries));
+        ASSERT_TRUE(bulk.verify());
+        ASSERT_TRUE(bulk.verifyRank());
+        ASSERT_EQ(single.size(), bulk.size());
+
+        // The first of equal keys wins, as with insert
+        RankedMap::iterator bi = bulk.begin();
+        RankedMap::iterator si = single.begin();
+        for (int64_t rank = 1; !si.isEnd(); ++rank) {
+            ASSERT_FALSE(bi.isEnd());
+            ASSERT_EQ(si.key(), bi.key());
+            ASSERT_EQ(si.value(), bi.value());
+            ASSERT_EQ(rank, bulk.rankAsc(bi.key()));
+            ASSERT_EQ(rank, bulk.rankOf(bi));
+            si.moveNext();
+            bi.moveNext();
+        }
+        ASSERT_TRUE(bi.isEnd());
+    }
+
+    // Still balanced after erasing through it
+    for (int i = 0; i < 5000; i += 3) {
+        ASSERT_EQ(single.erase(i), bulk.erase(i));
+    }
+    ASSERT_TRUE(bulk.verify());
+    ASSERT_TRUE(bulk.verifyRank());
+    ASSERT_EQ(single.size(), bulk.size());
+}
+
 TEST_F(CompactingMapTest, RandomUnique) {
     const int ITERATIONS = 1001;
     const int BIGGEST_VAL = 100;
@@ -22,6 +22,7 @@
  */
 
 #include "structures/CompactingPool.h"
+#include "common/HugePages.h"
 
 #include "harness.h"
 #include <iostream>
@@ -113,6 +114,58 @@ TEST_F(CompactingPoolTest, bytes_allocated_test)
     }
 }
 
+TEST_F(CompactingPoolTest, huge_pages)
+{
+    HugePages::setEnabled(true);
+    int64_t hugeBefore = HugePages::hugePageBytes();
+    int64_t normalBefore = HugePages::normalPageBytes();
+    {
+        // A bit over a huge page per buffer gets trimmed to one whole page
+        int32_t size = 1000;
+        int32_t num_elements = (HugePages::HUGE_PAGE_SIZE / size) + 10;
+        CompactingPool dut(size, num_elements);
+        char* elem = reinterpret_cast<char*>(dut.malloc(&elem));
+        memset(elem, 7, size);
+        EXPECT_TRUE(dut.getBytesAllocated() <= HugePages::HUGE_PAGE_SIZE);
+        int64_t mapped = (HugePages::hugePageBytes() - hugeBefore) +
+            (HugePages::normalPageBytes() - normalBefore);
+        EXPECT_EQ(static_cast<int64_t>(HugePages::HUGE_PAGE_SIZE), mapped);
+        dut.free(elem);
+
+        // Small buffers keep coming from the heap
+        CompactingPool small(17, 7);
+        elem = reinterpret_cast<char*>(small.malloc(&elem));
+        mapped = (HugePages::hugePageBytes() - hugeBefore) +
+            (HugePages::normalPageBytes() - normalBefore);
+        EXPECT_EQ(static_cast<int64_t>(HugePages::HUGE_PAGE_SIZE), mapped);
+        small.free(elem);
+    }
+    EXPECT_EQ(hugeBefore, HugePages::hugePageBytes());
+    EXPECT_EQ(normalBefore, HugePages::normalPageBytes());
+    HugePages::setEnabled(false);
+}
+
+TEST_F(CompactingPoolTest, release_cached_buffer)
+{
+    int32_t size = 17;
+    int32_t num_elements = 7;
+    CompactingPool dut(size, num_elements);
+    EXPECT_EQ(0, dut.releaseCachedBuffer());
+
+    // Freeing the last element keeps its buffer for the next malloc
+    char* elem = reinterpret_cast<char*>(dut.malloc(&elem));
+    dut.free(elem);
+    EXPECT_EQ(0, dut.getBytesAllocated());
+    EXPECT_EQ((size + CompactingPool::FIXED_OVERHEAD_PER_ENTRY()) * num_elements,
+              dut.releaseCachedBuffer());
+    EXPECT_EQ(0, dut.releaseCachedBuffer());
+
+    elem = reinterpret_cast<char*>(dut.malloc(&elem));
+    EXPECT_EQ((size + CompactingPool::FIXED_OVERHEAD_PER_ENTRY()) * num_elements,
+              dut.getBytesAllocated());
+    dut.free(elem);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,154 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <set>
+#include <stdint.h>
+#include "harness.h"
+#include "structures/CompressedBitmap.h"
+#include "indexes/TupleSlotMap.h"
+
+using namespace voltdb;
+
+class CompressedBitmapTest : public Test {
+public:
+    // The bitmap must hold exactly the values of the set.
+    void checkSame(const CompressedBitmap &bitmap, const std::set<uint32_t> &values) {
+        ASSERT_EQ(static_cast<int64_t>(values.size()), bitmap.cardinality());
+        ASSERT_EQ(values.empty(), bitmap.empty());
+        uint32_t value = 0;
+        bool found = bitmap.nextSlot(0, value);
+        for (std::set<uint32_t>::const_iterator iter = values.begin(); iter != values.end(); ++iter) {
+            ASSERT_TRUE(found);
+            ASSERT_EQ(*iter, value);
+            ASSERT_TRUE(bitmap.contains(value));
+            found = value != 0xFFFFFFFF && bitmap.nextSlot(value + 1, value);
+        }
+        ASSERT_FALSE(found);
+    }
+
+    // Fills a bitmap and a set with count random values below range.
+    void fill(CompressedBitmap &bitmap, std::set<uint32_t> &values, int count, uint32_t range) {
+        for (int i = 0; i < count; i++) {
+            uint32_t value = static_cast<uint32_t>(rand()) % range;
+            ASSERT_EQ(values.insert(value).second, bitmap.add(value));
+        }
+    }
+};
+
+// Adds and removes enough values for containers to turn into bitsets and
+// back into arrays.
+TEST_F(CompressedBitmapTest, AddRemove) {
+    srand(0);
+    CompressedBitmap bitmap;
+    std::set<uint32_t> values;
+    checkSame(bitmap, values);
+
+    // dense in the first container, sparse beyond it
+    fill(bitmap, values, 20000, 1 << 16);
+    fill(bitmap, values, 2000, 1 << 24);
+    ASSERT_TRUE(bitmap.add(0xFFFFFFFF));
+    values.insert(0xFFFFFFFF);
+    checkSame(bitmap, values);
+
+    uint32_t value;
+    ASSERT_TRUE(bitmap.nextSlot(0xFFFFFFFF, value));
+    ASSERT_EQ(0xFFFFFFFF, value);
+
+    for (int i = 0; i < 30000; i++) {
+        uint32_t victim = static_cast<uint32_t>(rand()) % (1 << 16);
+        ASSERT_EQ(values.erase(victim) == 1, bitmap.remove(victim));
+    }
+    checkSame(bitmap, values);
+
+    while ( ! values.empty()) {
+        ASSERT_TRUE(bitmap.remove(*values.begin()));
+        ASSERT_FALSE(bitmap.contains(*values.begin()));
+        values.erase(values.begin());
+    }
+    checkSame(bitmap, values);
+}
+
+// Copies, swaps and clears bitmaps with array and bitset containers.
+TEST_F(CompressedBitmapTest, CopySwapClear) {
+    srand(1);
+    const int counts[] = { 100, 3000, 30000 };
+    for (int left = 0; left < 3; left++) {
+        for (int right = 0; right < 3; right++) {
+            CompressedBitmap lhs, rhs;
+            std::set<uint32_t> lhsValues, rhsValues;
+            fill(lhs, lhsValues, counts[left], 3 << 16);
+            fill(rhs, rhsValues, counts[right], 3 << 16);
+            // a container that only one side has
+            lhs.add(5 << 16);
+            lhsValues.insert(5 << 16);
+
+            CompressedBitmap copy(lhs);
+            checkSame(copy, lhsValues);
+            copy.swap(rhs);
+            checkSame(copy, rhsValues);
+            checkSame(rhs, lhsValues);
+            checkSame(lhs, lhsValues);
+            copy.clear();
+            checkSame(copy, std::set<uint32_t>());
+        }
+    }
+}
+
+// Slots follow block positions, and freed block numbers are reused.
+TEST_F(CompressedBitmapTest, TupleSlotMap) {
+    const uint32_t tupleLength = 8;
+    const uint32_t tuplesPerBlock = 4;
+    TupleSlotMap slots(tupleLength, tuplesPerBlock);
+    char first[tupleLength * tuplesPerBlock];
+    char second[tupleLength * tuplesPerBlock];
+    char third[tupleLength * tuplesPerBlock];
+    slots.addBlock(first);
+    slots.addBlock(second);
+    ASSERT_EQ(2, slots.blockCount());
+
+    uint32_t slot;
+    ASSERT_TRUE(slots.slotOf(&first[0], slot));
+    ASSERT_EQ(0, slot);
+    ASSERT_TRUE(slots.slotOf(&second[3 * tupleLength], slot));
+    ASSERT_EQ(7, slot);
+    ASSERT_EQ(&second[3 * tupleLength], slots.addressOf(7));
+    ASSERT_EQ(&first[tupleLength], slots.addressOf(1));
+    ASSERT_FALSE(slots.slotOf(&third[0], slot));
+
+    // The first block's number goes to the next block added.
+    slots.removeBlock(first);
+    ASSERT_EQ(1, slots.blockCount());
+    ASSERT_FALSE(slots.slotOf(&first[0], slot));
+    slots.addBlock(third);
+    ASSERT_TRUE(slots.slotOf(&third[2 * tupleLength], slot));
+    ASSERT_EQ(2, slot);
+    ASSERT_EQ(&third[2 * tupleLength], slots.addressOf(2));
+    ASSERT_TRUE(slots.slotOf(&second[0], slot));
+    ASSERT_EQ(4, slot);
+    ASSERT_EQ(2, slots.blockCount());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
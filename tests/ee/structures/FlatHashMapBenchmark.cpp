@@ -0,0 +1,219 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Compares FlatHashMap with the boost::unordered_map that hash aggregation
+ * used to use, on the find-or-insert pattern of a GROUP BY: for every input
+ * row, look up its group and either bump the group's count or add it.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <sys/time.h>
+#include <vector>
+#include "boost/unordered_map.hpp"
+
+#include "harness.h"
+#include "common/NValue.hpp"
+#include "common/Pool.hpp"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "structures/FlatHashMap.h"
+
+using namespace voltdb;
+using namespace std;
+
+int64_t getMicrosNow () {
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+class BenchmarkRecorder {
+public:
+    BenchmarkRecorder(const char* name) : m_name(name), m_start(0), m_duration(0), m_count(0) {}
+
+    void start() {
+        m_start = getMicrosNow();
+    }
+
+    void stop() {
+        m_duration += getMicrosNow() - m_start;
+        m_count++;
+    }
+
+    void print() {
+        if (m_count < 1) {
+            return;
+        }
+        std::cout << m_name << " finished in " << m_duration
+                << " microseconds for " << m_count << " runs, AVG "
+                << m_duration / m_count << " microseconds" << std::endl;
+    }
+
+private:
+    const char* m_name;
+    int64_t m_start;
+    int64_t m_duration;
+    int m_count;
+};
+
+/*
+ * Group by one BIGINT.
+ */
+void benchmarkIntegerKeys(const std::vector<int64_t>& input, int repeat) {
+    BenchmarkRecorder benBoost("BoostUnorderedMap"), benFlat("FlatHashMap");
+    int64_t boostGroups = 0;
+    int64_t flatGroups = 0;
+    for (int run = 0; run < repeat; run++) {
+        {
+            benBoost.start();
+            boost::unordered_map<int64_t, int64_t> map;
+            for (size_t i = 0; i < input.size(); i++) {
+                boost::unordered_map<int64_t, int64_t>::iterator it = map.find(input[i]);
+                if (it == map.end()) {
+                    map.insert(std::make_pair(input[i], 1));
+                }
+                else {
+                    it->second++;
+                }
+            }
+            boostGroups = map.size();
+            benBoost.stop();
+        }
+        {
+            benFlat.start();
+            Pool pool;
+            FlatHashMap<int64_t, int64_t> map(&pool);
+            for (size_t i = 0; i < input.size(); i++) {
+                FlatHashMap<int64_t, int64_t>::iterator it = map.find(input[i]);
+                if (it == map.end()) {
+                    map.insert(std::make_pair(input[i], 1));
+                }
+                else {
+                    it->second++;
+                }
+            }
+            flatGroups = map.size();
+            benFlat.stop();
+        }
+    }
+    assert(boostGroups == flatGroups);
+    std::cout << "Benchmark: BIGINT group key, " << input.size() << " rows, "
+              << flatGroups << " groups" << std::endl;
+    benBoost.print();
+    benFlat.print();
+}
+
+/*
+ * Group by two BIGINT columns held in a key tuple, the way AggregateHashExecutor does.
+ */
+void benchmarkTupleKeys(const std::vector<int64_t>& input, int repeat) {
+    std::vector<ValueType> types(2, VALUE_TYPE_BIGINT);
+    std::vector<int32_t> lengths(2, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    std::vector<bool> allowNull(2, true);
+    TupleSchema* schema = TupleSchema::createTupleSchemaForTest(types, lengths, allowNull);
+    size_t tupleSize = schema->tupleLength() + TUPLE_HEADER_SIZE;
+
+    typedef boost::unordered_map<TableTuple, int64_t, TableTupleHasher, TableTupleEqualityChecker> BoostMap;
+    typedef FlatHashMap<TableTuple, int64_t, TableTupleHasher, TableTupleEqualityChecker> FlatMap;
+
+    BenchmarkRecorder benBoost("BoostUnorderedMap"), benFlat("FlatHashMap");
+    int64_t boostGroups = 0;
+    int64_t flatGroups = 0;
+    for (int run = 0; run < repeat; run++) {
+        {
+            benBoost.start();
+            Pool pool;
+            BoostMap map;
+            TableTuple key(reinterpret_cast<char*>(pool.allocateZeroes(tupleSize)), schema);
+            for (size_t i = 0; i < input.size(); i++) {
+                key.setNValue(0, ValueFactory::getBigIntValue(input[i] % 1000));
+                key.setNValue(1, ValueFactory::getBigIntValue(input[i] / 1000));
+                BoostMap::iterator it = map.find(key);
+                if (it == map.end()) {
+                    map.insert(std::make_pair(key, 1));
+                    key.move(pool.allocateZeroes(tupleSize));
+                }
+                else {
+                    it->second++;
+                }
+            }
+            boostGroups = map.size();
+            benBoost.stop();
+        }
+        {
+            benFlat.start();
+            Pool pool;
+            FlatMap map(&pool);
+            TableTuple key(reinterpret_cast<char*>(pool.allocateZeroes(tupleSize)), schema);
+            for (size_t i = 0; i < input.size(); i++) {
+                key.setNValue(0, ValueFactory::getBigIntValue(input[i] % 1000));
+                key.setNValue(1, ValueFactory::getBigIntValue(input[i] / 1000));
+                FlatMap::iterator it = map.find(key);
+                if (it == map.end()) {
+                    map.insert(std::make_pair(key, 1));
+                    key.move(pool.allocateZeroes(tupleSize));
+                }
+                else {
+                    it->second++;
+                }
+            }
+            flatGroups = map.size();
+            benFlat.stop();
+        }
+    }
+    assert(boostGroups == flatGroups);
+    std::cout << "Benchmark: (BIGINT, BIGINT) group key tuple, " << input.size() << " rows, "
+              << flatGroups << " groups" << std::endl;
+    benBoost.print();
+    benFlat.print();
+
+    TupleSchema::freeTupleSchema(schema);
+}
+
+int main(int argc, char *argv[]) {
+    if ((argc > 1 && *argv[1] == '-') || argc <= 3) {
+        printf("To run a benchmark, execute %s with command line arguments: ("
+                "rows<int>, "
+                "groups<int>, "
+                "repeat<int>)\n",
+                argv[0]);
+        return 0;
+    }
+    int rows = std::atoi(argv[1]);
+    int groups = std::atoi(argv[2]);
+    int repeat = std::atoi(argv[3]);
+
+    srand(static_cast<unsigned int>(getMicrosNow() % 1000000));
+    std::vector<int64_t> input(rows);
+    for (int i = 0; i < rows; i++) {
+        input[i] = rand() % groups;
+    }
+
+    benchmarkIntegerKeys(input, repeat);
+    benchmarkTupleKeys(input, repeat);
+    return 0;
+}
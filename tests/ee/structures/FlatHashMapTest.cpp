@@ -0,0 +1,191 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <vector>
+#include "harness.h"
+#include "common/NValue.hpp"
+#include "common/Pool.hpp"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/tabletuple.h"
+#include "structures/FlatHashMap.h"
+
+using namespace voltdb;
+using namespace std;
+
+typedef FlatHashMap<int64_t, int64_t> IntMap;
+
+// Sends every key to the same home slot
+class ConstantHasher {
+public:
+    size_t operator()(const int64_t &) const { return 42; }
+};
+
+class FlatHashMapTest : public Test {
+public:
+    Pool m_pool;
+};
+
+TEST_F(FlatHashMapTest, InsertAndFind) {
+    IntMap map(&m_pool);
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.find(1) == map.end());
+    ASSERT_TRUE(map.begin() == map.end());
+
+    // Enough to grow many times
+    const int64_t count = 100000;
+    for (int64_t i = 0; i < count; i++) {
+        std::pair<IntMap::iterator, bool> result = map.insert(std::make_pair(i * 3, i));
+        ASSERT_TRUE(result.second);
+        ASSERT_EQ(i * 3, result.first->first);
+    }
+    ASSERT_EQ(count, map.size());
+    ASSERT_TRUE(map.capacity() * IntMap::MAX_LOAD_NUMERATOR >=
+                map.size() * IntMap::MAX_LOAD_DENOMINATOR);
+
+    for (int64_t i = 0; i < count; i++) {
+        IntMap::iterator it = map.find(i * 3);
+        ASSERT_TRUE(it != map.end());
+        ASSERT_EQ(i, it->second);
+        ASSERT_TRUE(map.find(i * 3 + 1) == map.end());
+    }
+
+    // A second insert of a key leaves the first value alone.
+    std::pair<IntMap::iterator, bool> result = map.insert(std::make_pair(30, -1));
+    ASSERT_FALSE(result.second);
+    ASSERT_EQ(10, result.first->second);
+    ASSERT_EQ(count, map.size());
+
+    // Values can be updated in place.
+    map.find(30)->second = -1;
+    ASSERT_EQ(-1, map.find(30)->second);
+}
+
+TEST_F(FlatHashMapTest, Iterate) {
+    IntMap map(&m_pool);
+    const int64_t count = 1000;
+    for (int64_t i = 0; i < count; i++) {
+        map.insert(std::make_pair(i, i * i));
+    }
+
+    std::vector<int> seen(count, 0);
+    const IntMap& constMap = map;
+    for (IntMap::const_iterator it = constMap.begin(); it != constMap.end(); it++) {
+        ASSERT_TRUE(it->first >= 0 && it->first < count);
+        ASSERT_EQ(it->first * it->first, it->second);
+        seen[it->first]++;
+    }
+    for (int64_t i = 0; i < count; i++) {
+        ASSERT_EQ(1, seen[i]);
+    }
+}
+
+TEST_F(FlatHashMapTest, ClearAndReset) {
+    IntMap map(&m_pool);
+    for (int64_t i = 0; i < 1000; i++) {
+        map.insert(std::make_pair(i, i));
+    }
+    size_t capacity = map.capacity();
+
+    // clear keeps the arrays for reuse
+    map.clear();
+    ASSERT_EQ(0, map.size());
+    ASSERT_EQ(capacity, map.capacity());
+    ASSERT_TRUE(map.find(5) == map.end());
+    ASSERT_TRUE(map.begin() == map.end());
+    map.insert(std::make_pair(5, 50));
+    ASSERT_EQ(50, map.find(5)->second);
+    ASSERT_EQ(capacity, map.capacity());
+
+    // reset forgets the arrays, so the pool can be purged
+    map.reset();
+    m_pool.purge();
+    ASSERT_EQ(0, map.size());
+    ASSERT_EQ(0, map.capacity());
+    ASSERT_TRUE(map.find(5) == map.end());
+    for (int64_t i = 0; i < 1000; i++) {
+        map.insert(std::make_pair(i, -i));
+    }
+    ASSERT_EQ(1000, map.size());
+    ASSERT_EQ(-999, map.find(999)->second);
+}
+
+TEST_F(FlatHashMapTest, Collisions) {
+    FlatHashMap<int64_t, int64_t, ConstantHasher> map(&m_pool);
+    for (int64_t i = 0; i < 500; i++) {
+        ASSERT_TRUE(map.insert(std::make_pair(i, i + 1)).second);
+    }
+    for (int64_t i = 0; i < 500; i++) {
+        ASSERT_EQ(i + 1, map.find(i)->second);
+    }
+    ASSERT_TRUE(map.find(500) == map.end());
+}
+
+TEST_F(FlatHashMapTest, Set) {
+    FlatHashSet<int64_t> set(&m_pool);
+    ASSERT_TRUE(set.insert(7));
+    ASSERT_TRUE(set.insert(8));
+    ASSERT_FALSE(set.insert(7));
+    ASSERT_EQ(2, set.size());
+    ASSERT_TRUE(set.contains(8));
+    ASSERT_FALSE(set.contains(9));
+    set.clear();
+    ASSERT_TRUE(set.empty());
+    ASSERT_FALSE(set.contains(8));
+}
+
+TEST_F(FlatHashMapTest, TupleKeys) {
+    std::vector<ValueType> types(2, VALUE_TYPE_BIGINT);
+    std::vector<int32_t> lengths(2, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    std::vector<bool> allowNull(2, true);
+    TupleSchema* schema = TupleSchema::createTupleSchemaForTest(types, lengths, allowNull);
+
+    const int count = 2000;
+    std::vector<char> storage(count * (schema->tupleLength() + TUPLE_HEADER_SIZE));
+    FlatHashMap<TableTuple, int, TableTupleHasher, TableTupleEqualityChecker> map(&m_pool);
+    for (int i = 0; i < count; i++) {
+        TableTuple tuple(&storage[i * (schema->tupleLength() + TUPLE_HEADER_SIZE)], schema);
+        tuple.setNValue(0, ValueFactory::getBigIntValue(i % 100));
+        tuple.setNValue(1, ValueFactory::getBigIntValue(i / 100));
+        ASSERT_TRUE(map.insert(std::make_pair(tuple, i)).second);
+    }
+
+    // Look up with tuples in different storage that hold equal keys.
+    char probeStorage[64];
+    TableTuple probe(probeStorage, schema);
+    for (int i = 0; i < count; i++) {
+        probe.setNValue(0, ValueFactory::getBigIntValue(i % 100));
+        probe.setNValue(1, ValueFactory::getBigIntValue(i / 100));
+        ASSERT_EQ(i, map.find(probe)->second);
+    }
+    probe.setNValue(1, ValueFactory::getBigIntValue(count));
+    ASSERT_TRUE(map.find(probe) == map.end());
+
+    TupleSchema::freeTupleSchema(schema);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -61,9 +61,9 @@ namespace voltdb {
  * Load a table from a SerializeInput object.  We get the
  * schema from the input itself.  This is used only for testing.
  *
- * Note that the sizes of the columns must be predictable from the
- * column types.  No columns may have variable sized types.  This
- * includes array types.
+ * The input doesn't give the sizes of the columns, so variable sized
+ * columns are given the largest size, and their values are allocated
+ * from pool if one is given.  Array types are not supported.
  *
  * The caller owns the table object, and is responsible for
  * deleting it.
@@ -109,7 +109,12 @@ TempTable *loadTableFrom(const char *buffer,
                     idx,
                     column_count);
         assert(colType != VALUE_TYPE_ARRAY);
-        builder.setColumnAtIndex(idx, colType);
+        if (isVariableLengthType(colType)) {
+            builder.setColumnAtIndex(idx, colType, TupleSchema::COLUMN_MAX_VALUE_LENGTH, true, true);
+        }
+        else {
+            builder.setColumnAtIndex(idx, colType);
+        }
     }
     TupleSchema *schema = builder.build();
     for (int idx = 0; idx < column_count; idx += 1) {
@@ -124,7 +129,7 @@ TempTable *loadTableFrom(const char *buffer,
                                        schema, // Transfers ownership to the table.
                                        columnNames,
                                        NULL);
-    table->loadTuplesFromNoHeader(result);
+    table->loadTuplesFromNoHeader(result, pool);
     return table;
 }
 }
@@ -108,13 +108,15 @@ public:
     }
 
     void initialize(const DBConfig  &db,
-                    uint32_t  randomSeed = (uint32_t)time(NULL)) {
-        initialize(db.m_catalogString, db.m_numTables, db.m_tables, randomSeed);
+                    uint32_t  randomSeed = (uint32_t)time(NULL),
+                    int64_t   tempTableMemoryLimit = voltdb::DEFAULT_TEMP_TABLE_MEMORY) {
+        initialize(db.m_catalogString, db.m_numTables, db.m_tables, randomSeed, tempTableMemoryLimit);
     }
     void initialize(const char         *catalogString,
                     int                 numTables,
                     const TableConfig **tables,
-                    uint32_t            randomSeed) {
+                    uint32_t            randomSeed,
+                    int64_t             tempTableMemoryLimit = voltdb::DEFAULT_TEMP_TABLE_MEMORY) {
         srand(randomSeed);
         m_catalog_string = catalogString;
         /*
@@ -136,7 +138,7 @@ public:
                              m_exception_buffer.get(), 4096);
         m_engine->resetReusedResultOutputBuffer();
         int partitionCount = 3;
-        ASSERT_TRUE(m_engine->initialize(this->m_cluster_id, this->m_site_id, 0, 0, "", 0, 1024, voltdb::DEFAULT_TEMP_TABLE_MEMORY, false));
+        ASSERT_TRUE(m_engine->initialize(this->m_cluster_id, this->m_site_id, 0, 0, "", 0, 1024, tempTableMemoryLimit, false));
         m_engine->updateHashinator(voltdb::HASHINATOR_LEGACY, (char*)&partitionCount, NULL, 0);
         ASSERT_TRUE(m_engine->loadCatalog( -2, m_catalog_string));
 
@@ -271,7 +273,12 @@ public:
             ASSERT_TRUE(iter.next(tuple));
             for (int32_t col = 0; col < nCols; col += 1) {
                 int32_t expected = answer[row * nCols + col];
-                int64_t v1 = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(col));
+                voltdb::NValue nval = tuple.getNValue(col);
+                int64_t v1 = voltdb::ValuePeeker::peekAsBigInt(nval);
+                // Tables are loaded from int32 values, where INT32_MIN means NULL.
+                if (nval.isNull()) {
+                    v1 = INT32_NULL;
+                }
                 VOLT_TRACE("Row %02d, col %02d: expected %04d, got %04ld (%s)",
                            row, col,
                            expected, v1,
@@ -406,6 +406,34 @@ public class TestSQLParser extends TestCase {
                 "create role ;");
     }
 
+    public void testParseCreateIndexUsing() {
+        Matcher matcher = SQLParser.matchCreateIndexUsing(
+                "CREATE INDEX idx ON t (a, b) USING btree;");
+        assertTrue(matcher.matches());
+        assertEquals("CREATE INDEX idx ON t (a, b)", matcher.group(1));
+        assertEquals("idx", matcher.group(2));
+        assertEquals("btree", matcher.group(3));
+
+        matcher = SQLParser.matchCreateIndexUsing(
+                "create index I on T (A)\nwhere A > 0\nusing BITMAP ;");
+        assertTrue(matcher.matches());
+        assertEquals("create index I on T (A)\nwhere A > 0", matcher.group(1));
+        assertEquals("I", matcher.group(2));
+        assertEquals("BITMAP", matcher.group(3));
+
+        assertTrue(SQLParser.matchCreateIndexUsing(
+                "CREATE UNIQUE INDEX idx ON t (a) USING BTREE;").matches());
+        assertTrue(SQLParser.matchCreateIndexUsing(
+                "CREATE ASSUMEUNIQUE INDEX idx ON t (a) USING BTREE;").matches());
+
+        assertFalse(SQLParser.matchCreateIndexUsing(
+                "CREATE INDEX idx ON t (a);").matches());
+        assertFalse(SQLParser.matchCreateIndexUsing(
+                "CREATE INDEX idx ON t (a) USING HASH;").matches());
+        assertFalse(SQLParser.matchCreateIndexUsing(
+                "CREATE TABLE t (a INTEGER) USING BTREE;").matches());
+    }
+
     public void testParseRecall()
     {
         parseRecallCase("RECALL 1", 1);
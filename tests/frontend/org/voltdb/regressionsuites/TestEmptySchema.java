@@ -54,7 +54,7 @@ public class TestEmptySchema extends RegressionSuite
 
         // Even running should be an improvement (ENG-4645), but do something just to be sure
         // Also, check to be sure we get a full schema for the table and index stats
-        ColumnInfo[] expectedSchema = new ColumnInfo[13];
+        ColumnInfo[] expectedSchema = new ColumnInfo[23];
         expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
         expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
         expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
@@ -68,6 +68,16 @@ public class TestEmptySchema extends RegressionSuite
         expectedSchema[10] = new ColumnInfo("STRING_DATA_MEMORY", VoltType.BIGINT);
         expectedSchema[11] = new ColumnInfo("TUPLE_LIMIT", VoltType.INTEGER);
         expectedSchema[12] = new ColumnInfo("PERCENT_FULL", VoltType.INTEGER);
+        expectedSchema[13] = new ColumnInfo("TUPLES_EXPIRED", VoltType.BIGINT);
+        expectedSchema[14] = new ColumnInfo("EXPIRATION_TIME", VoltType.BIGINT);
+        expectedSchema[15] = new ColumnInfo("COMPACTION_PENDING_MEMORY", VoltType.BIGINT);
+        expectedSchema[16] = new ColumnInfo("COMPACTION_STEPS", VoltType.BIGINT);
+        expectedSchema[17] = new ColumnInfo("COMPACTION_TIME", VoltType.BIGINT);
+        expectedSchema[18] = new ColumnInfo("COMPACTION_MAX_PAUSE", VoltType.BIGINT);
+        expectedSchema[19] = new ColumnInfo("EVICTED_BLOCKS", VoltType.BIGINT);
+        expectedSchema[20] = new ColumnInfo("EVICTED_MEMORY", VoltType.BIGINT);
+        expectedSchema[21] = new ColumnInfo("BLOCKS_FETCHED", VoltType.BIGINT);
+        expectedSchema[22] = new ColumnInfo("TUPLE_SLACK_MEMORY", VoltType.BIGINT);
         VoltTable expectedTable = new VoltTable(expectedSchema);
 
         VoltTable[] results = client.callProcedure("@Statistics", "TABLE", 0).getResults();
@@ -285,7 +285,7 @@ public class TestStatisticsSuite extends StatisticsTestSuiteBase {
         System.out.println("\n\nTESTING MEMORY STATS\n\n\n");
         Client client  = getFullyConnectedClient();
 
-        ColumnInfo[] expectedSchema = new ColumnInfo[14];
+        ColumnInfo[] expectedSchema = new ColumnInfo[17];
         expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
         expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
         expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
@@ -300,6 +300,9 @@ public class TestStatisticsSuite extends StatisticsTestSuiteBase {
         expectedSchema[11] = new ColumnInfo("POOLEDMEMORY", VoltType.BIGINT);
         expectedSchema[12] = new ColumnInfo("PHYSICALMEMORY", VoltType.BIGINT);
         expectedSchema[13] = new ColumnInfo("JAVAMAXHEAP", VoltType.INTEGER);
+        expectedSchema[14] = new ColumnInfo("HUGEPAGEMEMORY", VoltType.BIGINT);
+        expectedSchema[15] = new ColumnInfo("HUGEPAGEFALLBACKMEMORY", VoltType.BIGINT);
+        expectedSchema[16] = new ColumnInfo("RECLAIMEDMEMORY", VoltType.BIGINT);
         VoltTable expectedTable = new VoltTable(expectedSchema);
 
         VoltTable[] results = null;